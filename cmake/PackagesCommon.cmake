@@ -18,6 +18,9 @@ HT_INSTALL_LIBS(lib ${LZMA_LIBRARIES_SHARED})
 SET_DEPS(NAME "ZSTD"  REQUIRED TRUE LIB_PATHS "" INC_PATHS "" STATIC libzstd.a SHARED zstd INCLUDE zstd.h)
 HT_INSTALL_LIBS(lib ${ZSTD_LIBRARIES_SHARED})
 
+SET_DEPS(NAME "LZ4"   REQUIRED TRUE LIB_PATHS "" INC_PATHS "" STATIC liblz4.a SHARED lz4 INCLUDE lz4.h)
+HT_INSTALL_LIBS(lib ${LZ4_LIBRARIES_SHARED})
+
 SET_DEPS(NAME "EVENT" REQUIRED TRUE LIB_PATHS "" INC_PATHS "" STATIC libevent.a SHARED event INCLUDE event.h)
 HT_INSTALL_LIBS(lib  ${EVENT_LIBRARIES_SHARED})
 
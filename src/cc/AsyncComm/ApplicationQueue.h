@@ -31,6 +31,7 @@
 #include <AsyncComm/ApplicationQueueInterface.h>
 #include <AsyncComm/ApplicationHandler.h>
 
+#include <Common/LatencyHistogram.h>
 #include <Common/Logger.h>
 #include <Common/StringExt.h>
 #include <Common/Thread.h>
@@ -110,10 +111,13 @@ namespace Hypertable {
      */
     class RequestRec {
     public:
-      RequestRec(ApplicationHandler *arh) : handler(arh), group_state(0) { return; }
+      RequestRec(ApplicationHandler *arh) : handler(arh), group_state(0),
+        enqueue_time(std::chrono::steady_clock::now()) { return; }
       ~RequestRec() { delete handler; }
       ApplicationHandler *handler; //!< Pointer to ApplicationHandler
       GroupState *group_state;     //!< Pointer to GroupState to which request belongs
+      /// Time at which request was added to the queue
+      std::chrono::steady_clock::time_point enqueue_time;
     };
 
     /** Individual request queue
@@ -156,6 +160,9 @@ namespace Hypertable {
 
       /// Flag indicating if queue has been paused
       bool paused;
+
+      /// Histogram of time requests spend waiting on the queue
+      LatencyHistogram *wait_histogram {};
     };
 
     /** Application queue worker thread function (functor)
@@ -247,6 +254,8 @@ namespace Hypertable {
           }
 
           if (rec) {
+            if (m_state.wait_histogram)
+              m_state.wait_histogram->record_since(rec->enqueue_time);
             if (rec->handler)
               rec->handler->run();
             remove(rec);
@@ -418,6 +427,16 @@ namespace Hypertable {
       m_state.paused = true;
     }
 
+    /** Sets histogram for recording queue wait time.
+     * Each request's wait time, from the call to #add until a worker thread
+     * picks it up, is recorded in microseconds.  Must be called before any
+     * requests are added.
+     * @param histogram Histogram to record wait times into
+     */
+    void set_wait_histogram(LatencyHistogram *histogram) {
+      m_state.wait_histogram = histogram;
+    }
+
     /** Adds a request (application request handler) to the application queue.
      * The request queue is designed to support the serialization of related
      * requests.  Requests are related by the thread group ID value in the
@@ -307,6 +307,12 @@ void DefaultPolicy::init_options() {
         "of old MetaLog files to retain for historical purposes")
     ("Hypertable.MetaLog.MaxFileSize", i64(100*M), "Maximum "
         "size a MetaLog file can grow before it is compacted")
+    ("Hypertable.MetaLog.Compaction.Ratio", i32(2), "Compact a MetaLog "
+        "file in the background once the entries appended after its initial "
+        "snapshot exceed this multiple of the snapshot size (0 disables)")
+    ("Hypertable.MetaLog.Compaction.MinimumSize", i64(4*M), "Minimum "
+        "size a MetaLog file must reach before it is compacted in the "
+        "background")
     ("Hypertable.MetaLog.SkipErrors", boo(false), "Skipping "
         "errors instead of throwing exceptions on metalog errors")
     ("Hypertable.MetaLog.WriteInterval", i32(30),
@@ -359,8 +365,22 @@ void DefaultPolicy::init_options() {
         " maintenance interval (checkpoint BerkeleyDB, log cleanup etc)")
     ("Hyperspace.Checkpoint.Size", g_i32(1*M), "Run BerkeleyDB checkpoint"
         " when logs exceed this size limit")
+    ("Hyperspace.GroupCommit.Enable", boo(false), "Commit concurrent "
+        "BerkeleyDB transactions with a single shared log flush.  Committed "
+        "state becomes visible to other transactions before it is durable; "
+        "only the committing request waits for the flush")
+    ("Hyperspace.GroupCommit.Window", g_i32(1), "Time (millisec) a group "
+        "commit leader waits for more transactions before flushing the log")
+    ("Hyperspace.GroupCommit.MaxBatch", g_i32(64), "Flush the log as soon as "
+        "this many transactions are waiting for a group commit")
     ("Hyperspace.Client.Datagram.SendPort", i16(0),
         "Client UDP send port for keepalive packets")
+    ("Hyperspace.Client.Cache.Enable", boo(false), "Cache attribute values, "
+        "existence checks and directory listings in the Hyperspace client")
+    ("Hyperspace.Client.Cache.Lease", i32(5000), "Maximum time (millisec) "
+        "a Hyperspace client cache entry is served without revalidation")
+    ("Hyperspace.Client.Cache.MaxEntries", i32(100000), "Maximum number of "
+        "entries held in the Hyperspace client cache")
     ("Hyperspace.LogGc.Interval", g_i32(60000), "Check for unused BerkeleyDB "
         "log files after this much time")
     ("Hyperspace.LogGc.MaxUnusedLogs", g_i32(200), "Number of unused BerkeleyDB "
@@ -408,6 +428,10 @@ void DefaultPolicy::init_options() {
         "load balancer to be overloaded")
     ("Hypertable.HqlInterpreter.Mutator.NoLogSync", boo(false),
         "Suspends CommitLog sync operation on updates until command completion")
+    ("Hypertable.HqlInterpreter.LoadData.Threads", i32(1),
+        "Number of threads used to parse and load input for LOAD DATA "
+        "INFILE ... INTO TABLE; with more than one, cells are loaded in no "
+        "particular order")
     ("Hypertable.RangeLocator.MetadataReadaheadCount", i32(10),
         "Number of rows that the RangeLocator fetches from the METADATA")
     ("Hypertable.RangeLocator.MaxErrorQueueLength", i32(4),
@@ -432,7 +456,11 @@ void DefaultPolicy::init_options() {
     ("Hypertable.Master.Port", i16(15864),
         "Port number on which Hypertable Master is or should be listening")
     ("Hypertable.Master.Workers", i32(100),
-        "Number of Hypertable Master worker threads created")
+        "Maximum number of Hypertable Master worker threads")
+    ("Hypertable.Master.Workers.Minimum", i32(10),
+        "Number of Hypertable Master worker threads kept running when idle; "
+        "more are added, up to Hypertable.Master.Workers, while operations "
+        "are waiting to run")
     ("Hypertable.Master.Reactors", i32(),
         "Number of Hypertable Master communication reactor threads created")
     ("Hypertable.Master.Gc.Interval", i32(300000),
@@ -496,6 +524,41 @@ void DefaultPolicy::init_options() {
      "Trigger a merge if an adjacent run of merge candidate CellStores exceeds this length")
     ("Hypertable.RangeServer.CellStore.DefaultBlockSize",
         i32(64*KiB), "Default block size for cell stores")
+    ("Hypertable.RangeServer.CellStore.AdaptiveBlockSize", boo(false),
+        "Choose the block size of cell stores written by compactions from "
+        "each access group's scan statistics, between MinBlockSize for "
+        "point lookups and MaxBlockSize for large range scans, instead of "
+        "the configured block size")
+    ("Hypertable.RangeServer.CellStore.AdaptiveBlockSize.MinScans", i32(16),
+        "Number of (decayed) scans an access group must have seen before "
+        "its block size is adapted")
+    ("Hypertable.RangeServer.CellStore.MinBlockSize", i32(4*KiB),
+        "Smallest block size chosen in adaptive block size mode")
+    ("Hypertable.RangeServer.CellStore.MaxBlockSize", i32(256*KiB),
+        "Largest block size chosen in adaptive block size mode")
+    ("Hypertable.RangeServer.CellStore.SeparateValues", boo(false),
+        "Store the values of each cell store block in a separately "
+        "compressed section, so that key-only scans and scans that skip "
+        "most cells of a block do not inflate its values.  Such cell stores "
+        "are written as version 8, which older releases cannot read")
+    ("Hypertable.RangeServer.CellStore.RestartInterval", i32(0),
+        "Number of entries between uncompressed keys (restart points) in "
+        "cell store blocks, used to binary search a block on seek (0 for no "
+        "restart points).  Cell stores with restart points are written as "
+        "version 8, which releases that predate them cannot read, so only "
+        "enable them (16 is a good choice) once every RangeServer has been "
+        "upgraded")
+    ("Hypertable.RangeServer.CellStore.DeltaEncodeTimestamps", boo(false),
+        "Encode the timestamp and revision of each key in newly written cell "
+        "stores as a varint delta from the previous key.  Such cell stores "
+        "are written as version 8, which releases that predate this "
+        "encoding cannot read")
+    ("Hypertable.RangeServer.CellStore.Dictionary.MaxSize", i32(16*KiB),
+        "Maximum size of the dictionary trained for cell stores written with "
+        "the zstd_dict compressor")
+    ("Hypertable.RangeServer.CellStore.Dictionary.SampleSize", i32(1*MiB),
+        "Amount of block data buffered when writing a cell store with the "
+        "zstd_dict compressor, from which its dictionary is trained")
     ("Hypertable.RangeServer.Data.DefaultReplication",
         i32(-1), "Default replication for data")
     ("Hypertable.RangeServer.CellStore.DefaultCompressor",
@@ -522,6 +585,11 @@ void DefaultPolicy::init_options() {
      boo(true), "Enable query cache mutex statistics")
     ("Hypertable.RangeServer.QueryCache.MaxMemory", i64(50*M),
         "Maximum size of query cache")
+    ("Hypertable.RangeServer.RangeScanCache.MaxMemory", i64(0),
+        "Maximum size of cache holding results of small multi-row scans "
+        "(0 disables the cache)")
+    ("Hypertable.RangeServer.RangeScanCache.MaxResultSize", i32(64*K),
+        "Results of multi-row scans larger than this are not cached")
     ("Hypertable.RangeServer.Location.AutoReInitiate", boo(false),
      "If RS location marked removed, deletes previous location and inititate a new RS location")
     ("Hypertable.RangeServer.Range.RowSize.Unlimited", boo(false),
@@ -555,13 +623,19 @@ void DefaultPolicy::init_options() {
         "amount of outstanding commit log before pruning")
     ("Hypertable.RangeServer.CommitLog.RollLimit", i64(100*M),
         "Roll commit log after this many bytes")
+    ("Hypertable.RangeServer.CommitLog.Replay.Threads", i32(4),
+        "Number of threads used to decompress, and number used to apply, user "
+        "commit log blocks during startup replay (1 replays sequentially)")
     ("Hypertable.RangeServer.CommitLog.Compressor",
         str("quicklz"),
-       "Commit log compressor to use (zlib, lzo, quicklz, snappy, bmz, zstd, none)")
+       "Commit log compressor to use (zlib, lzo, lz4, quicklz, snappy, bmz, zstd, none)")
     ("Hypertable.RangeServer.Testing.MaintenanceNeeded.PauseInterval", i32(0),
         "TESTING:  After update, if range needs maintenance, pause for this number of milliseconds")
     ("Hypertable.RangeServer.UpdateCoalesceLimit", i64(5*M),
         "Amount of update data to coalesce into single commit log sync")
+    ("Hypertable.RangeServer.UpdateCoalesceWindow", i32(0),
+        "Microseconds to wait for more updates before committing a lone "
+        "update, so that concurrent small updates share one commit log write")
     ("Hypertable.RangeServer.Failover.FlushLimit.PerRange",
      i32(10*M), "Amount of updates (bytes) accumulated for a "
         "single range to trigger a replay buffer flush")
@@ -575,7 +649,7 @@ void DefaultPolicy::init_options() {
     ("Hypertable.CommitLog.RollLimit", i64(100*M),
         "Roll commit log after this many bytes")
     ("Hypertable.CommitLog.Compressor", str("quicklz"),
-        "Commit log compressor to use (zlib, lzo, quicklz, snappy, bmz, zstd, none)")
+        "Commit log compressor to use (zlib, lzo, lz4, quicklz, snappy, bmz, zstd, none)")
     ("Hypertable.CommitLog.SkipErrors", boo(false),
         "Skip over any corruption encountered in the commit log")
     ("Hypertable.RangeServer.Scanner.Ttl", i32(1800*K),
@@ -598,6 +672,28 @@ void DefaultPolicy::init_options() {
         "Limit on number of major compactions due to move per maintenance interval")
     ("Hypertable.RangeServer.Maintenance.InitializationPerInterval", i32(),
         "Limit on number of initialization tasks to create per maintenance interval")
+    ("Hypertable.RangeServer.Maintenance.Prioritizer", str("default"),
+        "Maintenance prioritization algorithm (default or cost-based)")
+    ("Hypertable.RangeServer.Maintenance.Scoring.MemoryWeight", f64(1.0),
+        "Cost-based prioritizer weight of memory freed")
+    ("Hypertable.RangeServer.Maintenance.Scoring.LogWeight", f64(1.0),
+        "Cost-based prioritizer weight of commit log bytes released")
+    ("Hypertable.RangeServer.Maintenance.Scoring.DiskWeight", f64(0.5),
+        "Cost-based prioritizer weight of disk space reclaimed")
+    ("Hypertable.RangeServer.Maintenance.Scoring.ReadCost", i32(65536),
+        "Cost-based prioritizer bytes of I/O charged per CellStore read")
+    ("Hypertable.RangeServer.Maintenance.Scoring.CpuWeight", f64(0.25),
+        "Cost-based prioritizer weight of bytes passed through merge and "
+        "compression code, relative to bytes of I/O")
+    ("Hypertable.RangeServer.Maintenance.Scoring.MinScore", f64(0.0),
+        "Cost-based prioritizer score that optional maintenance (e.g. memory "
+        "purges) must exceed to be scheduled")
+    ("Hypertable.RangeServer.Maintenance.Throttle.Rate", g_i32(0),
+        "Limit (MB/s) on compaction and split I/O shared by all maintenance "
+        "threads (0 = unlimited)")
+    ("Hypertable.RangeServer.Maintenance.Throttle.BackgroundReserve", g_i32(50),
+        "Percentage of maintenance throttle budget held back from merging, "
+        "major and GC compactions for minor compactions, splits and relinquishes")
     ("Hypertable.RangeServer.Monitoring.DataDirectories", str("/"),
         "Comma-separated list of directory mount points of disk volumes to monitor")
     ("Hypertable.RangeServer.Workers", i32(50),
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Definitions for LatencyHistogram.
+/// This file contains type definitions for LatencyHistogram, a lock-free
+/// histogram with logarithmic buckets for recording operation latencies.
+
+#include <Common/Compat.h>
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+
+using namespace Hypertable;
+using namespace std;
+
+namespace {
+
+  /// Source of round-robin shard assignments
+  atomic<unsigned> next_shard {};
+
+  /// Returns shard index of calling thread.
+  /// @return Shard index of calling thread
+  inline int thread_shard() {
+    static thread_local int shard =
+      (int)(next_shard.fetch_add(1, memory_order_relaxed) %
+            LatencyHistogram::SHARD_COUNT);
+    return shard;
+  }
+
+}
+
+int LatencyHistogram::bucket_index(uint64_t value) {
+  if (value < (uint64_t)SUB_BUCKET_COUNT)
+    return (int)value;
+  value = std::min(value, ((uint64_t)1 << MAX_MAGNITUDE) - 1);
+  int magnitude = 63 - __builtin_clzll(value);
+  int shift = magnitude - SUB_BUCKET_BITS;
+  return ((shift + 1) << SUB_BUCKET_BITS) +
+    (int)((value >> shift) - SUB_BUCKET_COUNT);
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(int index) {
+  if (index < SUB_BUCKET_COUNT)
+    return (uint64_t)index;
+  int shift = (index >> SUB_BUCKET_BITS) - 1;
+  uint64_t sub_bucket = (uint64_t)(index & (SUB_BUCKET_COUNT - 1));
+  return ((SUB_BUCKET_COUNT + sub_bucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value) {
+  Shard &shard = m_shards[thread_shard()];
+  shard.counts[bucket_index(value)].fetch_add(1, memory_order_relaxed);
+  shard.count.fetch_add(1, memory_order_relaxed);
+  shard.sum.fetch_add(value, memory_order_relaxed);
+  uint64_t max = shard.max.load(memory_order_relaxed);
+  while (value > max &&
+         !shard.max.compare_exchange_weak(max, value, memory_order_relaxed))
+    ;
+}
+
+void LatencyHistogram::snapshot(Snapshot *snapshot, bool reset) {
+  *snapshot = Snapshot();
+  for (auto &shard : m_shards) {
+    if (reset) {
+      for (int i=0; i<BUCKET_COUNT; i++)
+        snapshot->counts[i] += shard.counts[i].exchange(0, memory_order_relaxed);
+      snapshot->count += shard.count.exchange(0, memory_order_relaxed);
+      snapshot->sum += shard.sum.exchange(0, memory_order_relaxed);
+      snapshot->max = std::max(snapshot->max,
+                               shard.max.exchange(0, memory_order_relaxed));
+    }
+    else {
+      for (int i=0; i<BUCKET_COUNT; i++)
+        snapshot->counts[i] += shard.counts[i].load(memory_order_relaxed);
+      snapshot->count += shard.count.load(memory_order_relaxed);
+      snapshot->sum += shard.sum.load(memory_order_relaxed);
+      snapshot->max = std::max(snapshot->max,
+                               shard.max.load(memory_order_relaxed));
+    }
+  }
+}
+
+uint64_t LatencyHistogram::Snapshot::percentile(double percentile) const {
+  uint64_t total {};
+  for (int i=0; i<BUCKET_COUNT; i++)
+    total += counts[i];
+  if (total == 0)
+    return 0;
+  uint64_t target = (uint64_t)((percentile / 100.0) * (double)total + 0.5);
+  target = std::min(std::max(target, (uint64_t)1), total);
+  uint64_t seen {};
+  for (int i=0; i<BUCKET_COUNT; i++) {
+    seen += counts[i];
+    if (seen >= target)
+      return std::min(bucket_upper_bound(i), max);
+  }
+  return max;
+}
+
+void LatencyHistogram::Snapshot::subtract(const Snapshot &earlier) {
+  int highest {-1};
+  for (int i=0; i<BUCKET_COUNT; i++) {
+    counts[i] = (counts[i] > earlier.counts[i]) ? counts[i] - earlier.counts[i] : 0;
+    if (counts[i])
+      highest = i;
+  }
+  count = (count > earlier.count) ? count - earlier.count : 0;
+  sum = (sum > earlier.sum) ? sum - earlier.sum : 0;
+  if (highest == -1)
+    max = 0;
+  else
+    max = std::min(max, bucket_upper_bound(highest));
+}
@@ -0,0 +1,192 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Declarations for LatencyHistogram.
+/// This file contains type declarations for LatencyHistogram, a lock-free
+/// histogram with logarithmic buckets for recording operation latencies.
+
+#ifndef Common_LatencyHistogram_h
+#define Common_LatencyHistogram_h
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Hypertable {
+
+  /// @addtogroup Common
+  /// @{
+
+  /// Lock-free latency histogram.
+  /// Values (typically microseconds) are counted in HDR-style logarithmic
+  /// buckets: values below #SUB_BUCKET_COUNT get their own bucket and every
+  /// power-of-two range above that is split into #SUB_BUCKET_COUNT linear
+  /// sub-buckets, giving a worst case relative error of 12.5% across the whole
+  /// value range.  Values are clamped to 2^#MAX_MAGNITUDE - 1.  To keep
+  /// concurrent recorders from contending on the same cache lines, counters are
+  /// spread across #SHARD_COUNT shards and each thread is assigned a shard the
+  /// first time it records a value.  Recording is a handful of relaxed atomic
+  /// adds; snapshot() sums the shards.
+  class LatencyHistogram {
+  public:
+
+    /// Number of sub-buckets per power of two (log2)
+    static constexpr int SUB_BUCKET_BITS {3};
+
+    /// Number of sub-buckets per power of two
+    static constexpr int SUB_BUCKET_COUNT {1 << SUB_BUCKET_BITS};
+
+    /// Values are clamped to 2^MAX_MAGNITUDE - 1
+    static constexpr int MAX_MAGNITUDE {40};
+
+    /// Total number of buckets
+    static constexpr int BUCKET_COUNT
+      {(MAX_MAGNITUDE - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT};
+
+    /// Number of counter shards
+    static constexpr int SHARD_COUNT {16};
+
+    /// Point-in-time copy of histogram counters.
+    class Snapshot {
+    public:
+
+      /// Returns value at given percentile.
+      /// Returns the upper bound of the bucket containing the requested
+      /// percentile, capped at #max.
+      /// @param percentile Percentile in the range [0, 100]
+      /// @return Value at <code>percentile</code>, or 0 if empty
+      uint64_t percentile(double percentile) const;
+
+      /// Returns mean of recorded values.
+      /// @return Mean of recorded values, or 0 if empty
+      double mean() const { return count ? (double)sum / (double)count : 0.0; }
+
+      /// Subtracts an earlier snapshot of the same histogram.
+      /// After this call the snapshot describes only the values recorded
+      /// between the two snapshots.  Since the exact maximum of that interval
+      /// is unknown, #max is lowered to the upper bound of the highest
+      /// non-empty bucket if it exceeds it.
+      /// @param earlier Earlier snapshot of the same histogram
+      void subtract(const Snapshot &earlier);
+
+      /// Number of recorded values
+      uint64_t count {};
+
+      /// Sum of recorded values
+      uint64_t sum {};
+
+      /// Largest recorded value
+      uint64_t max {};
+
+      /// Per-bucket counts
+      uint64_t counts[BUCKET_COUNT] {};
+    };
+
+    /// Records elapsed time into a histogram when it goes out of scope.
+    class ScopedTimer {
+    public:
+
+      /// Constructor.
+      /// @param histogram Histogram to record into (may be nullptr, in which
+      /// case nothing is recorded)
+      ScopedTimer(LatencyHistogram *histogram)
+        : m_histogram(histogram), m_start(std::chrono::steady_clock::now()) { }
+
+      /// Destructor.
+      /// Records microseconds elapsed since construction.
+      ~ScopedTimer() {
+        if (m_histogram)
+          m_histogram->record_since(m_start);
+      }
+
+    private:
+
+      /// Histogram to record into
+      LatencyHistogram *m_histogram;
+
+      /// Start time
+      std::chrono::steady_clock::time_point m_start;
+    };
+
+    /// Constructor.
+    /// @param name Histogram name
+    LatencyHistogram(const std::string &name) : m_name(name) { }
+
+    /// Returns histogram name.
+    /// @return Histogram name
+    const std::string &name() const { return m_name; }
+
+    /// Records a value.
+    /// @param value Value to record
+    void record(uint64_t value);
+
+    /// Records microseconds elapsed since <code>start</code>.
+    /// @param start Start time
+    void record_since(std::chrono::steady_clock::time_point start) {
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      record(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    }
+
+    /// Copies counters into a snapshot.
+    /// The copy is not atomic with respect to concurrent recorders, so a
+    /// value recorded during the call may be only partially reflected.
+    /// @param snapshot Address of snapshot to fill in
+    /// @param reset If <i>true</i>, counters are reset to zero
+    void snapshot(Snapshot *snapshot, bool reset=false);
+
+    /// Returns bucket index for a value.
+    /// @param value Value
+    /// @return Index of bucket that counts <code>value</code>
+    static int bucket_index(uint64_t value);
+
+    /// Returns largest value counted by a bucket.
+    /// @param index Bucket index
+    /// @return Largest value counted by bucket <code>index</code>
+    static uint64_t bucket_upper_bound(int index);
+
+  private:
+
+    /// Per-thread counter shard
+    struct alignas(64) Shard {
+      std::atomic<uint64_t> count {};
+      std::atomic<uint64_t> sum {};
+      std::atomic<uint64_t> max {};
+      std::atomic<uint64_t> counts[BUCKET_COUNT] {};
+    };
+
+    /// Histogram name
+    std::string m_name;
+
+    /// Counter shards
+    Shard m_shards[SHARD_COUNT];
+  };
+
+  /// Smart pointer to LatencyHistogram
+  typedef std::shared_ptr<LatencyHistogram> LatencyHistogramPtr;
+
+  /// @}
+}
+
+#endif // Common_LatencyHistogram_h
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include <Common/Compat.h>
+#include <Common/LatencyHistogram.h>
+#include <Common/Logger.h>
+
+#include <thread>
+#include <vector>
+
+using namespace Hypertable;
+using namespace std;
+
+int main(int argc, char **argv) {
+  LatencyHistogram::Snapshot snapshot;
+
+  // Bucket boundaries are contiguous and bounded
+  for (int i=1; i<LatencyHistogram::BUCKET_COUNT; i++) {
+    uint64_t lower = LatencyHistogram::bucket_upper_bound(i-1) + 1;
+    HT_ASSERT(LatencyHistogram::bucket_index(lower) == i);
+    HT_ASSERT(LatencyHistogram::bucket_index(LatencyHistogram::bucket_upper_bound(i)) == i);
+  }
+  HT_ASSERT(LatencyHistogram::bucket_index((uint64_t)-1) ==
+            LatencyHistogram::BUCKET_COUNT-1);
+
+  // Relative error stays within one sub-bucket
+  for (uint64_t value = 1; value < ((uint64_t)1 << 36); value = value*3 + 1) {
+    uint64_t upper =
+      LatencyHistogram::bucket_upper_bound(LatencyHistogram::bucket_index(value));
+    HT_ASSERT(upper >= value);
+    HT_ASSERT((double)(upper - value) <= (double)value / 8.0);
+  }
+
+  // Percentiles
+  {
+    LatencyHistogram histogram("test");
+    for (uint64_t i=1; i<=1000; i++)
+      histogram.record(i);
+    histogram.snapshot(&snapshot);
+    HT_ASSERT(snapshot.count == 1000);
+    HT_ASSERT(snapshot.sum == 500500);
+    HT_ASSERT(snapshot.max == 1000);
+    uint64_t p50 = snapshot.percentile(50);
+    HT_ASSERT(p50 >= 500 && p50 <= 500 + 500/8);
+    uint64_t p99 = snapshot.percentile(99);
+    HT_ASSERT(p99 >= 990 && p99 <= 1000);
+    HT_ASSERT(snapshot.percentile(100) == 1000);
+
+    // Interval deltas
+    LatencyHistogram::Snapshot earlier = snapshot;
+    histogram.record(5);
+    histogram.snapshot(&snapshot, true);
+    snapshot.subtract(earlier);
+    HT_ASSERT(snapshot.count == 1 && snapshot.sum == 5 && snapshot.max == 5);
+
+    // Reset
+    histogram.snapshot(&snapshot);
+    HT_ASSERT(snapshot.count == 0 && snapshot.max == 0);
+    HT_ASSERT(snapshot.percentile(99) == 0);
+  }
+
+  // Concurrent recorders
+  {
+    LatencyHistogram histogram("concurrent");
+    vector<thread> threads;
+    for (int i=0; i<8; i++)
+      threads.push_back(thread([&histogram, i]() {
+            for (uint64_t j=0; j<100000; j++)
+              histogram.record(i);
+          }));
+    for (auto &t : threads)
+      t.join();
+    histogram.snapshot(&snapshot);
+    HT_ASSERT(snapshot.count == 800000);
+    HT_ASSERT(snapshot.sum == 100000 * 28);
+    HT_ASSERT(snapshot.max == 7);
+    for (int i=0; i<8; i++)
+      HT_ASSERT(snapshot.counts[i] == 100000);
+  }
+
+  return 0;
+}
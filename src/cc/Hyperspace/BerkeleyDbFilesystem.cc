@@ -113,6 +113,8 @@ BerkeleyDbFilesystem::BerkeleyDbFilesystem(PropertiesPtr &props,
     m_env.set_errcall(db_err_callback);
     m_env.set_verbose(DB_VERB_REPLICATION, 1);
     m_env.open(m_base_dir.c_str(), env_flags, 0);
+    if (props->get_bool("Hyperspace.GroupCommit.Enable"))
+      m_group_commit = std::make_unique<GroupCommit>(props, &m_env);
     {
       // Haven't implemented state recovery yet, so delete the old statedb and create the new one
       String state_db = m_base_dir + "/" + ms_name_state_db;
@@ -661,6 +663,7 @@ void BerkeleyDbFilesystem::start_transaction(BDbTxn &txn) {
     // Use handles for this thread
     txn.handle_namespace_db = db_handles->handle_namespace_db;
     txn.handle_state_db = db_handles->handle_state_db;
+    txn.group_commit = m_group_commit.get();
 
     // open txn
     m_env.txn_begin(NULL, &txn.db_txn, 0);
@@ -32,6 +32,7 @@
 
 #include <Hyperspace/DirEntry.h>
 #include <Hyperspace/DirEntryAttr.h>
+#include <Hyperspace/GroupCommit.h>
 #include <Hyperspace/StateDbKeys.h>
 
 #include <Common/DynamicBuffer.h>
@@ -231,17 +232,34 @@ namespace Hyperspace {
     BDbTxn(): handle_namespace_db(0), handle_state_db(0), db_txn(0) {}
 
     /** Commit transaction.
+     * If <code>flag</code> is zero and #group_commit is set, the transaction
+     * is committed with <code>DB_TXN_NOSYNC</code> and this method waits in
+     * GroupCommit::sync() for a shared log flush, otherwise the transaction
+     * is committed with <code>flag</code>.
      * @param flag BerkeleyDB commit flags
+     * @throws Exception with code Error::HYPERSPACE_BERKELEYDB_ERROR if the
+     * group commit log flush failed
      */
     void commit(int flag=0) {
+      if (flag == 0 && group_commit) {
+        db_txn->commit(DB_TXN_NOSYNC);
+        db_txn = 0;
+        group_commit->sync();
+        return;
+      }
       db_txn->commit(flag);
       db_txn = 0;
     }
 
-    /** Abort transaction. */
+    /** Abort transaction.
+     * Does nothing if the transaction has already been committed, which is
+     * the case when a group commit log flush fails.
+     */
     void abort() {
-      db_txn->abort();
-      db_txn = 0;
+      if (db_txn) {
+        db_txn->abort();
+        db_txn = 0;
+      }
     }
 
     /// Filesystem namespace database handle
@@ -252,6 +270,9 @@ namespace Hyperspace {
 
     /// BerkeleyDB transaction object
     DbTxn *db_txn;
+
+    /// Group commit object (null if group commit is disabled)
+    GroupCommit *group_commit {};
   };
 
   /** Writes human-readable version of <code>txn</code> to an ostream.
@@ -291,6 +312,14 @@ namespace Hyperspace {
      */
     void do_checkpoint();
 
+    /** Returns group commit statistics for the status text.
+     * @return Summary of group commit batch size and commit latency, or an
+     * empty string if group commit is disabled
+     */
+    String group_commit_statistics() {
+      return m_group_commit ? m_group_commit->format_statistics() : String();
+    }
+
     /** Check if we're the current master.
      * This method returns <i>true</i> if replication is disabled or if
      * we're the current elected master.
@@ -859,6 +888,9 @@ namespace Hyperspace {
     gInt32tPtr m_max_unused_logs;
     gInt32tPtr m_log_gc_interval;
     std::chrono::steady_clock::time_point m_last_log_gc_time;
+
+    /// Group commit object (null if disabled)
+    std::unique_ptr<GroupCommit> m_group_commit;
   };
 
   /** @} */
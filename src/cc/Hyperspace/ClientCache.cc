@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Definitions for ClientCache.
+/// This file contains type definitions for ClientCache, a lease-bounded
+/// cache of %Hyperspace attribute values, existence checks and directory
+/// listings maintained by Session.
+
+#include <Common/Compat.h>
+
+#include "ClientCache.h"
+
+using namespace Hyperspace;
+using namespace std;
+
+namespace {
+
+  /// Builds the map key for an entry.
+  string make_key(const string &name, char kind, const string &attr) {
+    string key;
+    key.reserve(name.length() + attr.length() + 2);
+    key.append(name);
+    key.push_back('\0');
+    key.push_back(kind);
+    key.append(attr);
+    return key;
+  }
+
+}
+
+bool ClientCache::lookup(const string &name, Kind kind, const string &attr,
+                         string &value) {
+  lock_guard<mutex> lock(m_mutex);
+  auto iter = m_entries.find(make_key(name, kind, attr));
+  if (iter != m_entries.end()) {
+    if (iter->second.first > chrono::steady_clock::now()) {
+      value = iter->second.second;
+      m_stats.hits++;
+      return true;
+    }
+    m_entries.erase(iter);
+  }
+  m_stats.misses++;
+  return false;
+}
+
+void ClientCache::insert(uint64_t generation, const string &name, Kind kind,
+                         const string &attr, const void *data, size_t len) {
+  lock_guard<mutex> lock(m_mutex);
+  if (generation != m_generation)
+    return;
+  auto now = chrono::steady_clock::now();
+  if (m_entries.size() >= m_max_entries) {
+    purge(now);
+    if (m_entries.size() >= m_max_entries)
+      return;
+  }
+  auto &entry = m_entries[make_key(name, kind, attr)];
+  entry.first = now + m_lease;
+  entry.second.assign((const char *)data, len);
+}
+
+void ClientCache::invalidate_attr(const string &name, const string &attr) {
+  lock_guard<mutex> lock(m_mutex);
+  m_generation++;
+  m_stats.invalidations++;
+  m_entries.erase(make_key(name, ATTR, attr));
+  erase_ancestor_listings(name);
+}
+
+void ClientCache::invalidate_node(const string &name) {
+  lock_guard<mutex> lock(m_mutex);
+  m_generation++;
+  m_stats.invalidations++;
+  if (name == "/") {
+    m_entries.clear();
+    return;
+  }
+  erase_prefix(name + '\0');
+  erase_prefix(name + '/');
+  erase_ancestor_listings(name);
+}
+
+void ClientCache::clear() {
+  lock_guard<mutex> lock(m_mutex);
+  m_generation++;
+  m_stats.invalidations++;
+  m_entries.clear();
+}
+
+void ClientCache::get_statistics(Statistics *stats) {
+  lock_guard<mutex> lock(m_mutex);
+  *stats = m_stats;
+  stats->entries = m_entries.size();
+}
+
+void ClientCache::erase_prefix(const string &prefix) {
+  auto iter = m_entries.lower_bound(prefix);
+  while (iter != m_entries.end() &&
+         iter->first.compare(0, prefix.length(), prefix) == 0)
+    iter = m_entries.erase(iter);
+}
+
+void ClientCache::erase_ancestor_listings(const string &name) {
+  size_t slash = name.rfind('/');
+  while (slash != string::npos) {
+    string parent = slash == 0 ? string("/") : name.substr(0, slash);
+    erase_prefix(make_key(parent, LISTING, ""));
+    erase_prefix(make_key(parent, LISTING_RECURSIVE, ""));
+    if (slash == 0)
+      break;
+    slash = name.rfind('/', slash - 1);
+  }
+}
+
+void ClientCache::purge(chrono::steady_clock::time_point now) {
+  for (auto iter = m_entries.begin(); iter != m_entries.end(); ) {
+    if (iter->second.first <= now)
+      iter = m_entries.erase(iter);
+    else
+      ++iter;
+  }
+}
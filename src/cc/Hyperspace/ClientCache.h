@@ -0,0 +1,184 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Declarations for ClientCache.
+/// This file contains type declarations for ClientCache, a lease-bounded
+/// cache of %Hyperspace attribute values, existence checks and directory
+/// listings maintained by Session.
+
+#ifndef Hyperspace_ClientCache_h
+#define Hyperspace_ClientCache_h
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace Hyperspace {
+
+  /// @addtogroup Hyperspace
+  /// @{
+
+  /// Client-side cache of %Hyperspace read results.
+  /// Entries are keyed by normalized node name, entry kind and attribute
+  /// name, and hold the raw result bytes.  Each entry is valid for a lease
+  /// period after which it is treated as a miss, which bounds how stale a
+  /// cached read can be for nodes that the application does not watch.
+  /// Entries are invalidated eagerly by Session when it issues a mutation
+  /// and when the %Master delivers an ATTR_SET, ATTR_DEL, CHILD_NODE_ADDED or
+  /// CHILD_NODE_REMOVED notification on an open handle.  To avoid caching a
+  /// result that raced with an invalidation, callers obtain the generation
+  /// with generation() before issuing a request and pass it to insert(),
+  /// which drops the result if any invalidation happened in between.
+  class ClientCache {
+  public:
+
+    /// Kind of cached result
+    enum Kind {
+      /// Value of an extended attribute
+      ATTR = 'a',
+      /// Result of an existence check
+      EXISTS = 'e',
+      /// Encoded readdir_attr listing
+      LISTING = 'l',
+      /// Encoded readdir_attr listing including sub entries
+      LISTING_RECURSIVE = 'r'
+    };
+
+    /// Cache statistics.
+    struct Statistics {
+      /// Number of lookups satisfied from the cache
+      uint64_t hits {};
+      /// Number of lookups not satisfied from the cache
+      uint64_t misses {};
+      /// Number of invalidations
+      uint64_t invalidations {};
+      /// Number of entries currently cached
+      size_t entries {};
+    };
+
+    /// Constructor.
+    /// @param lease_millis Lease period of each entry in milliseconds
+    /// @param max_entries Maximum number of entries to cache
+    ClientCache(int32_t lease_millis, size_t max_entries)
+      : m_lease(lease_millis), m_max_entries(max_entries) { }
+
+    /// Returns current invalidation generation.
+    /// @return Current invalidation generation
+    uint64_t generation() {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      return m_generation;
+    }
+
+    /// Looks up a cached result.
+    /// @param name Normalized node name
+    /// @param kind Kind of result
+    /// @param attr Attribute name (empty for EXISTS)
+    /// @param value Output string to hold cached result bytes
+    /// @return <i>true</i> if an unexpired entry was found, <i>false</i>
+    /// otherwise
+    bool lookup(const std::string &name, Kind kind, const std::string &attr,
+                std::string &value);
+
+    /// Inserts a result.
+    /// The result is dropped if an invalidation has happened since
+    /// <code>generation</code> was obtained.
+    /// @param generation Generation returned by generation() before the
+    /// request was issued
+    /// @param name Normalized node name
+    /// @param kind Kind of result
+    /// @param attr Attribute name (empty for EXISTS)
+    /// @param data Result bytes
+    /// @param len Length of result
+    void insert(uint64_t generation, const std::string &name, Kind kind,
+                const std::string &attr, const void *data, size_t len);
+
+    /// Invalidates a cached attribute value.
+    /// Drops the ATTR entry for <code>attr</code> of node <code>name</code>
+    /// and all listings of its ancestor directories, since listings carry
+    /// attribute values.
+    /// @param name Normalized node name
+    /// @param attr Attribute name
+    void invalidate_attr(const std::string &name, const std::string &attr);
+
+    /// Invalidates everything cached about a node.
+    /// Drops all entries of node <code>name</code>, of its descendants, and
+    /// all listings of its ancestor directories.  Used when a node is
+    /// created or removed.
+    /// @param name Normalized node name
+    void invalidate_node(const std::string &name);
+
+    /// Drops all entries.
+    void clear();
+
+    /// Fetches cache statistics.
+    /// @param stats Address of statistics structure to fill in
+    void get_statistics(Statistics *stats);
+
+  private:
+
+    typedef std::map<std::string, std::pair<std::chrono::steady_clock::time_point, std::string>> EntryMap;
+
+    /// Erases all entries whose key starts with <code>prefix</code>.
+    /// @param prefix Key prefix
+    /// @warning Must be called with #m_mutex locked
+    void erase_prefix(const std::string &prefix);
+
+    /// Erases listings of all ancestor directories of <code>name</code>.
+    /// @param name Normalized node name
+    /// @warning Must be called with #m_mutex locked
+    void erase_ancestor_listings(const std::string &name);
+
+    /// Erases expired entries.
+    /// @param now Current time
+    /// @warning Must be called with #m_mutex locked
+    void purge(std::chrono::steady_clock::time_point now);
+
+    /// %Mutex serializing access to members
+    std::mutex m_mutex;
+
+    /// Lease period of each entry
+    std::chrono::milliseconds m_lease;
+
+    /// Maximum number of entries
+    size_t m_max_entries {};
+
+    /// Map from encoded key to expiration time and result bytes
+    EntryMap m_entries;
+
+    /// Invalidation generation
+    uint64_t m_generation {};
+
+    /// Cache statistics
+    Statistics m_stats;
+  };
+
+  /// Smart pointer to ClientCache
+  typedef std::unique_ptr<ClientCache> ClientCachePtr;
+
+  /// @}
+}
+
+#endif // Hyperspace_ClientCache_h
@@ -275,6 +275,8 @@ void ClientKeepaliveHandler::handle(Hypertable::EventPtr &event) {
                 event_mask == EVENT_MASK_CHILD_NODE_REMOVED) {
               name = decode_vstr(&decode_ptr, &decode_remain);
 
+              m_session->invalidate_cache(handle_state->normal_name, event_mask, name);
+
               if (!m_delivered_events.insert(event_id).second)
                 continue;
 
@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Definitions for CompoundRequest.
+/// This file contains type definitions for CompoundRequest, a builder for an
+/// ordered list of %Hyperspace operations that the %Master executes in a
+/// single transaction.
+
+#include <Common/Compat.h>
+
+#include "CompoundRequest.h"
+
+#include <Common/Error.h>
+#include <Common/Serialization.h>
+
+using namespace Hyperspace;
+using namespace Hypertable;
+using namespace Hypertable::Serialization;
+using namespace std;
+
+namespace {
+
+  void add_attributes(CompoundRequest::Operation &op,
+                      const vector<Attribute> &attrs) {
+    op.attrs.reserve(attrs.size());
+    for (const auto &attr : attrs)
+      op.attrs.emplace_back(attr.name, string((const char *)attr.value,
+                                              attr.value_len));
+  }
+
+}
+
+CompoundRequest &CompoundRequest::mkdir(const string &name,
+                                        const vector<Attribute> &init_attrs) {
+  add_attributes(add(OP_MKDIR, name), init_attrs);
+  return *this;
+}
+
+CompoundRequest &CompoundRequest::mkdirs(const string &name,
+                                         const vector<Attribute> &init_attrs) {
+  add_attributes(add(OP_MKDIRS, name), init_attrs);
+  return *this;
+}
+
+CompoundRequest &CompoundRequest::unlink(const string &name, uint32_t flags) {
+  add(OP_UNLINK, name, flags);
+  return *this;
+}
+
+CompoundRequest &CompoundRequest::exists(const string &name) {
+  add(OP_EXISTS, name);
+  return *this;
+}
+
+CompoundRequest &CompoundRequest::open(const string &name, uint32_t open_flags,
+                                       const vector<Attribute> &init_attrs) {
+  Operation &op = add(OP_OPEN, name);
+  op.open_flags = open_flags;
+  add_attributes(op, init_attrs);
+  return *this;
+}
+
+CompoundRequest &CompoundRequest::attr_set(const string &name, const string &attr,
+                                           const void *value, size_t value_len) {
+  add(OP_ATTR_SET, name).attrs.emplace_back(attr, string((const char *)value,
+                                                         value_len));
+  return *this;
+}
+
+CompoundRequest &CompoundRequest::attr_set(const string &name,
+                                           const vector<Attribute> &attrs) {
+  add_attributes(add(OP_ATTR_SET, name), attrs);
+  return *this;
+}
+
+CompoundRequest &CompoundRequest::attr_get(const string &name, const string &attr,
+                                           uint32_t flags) {
+  add(OP_ATTR_GET, name, flags).attr = attr;
+  return *this;
+}
+
+CompoundRequest &CompoundRequest::attr_del(const string &name, const string &attr,
+                                           uint32_t flags) {
+  add(OP_ATTR_DEL, name, flags).attr = attr;
+  return *this;
+}
+
+CompoundRequest &CompoundRequest::attr_exists(const string &name,
+                                              const string &attr) {
+  add(OP_ATTR_EXISTS, name).attr = attr;
+  return *this;
+}
+
+CompoundRequest &CompoundRequest::attr_incr(const string &name,
+                                            const string &attr) {
+  add(OP_ATTR_INCR, name).attr = attr;
+  return *this;
+}
+
+const char *CompoundRequest::code_to_string(uint8_t code) {
+  switch (code) {
+  case OP_MKDIR:       return "mkdir";
+  case OP_MKDIRS:      return "mkdirs";
+  case OP_UNLINK:      return "unlink";
+  case OP_EXISTS:      return "exists";
+  case OP_OPEN:        return "open";
+  case OP_ATTR_SET:    return "attr_set";
+  case OP_ATTR_GET:    return "attr_get";
+  case OP_ATTR_DEL:    return "attr_del";
+  case OP_ATTR_EXISTS: return "attr_exists";
+  case OP_ATTR_INCR:   return "attr_incr";
+  default:
+    break;
+  }
+  return "unknown";
+}
+
+size_t CompoundRequest::encoded_length() const {
+  size_t length = 4;
+  for (const auto &op : m_operations) {
+    length += 1 + 4 + 4 + encoded_length_vstr(op.name) +
+      encoded_length_vstr(op.attr) + 4;
+    for (const auto &attr : op.attrs)
+      length += encoded_length_vstr(attr.first) +
+        encoded_length_vstr(attr.second.length());
+  }
+  return length;
+}
+
+void CompoundRequest::encode(uint8_t **bufp) const {
+  encode_i32(bufp, m_operations.size());
+  for (const auto &op : m_operations) {
+    encode_i8(bufp, op.code);
+    encode_i32(bufp, op.flags);
+    encode_i32(bufp, op.open_flags);
+    encode_vstr(bufp, op.name);
+    encode_vstr(bufp, op.attr);
+    encode_i32(bufp, op.attrs.size());
+    for (const auto &attr : op.attrs) {
+      encode_vstr(bufp, attr.first);
+      encode_vstr(bufp, attr.second.data(), attr.second.length());
+    }
+  }
+}
+
+namespace {
+  /// Smallest encoding of an operation (code, flags, open flags, empty name
+  /// and attribute, attribute count)
+  const size_t MIN_OPERATION_LENGTH = 1 + 4 + 4 + 2 + 2 + 4;
+  /// Smallest encoding of an attribute (empty name and value)
+  const size_t MIN_ATTRIBUTE_LENGTH = 2 + 2;
+}
+
+void CompoundRequest::decode(const uint8_t **bufp, size_t *remainp) {
+  size_t count = decode_i32(bufp, remainp);
+  // Bound the count by the bytes remaining before allocating for it
+  if (count > *remainp / MIN_OPERATION_LENGTH)
+    HT_THROWF(Error::PROTOCOL_ERROR, "Compound operation count %u exceeds "
+              "the %u bytes remaining", (unsigned)count, (unsigned)*remainp);
+  m_operations.clear();
+  m_operations.reserve(count);
+  for (size_t i=0; i<count; i++) {
+    Operation op;
+    op.code = decode_i8(bufp, remainp);
+    op.flags = decode_i32(bufp, remainp);
+    op.open_flags = decode_i32(bufp, remainp);
+    op.name = decode_vstr(bufp, remainp);
+    op.attr = decode_vstr(bufp, remainp);
+    size_t attr_count = decode_i32(bufp, remainp);
+    if (attr_count > *remainp / MIN_ATTRIBUTE_LENGTH)
+      HT_THROWF(Error::PROTOCOL_ERROR, "Compound attribute count %u exceeds "
+                "the %u bytes remaining", (unsigned)attr_count,
+                (unsigned)*remainp);
+    op.attrs.reserve(attr_count);
+    for (size_t j=0; j<attr_count; j++) {
+      string attr_name = decode_vstr(bufp, remainp);
+      uint32_t value_len;
+      const char *value = decode_vstr(bufp, remainp, &value_len);
+      op.attrs.emplace_back(attr_name, string(value, value_len));
+    }
+    m_operations.push_back(op);
+  }
+  m_results.clear();
+  m_results.resize(count);
+}
+
+size_t CompoundRequest::encoded_length_results() const {
+  size_t length = 4;
+  for (const auto &result : m_results)
+    length += 4 + 1 + 8 + encoded_length_bytes32(result.data.length());
+  return length;
+}
+
+void CompoundRequest::encode_results(uint8_t **bufp) const {
+  encode_i32(bufp, m_results.size());
+  for (const auto &result : m_results) {
+    encode_i32(bufp, result.error);
+    encode_bool(bufp, result.flag);
+    encode_i64(bufp, result.value);
+    encode_bytes32(bufp, result.data.data(), result.data.length());
+  }
+}
+
+void CompoundRequest::decode_results(const uint8_t **bufp, size_t *remainp) {
+  size_t count = decode_i32(bufp, remainp);
+  if (count != m_operations.size())
+    HT_THROWF(Error::PROTOCOL_ERROR, "Compound result count %u does not match "
+              "operation count %u", (unsigned)count,
+              (unsigned)m_operations.size());
+  for (auto &result : m_results) {
+    result.error = decode_i32(bufp, remainp);
+    result.flag = decode_bool(bufp, remainp);
+    result.value = decode_i64(bufp, remainp);
+    uint32_t data_len;
+    uint8_t *data = decode_bytes32(bufp, remainp, &data_len);
+    result.data.assign((const char *)data, data_len);
+  }
+}
+
+CompoundRequest::Operation &
+CompoundRequest::add(uint8_t code, const string &name, uint32_t flags) {
+  m_operations.emplace_back();
+  m_results.emplace_back();
+  Operation &op = m_operations.back();
+  op.code = code;
+  op.name = name;
+  op.flags = flags;
+  return op;
+}
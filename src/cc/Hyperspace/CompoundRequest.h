@@ -0,0 +1,279 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Declarations for CompoundRequest.
+/// This file contains type declarations for CompoundRequest, a builder for an
+/// ordered list of %Hyperspace operations that the %Master executes in a
+/// single transaction.
+
+#ifndef Hyperspace_CompoundRequest_h
+#define Hyperspace_CompoundRequest_h
+
+#include <Hyperspace/Protocol.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Hyperspace {
+
+  /// @addtogroup Hyperspace
+  /// @{
+
+  /// Ordered list of %Hyperspace operations executed in one transaction.
+  /// Operations are appended with the builder methods and the request is
+  /// sent with Session::execute().  The %Master runs the operations in order
+  /// inside a single BerkeleyDB transaction; if any operation fails, the
+  /// transaction is aborted, none of the operations take effect and
+  /// Session::execute() throws an exception carrying the error of the failing
+  /// operation.  Operations flagged with FLAG_IGNORE_NOT_FOUND that fail
+  /// because the node or attribute does not exist are skipped instead, with
+  /// the error recorded in their result.
+  ///
+  /// An operation given an empty node name applies to the handle opened by
+  /// the most recent open() in the same request.  Handles opened by a
+  /// compound request are closed when the request completes.
+  ///
+  /// Results are available through result() after Session::execute()
+  /// returns, indexed by the order in which operations were added.
+  class CompoundRequest {
+  public:
+
+    /// Operation codes
+    enum Code {
+      OP_MKDIR = 1,
+      OP_MKDIRS = 2,
+      OP_UNLINK = 3,
+      OP_EXISTS = 4,
+      OP_OPEN = 5,
+      OP_ATTR_SET = 6,
+      OP_ATTR_GET = 7,
+      OP_ATTR_DEL = 8,
+      OP_ATTR_EXISTS = 9,
+      OP_ATTR_INCR = 10
+    };
+
+    /// Operation flags
+    enum Flags {
+      /// Skip operation if node or attribute does not exist
+      FLAG_IGNORE_NOT_FOUND = 0x0001
+    };
+
+    /// Single operation.
+    struct Operation {
+      /// Operation code
+      uint8_t code {};
+      /// Operation flags
+      uint32_t flags {};
+      /// Open flags (OP_OPEN)
+      uint32_t open_flags {};
+      /// Node name (empty means handle of preceding open)
+      std::string name;
+      /// %Attribute name (single attribute operations)
+      std::string attr;
+      /// %Attribute name/value pairs (OP_ATTR_SET and initial attributes)
+      std::vector<std::pair<std::string, std::string>> attrs;
+    };
+
+    /// Result of a single operation.
+    struct Result {
+      /// Error code (non-zero only for skipped operations)
+      int32_t error {};
+      /// Existence flag (OP_EXISTS, OP_ATTR_EXISTS) or created flag (OP_OPEN)
+      bool flag {};
+      /// Value of attribute before increment (OP_ATTR_INCR) or lock
+      /// generation (OP_OPEN)
+      uint64_t value {};
+      /// %Attribute value (OP_ATTR_GET)
+      std::string data;
+    };
+
+    /// Appends a mkdir operation.
+    /// @param name Directory name
+    /// @param init_attrs Initial attributes
+    /// @return Reference to this request
+    CompoundRequest &mkdir(const std::string &name,
+                           const std::vector<Attribute> &init_attrs = {});
+
+    /// Appends a mkdirs operation, creating missing parent directories.
+    /// @param name Directory name
+    /// @param init_attrs Initial attributes of <code>name</code>
+    /// @return Reference to this request
+    CompoundRequest &mkdirs(const std::string &name,
+                            const std::vector<Attribute> &init_attrs = {});
+
+    /// Appends an unlink operation.
+    /// @param name File or directory name
+    /// @param flags Operation flags
+    /// @return Reference to this request
+    CompoundRequest &unlink(const std::string &name, uint32_t flags = 0);
+
+    /// Appends an exists operation.
+    /// @param name File or directory name
+    /// @return Reference to this request
+    CompoundRequest &exists(const std::string &name);
+
+    /// Appends an open operation.
+    /// Subsequent operations with an empty name apply to the opened handle.
+    /// @param name File name
+    /// @param open_flags Open flags (see Hyperspace::OpenFlags)
+    /// @param init_attrs Initial attributes (requires OPEN_FLAG_CREATE)
+    /// @return Reference to this request
+    CompoundRequest &open(const std::string &name, uint32_t open_flags,
+                          const std::vector<Attribute> &init_attrs = {});
+
+    /// Appends an attr_set operation for a single attribute.
+    /// @param name Node name, or empty for handle of preceding open
+    /// @param attr %Attribute name
+    /// @param value %Attribute value
+    /// @param value_len Length of value
+    /// @return Reference to this request
+    CompoundRequest &attr_set(const std::string &name, const std::string &attr,
+                              const void *value, size_t value_len);
+
+    /// Appends an attr_set operation for several attributes.
+    /// @param name Node name, or empty for handle of preceding open
+    /// @param attrs Attributes to set
+    /// @return Reference to this request
+    CompoundRequest &attr_set(const std::string &name,
+                              const std::vector<Attribute> &attrs);
+
+    /// Appends an attr_get operation.
+    /// @param name Node name, or empty for handle of preceding open
+    /// @param attr %Attribute name
+    /// @param flags Operation flags
+    /// @return Reference to this request
+    CompoundRequest &attr_get(const std::string &name, const std::string &attr,
+                              uint32_t flags = 0);
+
+    /// Appends an attr_del operation.
+    /// @param name Node name, or empty for handle of preceding open
+    /// @param attr %Attribute name
+    /// @param flags Operation flags
+    /// @return Reference to this request
+    CompoundRequest &attr_del(const std::string &name, const std::string &attr,
+                              uint32_t flags = 0);
+
+    /// Appends an attr_exists operation.
+    /// @param name Node name, or empty for handle of preceding open
+    /// @param attr %Attribute name
+    /// @return Reference to this request
+    CompoundRequest &attr_exists(const std::string &name, const std::string &attr);
+
+    /// Appends an attr_incr operation.
+    /// @param name Node name, or empty for handle of preceding open
+    /// @param attr %Attribute name
+    /// @return Reference to this request
+    CompoundRequest &attr_incr(const std::string &name, const std::string &attr);
+
+    /// Returns number of operations.
+    /// @return Number of operations
+    size_t size() const { return m_operations.size(); }
+
+    /// Checks if request has no operations.
+    /// @return <i>true</i> if request is empty, <i>false</i> otherwise
+    bool empty() const { return m_operations.empty(); }
+
+    /// Returns an operation.
+    /// @param i Operation index
+    /// @return Reference to operation <code>i</code>
+    const Operation &operation(size_t i) const { return m_operations[i]; }
+
+    /// Returns mutable operation.
+    /// @param i Operation index
+    /// @return Reference to operation <code>i</code>
+    Operation &operation(size_t i) { return m_operations[i]; }
+
+    /// Returns result of an operation.
+    /// @param i Operation index
+    /// @return Reference to result of operation <code>i</code>
+    const Result &result(size_t i) const { return m_results[i]; }
+
+    /// Returns mutable result of an operation.
+    /// @param i Operation index
+    /// @return Reference to result of operation <code>i</code>
+    Result &result(size_t i) { return m_results[i]; }
+
+    /// Checks if operation requires a node name.
+    /// Operations that create, remove or open nodes cannot be applied to the
+    /// handle of a preceding open.
+    /// @param code Operation code
+    /// @return <i>true</i> if operation requires a name, <i>false</i>
+    /// otherwise
+    static bool requires_name(uint8_t code) {
+      return code == OP_MKDIR || code == OP_MKDIRS || code == OP_UNLINK ||
+        code == OP_EXISTS || code == OP_OPEN;
+    }
+
+    /// Returns printable name of an operation code.
+    /// @param code Operation code
+    /// @return Operation name
+    static const char *code_to_string(uint8_t code);
+
+    /// Returns serialized length of operations.
+    /// @return Serialized length of operations
+    size_t encoded_length() const;
+
+    /// Serializes operations.
+    /// @param bufp Address of destination buffer pointer (advanced by call)
+    void encode(uint8_t **bufp) const;
+
+    /// Deserializes operations.
+    /// @param bufp Address of source buffer pointer (advanced by call)
+    /// @param remainp Address of integer holding amount of remaining buffer
+    void decode(const uint8_t **bufp, size_t *remainp);
+
+    /// Returns serialized length of results.
+    /// @return Serialized length of results
+    size_t encoded_length_results() const;
+
+    /// Serializes results.
+    /// @param bufp Address of destination buffer pointer (advanced by call)
+    void encode_results(uint8_t **bufp) const;
+
+    /// Deserializes results.
+    /// @param bufp Address of source buffer pointer (advanced by call)
+    /// @param remainp Address of integer holding amount of remaining buffer
+    void decode_results(const uint8_t **bufp, size_t *remainp);
+
+  private:
+
+    /// Appends an operation.
+    /// @param code Operation code
+    /// @param name Node name
+    /// @param flags Operation flags
+    /// @return Reference to new operation
+    Operation &add(uint8_t code, const std::string &name, uint32_t flags = 0);
+
+    /// Operations
+    std::vector<Operation> m_operations;
+
+    /// Results (one per operation)
+    std::vector<Result> m_results;
+  };
+
+  /// @}
+}
+
+#endif // Hyperspace_CompoundRequest_h
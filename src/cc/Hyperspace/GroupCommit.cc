@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Definitions for GroupCommit.
+/// This file contains type definitions for GroupCommit, a class that batches
+/// the log flushes of concurrently committing BerkeleyDB transactions.
+
+#include <Common/Compat.h>
+
+#include "GroupCommit.h"
+
+#include <Common/Error.h>
+#include <Common/Logger.h>
+#include <Common/String.h>
+
+#include <algorithm>
+
+using namespace Hyperspace;
+using namespace Hypertable;
+using namespace std;
+
+GroupCommit::GroupCommit(PropertiesPtr &props, DbEnv *env)
+  : GroupCommit(props, [env]() { env->log_flush(NULL); }) {
+}
+
+GroupCommit::GroupCommit(PropertiesPtr &props, FlushFunction flush)
+  : m_flush(flush) {
+  m_window = props->get_ptr<gInt32t>("Hyperspace.GroupCommit.Window");
+  m_max_batch = props->get_ptr<gInt32t>("Hyperspace.GroupCommit.MaxBatch");
+}
+
+void GroupCommit::sync() {
+  auto start = chrono::steady_clock::now();
+  unique_lock<mutex> lock(m_mutex);
+  uint64_t ticket = ++m_requested;
+
+  // Let a waiting leader know the batch has grown
+  if (m_flushing)
+    m_cond.notify_all();
+
+  while (m_flushed < ticket) {
+
+    if (ticket <= m_failed)
+      HT_THROWF(Error::HYPERSPACE_BERKELEYDB_ERROR,
+                "Error flushing BerkeleyDb log: %s", m_error.c_str());
+
+    if (m_flushing) {
+      m_cond.wait(lock);
+      continue;
+    }
+
+    // Become the leader for the next flush
+    m_flushing = true;
+    uint64_t max_batch = (uint64_t)std::max(m_max_batch->get(), 1);
+    auto deadline = chrono::steady_clock::now() +
+      chrono::milliseconds(std::max(m_window->get(), 0));
+    while (m_requested - m_flushed < max_batch &&
+           m_cond.wait_until(lock, deadline) != cv_status::timeout)
+      ;
+    uint64_t target = m_requested;
+
+    lock.unlock();
+    auto flush_start = chrono::steady_clock::now();
+    bool failed = false;
+    string error;
+    try {
+      m_flush();
+    }
+    catch (DbException &e) {
+      failed = true;
+      error = e.what();
+      HT_ERROR_OUT << "Error flushing BerkeleyDb log: " << error << HT_END;
+    }
+    auto flush_end = chrono::steady_clock::now();
+    lock.lock();
+
+    if (failed) {
+      m_stats.failed_flushes++;
+      m_failed = target;
+      m_error = error;
+      m_flushing = false;
+      m_cond.notify_all();
+      continue;
+    }
+
+    m_stats.flushes++;
+    m_stats.max_batch = std::max(m_stats.max_batch, target - m_flushed);
+    m_stats.flush_us +=
+      chrono::duration_cast<chrono::microseconds>(flush_end - flush_start).count();
+    m_flushed = target;
+    m_flushing = false;
+    m_cond.notify_all();
+  }
+
+  uint64_t latency = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+  m_stats.commits++;
+  m_stats.commit_latency_us += latency;
+  m_stats.max_commit_latency_us = std::max(m_stats.max_commit_latency_us, latency);
+}
+
+void GroupCommit::get_statistics(Statistics *stats) {
+  lock_guard<mutex> lock(m_mutex);
+  *stats = m_stats;
+}
+
+string GroupCommit::format_statistics() {
+  Statistics stats;
+  get_statistics(&stats);
+  if (stats.flushes == 0)
+    return "group commit idle";
+  return format("group commit: %llu commits in %llu flushes (avg batch %.1f, "
+                "max %llu), commit latency avg %.2fms max %.2fms, "
+                "flush avg %.2fms", (Llu)stats.commits, (Llu)stats.flushes,
+                (double)stats.commits / stats.flushes, (Llu)stats.max_batch,
+                stats.commits ? (double)stats.commit_latency_us / stats.commits / 1000.0 : 0.0,
+                (double)stats.max_commit_latency_us / 1000.0,
+                (double)stats.flush_us / stats.flushes / 1000.0);
+}
@@ -0,0 +1,154 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Declarations for GroupCommit.
+/// This file contains type declarations for GroupCommit, a class that batches
+/// the log flushes of concurrently committing BerkeleyDB transactions.
+
+#ifndef Hyperspace_GroupCommit_h
+#define Hyperspace_GroupCommit_h
+
+#include <Common/Properties.h>
+
+#include <db_cxx.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace Hyperspace {
+
+  using namespace Hypertable;
+
+  /// @addtogroup Hyperspace
+  /// @{
+
+  /// Group commit for BerkeleyDB transactions.
+  /// Transactions are committed with <code>DB_TXN_NOSYNC</code>, which
+  /// releases their locks and appends the commit record to the in-memory log
+  /// buffer, and then call sync() which returns only after the log has been
+  /// flushed to stable storage.  The first waiting caller becomes the leader:
+  /// it waits up to <code>Hyperspace.GroupCommit.Window</code> milliseconds,
+  /// or until <code>Hyperspace.GroupCommit.MaxBatch</code> callers are
+  /// waiting, and then issues a single <code>DbEnv::log_flush()</code> that
+  /// makes every commit record written so far durable.  Callers that arrive
+  /// while a flush is in progress wait for the next one.
+  /// Since <code>DB_TXN_NOSYNC</code> releases the transaction's locks before
+  /// the flush, other transactions can read committed state that is not yet
+  /// durable.  Only the committing request is held back until sync() returns,
+  /// which is why group commit is disabled by default.
+  class GroupCommit {
+  public:
+
+    /// Group commit statistics.
+    struct Statistics {
+      /// Number of commits synced
+      uint64_t commits {};
+      /// Number of log flushes
+      uint64_t flushes {};
+      /// Largest number of commits covered by one flush
+      uint64_t max_batch {};
+      /// Total commit latency (time spent in sync()) in microseconds
+      uint64_t commit_latency_us {};
+      /// Largest commit latency in microseconds
+      uint64_t max_commit_latency_us {};
+      /// Total log flush time in microseconds
+      uint64_t flush_us {};
+      /// Number of failed log flushes
+      uint64_t failed_flushes {};
+    };
+
+    /// Log flush function, throws DbException on failure
+    typedef std::function<void()> FlushFunction;
+
+    /// Constructor.
+    /// Flushes the log with <code>DbEnv::log_flush()</code>.
+    /// @param props %Properties object
+    /// @param env BerkeleyDB environment
+    GroupCommit(PropertiesPtr &props, DbEnv *env);
+
+    /// Constructor.
+    /// @param props %Properties object
+    /// @param flush Function called to flush the log
+    GroupCommit(PropertiesPtr &props, FlushFunction flush);
+
+    /// Waits for the log to be flushed past the caller's commit record.
+    /// Must be called after the caller's transaction has been committed with
+    /// <code>DB_TXN_NOSYNC</code>.  If the flush covering the caller's commit
+    /// fails, every caller in that batch gets the error and the next caller
+    /// starts a new flush.
+    /// @throws Exception with code Error::HYPERSPACE_BERKELEYDB_ERROR if the
+    /// log flush failed
+    void sync();
+
+    /// Fetches cumulative statistics.
+    /// @param stats Address of statistics structure to fill in
+    void get_statistics(Statistics *stats);
+
+    /// Formats statistics for the %Hyperspace status text.
+    /// @return Human-readable summary of batch size and commit latency
+    std::string format_statistics();
+
+  private:
+
+    /// Log flush function
+    FlushFunction m_flush;
+
+    /// Maximum time (milliseconds) a leader waits for more commits
+    gInt32tPtr m_window;
+
+    /// Maximum number of commits per flush
+    gInt32tPtr m_max_batch;
+
+    /// %Mutex serializing access to members
+    std::mutex m_mutex;
+
+    /// Signals flush completion and batch growth
+    std::condition_variable m_cond;
+
+    /// Number of commits that have called sync()
+    uint64_t m_requested {};
+
+    /// Number of commits made durable
+    uint64_t m_flushed {};
+
+    /// Highest commit covered by a failed flush
+    uint64_t m_failed {};
+
+    /// Error message of the last failed flush
+    std::string m_error;
+
+    /// Flag indicating if a leader is waiting for or running a flush
+    bool m_flushing {};
+
+    /// Cumulative statistics
+    Statistics m_stats;
+  };
+
+  /// @}
+}
+
+#endif // Hyperspace_GroupCommit_h
@@ -523,38 +523,13 @@ Hyperspace::Master::mkdir(ResponseCallback *cb, uint64_t session_id, const char
 
 void
 Hyperspace::Master::mkdirs(ResponseCallback *cb, uint64_t session_id, const char *name, const std::vector<Attribute>& init_attrs) {
-  std::vector<EventContext> evts;
   bool commited = false;
   m_metrics_handler->request_increment();
   CommandContext ctx("mkdirs", session_id);
   HT_BDBTXN_BEGIN() {
     commited = false;
     ctx.reset(&txn);
-    bool file_exists;
-    exists(ctx, name, file_exists);
-    if (!ctx.aborted && !file_exists) {
-      typedef boost::tokenizer<boost::char_separator<char> > tokenizer;
-      boost::char_separator<char> sep("/");
-      std::vector<String> name_components;
-      String path(name);
-      tokenizer tokens(path, sep);
-      for (tokenizer::iterator tok_iter = tokens.begin();
-            tok_iter != tokens.end(); ++tok_iter)
-        name_components.push_back(*tok_iter);
-
-      path.clear();
-      for (size_t i=0; i<name_components.size(); i++) {
-        path += String("/") + name_components[i];
-        mkdir(ctx, path.c_str());
-        if (ctx.aborted && ctx.error != Error::HYPERSPACE_FILE_EXISTS)
-          break;
-        if (init_attrs.size() && !ctx.aborted &&
-            i == name_components.size() - 1)
-          attr_set(ctx, 0, name, init_attrs);
-        ctx.reset_error();
-      }
-    }
-
+    mkdirs(ctx, name, init_attrs);
     if (ctx.aborted)
       txn.abort();
     else {
@@ -928,7 +903,7 @@ Hyperspace::Master::attr_del(ResponseCallback *cb, uint64_t session_id, uint64_t
   HT_BDBTXN_BEGIN() {
     commited = false;
     ctx.reset(&txn);
-    attr_del(ctx, handle, name);
+    attr_del(ctx, handle, 0, name);
     if (ctx.aborted)
       txn.abort();
     else {
@@ -1155,6 +1130,157 @@ Hyperspace::Master::readpath_attr(ResponseCallbackReadpathAttr *cb, uint64_t ses
     HT_ERRORF("Problem sending back response - %s", Error::get_text(ctx.error));
 }
 
+/*
+ * compound does the following:
+ *
+ * > Start BDB txn
+ *   > Execute operations in order, applying operations without a name to
+ *     the handle of the most recent open
+ *   > Skip operations flagged IGNORE_NOT_FOUND whose node or attribute
+ *     does not exist, abort on any other error
+ *   > Close handles opened by the request
+ * > End BDB txn
+ * > Deliver notifications
+ * > Destroy handles opened by the request
+ * > Send operation results back in response
+ */
+void
+Hyperspace::Master::compound(ResponseCallbackCompound *cb, uint64_t session_id,
+                             CompoundRequest &request) {
+  bool commited = false;
+  size_t failed = 0;
+  std::vector<uint64_t> opened_handles;
+  m_metrics_handler->request_increment();
+  CommandContext ctx("compound", session_id);
+  HT_BDBTXN_BEGIN() {
+    commited = false;
+    opened_handles.clear();
+    ctx.reset(&txn);
+    uint64_t handle = 0;
+    for (failed=0; failed<request.size(); failed++) {
+      const CompoundRequest::Operation &op = request.operation(failed);
+      CompoundRequest::Result &result = request.result(failed);
+      result = CompoundRequest::Result();
+      const char *name = op.name.empty() ? 0 : op.name.c_str();
+      std::vector<Attribute> attrs;
+      attrs.reserve(op.attrs.size());
+      for (const auto &attr : op.attrs)
+        attrs.emplace_back(attr.first.c_str(), attr.second.data(),
+                           attr.second.length());
+
+      if (CompoundRequest::requires_name(op.code) && (!name || *name != '/')) {
+        ctx.set_error(Error::HYPERSPACE_BAD_PATHNAME,
+                      (String)"bad name '" + op.name + "'");
+        break;
+      }
+
+      switch (op.code) {
+      case CompoundRequest::OP_MKDIR:
+        mkdir(ctx, name);
+        if (!attrs.empty() && !ctx.aborted)
+          attr_set(ctx, 0, name, attrs);
+        break;
+      case CompoundRequest::OP_MKDIRS:
+        mkdirs(ctx, name, attrs);
+        break;
+      case CompoundRequest::OP_UNLINK:
+        unlink(ctx, name);
+        break;
+      case CompoundRequest::OP_EXISTS:
+        exists(ctx, name, result.flag);
+        break;
+      case CompoundRequest::OP_OPEN:
+        open(ctx, name, op.open_flags, 0, attrs, handle, result.flag,
+             result.value);
+        if (!ctx.aborted)
+          opened_handles.push_back(handle);
+        break;
+      case CompoundRequest::OP_ATTR_SET:
+        attr_set(ctx, handle, name, attrs);
+        break;
+      case CompoundRequest::OP_ATTR_GET:
+        {
+          DynamicBuffer dbuf;
+          attr_get(ctx, handle, name, op.attr.c_str(), dbuf);
+          if (!ctx.aborted)
+            result.data.assign((const char *)dbuf.base, dbuf.fill());
+        }
+        break;
+      case CompoundRequest::OP_ATTR_DEL:
+        attr_del(ctx, handle, name, op.attr.c_str());
+        break;
+      case CompoundRequest::OP_ATTR_EXISTS:
+        attr_exists(ctx, handle, name, op.attr.c_str(), result.flag);
+        break;
+      case CompoundRequest::OP_ATTR_INCR:
+        attr_incr(ctx, handle, name, op.attr.c_str(), result.value);
+        break;
+      default:
+        ctx.set_error(Error::PROTOCOL_ERROR,
+                      format("Unrecognized operation code %d", (int)op.code));
+        break;
+      }
+
+      if (ctx.aborted) {
+        if ((op.flags & CompoundRequest::FLAG_IGNORE_NOT_FOUND) == 0 ||
+            (ctx.error != Error::HYPERSPACE_FILE_NOT_FOUND &&
+             ctx.error != Error::HYPERSPACE_BAD_PATHNAME &&
+             ctx.error != Error::HYPERSPACE_ATTR_NOT_FOUND))
+          break;
+        result.error = ctx.error;
+        ctx.reset_error();
+      }
+    }
+
+    if (!ctx.aborted) {
+      for (auto opened_handle : opened_handles) {
+        close(ctx, opened_handle);
+        if (ctx.aborted)
+          break;
+      }
+    }
+
+    if (ctx.aborted)
+      txn.abort();
+    else {
+      txn.commit();
+      commited = true;
+    }
+  }
+  HT_BDBTXN_END_CB(cb);
+
+  // check for errors
+  if (ctx.aborted) {
+    if (failed < request.size())
+      ctx.error_msg = format("operation %u (%s) - %s", (unsigned)failed,
+                             CompoundRequest::code_to_string(request.operation(failed).code),
+                             ctx.error_msg.c_str());
+    if (ctx.error == Error::HYPERSPACE_FILE_EXISTS ||
+        ctx.error == Error::HYPERSPACE_FILE_NOT_FOUND)
+      HT_INFOF("%s - %s", Error::get_text(ctx.error), ctx.error_msg.c_str());
+    else
+      HT_ERROR_OUT << Error::get_text(ctx.error) << " - " << ctx.error_msg << HT_END;
+    cb->error(ctx.error, ctx.error_msg);
+    return;
+  }
+
+  // deliver notifications
+  if (commited)
+    deliver_event_notifications(ctx);
+
+  // destroy handles opened by the request (release locks, grant next
+  // pending locks, delete ephemerals etc.)
+  for (auto opened_handle : opened_handles) {
+    if (!destroy_handle(opened_handle, ctx.error, ctx.error_msg)) {
+      cb->error(ctx.error, ctx.error_msg);
+      return;
+    }
+  }
+
+  if ((ctx.error = cb->response(request)) != Error::OK)
+    HT_ERRORF("Problem sending back response - %s", Error::get_text(ctx.error));
+}
+
 /*
  * shutdown
  */
@@ -1194,7 +1320,13 @@ void Hyperspace::Master::shutdown(ResponseCallback *cb, uint64_t session_id) {
 
 void Hyperspace::Master::status(ResponseCallbackStatus *cb) {
   HT_INFO("status");
-  cb->response(m_status);
+  Status::Code code;
+  String text;
+  m_status.get(&code, text);
+  if (code == Status::Code::OK && text.empty() && m_bdb_fs)
+    cb->response(Status(code, m_bdb_fs->group_commit_statistics()));
+  else
+    cb->response(m_status);
 }
 
 /*
@@ -1922,6 +2054,37 @@ void Hyperspace::Master::mkdir(CommandContext &ctx, const char *name) {
 
 
 
+void Hyperspace::Master::mkdirs(CommandContext &ctx, const char *name,
+                                const std::vector<Attribute> &init_attrs) {
+  bool file_exists;
+  exists(ctx, name, file_exists);
+  if (ctx.aborted || file_exists)
+    return;
+
+  typedef boost::tokenizer<boost::char_separator<char> > tokenizer;
+  boost::char_separator<char> sep("/");
+  std::vector<String> name_components;
+  String path(name);
+  tokenizer tokens(path, sep);
+  for (tokenizer::iterator tok_iter = tokens.begin();
+       tok_iter != tokens.end(); ++tok_iter)
+    name_components.push_back(*tok_iter);
+
+  path.clear();
+  for (size_t i=0; i<name_components.size(); i++) {
+    path += String("/") + name_components[i];
+    mkdir(ctx, path.c_str());
+    if (ctx.aborted) {
+      if (ctx.error != Error::HYPERSPACE_FILE_EXISTS)
+        return;
+      ctx.reset_error();
+    }
+  }
+
+  if (!init_attrs.empty())
+    attr_set(ctx, 0, name, init_attrs);
+}
+
 void Hyperspace::Master::open(CommandContext &ctx, const char *name,
           uint32_t flags, uint32_t event_mask,
           std::vector<Attribute> &init_attrs, uint64_t& handle,
@@ -2238,17 +2401,28 @@ void Hyperspace::Master::attr_incr(CommandContext &ctx, uint64_t handle,
   }
 }
 
-void Hyperspace::Master::attr_del(CommandContext &ctx, uint64_t handle, const char *name) {
+void Hyperspace::Master::attr_del(CommandContext &ctx, uint64_t handle,
+                                  const char *name, const char *attr) {
   HT_ASSERT(ctx.txn);
   BDbTxn &txn = *ctx.txn;
 
   String node;
-  if (!get_handle_node(ctx, handle, name, node))
+  if (name && *name) {
+    if (!get_named_node(ctx, name, attr, node))
+      return;
+  }
+  else
+    if (!get_handle_node(ctx, handle, attr, node))
+      return;
+
+  if (!m_bdb_fs->exists_xattr(txn, node, attr)) {
+    ctx.set_error(Error::HYPERSPACE_ATTR_NOT_FOUND, attr);
     return;
-  m_bdb_fs->del_xattr(txn, node, name);
+  }
+  m_bdb_fs->del_xattr(txn, node, attr);
 
   // create event notification and persist
-  create_event(ctx, node, EVENT_MASK_ATTR_DEL, name);
+  create_event(ctx, node, EVENT_MASK_ATTR_DEL, attr);
 }
 
 void Hyperspace::Master::attr_exists(CommandContext& ctx, uint64_t handle,
@@ -23,6 +23,7 @@
 #define Hyperspace_Master_h
 
 #include <Hyperspace/BerkeleyDbFilesystem.h>
+#include <Hyperspace/CompoundRequest.h>
 #include <Hyperspace/MetricsHandler.h>
 #include <Hyperspace/Protocol.h>
 #include <Hyperspace/ServerKeepaliveHandler.h>
@@ -30,6 +31,7 @@
 #include <Hyperspace/response/ResponseCallbackAttrGet.h>
 #include <Hyperspace/response/ResponseCallbackAttrIncr.h>
 #include <Hyperspace/response/ResponseCallbackAttrList.h>
+#include <Hyperspace/response/ResponseCallbackCompound.h>
 #include <Hyperspace/response/ResponseCallbackExists.h>
 #include <Hyperspace/response/ResponseCallbackLock.h>
 #include <Hyperspace/response/ResponseCallbackOpen.h>
@@ -121,6 +123,8 @@ namespace Hyperspace {
     void lock(ResponseCallbackLock *cb, uint64_t session_id, uint64_t handle,
               uint32_t mode, bool try_lock);
     void release(ResponseCallback *cb, uint64_t session_id, uint64_t handle);
+    void compound(ResponseCallbackCompound *cb, uint64_t session_id,
+                  CompoundRequest &request);
 
     /*
      * Creates a new session by allocating a new SessionData object, obtaining a
@@ -250,6 +254,8 @@ namespace Hyperspace {
     };
 
     void mkdir(CommandContext &ctx, const char *name);
+    void mkdirs(CommandContext &ctx, const char *name,
+                const std::vector<Attribute> &init_attrs);
     void unlink(CommandContext &ctx, const char *name);
     void open(CommandContext &ctx, const char *name,
               uint32_t flags, uint32_t event_mask,
@@ -265,7 +271,8 @@ namespace Hyperspace {
                   std::vector<DynamicBufferPtr> &dbufs);
     void attr_incr(CommandContext &ctx, uint64_t handle,
                    const char *name, const char *attr, uint64_t& attr_val);
-    void attr_del(CommandContext &ctx, uint64_t handle, const char *name);
+    void attr_del(CommandContext &ctx, uint64_t handle,
+                  const char *name, const char *attr);
     void attr_exists(CommandContext& ctx, uint64_t handle,
                      const char *name, const char *attr, bool& exists);
     void attr_list(CommandContext& ctx, uint64_t handle, std::vector<String>& attributes);
@@ -28,6 +28,7 @@
 #include <Common/Compat.h>
 
 #include "Protocol.h"
+#include "CompoundRequest.h"
 
 #include <AsyncComm/CommHeader.h>
 
@@ -69,7 +70,8 @@ const char *Hyperspace::Protocol::command_strs[COMMAND_MAX] = {
   "readdirattr",
   "attrincr",
   "readpathattr",
-  "shutdown"
+  "shutdown",
+  "compound"
 };
 
 
@@ -520,3 +522,14 @@ CommBuf *Hyperspace::Protocol::create_shutdown_request() {
   CommBuf *cbuf = new CommBuf(header, 0);
   return cbuf;
 }
+
+
+CommBuf *
+Hyperspace::Protocol::create_compound_request(const CompoundRequest &request) {
+  CommHeader header(COMMAND_COMPOUND);
+  if (!request.empty())
+    header.gid = filename_to_group(request.operation(0).name);
+  CommBuf *cbuf = new CommBuf(header, request.encoded_length());
+  request.encode(cbuf->get_data_ptr_address());
+  return cbuf;
+}
@@ -65,6 +65,8 @@ namespace Hyperspace {
     uint32_t value_len;
   };
 
+  class CompoundRequest;
+
   /** %Protocol driver for encoding request messages. */
   class Protocol : public Hypertable::Protocol {
 
@@ -177,6 +179,17 @@ namespace Hyperspace {
     static CommBuf *create_status_request();
     static CommBuf *create_shutdown_request();
 
+    /** Creates <i>compound</i> request message.
+     * This method creates a CommBuf object holding a <i>compound</i> request
+     * message.  The message body is the serialized operation list produced by
+     * CompoundRequest::encode().  The <i>gid</i> field of the header is set to
+     * the return value of filename_to_group() called with the node name of
+     * the first operation.
+     * @param request Compound request
+     * @return Heap allocated comm buffer holding request
+     */
+    static CommBuf *create_compound_request(const CompoundRequest &request);
+
     static const uint64_t COMMAND_KEEPALIVE      = 0;
     static const uint64_t COMMAND_HANDSHAKE      = 1;
     static const uint64_t COMMAND_OPEN           = 2;
@@ -202,7 +215,8 @@ namespace Hyperspace {
     static const uint64_t COMMAND_ATTRINCR       = 22;
     static const uint64_t COMMAND_READPATHATTR   = 23;
     static const uint64_t COMMAND_SHUTDOWN       = 24;
-    static const uint64_t COMMAND_MAX            = 25;
+    static const uint64_t COMMAND_COMPOUND       = 25;
+    static const uint64_t COMMAND_MAX            = 26;
 
     static const char * command_strs[COMMAND_MAX];
 
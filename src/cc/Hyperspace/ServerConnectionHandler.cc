@@ -49,6 +49,7 @@
 #include "request/RequestHandlerDoMaintenance.h"
 #include "request/RequestHandlerDestroySession.h"
 #include "request/RequestHandlerShutdown.h"
+#include "request/RequestHandlerCompound.h"
 #include "ServerConnectionHandler.h"
 
 using namespace std;
@@ -174,6 +175,10 @@ void ServerConnectionHandler::handle(EventPtr &event) {
         handler = new RequestHandlerShutdown(m_comm, m_master.get(),
                                              m_session_id, event);
         break;
+      case Protocol::COMMAND_COMPOUND:
+        handler = new RequestHandlerCompound(m_comm, m_master.get(),
+                                             m_session_id, event);
+        break;
       default:
         HT_THROWF(Error::PROTOCOL_ERROR, "Unimplemented command (%llu)",
                   (Llu)event->header.command);
@@ -67,6 +67,10 @@ Session::Session(Comm *comm, PropertiesPtr &props)
 
   m_reconnect = props->get_bool("Hyperspace.Session.Reconnect");
 
+  if (props->get_bool("Hyperspace.Client.Cache.Enable"))
+    m_cache = std::make_unique<ClientCache>(props->get_i32("Hyperspace.Client.Cache.Lease"),
+                                            props->get_i32("Hyperspace.Client.Cache.MaxEntries"));
+
   if (m_reconnect)
     HT_DEBUG("Hyperspace session setup to reconnect");
 
@@ -201,6 +205,8 @@ Session::open(ClientHandleStatePtr &handle_state, CommBufPtr &cbuf_ptr,
       handle_state->lock_generation = decode_i64(&decode_ptr, &decode_remain);
       /** if (createdp) *createdp = cbyte ? true : false; **/
       m_keepalive_handler_ptr->register_handle(handle_state);
+      if (m_cache && (open_flags & OPEN_FLAG_CREATE))
+        m_cache->invalidate_node(handle_state->normal_name);
       HT_DEBUG_OUT << "Open succeeded session="
                   << m_keepalive_handler_ptr->get_session_id()
                   << ", name=" << handle_state->normal_name
@@ -334,6 +340,8 @@ void Session::unlink(const std::string &name, Timer *timer) {
     if (!sync_handler.wait_for_reply(event_ptr))
       HT_THROWF((int)Protocol::response_code(event_ptr.get()),
                 "Hyperspace 'unlink' error, name=%s", normal_name.c_str());
+    if (m_cache)
+      m_cache->invalidate_node(normal_name);
   }
   else {
     state_transition(Session::STATE_JEOPARDY);
@@ -342,14 +350,96 @@ void Session::unlink(const std::string &name, Timer *timer) {
 
 }
 
+void Session::execute(CompoundRequest &request, Timer *timer) {
+  DispatchHandlerSynchronizer sync_handler;
+  Hypertable::EventPtr event_ptr;
+
+  if (request.empty())
+    return;
+
+  for (size_t i=0; i<request.size(); i++) {
+    CompoundRequest::Operation &op = request.operation(i);
+    if (!op.name.empty()) {
+      String normal_name;
+      normalize_name(op.name, normal_name);
+      op.name = normal_name;
+    }
+  }
+
+  CommBufPtr cbuf_ptr(Protocol::create_compound_request(request));
+
+ try_again:
+  if (!wait_for_safe())
+    HT_THROW(Error::HYPERSPACE_EXPIRED_SESSION, "");
+
+  int error = send_message(cbuf_ptr, &sync_handler, timer);
+  if (error == Error::OK) {
+    if (!sync_handler.wait_for_reply(event_ptr))
+      HT_THROWF((int)Protocol::response_code(event_ptr.get()),
+                "Hyperspace compound request error, %s",
+                Protocol::string_format_message(event_ptr).c_str());
+    const uint8_t *decode_ptr = event_ptr->payload + 4;
+    size_t decode_remain = event_ptr->payload_len - 4;
+    request.decode_results(&decode_ptr, &decode_remain);
+    if (m_cache) {
+      String opened_name;
+      for (size_t i=0; i<request.size(); i++) {
+        const CompoundRequest::Operation &op = request.operation(i);
+        if (request.result(i).error != Error::OK)
+          continue;
+        const String &normal_name = op.name.empty() ? opened_name : op.name;
+        switch (op.code) {
+        case CompoundRequest::OP_OPEN:
+          opened_name = op.name;
+          if (op.open_flags & OPEN_FLAG_CREATE)
+            m_cache->invalidate_node(op.name);
+          break;
+        case CompoundRequest::OP_MKDIRS:
+          for (size_t slash = op.name.find('/', 1); slash != String::npos;
+               slash = op.name.find('/', slash + 1))
+            m_cache->invalidate_node(op.name.substr(0, slash));
+          m_cache->invalidate_node(op.name);
+          break;
+        case CompoundRequest::OP_MKDIR:
+        case CompoundRequest::OP_UNLINK:
+          m_cache->invalidate_node(op.name);
+          break;
+        case CompoundRequest::OP_ATTR_SET:
+          for (const auto &attr : op.attrs)
+            m_cache->invalidate_attr(normal_name, attr.first);
+          break;
+        case CompoundRequest::OP_ATTR_DEL:
+        case CompoundRequest::OP_ATTR_INCR:
+          m_cache->invalidate_attr(normal_name, op.attr);
+          break;
+        default:
+          break;
+        }
+      }
+    }
+  }
+  else {
+    state_transition(Session::STATE_JEOPARDY);
+    goto try_again;
+  }
+}
+
 
 bool Session::exists(const std::string &name, Timer *timer) {
   DispatchHandlerSynchronizer sync_handler;
   Hypertable::EventPtr event_ptr;
   String normal_name;
+  uint64_t generation = 0;
 
   normalize_name(name, normal_name);
 
+  if (m_cache) {
+    String cached;
+    if (m_cache->lookup(normal_name, ClientCache::EXISTS, "", cached))
+      return cached[0] != 0;
+    generation = m_cache->generation();
+  }
+
   CommBufPtr cbuf_ptr(Protocol::create_exists_request(normal_name));
 
  try_again:
@@ -366,6 +456,8 @@ bool Session::exists(const std::string &name, Timer *timer) {
       const uint8_t *decode_ptr = event_ptr->payload + 4;
       size_t decode_remain = event_ptr->payload_len - 4;
       uint8_t bval = decode_byte(&decode_ptr, &decode_remain);
+      if (m_cache)
+        m_cache->insert(generation, normal_name, ClientCache::EXISTS, "", &bval, 1);
       return (bval == 0) ? false : true;
     }
   }
@@ -399,6 +491,7 @@ void Session::attr_set(uint64_t handle, const std::string &attr,
                 "Problem setting attribute '%s' of hyperspace file '%s'",
                 attr.c_str(), fname.c_str());
     }
+    invalidate_cached_attr(handle, attr);
     return;
   }
 
@@ -428,6 +521,8 @@ void Session::attr_set(uint64_t handle, const std::vector<Attribute> &attrs,
       HT_THROWF((int)Protocol::response_code(event_ptr.get()),
                 "Problem setting attributes of hyperspace file '%s'", fname.c_str());
     }
+    for (auto &attribute : attrs)
+      invalidate_cached_attr(handle, attribute.name);
     return;
   }
 
@@ -460,6 +555,13 @@ void Session::attr_set(const std::string &name, uint32_t oflags, const std::stri
                 "Problem setting attribute '%s' of hyperspace file '%s'",
                 attr.c_str(), name.c_str());
     }
+    if (m_cache) {
+      String normal_name;
+      normalize_name(name, normal_name);
+      if (oflags & OPEN_FLAG_CREATE)
+        m_cache->invalidate_node(normal_name);
+      m_cache->invalidate_attr(normal_name, attr);
+    }
     return;
   }
 
@@ -484,6 +586,14 @@ void Session::attr_set(const std::string &name, uint32_t oflags,
       HT_THROWF((int)Protocol::response_code(event_ptr.get()),
                 "Problem setting attributes of hyperspace file '%s'", name.c_str());
     }
+    if (m_cache) {
+      String normal_name;
+      normalize_name(name, normal_name);
+      if (oflags & OPEN_FLAG_CREATE)
+        m_cache->invalidate_node(normal_name);
+      for (auto &attribute : attrs)
+        m_cache->invalidate_attr(normal_name, attribute.name);
+    }
     return;
   }
 
@@ -517,6 +627,7 @@ uint64_t Session::attr_incr(uint64_t handle, const std::string &attr, Timer *tim
       const uint8_t *decode_ptr = event_ptr->payload + 4;
       size_t decode_remain = event_ptr->payload_len - 4;
       uint64_t attr_val = decode_i64(&decode_ptr, &decode_remain);
+      invalidate_cached_attr(handle, attr);
 
       return attr_val;
     }
@@ -550,6 +661,11 @@ uint64_t Session::attr_incr(const std::string &name, const std::string &attr, Ti
       const uint8_t *decode_ptr = event_ptr->payload + 4;
       size_t decode_remain = event_ptr->payload_len - 4;
       uint64_t attr_val = decode_i64(&decode_ptr, &decode_remain);
+      if (m_cache) {
+        String normal_name;
+        normalize_name(name, normal_name);
+        m_cache->invalidate_attr(normal_name, attr);
+      }
 
       return attr_val;
     }
@@ -566,6 +682,15 @@ Session::attr_get(uint64_t handle, const std::string &attr,
                   DynamicBuffer &value, Timer *timer) {
   DispatchHandlerSynchronizer sync_handler;
   Hypertable::EventPtr event_ptr;
+  String normal_name;
+  uint64_t generation = 0;
+
+  if (cached_name(handle, normal_name)) {
+    if (lookup_cached_value(normal_name, attr, value))
+      return;
+    generation = m_cache->generation();
+  }
+
   CommBufPtr cbuf_ptr(Protocol::create_attr_get_request(handle, 0, attr));
 
  try_again:
@@ -583,8 +708,12 @@ Session::attr_get(uint64_t handle, const std::string &attr,
                 "Problem getting attribute '%s' of hyperspace file '%s'",
                 attr.c_str(), fname.c_str());
     }
-    else
+    else {
       decode_value(event_ptr, value);
+      if (!normal_name.empty())
+        m_cache->insert(generation, normal_name, ClientCache::ATTR, attr,
+                        value.base, value.fill());
+    }
   }
   else {
     state_transition(Session::STATE_JEOPARDY);
@@ -597,6 +726,16 @@ Session::attr_get(const std::string &name, const std::string &attr,
                   DynamicBuffer &value, Timer *timer) {
   DispatchHandlerSynchronizer sync_handler;
   Hypertable::EventPtr event_ptr;
+  String normal_name;
+  uint64_t generation = 0;
+
+  if (m_cache) {
+    normalize_name(name, normal_name);
+    if (lookup_cached_value(normal_name, attr, value))
+      return;
+    generation = m_cache->generation();
+  }
+
   CommBufPtr cbuf_ptr(Protocol::create_attr_get_request(0, &name, attr));
 
  try_again:
@@ -610,8 +749,12 @@ Session::attr_get(const std::string &name, const std::string &attr,
                 "Problem getting attribute '%s' of hyperspace file '%s'",
                 attr.c_str(), name.c_str());
     }
-    else
+    else {
       decode_value(event_ptr, value);
+      if (m_cache)
+        m_cache->insert(generation, normal_name, ClientCache::ATTR, attr,
+                        value.base, value.fill());
+    }
   }
   else {
     state_transition(Session::STATE_JEOPARDY);
@@ -775,6 +918,7 @@ void Session::attr_del(uint64_t handle, const std::string &name, Timer *timer) {
                 "Problem deleting attribute '%s' of hyperspace file '%s'",
                 name.c_str(), fname.c_str());
     }
+    invalidate_cached_attr(handle, name);
   }
   else {
     state_transition(Session::STATE_JEOPARDY);
@@ -876,6 +1020,20 @@ Session::readdir_attr(uint64_t handle, const std::string &attr, bool include_sub
                       std::vector<DirEntryAttr> &listing, Timer *timer) {
   DispatchHandlerSynchronizer sync_handler;
   Hypertable::EventPtr event_ptr;
+  ClientCache::Kind kind = include_sub_entries ?
+    ClientCache::LISTING_RECURSIVE : ClientCache::LISTING;
+  String normal_name;
+  uint64_t generation = 0;
+
+  if (cached_name(handle, normal_name)) {
+    String cached;
+    if (m_cache->lookup(normal_name, kind, attr, cached)) {
+      decode_listing((const uint8_t *)cached.data(), cached.length(), listing);
+      return;
+    }
+    generation = m_cache->generation();
+  }
+
   CommBufPtr cbuf_ptr(Protocol::create_readdir_attr_request(handle, 0, attr, include_sub_entries));
 
  try_again:
@@ -888,8 +1046,12 @@ Session::readdir_attr(uint64_t handle, const std::string &attr, bool include_sub
       HT_THROW((int)Protocol::response_code(event_ptr.get()),
                "Hyperspace 'readdir_attr' error");
     }
-    else
+    else {
       decode_listing(event_ptr, listing);
+      if (!normal_name.empty())
+        m_cache->insert(generation, normal_name, kind, attr,
+                        event_ptr->payload + 4, event_ptr->payload_len - 4);
+    }
   }
   else {
     state_transition(Session::STATE_JEOPARDY);
@@ -902,6 +1064,21 @@ Session::readdir_attr(const std::string &name, const std::string &attr, bool inc
                       std::vector<DirEntryAttr> &listing, Timer *timer) {
   DispatchHandlerSynchronizer sync_handler;
   Hypertable::EventPtr event_ptr;
+  ClientCache::Kind kind = include_sub_entries ?
+    ClientCache::LISTING_RECURSIVE : ClientCache::LISTING;
+  String normal_name;
+  uint64_t generation = 0;
+
+  if (m_cache) {
+    String cached;
+    normalize_name(name, normal_name);
+    if (m_cache->lookup(normal_name, kind, attr, cached)) {
+      decode_listing((const uint8_t *)cached.data(), cached.length(), listing);
+      return;
+    }
+    generation = m_cache->generation();
+  }
+
   CommBufPtr cbuf_ptr(Protocol::create_readdir_attr_request(0, &name, attr, include_sub_entries));
 
  try_again:
@@ -914,8 +1091,12 @@ Session::readdir_attr(const std::string &name, const std::string &attr, bool inc
       HT_THROW((int)Protocol::response_code(event_ptr.get()),
                "Hyperspace 'readdir_attr' error");
     }
-    else
+    else {
       decode_listing(event_ptr, listing);
+      if (!normal_name.empty())
+        m_cache->insert(generation, normal_name, kind, attr,
+                        event_ptr->payload + 4, event_ptr->payload_len - 4);
+    }
   }
   else {
     state_transition(Session::STATE_JEOPARDY);
@@ -1202,6 +1383,9 @@ int Session::state_transition(int state) {
   lock_guard<mutex> lock(m_mutex);
   int old_state = m_state;
   m_state = state;
+  // Notifications may be missed while not in STATE_SAFE
+  if (m_cache && old_state == STATE_SAFE && m_state != STATE_SAFE)
+    m_cache->clear();
   if (m_state == STATE_SAFE) {
     m_cond.notify_all();
     if (old_state == STATE_JEOPARDY) {
@@ -1286,6 +1470,13 @@ void Session::mkdir(const std::string &name, bool create_intermediate, const std
     if (!sync_handler.wait_for_reply(event_ptr))
       HT_THROWF((int)Protocol::response_code(event_ptr.get()),
                 "Hyperspace 'mkdir' error, name=%s", normal_name.c_str());
+    if (m_cache) {
+      // Intermediate directories may have been created as well
+      size_t slash = create_intermediate ? normal_name.find('/', 1) : String::npos;
+      for (; slash != String::npos; slash = normal_name.find('/', slash + 1))
+        m_cache->invalidate_node(normal_name.substr(0, slash));
+      m_cache->invalidate_node(normal_name);
+    }
   }
   else {
     state_transition(Session::STATE_JEOPARDY);
@@ -1338,8 +1529,11 @@ void Session::decode_values(Hypertable::EventPtr& event_ptr, std::vector<Dynamic
 }
 
 void Session::decode_listing(Hypertable::EventPtr& event_ptr, std::vector<DirEntryAttr> &listing) {
-  const uint8_t *decode_ptr = event_ptr->payload + 4;
-  size_t decode_remain = event_ptr->payload_len - 4;
+  decode_listing(event_ptr->payload + 4, event_ptr->payload_len - 4, listing);
+}
+
+void Session::decode_listing(const uint8_t *decode_ptr, size_t decode_remain,
+                             std::vector<DirEntryAttr> &listing) {
   uint32_t entry_cnt;
   DirEntryAttr dentry;
   try {
@@ -1391,6 +1585,52 @@ Session::send_message(CommBufPtr &cbuf_ptr, DispatchHandler *handler,
 }
 
 
+void Session::invalidate_cache(const std::string &normal_name,
+                               uint32_t event_mask, const std::string &name) {
+  if (!m_cache)
+    return;
+  if (event_mask == EVENT_MASK_ATTR_SET || event_mask == EVENT_MASK_ATTR_DEL)
+    m_cache->invalidate_attr(normal_name, name);
+  else if (event_mask == EVENT_MASK_CHILD_NODE_ADDED ||
+           event_mask == EVENT_MASK_CHILD_NODE_REMOVED)
+    m_cache->invalidate_node(normal_name == "/" ? normal_name + name :
+                             normal_name + "/" + name);
+}
+
+bool Session::get_cache_statistics(ClientCache::Statistics *stats) {
+  if (!m_cache)
+    return false;
+  m_cache->get_statistics(stats);
+  return true;
+}
+
+bool Session::cached_name(uint64_t handle, String &normal_name) {
+  ClientHandleStatePtr handle_state;
+  if (!m_cache || !m_keepalive_handler_ptr->get_handle_state(handle, handle_state))
+    return false;
+  normal_name = handle_state->normal_name;
+  return true;
+}
+
+bool Session::lookup_cached_value(const String &normal_name, const String &attr,
+                                  DynamicBuffer &value) {
+  String cached;
+  if (!m_cache->lookup(normal_name, ClientCache::ATTR, attr, cached))
+    return false;
+  value.clear();
+  value.ensure(cached.length()+1);
+  value.add_unchecked(cached.data(), cached.length());
+  // nul-terminate to match decode_value()
+  *value.ptr = 0;
+  return true;
+}
+
+void Session::invalidate_cached_attr(uint64_t handle, const String &attr) {
+  String normal_name;
+  if (cached_name(handle, normal_name))
+    m_cache->invalidate_attr(normal_name, attr);
+}
+
 void Session::normalize_name(const String &name, String &normal) {
 
   if (name == "/") {
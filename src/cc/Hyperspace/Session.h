@@ -22,7 +22,9 @@
 #ifndef Hyperspace_Session_h
 #define Hyperspace_Session_h
 
+#include <Hyperspace/ClientCache.h>
 #include <Hyperspace/ClientKeepaliveHandler.h>
+#include <Hyperspace/CompoundRequest.h>
 #include <Hyperspace/DirEntry.h>
 #include <Hyperspace/DirEntryAttr.h>
 #include <Hyperspace/HandleCallback.h>
@@ -472,6 +474,18 @@ namespace Hyperspace {
      */
     void unlink(const std::string &name, Timer *timer=0);
 
+    /** Executes a compound request.  The operations of <code>request</code>
+     * are executed in order by the master in a single transaction, so either
+     * all of them take effect or none do.  On success, per-operation results
+     * can be read with CompoundRequest::result().  If an operation fails,
+     * an exception is thrown carrying the error code of the failing
+     * operation and a message identifying it.
+     *
+     * @param request compound request to execute
+     * @param timer maximum wait timer
+     */
+    void execute(CompoundRequest &request, Timer *timer=0);
+
     /** Gets a directory listing.  The listing comes back as a vector of
      * DireEntry which contains a name and boolean flag indicating if the
      * entry is an element or not.
@@ -675,6 +689,23 @@ namespace Hyperspace {
 
     void update_master_addr(const String &host);
 
+    /// Invalidates cached results affected by a handle notification.
+    /// Called by ClientKeepaliveHandler for each ATTR_SET, ATTR_DEL,
+    /// CHILD_NODE_ADDED and CHILD_NODE_REMOVED notification it receives.
+    /// Does nothing if the client cache is disabled.
+    /// @param normal_name Normalized name of node the handle refers to
+    /// @param event_mask Notification event mask
+    /// @param name Attribute name for attribute events, child node name
+    /// for child node events
+    void invalidate_cache(const std::string &normal_name, uint32_t event_mask,
+                          const std::string &name);
+
+    /// Fetches client cache statistics.
+    /// @param stats Address of statistics structure to fill in
+    /// @return <i>true</i> if the client cache is enabled and
+    /// <code>stats</code> was filled in, <i>false</i> otherwise
+    bool get_cache_statistics(ClientCache::Statistics *stats);
+
     /// Handle sleep event (e.g. laptop close).
     /// This method handles a suspend event (e.g. laptop close) by setting
     /// #m_expire_time to the current time plus the grace period.
@@ -720,6 +751,7 @@ namespace Hyperspace {
 
     void mkdir(const std::string &name, bool create_intermediate, const std::vector<Attribute> *init_attrs, Timer *timer);
     void decode_listing(Hypertable::EventPtr& event_ptr, std::vector<DirEntryAttr> &listing);
+    void decode_listing(const uint8_t *decode_ptr, size_t decode_remain, std::vector<DirEntryAttr> &listing);
     void decode_value(Hypertable::EventPtr& event_ptr, DynamicBuffer &value);
     void decode_values(Hypertable::EventPtr& event_ptr, std::vector<DynamicBufferPtr> &values);
     bool wait_for_safe();
@@ -727,6 +759,26 @@ namespace Hyperspace {
     void normalize_name(const std::string &name, std::string &normal);
     uint64_t open(ClientHandleStatePtr &, CommBufPtr &, Timer *timer);
 
+    /// Looks up normalized name of a handle for use as a cache key.
+    /// @param handle File handle
+    /// @param normal_name Output string to hold normalized name
+    /// @return <i>true</i> if the client cache is enabled and
+    /// <code>handle</code> is known, <i>false</i> otherwise
+    bool cached_name(uint64_t handle, String &normal_name);
+
+    /// Looks up a cached attribute value.
+    /// @param normal_name Normalized node name
+    /// @param attr Attribute name
+    /// @param value Buffer to hold nul-terminated value on hit
+    /// @return <i>true</i> on cache hit, <i>false</i> otherwise
+    bool lookup_cached_value(const String &normal_name, const String &attr,
+                             DynamicBuffer &value);
+
+    /// Invalidates cached value of an attribute of the node behind a handle.
+    /// @param handle File handle
+    /// @param attr Attribute name
+    void invalidate_cached_attr(uint64_t handle, const String &attr);
+
     std::mutex                m_mutex;
     std::condition_variable   m_cond;
     Comm                      *m_comm;
@@ -747,6 +799,8 @@ namespace Hyperspace {
     bool                      m_silent;
     /// Delivers suspend/resume notifications (e.g. laptop close/open).
     SleepWakeNotifier         *m_sleep_wake_notifier;
+    /// Client-side read cache (null unless Hyperspace.Client.Cache.Enable)
+    ClientCachePtr            m_cache;
   };
 
   typedef std::shared_ptr<Session> SessionPtr;
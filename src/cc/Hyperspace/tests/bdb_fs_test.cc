@@ -67,6 +67,9 @@ int main(int argc, char **argv) {
   props->set("Hyperspace.Checkpoint.Size",     (gInt32t)1000000 );
   props->set("Hyperspace.LogGc.Interval",      (gInt32t)3600000 );
   props->set("Hyperspace.LogGc.MaxUnusedLogs", (gInt32t)200 );
+  props->set("Hyperspace.GroupCommit.Enable",   true );
+  props->set("Hyperspace.GroupCommit.Window",   (gInt32t)1 );
+  props->set("Hyperspace.GroupCommit.MaxBatch", (gInt32t)64 );
 
   bdb_fs = new BerkeleyDbFilesystem(props, filename, thread_ids);
 
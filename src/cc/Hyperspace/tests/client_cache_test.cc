@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <Common/Compat.h>
+
+#include <Hyperspace/ClientCache.h>
+
+#include <Common/Logger.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+using namespace Hypertable;
+using namespace Hyperspace;
+using namespace std;
+
+namespace {
+
+  void put(ClientCache &cache, const string &name, ClientCache::Kind kind,
+           const string &attr, const string &value) {
+    cache.insert(cache.generation(), name, kind, attr, value.c_str(),
+                 value.length());
+  }
+
+  bool cached(ClientCache &cache, const string &name, ClientCache::Kind kind,
+              const string &attr, const string &expected="") {
+    string value;
+    if (!cache.lookup(name, kind, attr, value))
+      return false;
+    HT_ASSERT(expected.empty() || value == expected);
+    return true;
+  }
+
+}
+
+int main(int argc, char **argv) {
+
+  // hits and misses
+  {
+    ClientCache cache(60000, 100);
+    HT_ASSERT(!cached(cache, "/a", ClientCache::ATTR, "x"));
+    put(cache, "/a", ClientCache::ATTR, "x", "1");
+    put(cache, "/a", ClientCache::EXISTS, "", "t");
+    HT_ASSERT(cached(cache, "/a", ClientCache::ATTR, "x", "1"));
+    HT_ASSERT(cached(cache, "/a", ClientCache::EXISTS, ""));
+    HT_ASSERT(!cached(cache, "/a", ClientCache::ATTR, "y"));
+    HT_ASSERT(!cached(cache, "/ab", ClientCache::ATTR, "x"));
+    ClientCache::Statistics stats;
+    cache.get_statistics(&stats);
+    HT_ASSERT(stats.hits == 2 && stats.misses == 3 && stats.entries == 2);
+  }
+
+  // eviction: lease expiry and the entry cap
+  {
+    ClientCache cache(100, 2);
+    put(cache, "/a", ClientCache::ATTR, "x", "1");
+    put(cache, "/b", ClientCache::ATTR, "x", "2");
+    put(cache, "/c", ClientCache::ATTR, "x", "3");
+    HT_ASSERT(cached(cache, "/a", ClientCache::ATTR, "x"));
+    HT_ASSERT(cached(cache, "/b", ClientCache::ATTR, "x"));
+    HT_ASSERT(!cached(cache, "/c", ClientCache::ATTR, "x"));
+    this_thread::sleep_for(chrono::milliseconds(200));
+    HT_ASSERT(!cached(cache, "/a", ClientCache::ATTR, "x"));
+    // cache is full again with /b expired, which is purged to make room
+    put(cache, "/c", ClientCache::ATTR, "x", "3");
+    put(cache, "/d", ClientCache::ATTR, "x", "4");
+    HT_ASSERT(cached(cache, "/c", ClientCache::ATTR, "x", "3"));
+    HT_ASSERT(cached(cache, "/d", ClientCache::ATTR, "x", "4"));
+    ClientCache::Statistics stats;
+    cache.get_statistics(&stats);
+    HT_ASSERT(stats.entries == 2);
+  }
+
+  // attribute invalidation drops ancestor listings only
+  {
+    ClientCache cache(60000, 100);
+    put(cache, "/t/ns/table", ClientCache::ATTR, "x", "1");
+    put(cache, "/t/ns/table", ClientCache::ATTR, "y", "2");
+    put(cache, "/t/ns", ClientCache::LISTING, "x", "l1");
+    put(cache, "/t", ClientCache::LISTING_RECURSIVE, "x", "l2");
+    put(cache, "/", ClientCache::LISTING, "x", "l3");
+    put(cache, "/t/other", ClientCache::LISTING, "x", "l4");
+    cache.invalidate_attr("/t/ns/table", "x");
+    HT_ASSERT(!cached(cache, "/t/ns/table", ClientCache::ATTR, "x"));
+    HT_ASSERT(cached(cache, "/t/ns/table", ClientCache::ATTR, "y"));
+    HT_ASSERT(!cached(cache, "/t/ns", ClientCache::LISTING, "x"));
+    HT_ASSERT(!cached(cache, "/t", ClientCache::LISTING_RECURSIVE, "x"));
+    HT_ASSERT(!cached(cache, "/", ClientCache::LISTING, "x"));
+    HT_ASSERT(cached(cache, "/t/other", ClientCache::LISTING, "x"));
+  }
+
+  // node invalidation drops the node and its descendants, not siblings
+  {
+    ClientCache cache(60000, 100);
+    put(cache, "/t/ns", ClientCache::EXISTS, "", "t");
+    put(cache, "/t/ns/a", ClientCache::ATTR, "x", "1");
+    put(cache, "/t/ns/a/b", ClientCache::ATTR, "x", "1");
+    put(cache, "/t/nsx", ClientCache::ATTR, "x", "1");
+    put(cache, "/t", ClientCache::LISTING, "", "l");
+    cache.invalidate_node("/t/ns");
+    HT_ASSERT(!cached(cache, "/t/ns", ClientCache::EXISTS, ""));
+    HT_ASSERT(!cached(cache, "/t/ns/a", ClientCache::ATTR, "x"));
+    HT_ASSERT(!cached(cache, "/t/ns/a/b", ClientCache::ATTR, "x"));
+    HT_ASSERT(!cached(cache, "/t", ClientCache::LISTING, ""));
+    HT_ASSERT(cached(cache, "/t/nsx", ClientCache::ATTR, "x"));
+    cache.clear();
+    HT_ASSERT(!cached(cache, "/t/nsx", ClientCache::ATTR, "x"));
+  }
+
+  // a fill that raced with an invalidation is dropped
+  {
+    ClientCache cache(60000, 100);
+    uint64_t generation = cache.generation();
+    cache.invalidate_attr("/a", "x");
+    cache.insert(generation, "/a", ClientCache::ATTR, "x", "1", 1);
+    HT_ASSERT(!cached(cache, "/a", ClientCache::ATTR, "x"));
+  }
+
+  return 0;
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <Common/Compat.h>
+
+#include <Hyperspace/CompoundRequest.h>
+#include <Hyperspace/Config.h>
+#include <Hyperspace/Session.h>
+
+#include <AsyncComm/Comm.h>
+
+#include <Common/Error.h>
+#include <Common/Init.h>
+#include <Common/ServerLauncher.h>
+
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace Hypertable;
+using namespace Hyperspace;
+using namespace Config;
+using namespace std;
+
+namespace {
+
+  string attr_value(SessionPtr &session, const string &name,
+                    const string &attr) {
+    DynamicBuffer value;
+    session->attr_get(name, attr, value);
+    return string((const char *)value.base, value.fill());
+  }
+
+  void expect_error(SessionPtr &session, CompoundRequest &request, int error) {
+    try {
+      session->execute(request);
+      HT_ASSERT(!"compound request did not fail");
+    }
+    catch (Exception &e) {
+      HT_ASSERT(e.code() == error);
+    }
+  }
+
+  void run_tests(SessionPtr &session) {
+    uint32_t open_flags = OPEN_FLAG_READ|OPEN_FLAG_WRITE|OPEN_FLAG_CREATE;
+    vector<Attribute> attrs;
+    attrs.emplace_back("nid", "0", 1);
+
+    // every operation type, with nameless operations applied to the handle
+    // of the preceding open
+    {
+      CompoundRequest request;
+      request.mkdirs("/compound/a/b", attrs)
+        .mkdir("/compound/c")
+        .open("/compound/c/file", open_flags)
+        .attr_set("", "x", "1", 1)
+        .attr_get("", "x")
+        .attr_exists("", "x")
+        .attr_incr("/compound/a/b", "nid")
+        .attr_incr("/compound/a/b", "nid")
+        .exists("/compound/a")
+        .exists("/compound/missing");
+      session->execute(request);
+      HT_ASSERT(request.result(2).flag);
+      HT_ASSERT(request.result(4).data == "1");
+      HT_ASSERT(request.result(5).flag);
+      HT_ASSERT(request.result(7).value == request.result(6).value + 1);
+      HT_ASSERT(request.result(8).flag);
+      HT_ASSERT(!request.result(9).flag);
+      for (size_t i=0; i<request.size(); i++)
+        HT_ASSERT(request.result(i).error == Error::OK);
+    }
+    HT_ASSERT(session->exists("/compound/a/b"));
+    HT_ASSERT(attr_value(session, "/compound/c/file", "x") == "1");
+    HT_ASSERT(attr_value(session, "/compound/a/b", "nid") == "2");
+
+    // handles opened by the request are closed, so the file can be removed
+    {
+      CompoundRequest request;
+      request.attr_del("/compound/c/file", "x")
+        .unlink("/compound/c/file");
+      session->execute(request);
+    }
+    HT_ASSERT(!session->exists("/compound/c/file"));
+
+    // a failing operation aborts the whole request
+    {
+      CompoundRequest request;
+      request.mkdir("/compound/c/d")
+        .attr_set("/compound/c", "y", "1", 1)
+        .unlink("/compound/c/missing");
+      expect_error(session, request, Error::HYPERSPACE_FILE_NOT_FOUND);
+    }
+    HT_ASSERT(!session->exists("/compound/c/d"));
+    HT_ASSERT(!session->attr_exists("/compound/c", "y"));
+
+    {
+      CompoundRequest request;
+      request.mkdir("/compound/c/d")
+        .mkdir("/compound/c");
+      expect_error(session, request, Error::HYPERSPACE_FILE_EXISTS);
+    }
+    HT_ASSERT(!session->exists("/compound/c/d"));
+
+    // operations that create, remove or open nodes need a name
+    {
+      CompoundRequest request;
+      request.mkdir("");
+      expect_error(session, request, Error::HYPERSPACE_BAD_PATHNAME);
+    }
+
+    // missing nodes and attributes are skipped with FLAG_IGNORE_NOT_FOUND
+    {
+      CompoundRequest request;
+      request.unlink("/compound/c/missing", CompoundRequest::FLAG_IGNORE_NOT_FOUND)
+        .attr_del("/compound/c", "missing", CompoundRequest::FLAG_IGNORE_NOT_FOUND)
+        .attr_get("/compound/c", "missing", CompoundRequest::FLAG_IGNORE_NOT_FOUND)
+        .mkdir("/compound/c/d");
+      session->execute(request);
+      HT_ASSERT(request.result(0).error == Error::HYPERSPACE_FILE_NOT_FOUND);
+      HT_ASSERT(request.result(1).error == Error::HYPERSPACE_ATTR_NOT_FOUND);
+      HT_ASSERT(request.result(2).error == Error::HYPERSPACE_ATTR_NOT_FOUND);
+      HT_ASSERT(request.result(3).error == Error::OK);
+    }
+    HT_ASSERT(session->exists("/compound/c/d"));
+
+    // FLAG_IGNORE_NOT_FOUND does not mask other errors
+    {
+      CompoundRequest request;
+      request.mkdir("/compound/c/e")
+        .unlink("/compound/c", CompoundRequest::FLAG_IGNORE_NOT_FOUND);
+      expect_error(session, request, Error::HYPERSPACE_DIR_NOT_EMPTY);
+    }
+    HT_ASSERT(!session->exists("/compound/c/e"));
+
+    // an empty request is a no-op
+    {
+      CompoundRequest request;
+      session->execute(request);
+    }
+
+    CompoundRequest cleanup;
+    cleanup.unlink("/compound/c/d")
+      .unlink("/compound/c")
+      .unlink("/compound/a/b")
+      .unlink("/compound/a")
+      .unlink("/compound");
+    session->execute(cleanup);
+    HT_ASSERT(!session->exists("/compound"));
+  }
+
+}
+
+int main(int argc, char *argv[]) {
+  typedef Cons<DefaultServerPolicy, HyperspaceClientPolicy> MyPolicy;
+  std::vector<const char *> master_args;
+
+  try {
+    InetAddr addr;
+    String hyperspace_replica_port_arg;
+
+    init_with_policy<MyPolicy>(argc, argv);
+
+    Comm *comm = Comm::instance();
+
+    if (system("/bin/rm -rf ./hsroot") != 0) {
+      HT_ERROR("Problem removing ./hsroot directory");
+      exit(EXIT_FAILURE);
+    }
+
+    if (system("mkdir -p ./hsroot") != 0) {
+      HT_ERROR("Unable to create ./hsroot directory");
+      exit(EXIT_FAILURE);
+    }
+
+    addr = InetAddr(INADDR_ANY, 48122);
+    comm->find_available_tcp_port(addr);
+    hyperspace_replica_port_arg = format("--Hyperspace.Replica.Port=%d",
+                                         (int)ntohs(addr.sin_port));
+
+    master_args.push_back("htHyperspace");
+    master_args.push_back("--config=./compound_handler_test.cfg");
+    master_args.push_back(hyperspace_replica_port_arg.c_str());
+    master_args.push_back((const char *)0);
+
+    {
+      ServerLauncher master("./htHyperspace",
+                            (char * const *)&master_args[0]);
+
+      properties->set("Hyperspace.Replica.Port", (uint16_t)ntohs(addr.sin_port));
+
+      SessionPtr session = make_shared<Hyperspace::Session>(comm, properties);
+      HT_ASSERT(session->wait_for_connection(30000));
+
+      run_tests(session);
+    }
+  }
+  catch (Exception &e) {
+    HT_ERROR_OUT << e << HT_END;
+    quick_exit(EXIT_FAILURE);
+  }
+
+  quick_exit(EXIT_SUCCESS);
+}
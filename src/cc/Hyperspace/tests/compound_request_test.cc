@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <Common/Compat.h>
+
+#include <Hyperspace/CompoundRequest.h>
+#include <Hyperspace/Session.h>
+
+#include <Common/Error.h>
+#include <Common/Logger.h>
+#include <Common/Serialization.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Hypertable;
+using namespace Hyperspace;
+using namespace Hypertable::Serialization;
+using namespace std;
+
+namespace {
+
+  void check_equal(const CompoundRequest &r1, const CompoundRequest &r2) {
+    HT_ASSERT(r1.size() == r2.size());
+    for (size_t i=0; i<r1.size(); i++) {
+      const CompoundRequest::Operation &op1 = r1.operation(i);
+      const CompoundRequest::Operation &op2 = r2.operation(i);
+      HT_ASSERT(op1.code == op2.code);
+      HT_ASSERT(op1.flags == op2.flags);
+      HT_ASSERT(op1.open_flags == op2.open_flags);
+      HT_ASSERT(op1.name == op2.name);
+      HT_ASSERT(op1.attr == op2.attr);
+      HT_ASSERT(op1.attrs == op2.attrs);
+    }
+  }
+
+}
+
+int main(int argc, char **argv) {
+  const char binary[] = { 'a', '\0', 'b', '\xff' };
+  vector<Attribute> attrs;
+  attrs.emplace_back("schema", "<Schema/>", 9);
+  attrs.emplace_back("binary", binary, sizeof(binary));
+
+  CompoundRequest request;
+  request.mkdirs("/hypertable/namemap/ids/1", attrs)
+    .mkdir("/hypertable/tables/1")
+    .open("/hypertable/tables/1", OPEN_FLAG_READ|OPEN_FLAG_WRITE|OPEN_FLAG_CREATE, attrs)
+    .attr_set("", "x", "1", 1)
+    .attr_set("/hypertable/tables/1", attrs)
+    .attr_get("", "schema", CompoundRequest::FLAG_IGNORE_NOT_FOUND)
+    .attr_del("/hypertable/tables/1", "x")
+    .attr_exists("", "binary")
+    .attr_incr("/hypertable/namemap/ids", "nid")
+    .exists("/hypertable")
+    .unlink("/hypertable/tables/0", CompoundRequest::FLAG_IGNORE_NOT_FOUND);
+
+  HT_ASSERT(request.size() == 11 && !request.empty());
+  HT_ASSERT(request.operation(0).code == CompoundRequest::OP_MKDIRS);
+  HT_ASSERT(request.operation(0).attrs.size() == 2);
+  HT_ASSERT(request.operation(0).attrs[1].second == string(binary, sizeof(binary)));
+  HT_ASSERT(request.operation(3).name.empty());
+  HT_ASSERT(request.operation(3).attrs.size() == 1);
+  HT_ASSERT(request.operation(5).flags == CompoundRequest::FLAG_IGNORE_NOT_FOUND);
+  HT_ASSERT(request.operation(5).attr == "schema");
+
+  // only operations that create, remove or open nodes require a name
+  for (size_t i=0; i<request.size(); i++) {
+    uint8_t code = request.operation(i).code;
+    HT_ASSERT(strcmp(CompoundRequest::code_to_string(code), "unknown"));
+    HT_ASSERT(CompoundRequest::requires_name(code) ==
+              (code == CompoundRequest::OP_MKDIR ||
+               code == CompoundRequest::OP_MKDIRS ||
+               code == CompoundRequest::OP_UNLINK ||
+               code == CompoundRequest::OP_EXISTS ||
+               code == CompoundRequest::OP_OPEN));
+  }
+  HT_ASSERT(!strcmp(CompoundRequest::code_to_string(0), "unknown"));
+
+  // operations round trip
+  vector<uint8_t> buf(request.encoded_length());
+  uint8_t *ptr = buf.data();
+  request.encode(&ptr);
+  HT_ASSERT(ptr == buf.data() + buf.size());
+
+  CompoundRequest decoded;
+  const uint8_t *decode_ptr = buf.data();
+  size_t remain = buf.size();
+  decoded.decode(&decode_ptr, &remain);
+  HT_ASSERT(remain == 0);
+  check_equal(request, decoded);
+
+  // results round trip
+  decoded.result(2).flag = true;
+  decoded.result(2).value = 42;
+  decoded.result(5).data = string(binary, sizeof(binary));
+  decoded.result(8).value = 7;
+  decoded.result(10).error = Error::HYPERSPACE_FILE_NOT_FOUND;
+  buf.resize(decoded.encoded_length_results());
+  ptr = buf.data();
+  decoded.encode_results(&ptr);
+  HT_ASSERT(ptr == buf.data() + buf.size());
+
+  decode_ptr = buf.data();
+  remain = buf.size();
+  request.decode_results(&decode_ptr, &remain);
+  HT_ASSERT(remain == 0);
+  for (size_t i=0; i<request.size(); i++) {
+    HT_ASSERT(request.result(i).error == decoded.result(i).error);
+    HT_ASSERT(request.result(i).flag == decoded.result(i).flag);
+    HT_ASSERT(request.result(i).value == decoded.result(i).value);
+    HT_ASSERT(request.result(i).data == decoded.result(i).data);
+  }
+  HT_ASSERT(request.result(10).error == Error::HYPERSPACE_FILE_NOT_FOUND);
+
+  // results that do not match the operations are rejected
+  CompoundRequest other;
+  other.exists("/hypertable");
+  decode_ptr = buf.data();
+  remain = buf.size();
+  try {
+    other.decode_results(&decode_ptr, &remain);
+    HT_ASSERT(!"decode_results() accepted mismatched results");
+  }
+  catch (Exception &e) {
+    HT_ASSERT(e.code() == Error::PROTOCOL_ERROR);
+  }
+
+  // truncated operations are rejected
+  buf.resize(request.encoded_length());
+  ptr = buf.data();
+  request.encode(&ptr);
+  decode_ptr = buf.data();
+  remain = buf.size() - 1;
+  try {
+    decoded.decode(&decode_ptr, &remain);
+    HT_ASSERT(!"decode() accepted truncated operations");
+  }
+  catch (Exception &e) {
+    HT_ASSERT(e.code() == Error::SERIALIZATION_INPUT_OVERRUN);
+  }
+
+  // counts larger than the remaining bytes could hold are rejected before
+  // anything is allocated for them
+  buf.resize(request.encoded_length());
+  ptr = buf.data();
+  request.encode(&ptr);
+  for (size_t offset : { (size_t)0, (size_t)(4 + 1 + 4 + 4) +
+        encoded_length_vstr(request.operation(0).name) +
+        encoded_length_vstr(request.operation(0).attr) }) {
+    vector<uint8_t> bad(buf);
+    uint8_t *count_ptr = bad.data() + offset;
+    encode_i32(&count_ptr, 0x7fffffff);
+    decode_ptr = bad.data();
+    remain = bad.size();
+    try {
+      decoded.decode(&decode_ptr, &remain);
+      HT_ASSERT(!"decode() accepted an oversized count");
+    }
+    catch (Exception &e) {
+      HT_ASSERT(e.code() == Error::PROTOCOL_ERROR);
+    }
+  }
+
+  // empty request
+  CompoundRequest empty;
+  HT_ASSERT(empty.empty());
+  buf.resize(empty.encoded_length());
+  ptr = buf.data();
+  empty.encode(&ptr);
+  decode_ptr = buf.data();
+  remain = buf.size();
+  decoded.decode(&decode_ptr, &remain);
+  HT_ASSERT(decoded.empty() && remain == 0);
+
+  return 0;
+}
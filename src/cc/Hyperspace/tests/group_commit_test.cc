@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <Common/Compat.h>
+
+#include <Hyperspace/GroupCommit.h>
+
+#include <Common/Error.h>
+#include <Common/Logger.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace Hypertable;
+using namespace Hyperspace;
+using namespace std;
+
+namespace {
+
+  const int THREADS = 16;
+  const int COMMITS = 50;
+
+  /// Simulated log: commit records are appended to #written and become
+  /// durable when a flush copies #written to #durable
+  struct Log {
+    atomic<uint64_t> written {};
+    atomic<uint64_t> durable {};
+    atomic<uint64_t> flushes {};
+    atomic<bool> fail {};
+    void flush() {
+      uint64_t position = written;
+      this_thread::sleep_for(chrono::microseconds(200));
+      flushes++;
+      if (fail)
+        throw DbException("injected log flush failure", EIO);
+      uint64_t current = durable;
+      while (current < position &&
+             !durable.compare_exchange_weak(current, position))
+        ;
+    }
+  };
+
+  PropertiesPtr make_properties(int32_t window, int32_t max_batch) {
+    PropertiesPtr props = make_shared<Properties>();
+    props->set("Hyperspace.GroupCommit.Window", (gInt32t)window);
+    props->set("Hyperspace.GroupCommit.MaxBatch", (gInt32t)max_batch);
+    return props;
+  }
+
+}
+
+int main(int argc, char **argv) {
+
+  // concurrent commits are durable when sync() returns and share flushes
+  {
+    Log log;
+    PropertiesPtr props = make_properties(1, 8);
+    GroupCommit group_commit(props, [&log]() { log.flush(); });
+    atomic<int> not_durable {};
+    vector<thread> threads;
+    for (int i=0; i<THREADS; i++)
+      threads.push_back(thread([&]() {
+            for (int j=0; j<COMMITS; j++) {
+              uint64_t position = ++log.written;
+              group_commit.sync();
+              if (log.durable < position)
+                not_durable++;
+            }
+          }));
+    for (auto &t : threads)
+      t.join();
+    HT_ASSERT(not_durable == 0);
+    GroupCommit::Statistics stats;
+    group_commit.get_statistics(&stats);
+    HT_ASSERT(stats.commits == THREADS * COMMITS);
+    HT_ASSERT(stats.flushes == log.flushes);
+    HT_ASSERT(stats.flushes < stats.commits);
+    HT_ASSERT(stats.max_batch > 1 && stats.max_batch <= (uint64_t)THREADS);
+    HT_ASSERT(stats.failed_flushes == 0);
+  }
+
+  // a failed flush is reported to every commit in its batch and the next
+  // commit starts a new flush
+  {
+    Log log;
+    PropertiesPtr props = make_properties(50, THREADS);
+    GroupCommit group_commit(props, [&log]() { log.flush(); });
+    log.fail = true;
+    atomic<int> errors {};
+    vector<thread> threads;
+    for (int i=0; i<THREADS; i++)
+      threads.push_back(thread([&]() {
+            ++log.written;
+            try {
+              group_commit.sync();
+            }
+            catch (Exception &e) {
+              HT_ASSERT(e.code() == Error::HYPERSPACE_BERKELEYDB_ERROR);
+              errors++;
+            }
+          }));
+    for (auto &t : threads)
+      t.join();
+    HT_ASSERT(errors == THREADS);
+    HT_ASSERT(log.durable == 0);
+
+    log.fail = false;
+    uint64_t position = ++log.written;
+    group_commit.sync();
+    HT_ASSERT(log.durable >= position);
+
+    GroupCommit::Statistics stats;
+    group_commit.get_statistics(&stats);
+    HT_ASSERT(stats.failed_flushes >= 1);
+    HT_ASSERT(stats.flushes == 1 && stats.commits == 1);
+  }
+
+  return 0;
+}
@@ -46,14 +46,18 @@ namespace {
   bool desc_inited = false;
 
   PropertiesDesc 
-	  compressor_desc("  bmz|lzo|quicklz|zlib|snappy|zstd|none [compressor_options]\n\n"
+	  compressor_desc("  bmz|lz4|lzo|quicklz|zlib|snappy|zstd|zstd_dict|none [compressor_options]\n\n"
 		  "compressor_options"),
     bloomfilter_desc("  rows|rows+cols|none [bloomfilter_options]\n\n"
                       "  Default bloom filter is defined by the config property:\n"
                       "  Hypertable.RangeServer.CellStore.DefaultBloomFilter.\n\n"
-                      "bloomfilter_options");
+                      "bloomfilter_options"),
+    compaction_policy_desc("  default|size-tiered|time-window "
+                           "[compaction_policy_options]\n\n"
+                           "compaction_policy_options");
 
-  PropertiesDesc compressor_hidden_desc, bloomfilter_hidden_desc;
+  PropertiesDesc compressor_hidden_desc, bloomfilter_hidden_desc,
+    compaction_policy_hidden_desc;
 
   void init_schema_options_desc() {
     lock_guard<mutex> lock(desc_mutex);
@@ -62,15 +66,16 @@ namespace {
       return;
 
     compressor_desc.add_options()
-	    ("ultra,20", "Highest setting (probably slower) for zstd")
-	    ("best,9", "Highest setting (probably slower) for zlib, zstd")
-      ("normal", "Normal setting for zlib, zstd")
+	    ("ultra,20", "Highest setting (probably slower) for zstd, zstd_dict")
+	    ("best,9", "Highest setting (probably slower) for zlib, zstd, zstd_dict")
+      ("normal", "Normal setting for lz4, zlib, zstd, zstd_dict")
+      ("fast", i32(1), "Acceleration factor for lz4")
       ("fp-len", i16(19), "Minimum fingerprint length for bmz")
       ("offset", i16(0), "Starting fingerprint offset for bmz")
       ;
     compressor_hidden_desc.add_options()
       ("compressor-type", str(), 
-       "Compressor type (bmz|lzo|quicklz|zlib|snappy|zstd|none)")
+       "Compressor type (bmz|lz4|lzo|quicklz|zlib|snappy|zstd|zstd_dict|none)")
        ("compressor-type", 1);
 
     bloomfilter_desc.add_options()
@@ -88,6 +93,18 @@ namespace {
       ("bloom-filter-mode", 1);
       // ("bloom-filter-mode", eNum<ConfBloomFilterMode>(0)
       ;
+
+    compaction_policy_desc.add_options()
+      ("min-threshold", i32(4), "Minimum number of cell stores in a merge run")
+      ("max-threshold", i32(32), "Maximum number of cell stores in a merge run")
+      ("size-ratio", f64(2.0), "Maximum size ratio between cell stores of the "
+       "same tier (size-tiered)")
+      ("window", i32(86400), "Time window size in seconds (time-window)")
+      ;
+    compaction_policy_hidden_desc.add_options()
+      ("compaction-policy-type", str(),
+       "Compaction policy type (default|size-tiered|time-window)")
+      ("compaction-policy-type", 1);
   
     desc_inited = true;
   }
@@ -129,6 +146,20 @@ namespace {
     }
   }
 
+  void validate_compaction_policy(const std::string &compaction_policy) {
+    if (compaction_policy.empty())
+      return;
+
+    try {
+      PropertiesPtr props = make_shared<Properties>();
+      AccessGroupOptions::parse_compaction_policy(compaction_policy, props);
+    }
+    catch (Exception &e) {
+      HT_THROWF(Error::SCHEMA_PARSE_ERROR, "Invalid compaction policy spec - %s",
+                compaction_policy.c_str());
+    }
+  }
+
 } // local namespace
 
 
@@ -170,6 +201,16 @@ bool AccessGroupOptions::is_set_bloom_filter() const {
   return m_isset.test(BLOOMFILTER);
 }
 
+void AccessGroupOptions::set_compaction_policy(const std::string &compaction_policy) {
+  validate_compaction_policy(compaction_policy);
+  m_compaction_policy = compaction_policy;
+  m_isset.set(COMPACTION_POLICY);
+}
+
+bool AccessGroupOptions::is_set_compaction_policy() const {
+  return m_isset.test(COMPACTION_POLICY);
+}
+
 void AccessGroupOptions::set_in_memory(bool value) {
   m_in_memory = value;
   m_isset.set(IN_MEMORY);
@@ -188,6 +229,8 @@ void AccessGroupOptions::merge(const AccessGroupOptions &other) {
     set_compressor(other.get_compressor());
   if (!is_set_bloom_filter() && other.is_set_bloom_filter())
     set_bloom_filter(other.get_bloom_filter());
+  if (!is_set_compaction_policy() && other.is_set_compaction_policy())
+    set_compaction_policy(other.get_compaction_policy());
   if (!is_set_in_memory() && other.is_set_in_memory())
     set_in_memory(other.get_in_memory());
 }
@@ -208,6 +251,8 @@ namespace {
         m_options->set_compressor(content);
       else if (!strcasecmp(name, "BloomFilter"))
         m_options->set_bloom_filter(content);
+      else if (!strcasecmp(name, "CompactionPolicy"))
+        m_options->set_compaction_policy(content);
       else if (!strcasecmp(name, "InMemory"))
         m_options->set_in_memory(content_to_bool(name, content));
       else if (!m_element_stack.empty())
@@ -239,6 +284,9 @@ const std::string AccessGroupOptions::render_xml(const std::string &line_prefix)
   if (is_set_bloom_filter())
     xstr += format("%s<BloomFilter>%s</BloomFilter>\n",
                    line_prefix.c_str(), m_bloomfilter.c_str());
+  if (is_set_compaction_policy())
+    xstr += format("%s<CompactionPolicy>%s</CompactionPolicy>\n",
+                   line_prefix.c_str(), m_compaction_policy.c_str());
   if (is_set_in_memory())
     xstr += format("%s<InMemory>%s</InMemory>\n",
                    line_prefix.c_str(), m_in_memory ? "true" : "false");
@@ -255,6 +303,8 @@ const std::string AccessGroupOptions::render_hql() const {
     hstr += format(" COMPRESSOR \"%s\"", m_compressor.c_str());
   if (is_set_bloom_filter())
     hstr += format(" BLOOMFILTER \"%s\"", m_bloomfilter.c_str());
+  if (is_set_compaction_policy())
+    hstr += format(" COMPACTION_POLICY \"%s\"", m_compaction_policy.c_str());
   if (is_set_in_memory())
     hstr += format(" IN_MEMORY %s", m_in_memory ? "true" : "false");
   return hstr;
@@ -266,6 +316,7 @@ bool AccessGroupOptions::operator==(const AccessGroupOptions &other) const {
           m_blocksize == other.m_blocksize &&
           m_compressor == other.m_compressor &&
           m_bloomfilter == other.m_bloomfilter &&
+          m_compaction_policy == other.m_compaction_policy &&
           m_in_memory == other.m_in_memory);
 }
 
@@ -295,6 +346,37 @@ void AccessGroupOptions::parse_bloom_filter(const std::string &spec, PropertiesP
                  mode.c_str());
 }
 
+void AccessGroupOptions::parse_compaction_policy(const std::string &spec,
+                                                 PropertiesPtr &props) {
+
+  init_schema_options_desc();
+
+  vector<std::string> args;
+  boost::split(args, spec, boost::is_any_of(" \t"));
+  HT_TRY("parsing compaction policy spec",
+         props->parse_args(args, compaction_policy_desc,
+                           &compaction_policy_hidden_desc));
+
+  std::string type = props->get_str("compaction-policy-type");
+  if (type != "default" && type != "size-tiered" && type != "time-window")
+    HT_THROWF(Error::BAD_SCHEMA, "unknown compaction policy: '%s'",
+              type.c_str());
+
+  if (props->get_i32("min-threshold") < 2)
+    HT_THROWF(Error::BAD_SCHEMA, "compaction policy min-threshold (%d) "
+              "must be at least 2", props->get_i32("min-threshold"));
+  if (props->get_i32("max-threshold") < props->get_i32("min-threshold"))
+    HT_THROWF(Error::BAD_SCHEMA, "compaction policy max-threshold (%d) "
+              "is less than min-threshold (%d)", props->get_i32("max-threshold"),
+              props->get_i32("min-threshold"));
+  if (props->get_f64("size-ratio") < 1.0)
+    HT_THROWF(Error::BAD_SCHEMA, "compaction policy size-ratio (%f) "
+              "must be at least 1.0", props->get_f64("size-ratio"));
+  if (props->get_i32("window") <= 0)
+    HT_THROWF(Error::BAD_SCHEMA, "compaction policy window (%d) "
+              "must be positive", props->get_i32("window"));
+}
+
 AccessGroupSpec::~AccessGroupSpec() {
   for (auto cf_spec : m_columns)
     delete cf_spec;
@@ -394,6 +476,17 @@ const std::string &AccessGroupSpec::get_option_bloom_filter() const {
   return m_options.get_bloom_filter();
 }
 
+void AccessGroupSpec::set_option_compaction_policy(const std::string &compaction_policy) {
+  if (!m_options.is_set_compaction_policy() ||
+      m_options.get_compaction_policy() != compaction_policy)
+    m_generation = 0;
+  m_options.set_compaction_policy(compaction_policy);
+}
+
+const std::string &AccessGroupSpec::get_option_compaction_policy() const {
+  return m_options.get_compaction_policy();
+}
+
 void AccessGroupSpec::set_option_in_memory(bool value) {
   if (!m_options.is_set_in_memory() ||
       m_options.get_in_memory() != value)
@@ -85,6 +85,8 @@ namespace Hypertable {
       BLOOMFILTER,
       /// <i>in memory</i> bit
       IN_MEMORY,
+      /// <i>compaction policy</i> bit
+      COMPACTION_POLICY,
       /// Total bit count
       MAX
     };
@@ -182,6 +184,40 @@ namespace Hypertable {
     /// otherwise.
     bool is_set_bloom_filter() const;
 
+    /// Sets <i>compaction policy</i> option.
+    /// Sets the COMPACTION_POLICY bit of #m_isset, validates the specification
+    /// given in the <code>compaction_policy</code> argument, and if it is
+    /// valid, sets #m_compaction_policy to <code>compaction_policy</code>.  The
+    /// following compaction policy specifications are valid:
+    /// <pre>
+    /// policy:
+    ///   default [options]
+    ///   size-tiered [options]
+    ///   time-window [options]
+    ///
+    /// options:
+    ///   --min-threshold &lt;int&gt;
+    ///   --max-threshold &lt;int&gt;
+    ///   --size-ratio &lt;float&gt;
+    ///   --window &lt;seconds&gt;
+    /// </pre>
+    /// @param compaction_policy Compaction policy specification
+    /// @throws Exception with code set to Error::SCHEMA_PARSE_ERROR
+    /// if compaction policy specification is invalid
+    void set_compaction_policy(const std::string &compaction_policy);
+
+    /// Gets <i>compaction policy</i> option.
+    /// @return <i>compaction policy</i> option.
+    const std::string &get_compaction_policy() const {
+      return m_compaction_policy;
+    }
+
+    /// Checks if <i>compaction policy</i> option is set.
+    /// This method returns the value of the COMPACTION_POLICY bit of #m_isset.
+    /// @return <i>true</i> if <i>compaction policy</i> option is set,
+    /// <i>false</i> otherwise.
+    bool is_set_compaction_policy() const;
+
     /// Sets <i>in memory</i> option.
     /// Sets the IN_MEMORY bit of #m_isset and sets #m_in_memory to
     /// <code>value</code>.
@@ -219,6 +255,7 @@ namespace Hypertable {
      *   <Compressor>zlib --best</Compressor>
      *   <BloomFilter>rows+cols --false-positive 0.02 --bits-per-item 9
      *                --num-hashes 7 --max-approx-items 900</BloomFilter>
+     *   <CompactionPolicy>time-window --window 86400</CompactionPolicy>
      *   <InMemory>true</InMemory>
      * </Options>
      * @endverbatim
@@ -242,6 +279,7 @@ namespace Hypertable {
      *   <Compressor>zlib --best</Compressor>
      *   <BloomFilter>rows+cols --false-positive 0.02 --bits-per-item 9
      *                --num-hashes 7 --max-approx-items 900</BloomFilter>
+     *   <CompactionPolicy>time-window --window 86400</CompactionPolicy>
      *   <InMemory>true</InMemory>
      * @endverbatim
      * @param line_prefix std::string to prepend to each line of output
@@ -256,7 +294,7 @@ namespace Hypertable {
     /// specification is the same.  The following shows an example of the HQL
     /// output produced by this member function.
     /// <pre>
-    /// REPLICATION 3 BLOCKSIZE 67108864 COMPRESSOR "zlib --best" BLOOMFILTER "rows+cols --false-positive 0.02" IN_MEMORY
+    /// REPLICATION 3 BLOCKSIZE 67108864 COMPRESSOR "zlib --best" BLOOMFILTER "rows+cols --false-positive 0.02" COMPACTION_POLICY "time-window --window 86400" IN_MEMORY
     /// </pre>
     /// @return std::string representing options in HQL format
     const std::string render_hql() const;
@@ -308,6 +346,55 @@ namespace Hypertable {
     /// @param props Properties object to populate
     static void parse_bloom_filter(const std::string &spec, PropertiesPtr &props);
 
+    /// Parses a compaction policy specification and sets properties.
+    /// Parses the compaction policy specification given in <code>spec</code>
+    /// and populates <code>props</code> with the corresponding properties
+    /// described in the following table.
+    /// <table>
+    /// <tr>
+    /// <th>%Property</th>
+    /// <th>Type</th>
+    /// <th>Default</th>
+    /// <th>Description</th>
+    /// </tr>
+    /// <tr>
+    /// <td>compaction-policy-type</td>
+    /// <td>string</td>
+    /// <td><i>none</i></td>
+    /// <td>Policy (default|size-tiered|time-window)</td>
+    /// </tr>
+    /// <tr>
+    /// <td>min-threshold</td>
+    /// <td>int</td>
+    /// <td>4</td>
+    /// <td>Minimum number of cell stores in a merge run</td>
+    /// </tr>
+    /// <tr>
+    /// <td>max-threshold</td>
+    /// <td>int</td>
+    /// <td>32</td>
+    /// <td>Maximum number of cell stores in a merge run</td>
+    /// </tr>
+    /// <tr>
+    /// <td>size-ratio</td>
+    /// <td>float</td>
+    /// <td>2.0</td>
+    /// <td>Maximum size ratio between cell stores of the same tier</td>
+    /// </tr>
+    /// <tr>
+    /// <td>window</td>
+    /// <td>int</td>
+    /// <td>86400</td>
+    /// <td>Time window size in seconds</td>
+    /// </tr>
+    /// </table>
+    /// @param spec Compaction policy specification
+    /// @param props Properties object to populate
+    /// @throws Exception with code set to Error::BAD_SCHEMA if the policy type
+    /// is unknown or an option is out of range
+    static void parse_compaction_policy(const std::string &spec,
+                                        PropertiesPtr &props);
+
     /// Equality operator.
     /// @param other Other object to which comparison is to be made
     /// @return <i>true</i> if this object is equal to <code>other</code>,
@@ -328,6 +415,9 @@ namespace Hypertable {
     /// Bloom filter specification
     std::string m_bloomfilter;
 
+    /// Compaction policy specification
+    std::string m_compaction_policy;
+
     /// In memory
     bool m_in_memory {};
 
@@ -428,6 +518,19 @@ namespace Hypertable {
     /// @return <i>bloom filter</i> option.
     const std::string &get_option_bloom_filter() const;
 
+    /// Sets <i>compaction policy</i> option.
+    /// Sets the <i>compaction policy</i> option of the #m_options member to
+    /// <code>compaction_policy</code> by calling
+    /// AccessGroupOptions::set_compaction_policy().
+    /// @param compaction_policy Compaction policy specification
+    /// @throws Exception with code set to Error::SCHEMA_PARSE_ERROR
+    /// if compaction policy specification is invalid
+    void set_option_compaction_policy(const std::string &compaction_policy);
+
+    /// Gets <i>compaction policy</i> option.
+    /// @return <i>compaction policy</i> option.
+    const std::string &get_option_compaction_policy() const;
+
     /// Sets <i>in memory</i> option.
     /// Sets the <i>in memory</i> option of the #m_options member to
     /// <code>value</code>
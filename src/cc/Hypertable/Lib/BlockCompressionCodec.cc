@@ -38,7 +38,9 @@ namespace {
     "lzo",
     "quicklz",
 	"snappy",
-	"zstd"
+	"zstd",
+    "lz4",
+    "zstd_dict"
   };
 }
 
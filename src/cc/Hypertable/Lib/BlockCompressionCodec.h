@@ -57,7 +57,9 @@ namespace Hypertable {
       QUICKLZ=4,  ///< QuickLZ 1.5 compession
 	  SNAPPY=5,   ///< Snappy compression
 	  ZSTD=6,     ///< Zstandard compression
-      COMPRESSION_TYPE_LIMIT=7  ///< Limit of compression types
+      LZ4=7,      ///< LZ4 compression
+      ZSTD_DICT=8, ///< Zstandard compression with a trained dictionary
+      COMPRESSION_TYPE_LIMIT=9  ///< Limit of compression types
     };
 
     /// Compression codec argument vector.
@@ -0,0 +1,141 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Definitions for BlockCompressionCodecLz4.
+/// This file contains definitions for BlockCompressionCodecLz4, a class
+/// for compressing blocks using the LZ4 compression algorithm.
+
+#include <Common/Compat.h>
+
+#include "BlockCompressionCodecLz4.h"
+
+#include <Common/DynamicBuffer.h>
+#include <Common/Logger.h>
+#include <Common/Checksum.h>
+
+#include <cstdlib>
+
+using namespace Hypertable;
+
+void BlockCompressionCodecLz4::set_args(const Args &args) {
+  for (auto it = args.begin(); it != args.end(); ++it) {
+    if (*it == "--normal")
+      m_acceleration = 1;
+    else if (*it == "--fast" || it->compare(0, 7, "--fast=") == 0) {
+      if (*it == "--fast") {
+        if (++it == args.end())
+          HT_THROW(Error::BLOCK_COMPRESSOR_INVALID_ARG,
+                   "Missing value for lz4 codec argument --fast");
+        m_acceleration = atoi(it->c_str());
+      }
+      else
+        m_acceleration = atoi(it->c_str() + 7);
+      if (m_acceleration < 1)
+        HT_THROWF(Error::BLOCK_COMPRESSOR_INVALID_ARG, "Invalid argument "
+                  "to lz4 codec: '%s'", it->c_str());
+    }
+    else
+      HT_THROWF(Error::BLOCK_COMPRESSOR_INVALID_ARG, "Unrecognized argument "
+                "to lz4 codec: '%s'", it->c_str());
+  }
+}
+
+void
+BlockCompressionCodecLz4::deflate(const DynamicBuffer &input,
+    DynamicBuffer &output, BlockHeader &header, size_t reserve) {
+  int bound = LZ4_compressBound((int)input.fill());
+  output.reserve(header.encoded_length() + bound + reserve);
+
+  int outlen = LZ4_compress_fast((const char *)input.base,
+                                 (char *)output.base+header.encoded_length(),
+                                 (int)input.fill(), bound, m_acceleration);
+
+  if (outlen <= 0 && input.fill() > 0)
+    HT_THROWF(Error::BLOCK_COMPRESSOR_DEFLATE_ERROR,
+              "Compressed block deflate error, length=%lu", (Lu)input.fill());
+
+  HT_ASSERT(outlen+reserve <= output.size);
+
+  /* check for an incompressible block */
+  if ((size_t)outlen >= input.fill()) {
+    header.set_compression_type(NONE);
+    memcpy(output.base+header.encoded_length(), input.base, input.fill());
+    header.set_data_length(input.fill());
+    header.set_data_zlength(input.fill());
+  }
+  else {
+    header.set_compression_type(LZ4);
+    header.set_data_length(input.fill());
+    header.set_data_zlength(outlen);
+  }
+
+  header.set_data_checksum(fletcher32(output.base + header.encoded_length(),
+                header.get_data_zlength()));
+
+  output.ptr = output.base;
+  header.encode(&output.ptr);
+  output.ptr += header.get_data_zlength();
+}
+
+void
+BlockCompressionCodecLz4::inflate(const DynamicBuffer &input,
+    DynamicBuffer &output, BlockHeader &header) {
+  const uint8_t *msg_ptr = input.base;
+  size_t remaining = input.fill();
+
+  header.decode(&msg_ptr, &remaining);
+
+  if (header.get_data_zlength() > remaining)
+    HT_THROWF(Error::BLOCK_COMPRESSOR_BAD_HEADER, "Block decompression error, "
+              "header zlength = %lu, actual = %lu",
+              (Lu)header.get_data_zlength(), (Lu)remaining);
+
+  uint32_t checksum = fletcher32(msg_ptr, header.get_data_zlength());
+
+  if (checksum != header.get_data_checksum())
+    HT_THROWF(Error::BLOCK_COMPRESSOR_CHECKSUM_MISMATCH, "Compressed block "
+              "checksum mismatch header=%lx, computed=%lx",
+              (Lu)header.get_data_checksum(), (Lu)checksum);
+
+  try {
+    output.reserve(header.get_data_length());
+
+    // check compress bit
+    if (header.get_compression_type() == NONE)
+      memcpy(output.base, msg_ptr, header.get_data_length());
+    else {
+      int len = LZ4_decompress_safe((const char *)msg_ptr,
+                                    (char *)output.base,
+                                    (int)header.get_data_zlength(),
+                                    (int)header.get_data_length());
+      if (len < 0 || (uint32_t)len != header.get_data_length())
+        HT_THROWF(Error::BLOCK_COMPRESSOR_INFLATE_ERROR, "%s",
+                "Compressed block inflate error");
+    }
+
+    output.ptr = output.base + header.get_data_length();
+  }
+  catch (Exception &e) {
+    output.free();
+    throw;
+  }
+}
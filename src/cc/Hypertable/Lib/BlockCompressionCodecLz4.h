@@ -0,0 +1,124 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Declarations for BlockCompressionCodecLz4.
+/// This file contains declarations for BlockCompressionCodecLz4, a class
+/// for compressing blocks using the LZ4 compression algorithm.
+
+#ifndef HYPERTABLE_BLOCKCOMPRESSIONCODECLZ4_H
+#define HYPERTABLE_BLOCKCOMPRESSIONCODECLZ4_H
+
+#include <Hypertable/Lib/BlockCompressionCodec.h>
+
+extern "C" {
+#include <lz4.h>
+}
+
+namespace Hypertable {
+
+  /// @addtogroup libHypertable
+  /// @{
+
+  /// Block compressor that uses the LZ4 algorithm.
+  /// This class provides a way to compress and decompress blocks of data using
+  /// the <i>lz4</i> algorithm, a general purpose compression algorithm with
+  /// very fast decompression, which makes it a good fit for read-heavy
+  /// tables.
+  class BlockCompressionCodecLz4 : public BlockCompressionCodec {
+
+  public:
+
+    /// Constructor.
+    /// @param args Arguments to control compression behavior
+    /// @throws Exception Code set to Error::BLOCK_COMPRESSOR_INVALID_ARG
+    BlockCompressionCodecLz4(const Args &args) { set_args(args); }
+
+    /// Destructor.
+    virtual ~BlockCompressionCodecLz4() { }
+
+    /// Sets arguments to control compression behavior.
+    /// The arguments accepted by this method are described in the following
+    /// table.
+    /// <table>
+    /// <tr>
+    /// <th>Argument</th><th>Description</th>
+    /// </tr>
+    /// <tr>
+    /// <td><code>--fast</code> <i>n</i> </td><td>Acceleration factor, higher
+    /// values trade compression ratio for speed (default is 1)</td>
+    /// </tr>
+    /// <tr>
+    /// <td><code>--normal</code> </td><td>Acceleration factor 1</td>
+    /// </tr>
+    /// </table>
+    /// @param args Vector of arguments
+    virtual void set_args(const Args &args);
+
+    /// Compresses a buffer using the LZ4 algorithm.
+    /// This method reserves enough space in <code>output</code> to hold the
+    /// serialized <code>header</code> followed by the compressed input followed
+    /// by <code>reserve</code> bytes.  If the resulting compressed buffer is
+    /// larger than the input buffer, then the input buffer is copied directly
+    /// to the output buffer and the compression type is set to
+    /// BlockCompressionCodec::NONE.  Before serailizing <code>header</code>,
+    /// the <i>data_length</i>, <i>data_zlength</i>, <i>data_checksum</i>, and
+    /// <i>compression_type</i> fields are set appropriately.  The output buffer
+    /// is formatted as follows:
+    /// <table>
+    /// <tr>
+    /// <td>header</td><td>compressed data</td><td>reserve</td>
+    /// </tr>
+    /// </table>
+    /// @param input Input buffer
+    /// @param output Output buffer
+    /// @param header Block header populated by function
+    /// @param reserve Additional space to reserve at end of <code>output</code>
+    ///   buffer
+    virtual void deflate(const DynamicBuffer &input, DynamicBuffer &output,
+                         BlockHeader &header, size_t reserve=0);
+
+    /// Decompresses a buffer compressed with the LZ4 algorithm.
+    /// @see deflate() for description of input buffer %format
+    /// @param input Input buffer
+    /// @param output Output buffer
+    /// @param header Block header
+    virtual void inflate(const DynamicBuffer &input, DynamicBuffer &output,
+                         BlockHeader &header);
+
+    /// Returns enum value representing compression type LZ4.
+    /// Returns the enum value LZ4
+    /// @see BlockCompressionCodec::LZ4
+    /// @return Compression type (LZ4)
+    virtual int get_type() { return LZ4; }
+
+  private:
+
+    /// Acceleration factor passed to LZ4_compress_fast()
+    int m_acceleration {1};
+  };
+
+  /// @}
+
+}
+
+#endif // HYPERTABLE_BLOCKCOMPRESSIONCODECLZ4_H
+
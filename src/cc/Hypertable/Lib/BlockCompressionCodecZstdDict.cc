@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Definitions for BlockCompressionCodecZstdDict.
+/// This file contains definitions for BlockCompressionCodecZstdDict, a class
+/// for compressing blocks using the ZSTD compression algorithm with a trained
+/// dictionary, and ZstdDictionary, the dictionary shared by those codecs.
+
+#include <Common/Compat.h>
+
+#include "BlockCompressionCodecZstdDict.h"
+
+#include <Common/DynamicBuffer.h>
+#include <Common/Logger.h>
+#include <Common/Checksum.h>
+
+extern "C" {
+#include <zdict.h>
+}
+
+#include <vector>
+
+using namespace Hypertable;
+
+ZstdDictionary::ZstdDictionary(const uint8_t *buf, size_t len)
+  : m_data((const char *)buf, len) {
+  m_ddict = ZSTD_createDDict(m_data.data(), m_data.size());
+  if (m_ddict == nullptr)
+    HT_THROWF(Error::BLOCK_COMPRESSOR_INIT_ERROR,
+              "Unable to load %lu byte zstd dictionary", (Lu)len);
+}
+
+ZstdDictionary::~ZstdDictionary() {
+  ZSTD_freeDDict(m_ddict);
+}
+
+ZstdDictionaryPtr ZstdDictionary::train(const uint8_t *buf, size_t len,
+                                        size_t sample_size, size_t capacity) {
+  std::vector<size_t> sample_sizes;
+
+  HT_ASSERT(sample_size > 0);
+
+  for (size_t offset = 0; offset < len; offset += sample_size)
+    sample_sizes.push_back(std::min(sample_size, len - offset));
+
+  std::string dict(capacity, '\0');
+  size_t dict_len = ZDICT_trainFromBuffer(&dict[0], capacity, buf,
+                                          sample_sizes.data(),
+                                          (unsigned)sample_sizes.size());
+  if (ZDICT_isError(dict_len)) {
+    HT_INFOF("Unable to train zstd dictionary from %lu bytes - %s",
+             (Lu)len, ZDICT_getErrorName(dict_len));
+    return ZstdDictionaryPtr();
+  }
+
+  return std::make_shared<ZstdDictionary>((const uint8_t *)dict.data(),
+                                          dict_len);
+}
+
+
+BlockCompressionCodecZstdDict::BlockCompressionCodecZstdDict(const Args &args)
+  : m_level(ZSTD_CLEVEL_DEFAULT) {
+  set_args(args);
+}
+
+BlockCompressionCodecZstdDict::~BlockCompressionCodecZstdDict() {
+  ZSTD_freeCDict(m_cdict);
+  ZSTD_freeCCtx(m_cctx);
+  ZSTD_freeDCtx(m_dctx);
+}
+
+void BlockCompressionCodecZstdDict::set_args(const Args &args) {
+  for (const auto &arg : args) {
+    if (arg == "--ultra" || arg == "-20")
+      m_level = ZSTD_maxCLevel();
+    else if (arg == "--best" || arg == "-9")
+      m_level = 9;
+    else if (arg == "--normal")
+      m_level = ZSTD_CLEVEL_DEFAULT;
+    else
+      HT_THROWF(Error::BLOCK_COMPRESSOR_INVALID_ARG, "Unrecognized argument "
+                "to zstd_dict codec: '%s'", arg.c_str());
+  }
+  if (m_cdict) {
+    ZSTD_freeCDict(m_cdict);
+    m_cdict = nullptr;
+  }
+}
+
+void
+BlockCompressionCodecZstdDict::set_dictionary(ZstdDictionaryPtr dictionary) {
+  if (m_cdict) {
+    ZSTD_freeCDict(m_cdict);
+    m_cdict = nullptr;
+  }
+  m_dictionary = dictionary;
+}
+
+void
+BlockCompressionCodecZstdDict::deflate(const DynamicBuffer &input,
+    DynamicBuffer &output, BlockHeader &header, size_t reserve) {
+  size_t bound = ZSTD_compressBound(input.fill());
+  size_t outlen;
+
+  output.reserve(header.encoded_length() + bound + reserve);
+
+  if (m_cctx == nullptr && (m_cctx = ZSTD_createCCtx()) == nullptr)
+    HT_THROW(Error::BLOCK_COMPRESSOR_INIT_ERROR,
+             "Unable to create zstd compression context");
+
+  if (m_dictionary) {
+    if (m_cdict == nullptr &&
+        (m_cdict = ZSTD_createCDict(m_dictionary->data(), m_dictionary->size(),
+                                    m_level)) == nullptr)
+      HT_THROW(Error::BLOCK_COMPRESSOR_INIT_ERROR,
+               "Unable to digest zstd dictionary");
+    outlen = ZSTD_compress_usingCDict(m_cctx,
+                                      output.base + header.encoded_length(),
+                                      bound, input.base, input.fill(),
+                                      m_cdict);
+  }
+  else
+    outlen = ZSTD_compressCCtx(m_cctx, output.base + header.encoded_length(),
+                               bound, input.base, input.fill(), m_level);
+
+  if (ZSTD_isError(outlen))
+    HT_THROWF(Error::BLOCK_COMPRESSOR_DEFLATE_ERROR,
+              "Compressed block deflate error, name=%s",
+              ZSTD_getErrorName(outlen));
+
+  HT_ASSERT(outlen+reserve <= output.size);
+
+  /* check for an incompressible block */
+  if (outlen >= input.fill()) {
+    header.set_compression_type(NONE);
+    memcpy(output.base+header.encoded_length(), input.base, input.fill());
+    header.set_data_length(input.fill());
+    header.set_data_zlength(input.fill());
+  }
+  else {
+    header.set_compression_type(ZSTD_DICT);
+    header.set_data_length(input.fill());
+    header.set_data_zlength(outlen);
+  }
+
+  header.set_data_checksum(fletcher32(output.base + header.encoded_length(),
+                header.get_data_zlength()));
+
+  output.ptr = output.base;
+  header.encode(&output.ptr);
+  output.ptr += header.get_data_zlength();
+}
+
+
+void
+BlockCompressionCodecZstdDict::inflate(const DynamicBuffer &input,
+    DynamicBuffer &output, BlockHeader &header) {
+  const uint8_t *msg_ptr = input.base;
+  size_t remaining = input.fill();
+
+  header.decode(&msg_ptr, &remaining);
+
+  if (header.get_data_zlength() > remaining)
+    HT_THROWF(Error::BLOCK_COMPRESSOR_BAD_HEADER, "Block decompression error, "
+              "header zlength = %lu, actual = %lu",
+              (Lu)header.get_data_zlength(), (Lu)remaining);
+
+  uint32_t checksum = fletcher32(msg_ptr, header.get_data_zlength());
+
+  if (checksum != header.get_data_checksum())
+    HT_THROWF(Error::BLOCK_COMPRESSOR_CHECKSUM_MISMATCH, "Compressed block "
+              "checksum mismatch header=%lx, computed=%lx",
+              (Lu)header.get_data_checksum(), (Lu)checksum);
+
+  try {
+    output.reserve(header.get_data_length());
+
+    // check compress bit
+    if (header.get_compression_type() == NONE)
+      memcpy(output.base, msg_ptr, header.get_data_length());
+    else {
+      if (m_dctx == nullptr && (m_dctx = ZSTD_createDCtx()) == nullptr)
+        HT_THROW(Error::BLOCK_COMPRESSOR_INIT_ERROR,
+                 "Unable to create zstd decompression context");
+
+      size_t len;
+      if (m_dictionary)
+        len = ZSTD_decompress_usingDDict(m_dctx, output.base,
+                                         header.get_data_length(), msg_ptr,
+                                         header.get_data_zlength(),
+                                         m_dictionary->ddict());
+      else
+        len = ZSTD_decompressDCtx(m_dctx, output.base,
+                                  header.get_data_length(), msg_ptr,
+                                  header.get_data_zlength());
+
+      if (ZSTD_isError(len))
+        HT_THROWF(Error::BLOCK_COMPRESSOR_INFLATE_ERROR,
+                  "Compressed block inflate error, name=%s",
+                  ZSTD_getErrorName(len));
+      if (len != header.get_data_length())
+        HT_THROWF(Error::BLOCK_COMPRESSOR_INFLATE_ERROR,
+                  "Compressed block inflate error, length %lu != %lu",
+                  (Lu)len, (Lu)header.get_data_length());
+    }
+
+    output.ptr = output.base + header.get_data_length();
+  }
+  catch (Exception &e) {
+    output.free();
+    throw;
+  }
+}
@@ -0,0 +1,191 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Declarations for BlockCompressionCodecZstdDict.
+/// This file contains declarations for BlockCompressionCodecZstdDict, a class
+/// for compressing blocks using the ZSTD compression algorithm with a trained
+/// dictionary, and ZstdDictionary, the dictionary shared by those codecs.
+
+#ifndef Hypertable_Lib_BlockCompressionCodecZstdDict_h
+#define Hypertable_Lib_BlockCompressionCodecZstdDict_h
+
+#include <Hypertable/Lib/BlockCompressionCodec.h>
+
+extern "C" {
+#include <zstd.h>
+}
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Hypertable {
+
+  /// @addtogroup libHypertable
+  /// @{
+
+  class ZstdDictionary;
+
+  /// Smart pointer to ZstdDictionary
+  typedef std::shared_ptr<ZstdDictionary> ZstdDictionaryPtr;
+
+  /// Trained ZSTD compression dictionary.
+  /// Holds the raw dictionary along with the digested decompression
+  /// dictionary, which is built once and can then be shared by any number of
+  /// codecs, including codecs used concurrently by different threads.
+  class ZstdDictionary {
+  public:
+
+    /// Constructor.
+    /// Copies the raw dictionary and digests it for decompression.
+    /// @param buf Raw dictionary
+    /// @param len Length of raw dictionary
+    /// @throws Exception Code set to Error::BLOCK_COMPRESSOR_INIT_ERROR
+    ZstdDictionary(const uint8_t *buf, size_t len);
+
+    /// Destructor.
+    ~ZstdDictionary();
+
+    /// Trains a dictionary.
+    /// <code>buf</code> is split into samples of <code>sample_size</code>
+    /// bytes from which a dictionary of up to <code>capacity</code> bytes is
+    /// trained.
+    /// @param buf Sample data
+    /// @param len Length of sample data
+    /// @param sample_size Size of each sample
+    /// @param capacity Maximum dictionary size
+    /// @return Trained dictionary or null if there was not enough sample data
+    static ZstdDictionaryPtr train(const uint8_t *buf, size_t len,
+                                   size_t sample_size, size_t capacity);
+
+    /// Gets raw dictionary.
+    /// @return Pointer to raw dictionary
+    const uint8_t *data() const { return (const uint8_t *)m_data.data(); }
+
+    /// Gets raw dictionary size.
+    /// @return Size of raw dictionary
+    size_t size() const { return m_data.size(); }
+
+    /// Gets dictionary ID.
+    /// @return Dictionary ID
+    uint32_t id() const { return ZSTD_getDictID_fromDDict(m_ddict); }
+
+    /// Gets digested decompression dictionary.
+    /// @return Decompression dictionary
+    const ZSTD_DDict *ddict() const { return m_ddict; }
+
+    /// Gets memory used by dictionary.
+    /// @return Memory used in bytes
+    size_t memory_used() const {
+      return m_data.size() + ZSTD_sizeof_DDict(m_ddict);
+    }
+
+  private:
+
+    /// Raw dictionary
+    std::string m_data;
+
+    /// Decompression dictionary
+    ZSTD_DDict *m_ddict {};
+  };
+
+  /// Block compressor that uses the ZSTD algorithm with a dictionary.
+  /// Small blocks of repetitive data, such as JSON values, compress poorly
+  /// on their own because every block starts with an empty history.  This
+  /// codec primes each block with a dictionary trained from similar data
+  /// (see ZstdDictionary::train()).  Without a dictionary it behaves like
+  /// BlockCompressionCodecZstd.  The dictionary is not stored in the
+  /// compressed blocks, so the codec that inflates a block must be given the
+  /// dictionary that was used to deflate it.
+  class BlockCompressionCodecZstdDict : public BlockCompressionCodec {
+
+  public:
+
+    /// Constructor.
+    /// @param args Arguments to control compression behavior
+    /// @throws Exception Code set to Error::BLOCK_COMPRESSOR_INVALID_ARG
+    BlockCompressionCodecZstdDict(const Args &args);
+
+    /// Destructor.
+    virtual ~BlockCompressionCodecZstdDict();
+
+    /// Sets arguments to control compression behavior.
+    /// Accepts the same arguments as BlockCompressionCodecZstd::set_args().
+    /// @param args Vector of arguments
+    virtual void set_args(const Args &args);
+
+    /// Sets the dictionary.
+    /// @param dictionary Dictionary, or null to compress without one
+    void set_dictionary(ZstdDictionaryPtr dictionary);
+
+    /// Gets the dictionary.
+    /// @return Dictionary, or null if none is set
+    ZstdDictionaryPtr get_dictionary() { return m_dictionary; }
+
+    /// Compresses a buffer using the ZSTD algorithm and the dictionary.
+    /// @see BlockCompressionCodecZstd::deflate() for description of output
+    /// buffer %format
+    /// @param input Input buffer
+    /// @param output Output buffer
+    /// @param header Block header populated by function
+    /// @param reserve Additional space to reserve at end of <code>output</code>
+    ///   buffer
+    virtual void deflate(const DynamicBuffer &input, DynamicBuffer &output,
+                         BlockHeader &header, size_t reserve=0);
+
+    /// Decompresses a buffer compressed with the ZSTD algorithm.
+    /// @see deflate() for description of input buffer %format
+    /// @param input Input buffer
+    /// @param output Output buffer
+    /// @param header Block header
+    virtual void inflate(const DynamicBuffer &input, DynamicBuffer &output,
+                         BlockHeader &header);
+
+    /// Returns enum value representing compression type ZSTD_DICT.
+    /// Returns the enum value ZSTD_DICT
+    /// @see BlockCompressionCodec::ZSTD_DICT
+    /// @return Compression type (ZSTD_DICT)
+    virtual int get_type() { return ZSTD_DICT; }
+
+  private:
+
+    /// Dictionary
+    ZstdDictionaryPtr m_dictionary;
+
+    /// Compression dictionary digested at #m_level, created on first deflate
+    ZSTD_CDict *m_cdict {};
+
+    /// Compression context
+    ZSTD_CCtx *m_cctx {};
+
+    /// Decompression context
+    ZSTD_DCtx *m_dctx {};
+
+    /// Compression level
+    int m_level;
+  };
+
+  /// @}
+
+}
+
+#endif // Hypertable_Lib_BlockCompressionCodecZstdDict_h
@@ -34,6 +34,7 @@
 #include <boost/shared_ptr.hpp>
 
 #include <bitset>
+#include <cstring>
 #include <memory>
 #include <vector>
 
@@ -99,7 +100,8 @@ namespace Hypertable {
 
     /// Default constructor.
     CellPredicate() :
-      cutoff_time(0), max_versions(0), counter(false), indexed(false) { }
+      cutoff_time(0), max_versions(0), counter(false), indexed(false),
+      pushdown(false) { }
 
     void all_matches(const char *qualifier, size_t qualifier_len,
                      const char* value, size_t value_len,
@@ -139,16 +141,8 @@ namespace Hypertable {
             return false;
         }
         else if (cp->operation & ColumnPredicate::QUALIFIER_PREFIX_MATCH) {
-          if (qualifier_len < cp->qualifier_len)
-            return false;
-          const char *p1 = qualifier;
-          const char *p2 = cp->qualifier;
-          const char *prefix_end = cp->qualifier + cp->qualifier_len;
-          for (; p2 < prefix_end; ++p1,++p2) {
-            if (*p1 != *p2)
-              break;
-          }
-          if (p2 != prefix_end)
+          if (qualifier_len < cp->qualifier_len ||
+              memcmp(qualifier, cp->qualifier, cp->qualifier_len))
             return false;
         }
         else if (cp->operation & ColumnPredicate::QUALIFIER_REGEX_MATCH) {
@@ -179,8 +173,19 @@ namespace Hypertable {
 
     void add_column_predicate(const ColumnPredicate &column_predicate, size_t id) {
       patterns.push_back(std::make_shared<CellPattern>(column_predicate, id));
+      if (column_predicate.operation & ColumnPredicate::VALUE_MATCH)
+        value_patterns = true;
     }
 
+    /// Checks if any patterns have been added.
+    /// @return <i>true</i> if predicate has patterns, <i>false</i> otherwise
+    bool has_patterns() const { return !patterns.empty(); }
+
+    /// Checks if any pattern matches against the cell value.
+    /// @return <i>true</i> if evaluating the predicate requires the cell
+    /// value, <i>false</i> otherwise
+    bool has_value_patterns() const { return value_patterns; }
+
     /// TTL cutoff time
     int64_t cutoff_time;
 
@@ -193,10 +198,17 @@ namespace Hypertable {
     /// Column family is indexed
     bool indexed;
 
+    /// Predicate can be evaluated by the cell store and cell cache scanners
+    /// before cells reach the merge
+    bool pushdown;
+
   private:
 
     /// Vector of patterns used in predicate match
     std::vector<CellPatternPtr> patterns;
+
+    /// At least one pattern in #patterns matches against the value
+    bool value_patterns {};
   };
 
   /// @}
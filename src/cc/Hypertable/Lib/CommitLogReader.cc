@@ -113,7 +113,15 @@ CommitLogReader::next_raw_block(CommitLogBlockInfo *infop,
     delete info->block_stream;
     info->block_stream = 0;
 
-    if (m_revision == TIMESTAMP_MIN) {
+    if (m_revisions_deferred) {
+      // Revisions of data blocks are added by add_revision() once they have
+      // been inflated, so empty fragments are dropped by finish_compressed()
+      lock_guard<mutex> lock(m_mutex);
+      if (m_revision > info->revision)
+        info->revision = m_revision;
+      m_fragment_queue_offset++;
+    }
+    else if (m_revision == TIMESTAMP_MIN) {
       if (m_verbose)
         HT_INFOF("Skipping log fragment '%s/%u' because unable to read any "
                  " valid blocks", info->log_dir.c_str(), info->num);
@@ -134,8 +142,11 @@ CommitLogReader::next_raw_block(CommitLogBlockInfo *infop,
     m_linked_log_hashes.insert(md5_hash(log_dir.c_str()));
     m_linked_logs.insert(log_dir);
     load_fragments(log_dir, *fragment_queue_iter);
-    if (header->get_revision() > m_latest_revision)
-      m_latest_revision = header->get_revision();
+    {
+      lock_guard<mutex> lock(m_mutex);
+      if (header->get_revision() > m_latest_revision)
+        m_latest_revision = header->get_revision();
+    }
     if (header->get_revision() > m_revision)
       m_revision = header->get_revision();
     goto try_again;
@@ -208,6 +219,68 @@ CommitLogReader::next(const uint8_t **blockp, size_t *lenp,
 }
 
 
+bool
+CommitLogReader::next_compressed(DynamicBuffer &zblock,
+                                 BlockHeaderCommitLog *header,
+                                 CommitLogFileInfo **fragmentp) {
+  CommitLogBlockInfo binfo;
+
+  m_revisions_deferred = true;
+
+  while (next_raw_block(&binfo, header)) {
+
+    if (binfo.error == Error::OK) {
+      zblock.clear();
+      zblock.ensure(binfo.block_len);
+      zblock.add_unchecked(binfo.block_ptr, binfo.block_len);
+      *fragmentp = m_fragment_queue[m_fragment_queue_offset];
+      return true;
+    }
+
+    LogFragmentQueue::iterator iter = m_fragment_queue.begin() + m_fragment_queue_offset;
+    HT_WARNF("Corruption detected in CommitLog fragment %s starting at "
+             "postion %lld for %lld bytes - %s",
+             (*iter)->block_stream->get_fname().c_str(),
+             (Lld)binfo.start_offset, (Lld)(binfo.end_offset
+             - binfo.start_offset), Error::get_text(binfo.error));
+  }
+
+  return false;
+}
+
+
+void CommitLogReader::add_revision(CommitLogFileInfo *fragment,
+                                   int64_t revision) {
+  lock_guard<mutex> lock(m_mutex);
+  if (revision > m_latest_revision)
+    m_latest_revision = revision;
+  if (revision > fragment->revision)
+    fragment->revision = revision;
+}
+
+
+void CommitLogReader::finish_compressed() {
+  lock_guard<mutex> lock(m_mutex);
+  HT_ASSERT(m_fragment_queue_offset == m_fragment_queue.size());
+  for (auto iter = m_fragment_queue.begin(); iter != m_fragment_queue.end(); ) {
+    // Fragment revisions start at zero, so only fragments without a single
+    // inflated block or link are left there
+    if ((*iter)->revision <= 0) {
+      if (m_verbose)
+        HT_INFOF("Skipping log fragment '%s/%u' because unable to read any "
+                 " valid blocks", (*iter)->log_dir.c_str(), (*iter)->num);
+      iter = m_fragment_queue.erase(iter);
+    }
+    else
+      ++iter;
+  }
+  m_fragment_queue_offset = m_fragment_queue.size();
+
+  struct LtClfip swo;
+  sort(m_fragment_queue.begin(), m_fragment_queue.end(), swo);
+}
+
+
 void CommitLogReader::load_fragments(String log_dir, CommitLogFileInfo *parent) {
   vector<Filesystem::Dirent> listing;
   CommitLogFileInfo *fi;
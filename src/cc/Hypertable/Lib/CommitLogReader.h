@@ -66,12 +66,43 @@ namespace Hypertable {
     bool next(const uint8_t **blockp, size_t *lenp,
               BlockHeaderCommitLog *);
 
+    /// Fetches next block without decompressing it.
+    /// Behaves like next(), except that the compressed block is copied into
+    /// <code>zblock</code> so that it can be inflated by the caller (e.g. on
+    /// another thread) with a codec created for
+    /// <code>header->get_compression_type()</code>.  Corrupt blocks are
+    /// skipped.  The block's revision is not recorded until the caller has
+    /// inflated it and passed it to add_revision(), and the fragment queue is
+    /// not finalized until finish_compressed() is called, so callers must not
+    /// mix calls to this function and next().
+    /// @param zblock Buffer to hold compressed block
+    /// @param header Address of header object to hold block header
+    /// @param fragmentp Address of pointer to hold fragment containing block
+    /// @return <i>true</i> if block was read, <i>false</i> if end of log
+    bool next_compressed(DynamicBuffer &zblock, BlockHeaderCommitLog *header,
+                         CommitLogFileInfo **fragmentp);
+
+    /// Records revision of a block returned by next_compressed().
+    /// Must only be called for blocks that were inflated successfully.  May
+    /// be called from any thread, concurrently with next_compressed().
+    /// @param fragment Fragment containing block
+    /// @param revision Revision from block header
+    void add_revision(CommitLogFileInfo *fragment, int64_t revision);
+
+    /// Finalizes the fragment queue after a replay with next_compressed().
+    /// Drops fragments for which no revision was recorded and sorts the
+    /// remaining ones by revision, as next() does at end of log.  Must be
+    /// called after next_compressed() returned <i>false</i> and after all
+    /// calls to add_revision().
+    void finish_compressed();
+
     void reset() {
       m_fragment_queue_offset = 0;
       m_block_buffer.clear();
       m_revision = TIMESTAMP_MIN;
       m_latest_revision = TIMESTAMP_MIN;
       m_error_map.clear();
+      m_revisions_deferred = false;
     }
 
     void get_linked_logs(StringSet &linked_logs) {
@@ -106,6 +137,10 @@ namespace Hypertable {
     std::string                 m_last_fragment_fname;
     int32_t                m_last_fragment_id {};
     bool                   m_verbose {};
+
+    /// Block revisions are recorded by add_revision() (set by
+    /// next_compressed())
+    bool                   m_revisions_deferred {};
   };
 
   /// Smart pointer to CommitLogReader
@@ -148,6 +148,8 @@ namespace {
         fprintf(stderr, " Bytes scanned:  %lld\n", (Lld)profile_data.bytes_scanned);
         fprintf(stderr, "Bytes returned:  %lld\n", (Lld)profile_data.bytes_returned);
         fprintf(stderr, "     Disk read:  %lld\n", (Lld)profile_data.disk_read);
+        fprintf(stderr, "Filtered early:  %lld\n", (Lld)profile_data.cells_filtered_pushdown);
+        fprintf(stderr, "Filtered merge:  %lld\n", (Lld)profile_data.cells_filtered_merge);
         fprintf(stderr, "   Scan blocks:  %d\n", (int)profile_data.scanblocks);
         fprintf(stderr, "  Sub scanners:  %d\n", (int)profile_data.subscanners);
         string servers;
@@ -82,6 +82,7 @@ namespace {
     "REPLAY LOG ............ Replay a commit log",
     "REPLAY COMMIT ......... Commit replay",
     "SHUTDOWN   ............ Shutdown the RangeServer",
+    "STATUS ................ Checks RangeServer status",
     "UPDATE ................ Selects (and display) cells from a table",
     "WAIT FOR MAINTENANCE .. Blocks until maintenance queue is empty",
     "",
@@ -361,6 +362,7 @@ namespace {
     "      | REPLICATION int",
     "      | COMPRESSOR compressor_spec",
     "      | BLOOMFILTER bloom_filter_spec",
+    "      | COMPACTION_POLICY compaction_policy_spec",
     "",
     "    access_group_options:",
     "      column_family_option | access_group_option",
@@ -372,6 +374,8 @@ namespace {
     "      | snappy",
 	"      | zlib [ zlib_options ]",
 	"      | zstd [ zstd_options ]",
+    "      | zstd_dict [ zstd_options ]",
+    "      | lz4 [ --fast int ]",
     "      | none",
     "",
     "    bmz_options:",
@@ -539,6 +543,7 @@ namespace {
     "      | REPLICATION int",
     "      | COMPRESSOR compressor_spec",
     "      | BLOOMFILTER bloom_filter_spec",
+    "      | COMPACTION_POLICY compaction_policy_spec",
     "",
     "    access_group_options:",
     "      column_family_option | access_group_option",
@@ -771,6 +776,7 @@ namespace {
     "  * REPLICATION int",
     "  * COMPRESSOR compressor_spec",
     "  * BLOOMFILTER bloom_filter_spec",
+    "  * COMPACTION_POLICY compaction_policy_spec",
     "",
     "Any of the column family options may be specified as access group options.",
     "Column family options specified as access group options are taken to be",
@@ -847,6 +853,35 @@ namespace {
     "  --max-approx-items arg  Number of cell store items used to guess the number",
     "                          of actual bloom filter entries (default = 1000)",
     "",
+    "The COMPACTION_POLICY option selects how the cell stores of an access group",
+    "are chosen for merging compactions.  The compaction policy specification can",
+    "take one of the following forms.",
+    "",
+    "  * default [ compaction_policy_options ]",
+    "  * size-tiered [ compaction_policy_options ]",
+    "  * time-window [ compaction_policy_options ]",
+    "",
+    "The default policy merges runs of small cell stores as governed by the",
+    "Hypertable.RangeServer.CellStore properties.  The size-tiered policy merges",
+    "runs of cell stores of similar size, so each cell is rewritten roughly once",
+    "per tier.  The time-window policy groups cell stores by the timestamps of the",
+    "cells they contain and never merges cell stores from different windows, which",
+    "lets whole cell stores be dropped once their contents have expired (TTL).",
+    "",
+    "The following describes the compaction policy options:",
+    "",
+    "  --min-threshold arg     Minimum number of cell stores in a merge run",
+    "                          (default = 4)",
+    "",
+    "  --max-threshold arg     Maximum number of cell stores in a merge run",
+    "                          (default = 32)",
+    "",
+    "  --size-ratio arg        Maximum size ratio between cell stores of the same",
+    "                          tier, size-tiered only (default = 2.0)",
+    "",
+    "  --window arg            Window size in seconds, time-window only",
+    "                          (default = 86400)",
+    "",
     "Compressors",
     "-----------",
     "",
@@ -860,6 +895,8 @@ namespace {
     "  * zlib",
 	"  * snappy",
     "  * zstd",
+    "  * zstd_dict",
+    "  * lz4",
     "  * none",
     "",
     "The default code is snappy for cell store blocks.  The following list ",
@@ -871,6 +908,12 @@ namespace {
     "  zlib --normal        Normal compression ratio",
     "  zstd -9 [ --best ]   Highest compression ratio (at the cost of speed)",
     "  zstd -20 [ --ultra ] Highest compression ratio (at the cost of speed)",
+    "  lz4 --fast arg       Acceleration factor, trades ratio for speed (default = 1)",
+    "",
+    "The zstd_dict codec compresses cell store blocks with a dictionary that is",
+    "trained from the first blocks written by each compaction and stored in the",
+    "cell store.  It accepts the same options as zstd and works best for small",
+    "blocks of repetitive values such as JSON.",
     "",
     "Table Options",
     "-------------",
@@ -1962,6 +2005,8 @@ namespace {
     "    options_spec:",
     "      (MAX_VERSIONS revision_count",
     "      | INTO FILE filename[.gz]",
+    "      | INTO DIRECTORY dirname",
+    "      | PARALLEL <n>",
     "      | BUCKETS <n>",
     "      | FS = '<char>'",
     "      | NO_ESCAPE",
@@ -2008,6 +2053,23 @@ namespace {
     "If the file name specified ends in a .gz extension, then the output is compressed",
     "with gzip before it is written to the file.",
     "",
+    "INTO DIRECTORY [file://|fs://]dirname",
+    "",
+    "Dumps the table into one file per range, scanning several ranges at once.",
+    "The ranges are read from the METADATA table and recorded in a file named",
+    "'ranges' in the directory.  The cells of the n-th range are written in row",
+    "order to part-n.tsv, so concatenating the part files in name order yields",
+    "output sorted by row key.  If the dump is interrupted, running the same",
+    "command again resumes it, skipping the ranges whose part file already",
+    "exists.  A dump is only resumed with the same table, WHERE clause and",
+    "output options it was started with.  The BUCKETS option is ignored and",
+    "INTO FILE may not be combined with this option.",
+    "",
+    "PARALLEL <n>",
+    "",
+    "Number of ranges scanned at once by DUMP TABLE ... INTO DIRECTORY",
+    "(default is 8).",
+    "",
     "BUCKETS <n>",
     "",
     "This option causes the DUMP TABLE command to use <n> buckets.  The default is",
@@ -2141,6 +2203,27 @@ namespace {
     0
   };
 
+  const char *help_text_rsclient_status[] = {
+    "",
+    "STATUS",
+    "======",
+    "",
+    "    STATUS [LATENCY]",
+    "",
+    "Description",
+    "-----------",
+    "",
+    "The STATUS command performs a status check of the RangeServer.  If the",
+    "LATENCY option is supplied, the RangeServer also reports latency",
+    "histograms for the update pipeline stages, scanner creation, scan block",
+    "fetches, block cache misses, and request queue wait time.  For each",
+    "histogram the sample count and the mean, 50th, 90th, 99th, 99.9th",
+    "percentile and maximum latency in milliseconds since server start are",
+    "shown.",
+    "",
+    0
+  };
+
   typedef std::unordered_map<std::string, const char **>  HelpTextMap;
 
   HelpTextMap &build_help_text_map() {
@@ -2215,6 +2298,7 @@ void HqlHelpText::install_range_server_client_text() {
   text_map["load range"] = help_text_load_range;
   text_map["update"] = help_text_update;
   text_map["shutdown"] = help_text_shutdown_rangeserver;
+  text_map["status"] = help_text_rsclient_status;
 }
 
 
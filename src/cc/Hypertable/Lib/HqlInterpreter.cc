@@ -30,8 +30,10 @@
 #include <Hypertable/Lib/LoadDataEscape.h>
 #include <Hypertable/Lib/LoadDataFlags.h>
 #include <Hypertable/Lib/LoadDataSource.h>
+#include <Hypertable/Lib/LoadDataSourceChunk.h>
 #include <Hypertable/Lib/LoadDataSourceFactory.h>
 #include <Hypertable/Lib/Namespace.h>
+#include <Hypertable/Lib/ParallelTableDumper.h>
 #include <Hypertable/Lib/ScanSpec.h>
 #include <Hypertable/Lib/Schema.h>
 #include <Hypertable/Lib/TableSplit.h>
@@ -52,11 +54,19 @@
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/device/null.hpp>
 
+#include <condition_variable>
 #include <cstdio>
 #include <cstring>
 #include <ctime>
-#include <sstream>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 using namespace std;
 using namespace Hypertable;
@@ -398,12 +408,66 @@ cmd_select(NamespacePtr &ns, ConnectionManagerPtr &conn_manager,
 }
 
 
+/// Dumps a table into one file per range (DUMP TABLE ... INTO DIRECTORY).
+int
+cmd_dump_table_parallel(NamespacePtr &ns, ConnectionManagerPtr &conn_manager,
+                        FsBroker::Lib::ClientPtr &fs_client,
+                        ParserState &state, HqlInterpreter::Callback &cb) {
+  string dir = state.scan.outdir;
+  FsBroker::Lib::ClientPtr dir_fs_client;
+  ParallelTableDumper::Format format;
+
+  if (!state.scan.outfile.empty())
+    HT_THROW(Error::HQL_PARSE_ERROR,
+             "INTO FILE and INTO DIRECTORY are mutually exclusive");
+
+  FileUtils::expand_tilde(dir);
+
+  if (boost::algorithm::starts_with(dir, "dfs://") ||
+      boost::algorithm::starts_with(dir, "fs://")) {
+    // init Fs client if not done yet
+    if (!fs_client)
+      fs_client = std::make_shared<FsBroker::Lib::Client>(conn_manager, Config::properties);
+    dir_fs_client = fs_client;
+    dir = dir.substr(dir.find("://") + 3);
+  }
+  else if (boost::algorithm::starts_with(dir, "file://"))
+    dir = dir.substr(7);
+
+  if (state.field_separator)
+    format.field_separator = state.field_separator;
+  format.escape = state.escape;
+  format.display_timestamps = state.scan.display_timestamps;
+
+  size_t parallelism = state.scan.parallel ? state.scan.parallel : 8;
+
+  ParallelTableDumper dumper(ns, state.table_name, state.scan.builder.get(),
+                             dir, dir_fs_client, parallelism, format);
+
+  dumper.run();
+
+  if (cb.normal_mode) {
+    cb.total_cells += dumper.total_cells();
+    cb.total_keys_size += dumper.total_keys_size();
+    cb.total_values_size += dumper.total_values_size();
+  }
+
+  cb.on_finish();
+  return 0;
+}
+
 int
 cmd_dump_table(NamespacePtr &ns,
                ConnectionManagerPtr &conn_manager, FsBroker::Lib::ClientPtr &fs_client,
                ParserState &state, HqlInterpreter::Callback &cb) {
   if (!ns)
     HT_THROW(Error::BAD_NAMESPACE, "Null namespace");
+
+  if (!state.scan.outdir.empty())
+    return cmd_dump_table_parallel(ns, conn_manager, fs_client, state, cb);
+  if (state.scan.parallel)
+    HT_THROW(Error::HQL_PARSE_ERROR, "PARALLEL requires INTO DIRECTORY");
+
   TablePtr table;
   boost::iostreams::filtering_ostream fout;
   FILE *outf = cb.output;
@@ -519,9 +583,204 @@ cmd_dump_table(NamespacePtr &ns,
   return 0;
 }
 
+/// Chunk of input lines handed from the reader to a LOAD DATA worker.
+struct LoadDataChunk {
+  DynamicBuffer buf;
+  int64_t start_line {};
+  ::uint64_t consumed {};
+};
+
+/// Loads LOAD DATA INFILE input into a table using multiple threads.
+/// The calling thread reads the input in chunks of whole lines with
+/// LoadDataSource::next_chunk() and queues them for <code>threads</code>
+/// workers.  Each worker parses its chunks with a LoadDataSourceChunk and
+/// feeds its own TableMutator.  The first worker uses <code>mutator</code>,
+/// which is left unflushed for Callback::on_finish(); the others are
+/// flushed by their workers.  Cells are loaded in no particular order.
+/// Progress is reported from the calling thread as chunks complete.  The
+/// first error encountered stops all threads and is rethrown.
+/// @param lds Initialized load data source
+/// @param table Destination table
+/// @param mutator Mutator for the first worker
+/// @param mutator_flags Flags for creating the other workers' mutators
+/// @param state Parser state
+/// @param cb Interpreter callback
+/// @param threads Number of worker threads
+/// @param report_progress Function to report consumed input bytes
+void load_data_parallel(LoadDataSourcePtr &lds, TablePtr &table,
+                        TableMutatorPtr &mutator, ::uint32_t mutator_flags,
+                        ParserState &state, HqlInterpreter::Callback &cb,
+                        int threads,
+                        std::function<void(::uint64_t)> report_progress) {
+  const size_t chunk_size = 4 * 1024 * 1024;
+  const size_t max_queued = 2 * threads;
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::deque<std::unique_ptr<LoadDataChunk>> queue;
+  std::exception_ptr error;
+  ::uint64_t completed_bytes {};
+  bool done {};
+  char fs = state.field_separator ? state.field_separator : '\t';
+  bool ignore_unknown_columns = LoadDataFlags::ignore_unknown_cfs(state.load_flags);
+
+  auto worker = [&](TableMutatorPtr worker_mutator) {
+    LoadDataSourceChunk parser(*lds);
+    KeySpec key;
+    ::uint8_t *value;
+    ::uint32_t value_len;
+    bool is_delete;
+    LoadDataEscape row_escaper;
+    LoadDataEscape qualifier_escaper;
+    LoadDataEscape value_escaper;
+    const char *escaped_buf;
+    size_t escaped_len;
+    ::uint64_t total_cells {}, total_keys_size {}, total_values_size {};
+
+    if (fs != '\t') {
+      row_escaper.set_field_separator(fs);
+      qualifier_escaper.set_field_separator(fs);
+      value_escaper.set_field_separator(fs);
+    }
+
+    try {
+      while (true) {
+        std::unique_ptr<LoadDataChunk> chunk;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          cond.wait(lock, [&]() { return !queue.empty() || done || error; });
+          if (error || queue.empty())
+            break;
+          chunk = std::move(queue.front());
+          queue.pop_front();
+          cond.notify_all();
+        }
+
+        parser.reset(chunk->buf, chunk->start_line);
+        try {
+          while (parser.next(&key, &value, &value_len, &is_delete, 0)) {
+
+            ++total_cells;
+            total_values_size += value_len;
+            total_keys_size += key.row_len;
+
+            if (state.escape) {
+              row_escaper.unescape((const char *)key.row, (size_t)key.row_len,
+                                   &escaped_buf, &escaped_len);
+              key.row = escaped_buf;
+              key.row_len = escaped_len;
+              qualifier_escaper.unescape(key.column_qualifier,
+                                         (size_t)key.column_qualifier_len,
+                                         &escaped_buf, &escaped_len);
+              key.column_qualifier = escaped_buf;
+              key.column_qualifier_len = escaped_len;
+              value_escaper.unescape((const char *)value, (size_t)value_len,
+                                     &escaped_buf, &escaped_len);
+            }
+            else {
+              escaped_buf = (const char *)value;
+              escaped_len = (size_t)value_len;
+            }
+
+            try {
+              if (ignore_unknown_columns &&
+                  !table->schema()->get_column_family(key.column_family))
+                continue;
+              if (is_delete)
+                worker_mutator->set_delete(key);
+              else
+                worker_mutator->set(key, escaped_buf, escaped_len);
+            }
+            catch (Exception &e) {
+              do {
+                worker_mutator->show_failed(e);
+              } while (!worker_mutator->retry());
+            }
+          }
+        }
+        catch (Exception &e) {
+          HT_THROW2F(e.code(), e, "line number %lld",
+                     (Lld)parser.get_current_lineno());
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        completed_bytes += chunk->consumed;
+      }
+
+      if (worker_mutator != mutator) {
+        try {
+          worker_mutator->flush();
+        }
+        catch (Exception &e) {
+          worker_mutator->show_failed(e);
+          throw;
+        }
+      }
+    }
+    catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!error)
+        error = std::current_exception();
+      cond.notify_all();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    cb.total_cells += total_cells;
+    cb.total_keys_size += total_keys_size;
+    cb.total_values_size += total_values_size;
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  workers.emplace_back(worker, mutator);
+  for (int i=1; i<threads; ++i)
+    workers.emplace_back(worker,
+                         TableMutatorPtr(table->create_mutator(0, mutator_flags)));
+
+  try {
+    while (true) {
+      auto chunk = std::make_unique<LoadDataChunk>();
+      if (!lds->next_chunk(chunk->buf, chunk_size, &chunk->start_line,
+                           &chunk->consumed))
+        break;
+      ::uint64_t completed;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&]() { return queue.size() < max_queued || error; });
+        if (error)
+          break;
+        queue.push_back(std::move(chunk));
+        cond.notify_all();
+        completed = completed_bytes;
+        completed_bytes = 0;
+      }
+      if (completed)
+        report_progress(completed);
+    }
+  }
+  catch (...) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!error)
+      error = std::current_exception();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    done = true;
+    cond.notify_all();
+  }
+
+  for (auto &thread : workers)
+    thread.join();
+
+  if (error)
+    std::rethrow_exception(error);
+
+  report_progress(completed_bytes);
+}
+
 int
 cmd_load_data(NamespacePtr &ns, ::uint32_t mutator_flags,
-              ConnectionManagerPtr &conn_manager, 
+              int32_t load_threads, ConnectionManagerPtr &conn_manager,
               FsBroker::Lib::ClientPtr &fs_client,
               ParserState &state, HqlInterpreter::Callback &cb) {
   if (!ns)
@@ -590,6 +849,29 @@ cmd_load_data(NamespacePtr &ns, ::uint32_t mutator_flags,
   else
     cb.on_update(cb.file_size);
 
+  auto report_progress = [&](::uint64_t amount) {
+    if (!cb.normal_mode || state.input_file_src == STDIN)
+      return;
+    if (largefile_mode) {
+      running_total += amount;
+      if (running_total >= consume_threshold) {
+        ::uint64_t megabytes = 1 + (running_total - consume_threshold)
+          / 1048576LL;
+        consume_threshold += megabytes * 1048576LL;
+        cb.on_progress(megabytes);
+      }
+    }
+    else
+      cb.on_progress(amount);
+  };
+
+  if (into_table && load_threads > 1) {
+    load_data_parallel(lds, table, mutator, mutator_flags, state, cb,
+                       load_threads, report_progress);
+    cb.on_finish(mutator);
+    return 0;
+  }
+
   if (!into_table) {
     display_timestamps = lds->has_timestamps();
     if (display_timestamps)
@@ -669,19 +951,7 @@ cmd_load_data(NamespacePtr &ns, ::uint32_t mutator_flags,
                << escaped_buf << "\n";
       }
 
-      if (cb.normal_mode && state.input_file_src != STDIN) {
-        if (largefile_mode == true) {
-          running_total += consumed;
-          if (running_total >= consume_threshold) {
-            consumed = 1 + (unsigned long)((running_total - consume_threshold) 
-                    / 1048576LL);
-            consume_threshold += (::uint64_t)consumed * 1048576LL;
-            cb.on_progress(consumed);
-          }
-        }
-        else
-          cb.on_progress(consumed);
-      }
+      report_progress(consumed);
     }
   }
   catch (Exception &e) {
@@ -953,9 +1223,11 @@ int cmd_close(Client *client, HqlInterpreter::Callback &cb) {
 
 HqlInterpreter::HqlInterpreter(Client *client, ConnectionManagerPtr &conn_manager,
     bool immutable_namespace) : m_client(client), m_mutator_flags(0),
-    m_conn_manager(conn_manager), m_fs_client(0), m_immutable_namespace(immutable_namespace) {
+    m_load_threads(1), m_conn_manager(conn_manager), m_fs_client(0), m_immutable_namespace(immutable_namespace) {
   if (Config::properties->get_bool("Hypertable.HqlInterpreter.Mutator.NoLogSync"))
     m_mutator_flags = Table::MUTATOR_FLAG_NO_LOG_SYNC;
+  m_load_threads =
+    Config::properties->get_i32("Hypertable.HqlInterpreter.LoadData.Threads");
 
 }
 
@@ -993,7 +1265,7 @@ int HqlInterpreter::execute(const string &line, Callback &cb) {
       return cmd_select(m_namespace, m_conn_manager, m_fs_client,
                         state, cb);
     case COMMAND_LOAD_DATA:
-      return cmd_load_data(m_namespace, m_mutator_flags,
+      return cmd_load_data(m_namespace, m_mutator_flags, m_load_threads,
                            m_conn_manager, m_fs_client, state, cb);
     case COMMAND_INSERT:
       return cmd_insert(m_namespace, state, cb);
@@ -144,6 +144,7 @@ namespace Hypertable {
     Client *m_client;
     NamespacePtr m_namespace;
     uint32_t m_mutator_flags;
+    int32_t m_load_threads;
     ConnectionManagerPtr m_conn_manager;
     FsBroker::Lib::ClientPtr m_fs_client;
     bool m_immutable_namespace;
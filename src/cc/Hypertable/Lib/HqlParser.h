@@ -265,6 +265,7 @@ namespace Hypertable {
 
       ScanSpecBuilder builder;
       std::string outfile;
+      std::string outdir;
       bool display_timestamps {};
       bool display_revisions {};
       bool keys_only {};
@@ -281,6 +282,7 @@ namespace Hypertable {
       int current_relop {};
       int last_boolean_op {BOOLOP_AND};
       int buckets {};
+      int parallel {};
     };
 
     class ParserState {
@@ -354,6 +356,7 @@ namespace Hypertable {
       ::int32_t row_uniquify_chars {};
       bool escape {true};
       bool nokeys {};
+      bool latency {};
       std::string current_rename_column_old_name;
       std::string current_column_family;
       std::string current_column_predicate_name;
@@ -1207,6 +1210,19 @@ namespace Hypertable {
       ParserState &state;
     };
 
+    struct set_compaction_policy {
+      set_compaction_policy(ParserState &state) : state(state) { }
+      void operator()(char const * str, char const *end) const {
+        std::string compaction_policy = strip_quotes(str, end-str);
+        to_lower(compaction_policy);
+        if (state.ag_spec)
+          state.ag_spec->set_option_compaction_policy(compaction_policy);
+        else
+          state.table_ag_defaults.set_compaction_policy(compaction_policy);
+      }
+      ParserState &state;
+    };
+
     struct access_group_add_column_family {
       access_group_add_column_family(ParserState &state) : state(state) { }
       void operator()(char const *str, char const *end) const {
@@ -1880,6 +1896,32 @@ namespace Hypertable {
       ParserState &state;
     };
 
+    struct scan_set_outdir {
+      scan_set_outdir(ParserState &state) : state(state) { }
+      void operator()(char const *str, char const *end) const {
+        if (state.scan.outdir != "")
+          HT_THROW(Error::HQL_PARSE_ERROR,
+                   "DUMP TABLE INTO DIRECTORY multiply defined.");
+        state.scan.outdir = String(str, end-str);
+        trim_if(state.scan.outdir, is_any_of("'\""));
+      }
+      ParserState &state;
+    };
+
+    struct scan_set_parallel {
+      scan_set_parallel(ParserState &state) : state(state) { }
+      void operator()(int ival) const {
+        if (state.scan.parallel != 0)
+          HT_THROW(Error::HQL_PARSE_ERROR,
+                   "DUMP TABLE PARALLEL option multiply defined.");
+        if (ival == 0)
+          HT_THROW(Error::HQL_PARSE_ERROR,
+                   "DUMP TABLE PARALLEL must be greater than zero.");
+        state.scan.parallel = ival;
+      }
+      ParserState &state;
+    };
+
     struct scan_set_year {
       scan_set_year(ParserState &state) : state(state) { }
       void operator()(int ival) const {
@@ -2343,6 +2385,14 @@ namespace Hypertable {
       ParserState &state;
     };
 
+    struct set_latency {
+      set_latency(ParserState &state) : state(state) { }
+      void operator()(char const *str, char const *end) const {
+        state.latency=true;
+      }
+      ParserState &state;
+    };
+
     struct set_flags_range_type {
       set_flags_range_type(ParserState &state) : state(state) { }
       void operator()(char const *str, char const *end) const {
@@ -2564,6 +2614,8 @@ namespace Hypertable {
           Token CELL_OFFSET  = as_lower_d["cell_offset"];
           Token INTO         = as_lower_d["into"];
           Token FILE         = as_lower_d["file"];
+          Token DIRECTORY    = as_lower_d["directory"];
+          Token PARALLEL     = as_lower_d["parallel"];
           Token LOAD         = as_lower_d["load"];
           Token DATA         = as_lower_d["data"];
           Token INFILE       = as_lower_d["infile"];
@@ -2606,6 +2658,7 @@ namespace Hypertable {
           Token COMMIT       = as_lower_d["commit"];
           Token LOG          = as_lower_d["log"];
           Token BLOOMFILTER  = as_lower_d["bloomfilter"];
+          Token COMPACTION_POLICY = as_lower_d["compaction_policy"];
           Token TRUE         = as_lower_d["true"];
           Token FALSE        = as_lower_d["false"];
           Token AND          = as_lower_d["and"];
@@ -2641,6 +2694,7 @@ namespace Hypertable {
           Token REBUILD      = as_lower_d["rebuild"];
           Token INDICES      = as_lower_d["indices"];
           Token STATUS       = as_lower_d["status"];
+          Token LATENCY      = as_lower_d["latency"];
 
           /**
            * Start grammar definition
@@ -2850,7 +2904,7 @@ namespace Hypertable {
             ;
 
           status_statement
-            = STATUS
+            = STATUS >> !(LATENCY[set_latency(self.state)])
             ;
 
           fetch_scanblock_statement
@@ -2888,6 +2942,8 @@ namespace Hypertable {
             | BUCKETS >> uint_p[scan_set_buckets(self.state)]
             | REVS >> !EQUAL >> uint_p[scan_set_max_versions(self.state)]
             | INTO >> FILE >> string_literal[scan_set_outfile(self.state)]
+            | INTO >> DIRECTORY >> string_literal[scan_set_outdir(self.state)]
+            | PARALLEL >> uint_p[scan_set_parallel(self.state)]
             | NO_TIMESTAMPS[scan_clear_display_timestamps(self.state)]
             | FS >> EQUAL >> single_string_literal[set_field_separator(self.state)]
             ;
@@ -3143,6 +3199,7 @@ namespace Hypertable {
             | COMPRESSOR >> *EQUAL >> string_literal[
                 set_compressor(self.state)]
             | bloom_filter_option
+            | compaction_policy_option
             ;
 
           bloom_filter_option
@@ -3150,6 +3207,11 @@ namespace Hypertable {
               >> string_literal[set_bloom_filter(self.state)]
             ;
 
+          compaction_policy_option
+            = COMPACTION_POLICY >> *EQUAL
+              >> string_literal[set_compaction_policy(self.state)]
+            ;
+
           in_memory_option
             = IN_MEMORY >> boolean_literal[set_in_memory(self.state)]
             | IN_MEMORY[set_in_memory(self.state)]
@@ -3437,6 +3499,7 @@ namespace Hypertable {
           BOOST_SPIRIT_DEBUG_RULE(index_definition);
           BOOST_SPIRIT_DEBUG_RULE(access_group_option);
           BOOST_SPIRIT_DEBUG_RULE(bloom_filter_option);
+          BOOST_SPIRIT_DEBUG_RULE(compaction_policy_option);
           BOOST_SPIRIT_DEBUG_RULE(in_memory_option);
           BOOST_SPIRIT_DEBUG_RULE(blocksize_option);
           BOOST_SPIRIT_DEBUG_RULE(replication_option);
@@ -3532,7 +3595,7 @@ namespace Hypertable {
           single_string_literal, double_string_literal, string_literal, 
           parameter_list, regexp_literal, ttl_option, counter_option, 
           access_group_definition, index_definition, access_group_option,
-          bloom_filter_option, in_memory_option,
+          bloom_filter_option, compaction_policy_option, in_memory_option,
           blocksize_option, replication_option, help_statement,
           describe_table_statement, show_statement, select_statement,
           where_clause, where_predicate,
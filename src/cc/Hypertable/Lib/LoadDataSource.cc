@@ -151,6 +151,24 @@ LoadDataSource::init(const std::vector<String> &key_columns,
   parse_header(header, key_columns, timestamp_column);
 }
 
+void LoadDataSource::copy_layout(const LoadDataSource &other) {
+  m_column_info = other.m_column_info;
+  m_key_comps = other.m_key_comps;
+  delete [] m_type_mask;
+  m_type_mask = new uint32_t [257];
+  memcpy(m_type_mask, other.m_type_mask, 257*sizeof(uint32_t));
+  m_hyperformat = other.m_hyperformat;
+  m_leading_timestamps = other.m_leading_timestamps;
+  m_timestamp_index = other.m_timestamp_index;
+  m_load_flags = other.m_load_flags;
+  m_field_separator = other.m_field_separator;
+  m_row_uniquify_chars = other.m_row_uniquify_chars;
+  if (m_row_uniquify_chars && !m_rsgen)
+    m_rsgen = new FixedRandomStringGenerator(m_row_uniquify_chars);
+  m_next_value = m_column_info.size();
+  m_limit = 0;
+}
+
 void
 LoadDataSource::parse_header(const string &header, 
                              const std::vector<String> &key_columns,
@@ -639,6 +657,29 @@ LoadDataSource::next(KeySpec *keyp, uint8_t **valuep, uint32_t *value_lenp,
   return false;
 }
 
+bool LoadDataSource::next_chunk(DynamicBuffer &chunk, size_t target_size,
+                                int64_t *start_linep, uint64_t *consumedp) {
+  string line;
+
+  chunk.clear();
+  *start_linep = m_cur_line;
+  *consumedp = 0;
+
+  while (chunk.fill() < target_size && get_next_line(line)) {
+    m_cur_line++;
+    chunk.ensure(line.length() + 1);
+    chunk.add_unchecked(line.c_str(), line.length());
+    chunk.add_unchecked("\n", 1);
+    if (!m_zipped)
+      *consumedp += line.length() + 1;
+  }
+
+  if (m_zipped)
+    *consumedp = incr_consumed();
+
+  return chunk.fill() > 0;
+}
+
 bool LoadDataSource::add_row_component(int index) 
 {
   const char *value = m_values[m_key_comps[index].index];
@@ -67,6 +67,22 @@ namespace Hypertable {
                       const std::string &timestamp_column,
                       char field_separator);
 
+    /// Reads a chunk of whole lines from the input.
+    /// Reads input lines into <code>chunk</code>, each one terminated by a
+    /// newline, until at least <code>target_size</code> bytes have been read
+    /// or the input is exhausted.  The chunk can then be parsed
+    /// independently of this source with a LoadDataSourceChunk.
+    /// @param chunk Buffer to hold the lines
+    /// @param target_size Minimum number of bytes to read
+    /// @param start_linep Address of variable to hold the current line number
+    /// before the first line of the chunk
+    /// @param consumedp Address of variable to hold the number of input
+    /// bytes consumed
+    /// @return <i>true</i> if any lines were read, <i>false</i> at end of
+    /// input
+    bool next_chunk(DynamicBuffer &chunk, size_t target_size,
+                    int64_t *start_linep, uint64_t *consumedp);
+
     int64_t get_current_lineno() { return m_cur_line; }
     unsigned long get_source_size() const { return m_source_size; }
 
@@ -88,6 +104,14 @@ namespace Hypertable {
                               const std::vector<String> &key_columns,
                               const std::string &timestamp_column);
     virtual void init_src()=0;
+
+    /// Copies the parsed header layout from another source.
+    /// Copies the column, key and timestamp layout established by
+    /// parse_header(), along with the load flags, so that this source
+    /// parses input lines exactly as <code>other</code> does.
+    /// @param other Initialized source from which to copy layout
+    void copy_layout(const LoadDataSource &other);
+
     virtual uint64_t incr_consumed()=0;
 
     bool should_skip(int idx, const uint32_t *masks) {
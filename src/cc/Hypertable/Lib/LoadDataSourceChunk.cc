@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Definitions for LoadDataSourceChunk.
+/// This file contains definitions for LoadDataSourceChunk, a class for
+/// parsing a chunk of LOAD DATA INFILE input lines.
+
+#include <Common/Compat.h>
+
+#include "LoadDataSourceChunk.h"
+
+#include <boost/iostreams/device/array.hpp>
+
+using namespace Hypertable;
+
+LoadDataSourceChunk::LoadDataSourceChunk(const LoadDataSource &source)
+  : LoadDataSource("") {
+  copy_layout(source);
+}
+
+void LoadDataSourceChunk::reset(const DynamicBuffer &chunk, int64_t start_line) {
+  m_fin.reset();
+  m_fin.clear();
+  m_fin.push(boost::iostreams::array_source((const char *)chunk.base,
+                                            chunk.fill()));
+  m_cur_line = start_line;
+  m_next_value = m_column_info.size();
+  m_limit = 0;
+}
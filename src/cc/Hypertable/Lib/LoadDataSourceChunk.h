@@ -0,0 +1,59 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#ifndef Hypertable_Lib_LoadDataSourceChunk_h
+#define Hypertable_Lib_LoadDataSourceChunk_h
+
+#include <Hypertable/Lib/LoadDataSource.h>
+
+#include <Common/DynamicBuffer.h>
+
+namespace Hypertable {
+
+  /// Parses a chunk of lines read by LoadDataSource::next_chunk().
+  /// Allows the lines of a single input to be parsed on several threads.
+  /// The header layout is copied from the source that read the chunk, and
+  /// next() yields the same cells, with the same line numbers in warnings
+  /// and errors, that the source itself would have yielded for those lines.
+  class LoadDataSourceChunk : public LoadDataSource {
+
+  public:
+
+    /// Constructor.
+    /// @param source Initialized source from which chunks are read
+    LoadDataSourceChunk(const LoadDataSource &source);
+
+    /// Starts parsing a new chunk.
+    /// <code>chunk</code> must remain valid until next() returns
+    /// <i>false</i> or reset() is called again.
+    /// @param chunk Chunk of lines filled by LoadDataSource::next_chunk()
+    /// @param start_line Line number returned by next_chunk() for the chunk
+    void reset(const DynamicBuffer &chunk, int64_t start_line);
+
+    uint64_t incr_consumed() override { return 0; }
+
+  protected:
+    void init_src() override { }
+  };
+
+}
+
+#endif // Hypertable_Lib_LoadDataSourceChunk_h
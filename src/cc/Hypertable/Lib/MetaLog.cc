@@ -30,9 +30,11 @@
 
 #include <Common/Filesystem.h>
 #include <Common/Serialization.h>
+#include <Common/StringExt.h>
 
 #include <algorithm>
 #include <cctype>
+#include <cstring>
 
 using namespace Hypertable;
 using namespace Hypertable::MetaLog;
@@ -72,6 +74,9 @@ void MetaLog::scan_log_directory(FilesystemPtr &fs, const string &path,
     if (*ptr == 0 || (ptr > listing[i].name.c_str() && !strcmp(ptr, ".bad")))
       id = atoi(listing[i].name.c_str());
   
+    if (!strcmp(ptr, ".compacting"))
+      continue;
+
     if (*ptr != 0) {
       HT_WARNF("Invalid META LOG file name encountered '%s', skipping...",
                listing[i].name.c_str());
@@ -86,3 +91,7 @@ void MetaLog::scan_log_directory(FilesystemPtr &fs, const string &path,
        [](int32_t lhs, int32_t rhs) { return lhs > rhs; });
 
 }
+
+string MetaLog::compaction_marker_file(const string &path, int32_t file_id) {
+  return path + "/" + file_id + ".compacting";
+}
@@ -102,6 +102,19 @@ namespace Hypertable {
     void scan_log_directory(FilesystemPtr &fs, const std::string &path,
                             std::deque<int32_t> &file_ids);
 
+    /** Returns pathname of compaction marker file.
+     * While a %MetaLog file is being written by a background compaction, a
+     * marker file named <code>&lt;file_id&gt;.compacting</code> exists in the
+     * log directory.  The marker is removed once the compacted file is
+     * complete, so a file with a marker left behind by a crash is incomplete
+     * and must not be loaded.
+     * @param path Pathname of %MetaLog directory
+     * @param file_id Numeric name of file being compacted
+     * @return Pathname of marker file for <code>file_id</code>
+     */
+    std::string compaction_marker_file(const std::string &path,
+                                       int32_t file_id);
+
    }
 
    /** @}*/
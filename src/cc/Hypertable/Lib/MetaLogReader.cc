@@ -38,6 +38,7 @@
 #include "Common/StringExt.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdio>
 
 #include <boost/algorithm/string.hpp>
@@ -84,9 +85,17 @@ void Reader::get_all_entities(std::vector<EntityPtr> &entities) {
 void Reader::reload() {
   try {
     scan_log_directory(m_fs, m_path, m_file_nums);
-    if (!m_file_nums.empty()) {
-      verify_backup(m_file_nums.front());
-      load_file(m_path + "/" + m_file_nums.front());
+    // Skip files left incomplete by an interrupted background compaction
+    auto iter = m_file_nums.begin();
+    while (iter != m_file_nums.end() &&
+           m_fs->exists(compaction_marker_file(m_path, *iter))) {
+      HT_WARNF("Skipping incomplete compacted MetaLog file %s/%d",
+               m_path.c_str(), (int)*iter);
+      ++iter;
+    }
+    if (iter != m_file_nums.end()) {
+      verify_backup(*iter);
+      load_file(m_path + "/" + *iter);
     }
   }
   catch (Exception &e) {
@@ -131,6 +140,7 @@ void Reader::verify_backup(int32_t file_num) {
 
 
 void Reader::load_file(const string &fname) {
+  auto start_time = chrono::steady_clock::now();
   int64_t file_length = m_fs->length(fname);
   
   Filesystem::SmartFdPtr smartfd_ptr = Filesystem::SmartFd::make_ptr(fname, 0);
@@ -220,6 +230,11 @@ void Reader::load_file(const string &fname) {
   if (!found_recover_entry)
     HT_THROW(Error::METALOG_MISSING_RECOVER_ENTITY, fname.c_str());
 
+  auto elapsed = chrono::steady_clock::now() - start_time;
+  HT_INFOF("Loaded %s (%lld bytes, %d live entities) in %lld ms",
+           fname.c_str(), (Lld)file_length, (int)m_entity_map.size(),
+           (Lld)chrono::duration_cast<chrono::milliseconds>(elapsed).count());
+
 }
 
 
@@ -102,7 +102,8 @@ namespace Hypertable {
       /** Loads %MetaLog.
        * This method scans the %MetaLog directory with a call to
        * scan_log_directory() and then loads the largest numerically named file
-       * in the directory with a call to load_file().  The #m_file_nums
+       * in the directory with a call to load_file(), skipping files that have
+       * a compaction marker (see compaction_marker_file()).  The #m_file_nums
        * vector is populated with the numeric file names found in log directory.
        * This method propagates all exceptions of type Error::METALOG_ERROR and
        * converts all other exceptions to Error::METALOG_READ_ERROR and
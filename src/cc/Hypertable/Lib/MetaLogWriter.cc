@@ -94,6 +94,12 @@ Writer::Writer(FilesystemPtr &fs, DefinitionPtr &definition, const string &path,
 
   int32_t next_id = m_file_ids.empty() ? 0 : m_file_ids.front()+1;
 
+  // Remove marker left behind by a compaction that crashed before creating
+  // its file, otherwise readers would skip the file we are about to write
+  String marker = compaction_marker_file(m_path, next_id);
+  if (m_fs->exists(marker))
+    m_fs->remove(marker);
+
   // Open FS file
   m_smartfd_ptr = Filesystem::SmartFd::make_ptr(m_path + "/" + next_id, 0);
   m_fs->create(m_smartfd_ptr, FS_BUFFER_SIZE, m_replication, FS_BLOCK_SIZE);
@@ -117,6 +123,16 @@ Writer::Writer(FilesystemPtr &fs, DefinitionPtr &definition, const string &path,
   if (!skip_recover_entry)
     record_state(make_shared<EntityRecover>());
 
+  // Enable background compaction now that the initial snapshot is written
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_snapshot_length = m_offset;
+    m_compaction_ratio =
+      Config::properties->get_i32("Hypertable.MetaLog.Compaction.Ratio");
+    m_compaction_minimum =
+      Config::properties->get_i64("Hypertable.MetaLog.Compaction.MinimumSize");
+  }
+
 }
 
 Writer::~Writer() {
@@ -125,6 +141,16 @@ Writer::~Writer() {
 }
 
 void Writer::close() {
+
+  // Abandon and wait for in-progress compaction
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_closed = true;
+    m_compaction_abandoned = true;
+  }
+  if (m_compaction_thread.joinable())
+    m_compaction_thread.join();
+
   lock_guard<mutex> lock(m_mutex);
 
   if(m_backup_fd!=-1){
@@ -158,6 +184,11 @@ void Writer::purge_old_log_files() {
     if (FileUtils::exists(tmp_name))
       FileUtils::unlink(tmp_name);
 
+    // remove compaction marker left behind by a crash
+    tmp_name = compaction_marker_file(m_path, m_file_ids.back());
+    if (m_fs->exists(tmp_name))
+      m_fs->remove(tmp_name);
+
     m_file_ids.pop_back();
   }
 
@@ -171,7 +202,10 @@ void Writer::roll() {
     ::close(m_backup_fd);
     m_backup_fd = -1;
   }
-  int32_t next_id = m_file_ids.front() + 1;
+  // Skip over (and abandon) file of in-progress compaction
+  int32_t next_id = std::max(m_file_ids.front(), m_compaction_file_id) + 1;
+  if (m_compaction_file_id != -1)
+    m_compaction_abandoned = true;
 
   int32_t write_tries = 0;
   try_again:
@@ -232,7 +266,8 @@ void Writer::try_roll(int32_t next_id) {
   // Write contents to file(s)
   FileUtils::write(m_backup_fd, buf.base, buf.size);
   m_fs->append(m_smartfd_ptr, buf, m_flush_method);
-  
+
+  m_snapshot_length = m_offset;
 }
 
 void Writer::service_write_queue() {
@@ -270,10 +305,147 @@ void Writer::service_write_queue() {
     }
   }
 
+  // Retain entries for in-progress compaction
+  if (m_compaction_file_id != -1)
+    m_compaction_tail.insert(m_compaction_tail.end(), m_write_queue.begin(),
+                             m_write_queue.end());
+
   m_write_queue.clear();
   m_write_ready = false;
   if (m_offset > m_max_file_size)
     roll();
+  else if (compaction_needed())
+    start_compaction();
+}
+
+
+bool Writer::compaction_needed() {
+  if (m_compaction_ratio <= 0 || m_compaction_file_id != -1 || m_closed ||
+      m_offset < m_compaction_minimum)
+    return false;
+  return (m_offset - m_snapshot_length) > m_compaction_ratio * m_snapshot_length;
+}
+
+
+void Writer::start_compaction() {
+  // Previous compaction thread has finished, reap it
+  if (m_compaction_thread.joinable())
+    m_compaction_thread.join();
+  m_compaction_file_id = m_file_ids.front() + 1;
+  m_compaction_abandoned = false;
+  m_compaction_tail.clear();
+  m_compaction_thread = thread(&Writer::compact, this, m_compaction_file_id,
+                               m_entity_map);
+}
+
+
+void Writer::compact(int32_t file_id, EntityMapT entity_map) {
+  auto start_time = chrono::steady_clock::now();
+  string marker = compaction_marker_file(m_path, file_id);
+  string backup_filename = m_backup_path + "/" + file_id;
+  Filesystem::SmartFdPtr smartfd_ptr;
+  int backup_fd {-1};
+  bool installed {};
+
+  try {
+
+    // Create marker so readers skip the file if we don't finish
+    Filesystem::SmartFdPtr marker_fd = Filesystem::SmartFd::make_ptr(marker, 0);
+    m_fs->create(marker_fd, FS_BUFFER_SIZE, m_replication, FS_BLOCK_SIZE);
+    m_fs->close(marker_fd);
+
+    smartfd_ptr = Filesystem::SmartFd::make_ptr(m_path + "/" + file_id, 0);
+    m_fs->create(smartfd_ptr, FS_BUFFER_SIZE, m_replication, FS_BLOCK_SIZE);
+    backup_fd = ::open(backup_filename.c_str(), O_CREAT|O_TRUNC|O_WRONLY, 0644);
+
+    // Write header and snapshot without holding the lock
+    size_t length = Header::LENGTH;
+    for (auto &entry : entity_map)
+      length += entry.second.first;
+    StaticBuffer buf(length);
+    uint8_t *ptr = buf.base;
+    encode_header(&ptr);
+    for (auto &entry : entity_map) {
+      memcpy(ptr, entry.second.second.get(), entry.second.first);
+      ptr += entry.second.first;
+    }
+    HT_ASSERT((ptr-buf.base) == (ptrdiff_t)buf.size);
+    int64_t offset = buf.size;
+    FileUtils::write(backup_fd, buf.base, buf.size);
+    m_fs->append(smartfd_ptr, buf, m_flush_method);
+
+    lock_guard<mutex> lock(m_mutex);
+
+    if (!m_compaction_abandoned) {
+
+      // Append entries written since the snapshot was taken followed by the
+      // Recover entity
+      length = EntityHeader::LENGTH;
+      for (auto &sb : m_compaction_tail)
+        length += sb->size;
+      StaticBuffer tail(length);
+      ptr = tail.base;
+      for (auto &sb : m_compaction_tail) {
+        memcpy(ptr, sb->base, sb->size);
+        ptr += sb->size;
+      }
+      EntityRecover er;
+      er.encode_entry(&ptr);
+      HT_ASSERT((ptr-tail.base) == (ptrdiff_t)tail.size);
+      offset += tail.size;
+      FileUtils::write(backup_fd, tail.base, tail.size);
+      m_fs->append(smartfd_ptr, tail, m_flush_method);
+
+      m_fs->remove(marker);
+
+      // Switch to compacted file
+      int64_t old_length = m_offset;
+      try { m_fs->close(m_smartfd_ptr); } catch (...) { }
+      ::close(m_backup_fd);
+      m_smartfd_ptr = smartfd_ptr;
+      m_backup_fd = backup_fd;
+      m_backup_filename = backup_filename;
+      m_offset = offset;
+      m_snapshot_length = offset;
+      m_file_ids.push_front(file_id);
+      purge_old_log_files();
+      m_compaction_count++;
+      installed = true;
+
+      auto elapsed = chrono::steady_clock::now() - start_time;
+      HT_INFOF("Compacted %s MetaLog from %lld to %lld bytes (%d entities) "
+               "in %lld ms", m_definition->name(), (Lld)old_length,
+               (Lld)offset, (int)entity_map.size(),
+               (Lld)chrono::duration_cast<chrono::milliseconds>(elapsed).count());
+    }
+  }
+  catch (Exception &e) {
+    HT_ERRORF("Problem compacting %s MetaLog into %s/%d - %s (%s)",
+              m_definition->name(), m_path.c_str(), (int)file_id,
+              Error::get_text(e.code()), e.what());
+  }
+
+  // Remove incomplete file before releasing its ID
+  if (!installed) {
+    try {
+      if (smartfd_ptr && smartfd_ptr->valid())
+        m_fs->close(smartfd_ptr);
+      if (backup_fd != -1)
+        ::close(backup_fd);
+      m_fs->remove(m_path + "/" + file_id);
+      if (FileUtils::exists(backup_filename))
+        FileUtils::unlink(backup_filename);
+      m_fs->remove(marker);
+    }
+    catch (Exception &e) {
+      HT_WARNF("Problem removing incomplete MetaLog file %s/%d - %s",
+               m_path.c_str(), (int)file_id, e.what());
+    }
+  }
+
+  lock_guard<mutex> lock(m_mutex);
+  m_compaction_file_id = -1;
+  m_compaction_tail.clear();
 }
 
 
@@ -314,9 +486,7 @@ void Writer::WriteScheduler::handle(EventPtr &event) {
 }
 
 
-void Writer::write_header() {
-  StaticBuffer buf(Header::LENGTH);
-  uint8_t backup_buf[Header::LENGTH];
+void Writer::encode_header(uint8_t **bufp) {
   Header header;
 
   assert(strlen(m_definition->name()) < sizeof(header.name));
@@ -325,9 +495,17 @@ void Writer::write_header() {
   memset(header.name, 0, sizeof(header.name));
   strcpy(header.name, m_definition->name());
 
+  header.encode(bufp);
+}
+
+
+void Writer::write_header() {
+  StaticBuffer buf(Header::LENGTH);
+  uint8_t backup_buf[Header::LENGTH];
+
   uint8_t *ptr = buf.base;
 
-  header.encode(&ptr);
+  encode_header(&ptr);
 
   assert((ptr-buf.base) == Header::LENGTH);
   memcpy(backup_buf, buf.base, Header::LENGTH);
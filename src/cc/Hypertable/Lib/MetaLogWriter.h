@@ -38,8 +38,10 @@
 
 #include <condition_variable>
 #include <deque>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -62,6 +64,12 @@ namespace Hypertable {
      * reader->get_entities(entities);
      * MetaLog::Writer writer = new MetaLog::Writer(log_fs, definition, log_dir, entities);
      * </pre>
+     * Each log file begins with a snapshot of the live entities followed by
+     * appended state changes.  To keep the amount of history a reader has to
+     * replay proportional to the live state, the writer compacts the log in
+     * a background thread once the bytes appended since the last snapshot
+     * exceed <code>Hypertable.MetaLog.Compaction.Ratio</code> times the
+     * snapshot size (see start_compaction()).
      */
     class Writer {
     public:
@@ -104,7 +112,9 @@ namespace Hypertable {
       ~Writer();
 
       /** Closes open file descriptors.
-       * This method closes both #m_smartfd_ptr and #m_backup_fd and sets them to -1.
+       * This method waits for any in-progress background compaction to finish
+       * (abandoning it) and then closes both #m_smartfd_ptr and #m_backup_fd
+       * and sets them to -1.
        */
       void close();
 
@@ -151,6 +161,14 @@ namespace Hypertable {
 
       void signal_write_ready();
 
+      /** Returns number of completed background compactions.
+       * @return Number of compacted files installed by this writer
+       */
+      int32_t compaction_count() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_compaction_count;
+      }
+
       /// Global flag to force writer to skip writing EntityRecover (testing)
       static bool skip_recover_entry;
 
@@ -186,6 +204,19 @@ namespace Hypertable {
 
       typedef std::shared_ptr<WriteScheduler> WriteSchedulerPtr;
 
+      // Serialized entity (length and smart pointer to buffer)
+      typedef std::pair<size_t, std::shared_ptr<uint8_t>> SerializedEntityT;
+
+      /// Map of entity ID to serialized entity
+      typedef std::map<int64_t, SerializedEntityT> EntityMapT;
+
+      /** Encodes %MetaLog file header.
+       * Encodes a MetaLog::Header initialized with the name and version
+       * obtained from #m_definition.
+       * @param bufp Address of destination buffer pointer (advanced by call)
+       */
+      void encode_header(uint8_t **bufp);
+
       /** Writes %MetaLog file header.
        * This method writes a %MetaLog file header to the open %MetaLog file
        * by initializing a MetaLog::Header object with the name and version
@@ -213,6 +244,36 @@ namespace Hypertable {
 
       void service_write_queue();
 
+      /** Checks if background compaction should be started.
+       * Returns <i>true</i> if compaction is enabled, no compaction is in
+       * progress, the current file is at least #m_compaction_minimum bytes,
+       * and the number of bytes appended since the snapshot at the beginning
+       * of the file exceeds #m_compaction_ratio times the snapshot size.
+       * @return <i>true</i> if compaction should be started
+       * @warning Must be called with #m_mutex locked
+       */
+      bool compaction_needed();
+
+      /** Starts background compaction.
+       * Assigns the next file ID to the compaction and launches compact() in
+       * #m_compaction_thread with a copy of #m_entity_map.
+       * @warning Must be called with #m_mutex locked
+       */
+      void start_compaction();
+
+      /** Compacts the log into a new file (compaction thread function).
+       * Creates a compaction marker (see compaction_marker_file()) and then,
+       * without holding #m_mutex, writes the file header and
+       * <code>entity_map</code> to file <code>file_id</code>.  It then locks
+       * #m_mutex, appends the entries written since the snapshot was taken
+       * (#m_compaction_tail) followed by a Recover entity, removes the marker
+       * and switches the writer to the new file.  If the writer was closed or
+       * rolled in the meantime, or an error occurs, the new file is removed.
+       * @param file_id Numeric name of compacted file
+       * @param entity_map Snapshot of live entities
+       */
+      void compact(int32_t file_id, EntityMapT entity_map);
+
       /// %Mutex for serializing access to members
       std::mutex m_mutex;
 
@@ -260,11 +321,36 @@ namespace Hypertable {
       /// Log flush method (FLUSH or SYNC)
       Filesystem::Flags m_flush_method {};
 
-      // Serialized entity (length and smart pointer to buffer)
-      typedef std::pair<size_t, std::shared_ptr<uint8_t>> SerializedEntityT;
-
       /// Map of current serialized entity data
-      std::map<int64_t, SerializedEntityT> m_entity_map;
+      EntityMapT m_entity_map;
+
+      /// Length of snapshot at beginning of current file
+      int64_t m_snapshot_length {};
+
+      /// Compaction trigger ratio of appended bytes to snapshot length
+      /// (0 disables background compaction)
+      int32_t m_compaction_ratio {};
+
+      /// Minimum file size before compaction is considered
+      int64_t m_compaction_minimum {};
+
+      /// Numeric name of file being compacted (-1 if none)
+      int32_t m_compaction_file_id {-1};
+
+      /// Set when a roll or close supersedes an in-progress compaction
+      bool m_compaction_abandoned {};
+
+      /// Entries written since in-progress compaction took its snapshot
+      std::vector<StaticBufferPtr> m_compaction_tail;
+
+      /// Background compaction thread
+      std::thread m_compaction_thread;
+
+      /// Number of completed background compactions
+      int32_t m_compaction_count {};
+
+      /// Set by close() to prevent further compactions
+      bool m_closed {};
 
       /// Flag indicating that 
       bool m_write_ready {};
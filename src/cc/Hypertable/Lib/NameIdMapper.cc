@@ -103,42 +103,40 @@ void NameIdMapper::add_entry(const string &names_parent, const string &names_ent
   attrs.push_back(Attribute("name", names_entry.c_str(), names_entry.length()));
   attrs.push_back(Attribute("nid", "0", 1));
 
+  // Create the ID file/dir and the names file/dir in a single transaction so
+  // a failure can't leave a dangling ID entry behind
+  CompoundRequest request;
   if (m_hyperspace->exists(ids_file)) {
     if (is_namespace) {
-      if (!m_hyperspace->attr_exists(ids_file, "nid")) {
-        m_hyperspace->attr_set(ids_file, 0, attrs);
-      }
+      if (!m_hyperspace->attr_exists(ids_file, "nid"))
+        request.attr_set(ids_file, attrs);
     }
   }
   else {
-    if (is_namespace) {
-      try {
-        m_hyperspace->mkdir(ids_file, attrs);
-      }
-      catch (Exception &e) {
-        HT_ERROR_OUT << e << HT_END;
-        throw;
-      }
-    }
+    if (is_namespace)
+      request.mkdir(ids_file, attrs);
     else
-      m_hyperspace->attr_set(ids_file, OPEN_FLAG_READ|OPEN_FLAG_WRITE|OPEN_FLAG_CREATE|OPEN_FLAG_EXCL,
-                             "name", names_entry.c_str(), names_entry.length());
+      request.open(ids_file, OPEN_FLAG_READ|OPEN_FLAG_WRITE|OPEN_FLAG_CREATE|OPEN_FLAG_EXCL,
+                   {Attribute("name", names_entry.c_str(), names_entry.length())});
   }
 
-  // At this point the ID file exists, we now need to
-  // create the names file/dir and update the "id" attribute
-
   UInt64Formatter buf(id);
+  std::vector<Attribute> init_attr;
+  init_attr.push_back(Attribute("id", buf.c_str(), buf.size()));
+
+  if (is_namespace)
+    request.mkdir(names_file, init_attr);
+  else
+    request.open(names_file, OPEN_FLAG_READ|OPEN_FLAG_WRITE|OPEN_FLAG_CREATE|OPEN_FLAG_EXCL,
+                 init_attr);
 
-  if (is_namespace) {
-    std::vector<Attribute> init_attr;
-    init_attr.push_back(Attribute("id", buf.c_str(), buf.size()));
-    m_hyperspace->mkdir(names_file, init_attr);
+  try {
+    m_hyperspace->execute(request);
   }
-  else {
-    // Set the "id" attribute of the names file
-    m_hyperspace->attr_set(names_file, OPEN_FLAG_READ|OPEN_FLAG_WRITE|OPEN_FLAG_CREATE|OPEN_FLAG_EXCL,
-                           "id", buf.c_str(), buf.size());
+  catch (Exception &e) {
+    if (e.code() != Error::HYPERSPACE_FILE_EXISTS)
+      HT_ERROR_OUT << e << HT_END;
+    throw;
   }
   ids.push_back(id);
 }
@@ -252,31 +250,23 @@ void NameIdMapper::rename(const string &curr_name, const string &next_name) {
 }
 
 void NameIdMapper::drop_mapping(const string &name) {
+  CompoundRequest request;
+  drop_mapping(name, request);
+  m_hyperspace->execute(request);
+}
+
+void NameIdMapper::drop_mapping(const string &name, CompoundRequest &request) {
   lock_guard<mutex> lock(m_mutex);
   string id;
   string table_name = name;
 
   boost::trim_if(table_name, boost::is_any_of("/ "));
 
-  if (do_mapping(name, false, id, 0)) {
-    try {
-      m_hyperspace->unlink(m_ids_dir + "/" + id);
-    }
-    catch (Exception &e) {
-      if (e.code() != Error::HYPERSPACE_FILE_NOT_FOUND &&
-          e.code() != Error::HYPERSPACE_BAD_PATHNAME)
-        throw;
-    }    
-  }
+  if (do_mapping(name, false, id, 0))
+    request.unlink(m_ids_dir + "/" + id, CompoundRequest::FLAG_IGNORE_NOT_FOUND);
 
-  try {
-    m_hyperspace->unlink(m_names_dir + "/" + table_name);
-  }
-  catch (Exception &e) {
-    if (e.code() != Error::HYPERSPACE_FILE_NOT_FOUND &&
-        e.code() != Error::HYPERSPACE_BAD_PATHNAME)
-      throw;
-  }
+  request.unlink(m_names_dir + "/" + table_name,
+                 CompoundRequest::FLAG_IGNORE_NOT_FOUND);
 }
 
 bool NameIdMapper::exists_mapping(const string &name, bool *is_namespace) {
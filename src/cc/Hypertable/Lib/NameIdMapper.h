@@ -86,6 +86,16 @@ namespace Hypertable {
      */
     void drop_mapping(const std::string &name);
 
+    /** Adds operations that drop a mapping to a compound request.
+     * The ID and name entries are unlinked when <code>request</code> is
+     * executed, allowing callers to remove other %Hyperspace state in the
+     * same transaction.  Entries that do not exist are skipped.
+     * @param name name to map
+     * @param request compound request to which unlink operations are added
+     */
+    void drop_mapping(const std::string &name,
+                      Hyperspace::CompoundRequest &request);
+
     /**
      * @param name name to check for mapping
      * @param is_namespace if mapping exists set to true if is namespace
@@ -0,0 +1,319 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Definitions for ParallelTableDumper.
+/// This file contains definitions for ParallelTableDumper, a class for
+/// dumping a table into one output file per range using multiple threads.
+
+#include <Common/Compat.h>
+
+#include "ParallelTableDumper.h"
+
+#include <Hypertable/Lib/Key.h>
+#include <Hypertable/Lib/LoadDataEscape.h>
+#include <Hypertable/Lib/TableScanner.h>
+#include <Hypertable/Lib/TableSplit.h>
+
+#include <FsBroker/Lib/FileDevice.h>
+
+#include <Common/Error.h>
+#include <Common/FileUtils.h>
+#include <Common/Logger.h>
+#include <Common/Serialization.h>
+#include <Common/String.h>
+#include <Common/md5.h>
+
+#include <boost/iostreams/device/file_descriptor.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+using namespace Hypertable;
+using namespace std;
+
+ParallelTableDumper::ParallelTableDumper(NamespacePtr &ns, const string &name,
+                                         ScanSpec &scan_spec,
+                                         const string &directory,
+                                         FsBroker::Lib::ClientPtr fs_client,
+                                         size_t parallelism,
+                                         const Format &format)
+  : m_scan_spec(scan_spec), m_directory(directory), m_fs_client(fs_client),
+    m_parallelism(parallelism ? parallelism : 1), m_format(format) {
+
+  if (!m_scan_spec.row_intervals.empty() || !m_scan_spec.cell_intervals.empty())
+    HT_THROW(Error::BAD_SCAN_SPEC,
+             "Parallel dump does not support row or cell intervals");
+
+  while (m_directory.length() > 1 && m_directory.back() == '/')
+    m_directory.pop_back();
+
+  m_table = ns->open_table(name);
+
+  if (m_fs_client)
+    m_fs_client->mkdirs(m_directory);
+  else if (!FileUtils::mkdirs(m_directory))
+    HT_THROWF(Error::LOCAL_IO_ERROR, "Unable to create directory %s",
+              m_directory.c_str());
+
+  load_ranges(ns, name);
+
+  for (size_t i=0; i<m_ranges.size(); ++i) {
+    if (exists(part_name(i)))
+      ++m_skipped;
+    else
+      m_pending.push_back(i);
+  }
+}
+
+void ParallelTableDumper::run() {
+  vector<thread> threads;
+  size_t n = min(m_parallelism, m_pending.size());
+
+  for (size_t i=0; i<n; ++i)
+    threads.push_back(thread(&ParallelTableDumper::worker, this));
+
+  for (auto &t : threads)
+    t.join();
+
+  if (m_error)
+    rethrow_exception(m_error);
+}
+
+void ParallelTableDumper::load_ranges(NamespacePtr &ns, const string &name) {
+  string ranges_file = m_directory + "/ranges";
+  const string &table_name = m_table->get_name();
+  string digest = compute_digest();
+  LoadDataEscape escaper;
+  const char *buf;
+  size_t len;
+
+  if (exists(ranges_file)) {
+    boost::iostreams::filtering_istream in;
+    if (m_fs_client)
+      in.push(FsBroker::Lib::FileSource(m_fs_client, ranges_file));
+    else
+      in.push(boost::iostreams::file_descriptor_source(ranges_file));
+    string line, expected;
+    expected = format("#table\t%s", table_name.c_str());
+    if (!getline(in, line) || line != expected)
+      HT_THROWF(Error::INVALID_OPERATION, "Unable to resume dump in %s, it was "
+                "produced for a different table (expected '%s', found '%s')",
+                m_directory.c_str(), expected.c_str(), line.c_str());
+    expected = format("#digest\t%s", digest.c_str());
+    if (!getline(in, line) || line != expected)
+      HT_THROWF(Error::INVALID_OPERATION, "Unable to resume dump of %s in %s, "
+                "it was produced with a different scan specification or "
+                "output format", table_name.c_str(), m_directory.c_str());
+    while (getline(in, line)) {
+      size_t tab = line.find('\t');
+      if (tab == string::npos)
+        HT_THROWF(Error::BAD_FORMAT, "Bad line in %s: %s", ranges_file.c_str(),
+                  line.c_str());
+      Range range;
+      escaper.unescape(line.c_str(), tab, &buf, &len);
+      range.start_row.assign(buf, len);
+      escaper.unescape(line.c_str()+tab+1, line.length()-tab-1, &buf, &len);
+      range.end_row.assign(buf, len);
+      m_ranges.push_back(range);
+    }
+    HT_INFOF("Resuming dump of %s with %d ranges from %s", name.c_str(),
+             (int)m_ranges.size(), ranges_file.c_str());
+    return;
+  }
+
+  TableSplitsContainer splits;
+  ns->get_table_splits(name, splits);
+  for (auto &split : splits) {
+    Range range;
+    range.start_row = split.start_row ? split.start_row : "";
+    range.end_row = split.end_row ? split.end_row : Key::END_ROW_MARKER;
+    m_ranges.push_back(range);
+  }
+
+  // Write to a temporary file first so a partial range list is never reused
+  {
+    boost::iostreams::filtering_ostream out;
+    open_sink(out, ranges_file + ".tmp");
+    out << "#table\t" << table_name << '\n';
+    out << "#digest\t" << digest << '\n';
+    for (auto &range : m_ranges) {
+      escaper.escape(range.start_row.c_str(), range.start_row.length(),
+                     &buf, &len);
+      out.write(buf, len);
+      out << '\t';
+      escaper.escape(range.end_row.c_str(), range.end_row.length(),
+                     &buf, &len);
+      out.write(buf, len);
+      out << '\n';
+    }
+    out.strict_sync();
+  }
+  rename(ranges_file + ".tmp", ranges_file);
+}
+
+string ParallelTableDumper::compute_digest() {
+  size_t length = m_scan_spec.encoded_length() + 3;
+  vector<uint8_t> buffer(length);
+  uint8_t *ptr = buffer.data();
+  m_scan_spec.encode(&ptr);
+  Serialization::encode_i8(&ptr, m_format.field_separator);
+  Serialization::encode_bool(&ptr, m_format.escape);
+  Serialization::encode_bool(&ptr, m_format.display_timestamps);
+  HT_ASSERT(ptr == buffer.data() + length);
+  char hex[33];
+  md5_hex(buffer.data(), length, hex);
+  return hex;
+}
+
+void ParallelTableDumper::worker() {
+  size_t next;
+
+  while ((next = m_next++) < m_pending.size()) {
+    {
+      lock_guard<mutex> lock(m_mutex);
+      if (m_error)
+        return;
+    }
+    try {
+      dump_range(m_pending[next]);
+    }
+    catch (...) {
+      lock_guard<mutex> lock(m_mutex);
+      if (!m_error)
+        m_error = current_exception();
+      return;
+    }
+  }
+}
+
+void ParallelTableDumper::dump_range(size_t i) {
+  string final_name = part_name(i);
+  string tmp_name = final_name + ".tmp";
+  char fs = m_format.field_separator;
+  ScanSpec scan_spec;
+  RowInterval ri;
+  Cell cell;
+  LoadDataEscape row_escaper;
+  LoadDataEscape escaper;
+  const char *buf;
+  size_t len;
+  uint64_t cells {}, keys_size {}, values_size {};
+
+  if (fs != '\t') {
+    row_escaper.set_field_separator(fs);
+    escaper.set_field_separator(fs);
+  }
+
+  m_scan_spec.base_copy(scan_spec);
+  ri.start = m_ranges[i].start_row.c_str();
+  ri.start_inclusive = false;
+  ri.end = m_ranges[i].end_row.c_str();
+  ri.end_inclusive = true;
+  scan_spec.row_intervals.push_back(ri);
+
+  TableScannerPtr scanner(m_table->create_scanner(scan_spec));
+  boost::iostreams::filtering_ostream out;
+  open_sink(out, tmp_name);
+
+  if (m_format.display_timestamps)
+    out << "#timestamp" << fs << "row" << fs << "column" << fs << "value\n";
+  else
+    out << "#row" << fs << "column" << fs << "value\n";
+
+  while (scanner->next(cell)) {
+    ++cells;
+    keys_size += strlen(cell.row_key);
+    if (cell.column_family && cell.column_qualifier)
+      keys_size += strlen(cell.column_qualifier) + 1;
+    values_size += cell.value_len;
+
+    if (m_format.display_timestamps)
+      out << cell.timestamp << fs;
+
+    if (m_format.escape)
+      row_escaper.escape(cell.row_key, strlen(cell.row_key), &buf, &len);
+    else
+      buf = cell.row_key;
+    out << buf;
+
+    if (cell.column_family) {
+      out << fs << cell.column_family;
+      if (cell.column_qualifier && *cell.column_qualifier) {
+        if (m_format.escape)
+          escaper.escape(cell.column_qualifier, strlen(cell.column_qualifier),
+                         &buf, &len);
+        else
+          buf = cell.column_qualifier;
+        out << ":" << buf;
+      }
+    }
+
+    if (m_format.escape)
+      escaper.escape((const char *)cell.value, (size_t)cell.value_len,
+                     &buf, &len);
+    else {
+      buf = (const char *)cell.value;
+      len = (size_t)cell.value_len;
+    }
+
+    HT_ASSERT(cell.flag == FLAG_INSERT);
+
+    out << fs;
+    out.write(buf, len);
+    out << "\n";
+  }
+  out.strict_sync();
+  out.reset();
+
+  rename(tmp_name, final_name);
+
+  m_total_cells += cells;
+  m_total_keys_size += keys_size;
+  m_total_values_size += values_size;
+}
+
+string ParallelTableDumper::part_name(size_t i) {
+  return format("%s/part-%06u.tsv", m_directory.c_str(), (unsigned)i);
+}
+
+bool ParallelTableDumper::exists(const string &path) {
+  if (m_fs_client)
+    return m_fs_client->exists(path);
+  return FileUtils::exists(path);
+}
+
+void ParallelTableDumper::rename(const string &from, const string &to) {
+  if (m_fs_client)
+    m_fs_client->rename(from, to);
+  else if (!FileUtils::rename(from, to))
+    HT_THROWF(Error::LOCAL_IO_ERROR, "Unable to rename %s to %s",
+              from.c_str(), to.c_str());
+}
+
+void ParallelTableDumper::open_sink(boost::iostreams::filtering_ostream &out,
+                                    const string &path) {
+  if (m_fs_client)
+    out.push(FsBroker::Lib::FileSink(m_fs_client, path));
+  else
+    out.push(boost::iostreams::file_descriptor_sink(path));
+}
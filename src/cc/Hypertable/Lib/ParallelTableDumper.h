@@ -0,0 +1,197 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Declarations for ParallelTableDumper.
+/// This file contains type declarations for ParallelTableDumper, a class for
+/// dumping a table into one output file per range using multiple threads.
+
+#ifndef Hypertable_Lib_ParallelTableDumper_h
+#define Hypertable_Lib_ParallelTableDumper_h
+
+#include <Hypertable/Lib/Namespace.h>
+#include <Hypertable/Lib/ScanSpec.h>
+#include <Hypertable/Lib/Table.h>
+
+#include <FsBroker/Lib/Client.h>
+
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Hypertable {
+
+  /// @addtogroup libHypertable
+  /// @{
+
+  /// Dumps a table into one output file per range using multiple threads.
+  /// The table's ranges are enumerated from the METADATA table (see
+  /// Namespace::get_table_splits()) and recorded, in row order, in a file
+  /// named <code>ranges</code> in the output directory.  Up to
+  /// <i>parallelism</i> ranges are scanned at once, each with its own
+  /// TableScanner, so memory use is bounded by the number of scanners.
+  /// The cells of range <i>n</i> are written in row order to
+  /// <code>part-</code><i>n</i><code>.tsv</code>, so concatenating the parts
+  /// in name order yields a stream ordered by row.  Each part is written to a
+  /// temporary file and renamed when complete.  If a dump fails, running it
+  /// again with the same directory reuses the recorded ranges and only
+  /// scans those whose part file does not exist.  The <code>ranges</code>
+  /// file starts with the table name and a digest of the scan specification
+  /// and output format, and a dump is only resumed if both match, so parts
+  /// produced by different dumps are never mixed.
+  class ParallelTableDumper {
+
+  public:
+
+    /// Output format options.
+    struct Format {
+      /// Field separator
+      char field_separator {'\t'};
+      /// Escape field separators, newlines and backslashes
+      bool escape {true};
+      /// Output a leading timestamp column
+      bool display_timestamps {};
+    };
+
+    /// Constructor.
+    /// Opens the table and loads or creates the range list in
+    /// <code>directory</code>.  If <code>fs_client</code> is set,
+    /// <code>directory</code> refers to the brokered filesystem, otherwise
+    /// to the local filesystem.
+    /// @param ns %Namespace containing table
+    /// @param name %Table name
+    /// @param scan_spec Scan specification, without row intervals
+    /// @param directory Output directory
+    /// @param fs_client FS broker client or null
+    /// @param parallelism Number of ranges to scan at once
+    /// @param format Output format
+    ParallelTableDumper(NamespacePtr &ns, const std::string &name,
+                        ScanSpec &scan_spec, const std::string &directory,
+                        FsBroker::Lib::ClientPtr fs_client,
+                        size_t parallelism, const Format &format);
+
+    /// Dumps all ranges that have not already been dumped.
+    /// Returns when every range has been dumped or when one of them fails,
+    /// in which case the first error is rethrown after the other threads
+    /// have finished their current range.
+    void run();
+
+    /// Gets number of ranges in the dump.
+    /// @return Number of ranges
+    size_t range_count() const { return m_ranges.size(); }
+
+    /// Gets number of ranges skipped because they were already dumped.
+    /// @return Number of ranges skipped
+    size_t skipped_count() const { return m_skipped; }
+
+    /// Gets number of cells dumped.
+    /// @return Number of cells dumped
+    uint64_t total_cells() const { return m_total_cells; }
+
+    /// Gets total size of row keys and qualifiers dumped.
+    /// @return Total key size
+    uint64_t total_keys_size() const { return m_total_keys_size; }
+
+    /// Gets total size of values dumped.
+    /// @return Total value size
+    uint64_t total_values_size() const { return m_total_values_size; }
+
+  private:
+
+    /// Row interval of one range.
+    struct Range {
+      std::string start_row;
+      std::string end_row;
+    };
+
+    /// Loads the range list or creates it from the METADATA table.
+    /// @throws Exception with code Error::INVALID_OPERATION if an existing
+    /// range list was written for a different table, scan specification or
+    /// output format
+    void load_ranges(NamespacePtr &ns, const std::string &name);
+
+    /// Computes digest identifying the scan specification and output format.
+    /// @return MD5 digest of the encoded scan specification and format, in hex
+    std::string compute_digest();
+
+    /// Worker thread function.
+    void worker();
+
+    /// Dumps range <code>i</code> to its part file.
+    void dump_range(size_t i);
+
+    std::string part_name(size_t i);
+    bool exists(const std::string &path);
+    void rename(const std::string &from, const std::string &to);
+    void open_sink(boost::iostreams::filtering_ostream &out,
+                   const std::string &path);
+
+    /// %Table being dumped
+    TablePtr m_table;
+
+    /// Scan specification applied to every range
+    ScanSpec &m_scan_spec;
+
+    /// Output directory
+    std::string m_directory;
+
+    /// FS broker client, null for local output
+    FsBroker::Lib::ClientPtr m_fs_client;
+
+    /// Number of ranges to scan at once
+    size_t m_parallelism;
+
+    /// Output format
+    Format m_format;
+
+    /// Ranges in row order
+    std::vector<Range> m_ranges;
+
+    /// Indexes of ranges that remain to be dumped
+    std::vector<size_t> m_pending;
+
+    /// Next entry of #m_pending to dump
+    std::atomic<size_t> m_next {};
+
+    /// Number of ranges skipped on resume
+    size_t m_skipped {};
+
+    /// %Mutex protecting #m_error
+    std::mutex m_mutex;
+
+    /// First error encountered
+    std::exception_ptr m_error;
+
+    std::atomic<uint64_t> m_total_cells {};
+    std::atomic<uint64_t> m_total_keys_size {};
+    std::atomic<uint64_t> m_total_values_size {};
+  };
+
+  /// @}
+
+}
+
+#endif // Hypertable_Lib_ParallelTableDumper_h
@@ -40,7 +40,7 @@ uint8_t ProfileDataScanner::encoding_version() const {
 }
 
 size_t ProfileDataScanner::encoded_length_internal() const {
-  size_t length = 52;
+  size_t length = 68;
   if (!servers.empty()) {
     for (auto & str : servers)
       length += encoded_length_vstr(str);
@@ -61,6 +61,8 @@ void ProfileDataScanner::encode_internal(uint8_t **bufp) const {
     for (auto & str : servers)
       encode_vstr(bufp, str);
   }
+  encode_i64(bufp, (uint64_t)cells_filtered_pushdown);
+  encode_i64(bufp, (uint64_t)cells_filtered_merge);
 }
 
 void ProfileDataScanner::decode_internal(uint8_t version, const uint8_t **bufp,
@@ -76,6 +78,12 @@ void ProfileDataScanner::decode_internal(uint8_t version, const uint8_t **bufp,
   size_t count = (size_t)decode_i32(bufp, remainp);
   for (size_t i=0; i<count; i++)
     servers.insert( decode_vstr(bufp, remainp) );
+  // Filter counts were appended without a version bump so that older
+  // decoders skip them; encodings from older servers end here
+  if (*remainp >= 16) {
+    cells_filtered_pushdown = (int64_t)decode_i64(bufp, remainp);
+    cells_filtered_merge = (int64_t)decode_i64(bufp, remainp);
+  }
 }
 
 
@@ -87,6 +95,8 @@ ProfileDataScanner &ProfileDataScanner::operator+=(const ProfileDataScanner &oth
   bytes_scanned += other.bytes_scanned;
   bytes_returned += other.bytes_returned;
   disk_read += other.disk_read;
+  cells_filtered_pushdown += other.cells_filtered_pushdown;
+  cells_filtered_merge += other.cells_filtered_merge;
   servers.insert(other.servers.begin(), other.servers.end());
   return *this;
 }
@@ -99,6 +109,8 @@ ProfileDataScanner &ProfileDataScanner::operator-=(const ProfileDataScanner &oth
   bytes_scanned -= other.bytes_scanned;
   bytes_returned -= other.bytes_returned;
   disk_read -= other.disk_read;
+  cells_filtered_pushdown -= other.cells_filtered_pushdown;
+  cells_filtered_merge -= other.cells_filtered_merge;
   for (auto &server : other.servers)
     servers.erase(server);
   return *this;
@@ -111,6 +123,8 @@ string ProfileDataScanner::to_string() {
   str += string("bytes_scanned=") + bytes_scanned + " ";
   str += string("bytes_returned=") + bytes_returned + " ";
   str += string("disk_read=") + disk_read + " ";
+  str += string("cells_filtered_pushdown=") + cells_filtered_pushdown + " ";
+  str += string("cells_filtered_merge=") + cells_filtered_merge + " ";
   str += string("subscanners=") + subscanners + " ";
   str += string("scanblocks=") + scanblocks + " ";
   str += string("servers=");
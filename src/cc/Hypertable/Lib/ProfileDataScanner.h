@@ -78,6 +78,13 @@ namespace Hypertable {
     /// Number of bytes read from disk while executing scan
     int64_t disk_read {};
 
+    /// Number of cells dropped by predicates in the cell store and cell
+    /// cache scanners, before reaching the merge
+    int64_t cells_filtered_pushdown {};
+
+    /// Number of cells dropped by predicates during the merge
+    int64_t cells_filtered_merge {};
+
     /// Set of server proxy names participating in scan
     std::set<std::string> servers;
 
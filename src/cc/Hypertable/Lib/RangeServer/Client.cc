@@ -30,6 +30,7 @@
 #include "Client.h"
 #include "Protocol.h"
 #include "Request/Parameters/AcknowledgeLoad.h"
+#include "Request/Parameters/AdoptCellStores.h"
 #include "Request/Parameters/CommitLogSync.h"
 #include "Request/Parameters/Compact.h"
 #include "Request/Parameters/CreateScanner.h"
@@ -49,6 +50,7 @@
 #include "Request/Parameters/RelinquishRange.h"
 #include "Request/Parameters/ReplayFragments.h"
 #include "Request/Parameters/SetState.h"
+#include "Request/Parameters/Status.h"
 #include "Request/Parameters/TableMaintenanceDisable.h"
 #include "Request/Parameters/TableMaintenanceEnable.h"
 #include "Request/Parameters/Update.h"
@@ -489,18 +491,36 @@ void Lib::RangeServer::Client::commit_log_sync(const CommAddress &addr, uint64_t
 }
 
 void Lib::RangeServer::Client::status(const CommAddress &addr, Status &status) {
-  do_status(addr, status, m_default_timeout_ms);
+  do_status(addr, 0, status, nullptr, m_default_timeout_ms);
 }
 
 void Lib::RangeServer::Client::status(const CommAddress &addr, Status &status, Timer &timer) {
-  do_status(addr, status, timer.remaining());
+  do_status(addr, 0, status, nullptr, timer.remaining());
 }
 
-void Lib::RangeServer::Client::do_status(const CommAddress &addr, Status &status, int32_t timeout_ms) {
+void Lib::RangeServer::Client::status(const CommAddress &addr, int32_t flags,
+                                      Status &status,
+                                      std::string &latency_report,
+                                      Timer &timer) {
+  do_status(addr, flags, status, &latency_report, timer.remaining());
+}
+
+void Lib::RangeServer::Client::do_status(const CommAddress &addr,
+                                         int32_t flags, Status &status,
+                                         std::string *latency_report,
+                                         int32_t timeout_ms) {
   DispatchHandlerSynchronizer sync_handler;
   CommHeader header(Protocol::COMMAND_STATUS);
   header.flags |= CommHeader::FLAGS_BIT_URGENT;
-  CommBufPtr cbuf(new CommBuf(header));
+  CommBufPtr cbuf;
+  // Servers that predate status flags ignore the payload
+  if (flags) {
+    Request::Parameters::Status params(flags);
+    cbuf.reset(new CommBuf(header, params.encoded_length()));
+    params.encode(cbuf->get_data_ptr_address());
+  }
+  else
+    cbuf.reset(new CommBuf(header));
   send_message(addr, cbuf, &sync_handler, timeout_ms);
 
   EventPtr event;
@@ -515,6 +535,8 @@ void Lib::RangeServer::Client::do_status(const CommAddress &addr, Status &status
     Response::Parameters::Status params;
     params.decode(&ptr, &remaining);
     status = params.status();
+    if (latency_report)
+      *latency_report = params.latency_report();
   }
 }
 
@@ -844,6 +866,24 @@ void Lib::RangeServer::Client::table_maintenance_disable(const CommAddress &addr
   send_message(addr, cbuf, handler, m_default_timeout_ms);
 }
 
+void Lib::RangeServer::Client::adopt_cellstores(const CommAddress &addr,
+                         const TableIdentifier &table, const RangeSpec &range,
+                         const vector<pair<String, String>> &files,
+                         Timer &timer) {
+  DispatchHandlerSynchronizer sync_handler;
+  CommHeader header(Protocol::COMMAND_ADOPT_CELLSTORES);
+  Request::Parameters::AdoptCellStores params(table, range, files);
+  CommBufPtr cbuf(new CommBuf(header, params.encoded_length()));
+  params.encode(cbuf->get_data_ptr_address());
+
+  EventPtr event;
+  send_message(addr, cbuf, &sync_handler, timer.remaining());
+
+  if (!sync_handler.wait_for_reply(event))
+    HT_THROW(Hypertable::Protocol::response_code(event),
+             String("RangeServer adopt_cellstores() failure : ")
+             + Hypertable::Protocol::string_format_message(event));
+}
 
 void Lib::RangeServer::Client::send_message(const CommAddress &addr, CommBufPtr &cbuf,
                           DispatchHandler *handler, int32_t timeout_ms) {
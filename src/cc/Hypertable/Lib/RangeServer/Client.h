@@ -48,6 +48,9 @@
 
 #include <map>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace Hypertable {
 namespace Lib {
@@ -356,6 +359,17 @@ namespace RangeServer {
      */
     void status(const CommAddress &addr, Status &status, Timer &timer);
 
+    /// Issues a <i>status</i> request with flags.
+    /// This call blocks until it receives a response from the server.
+    /// @param addr Address of RangeServer
+    /// @param flags Status flags (see Protocol::StatusFlags)
+    /// @param status Output variable to hold status
+    /// @param latency_report Output variable to hold latency histogram report
+    /// (filled in if Protocol::STATUS_FLAG_LATENCY is set)
+    /// @param timer Deadline timer
+    void status(const CommAddress &addr, int32_t flags, Status &status,
+                std::string &latency_report, Timer &timer);
+
     /// Issues an asynchonous <i>status</i> request with timer.
     /// @param addr Address of RangeServer
     /// @param handler Response handler
@@ -561,6 +575,19 @@ namespace RangeServer {
                                    const TableIdentifier &table,
                                    DispatchHandler *handler);
 
+    /// Issues a synchronous RangeServer::adopt_cellstores() request.
+    /// Asks the RangeServer to add the given CellStore files, written
+    /// offline by a bulk loader, to the access groups of a range.
+    /// @param addr Address of RangeServer
+    /// @param table %Table identifier
+    /// @param range %Range specification
+    /// @param files Vector of (access group name, CellStore file) pairs
+    /// @param timer Maximum wait timer
+    void adopt_cellstores(const CommAddress &addr, const TableIdentifier &table,
+                          const RangeSpec &range,
+                          const std::vector<std::pair<std::string, std::string>> &files,
+                          Timer &timer);
+
   private:
     void do_load_range(const CommAddress &addr, const TableIdentifier &table,
                        const RangeSpec &range_spec, const RangeState &range_state,
@@ -576,7 +603,8 @@ namespace RangeServer {
     void do_drop_table(const CommAddress &addr,
                        const TableIdentifier &table,
                        int32_t timeout_ms);
-    void do_status(const CommAddress &addr, Status &status, int32_t timeout_ms);
+    void do_status(const CommAddress &addr, int32_t flags, Status &status,
+                   std::string *latency_report, int32_t timeout_ms);
     void do_get_statistics(const CommAddress &addr, std::vector<SystemVariable::Spec> &specs,
                            int64_t generation, StatsRangeServer &stats,
                            int32_t timeout_ms);
@@ -85,6 +85,7 @@ namespace RangeServer {
       COMMAND_SET_STATE,
       COMMAND_TABLE_MAINTENANCE_ENABLE,
       COMMAND_TABLE_MAINTENANCE_DISABLE,
+      COMMAND_ADOPT_CELLSTORES,
       COMMAND_MAX
     };
 
@@ -117,6 +118,12 @@ namespace RangeServer {
 
     static string compact_flags_to_string(uint32_t flags);
 
+    // Status flags
+    enum StatusFlags {
+      /* Include latency histogram report in response */
+      STATUS_FLAG_LATENCY   = 0x0001
+    };
+
   };
 
   /// @}
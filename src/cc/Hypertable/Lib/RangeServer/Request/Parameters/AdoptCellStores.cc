@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Definitions for AdoptCellStores request parameters.
+/// This file contains definitions for AdoptCellStores, a class for encoding
+/// and decoding paramters to the <i>adopt cellstores</i> %RangeServer
+/// function.
+
+#include <Common/Compat.h>
+
+#include "AdoptCellStores.h"
+
+#include <Common/Logger.h>
+#include <Common/Serialization.h>
+
+using namespace Hypertable;
+using namespace Hypertable::Lib::RangeServer::Request::Parameters;
+
+uint8_t AdoptCellStores::encoding_version() const {
+  return 1;
+}
+
+size_t AdoptCellStores::encoded_length_internal() const {
+  size_t length = m_table.encoded_length() + m_range_spec.encoded_length() + 4;
+  for (auto &entry : m_files)
+    length += Serialization::encoded_length_vstr(entry.first) +
+      Serialization::encoded_length_vstr(entry.second);
+  return length;
+}
+
+/// @details
+/// Encoding is as follows:
+/// <table>
+/// <tr><th>Encoding</th><th>Description</th></tr>
+/// <tr><td>TableIdentifier</td><td>%Table identifier</td></tr>
+/// <tr><td>RangeSpec</td><td>%Range specification</td></tr>
+/// <tr><td>i32</td><td>File count</td></tr>
+/// <tr><td>For each file ...</td></tr>
+/// <tr><td>vstr</td><td>Access group name</td></tr>
+/// <tr><td>vstr</td><td>CellStore file name</td></tr>
+/// </table>
+void AdoptCellStores::encode_internal(uint8_t **bufp) const {
+  m_table.encode(bufp);
+  m_range_spec.encode(bufp);
+  Serialization::encode_i32(bufp, m_files.size());
+  for (auto &entry : m_files) {
+    Serialization::encode_vstr(bufp, entry.first);
+    Serialization::encode_vstr(bufp, entry.second);
+  }
+}
+
+void AdoptCellStores::decode_internal(uint8_t version, const uint8_t **bufp,
+                                      size_t *remainp) {
+  m_table.decode(bufp, remainp);
+  m_range_spec.decode(bufp, remainp);
+  size_t count = Serialization::decode_i32(bufp, remainp);
+  m_files.reserve(count);
+  for (size_t i=0; i<count; ++i) {
+    std::string ag_name = Serialization::decode_vstr(bufp, remainp);
+    std::string file = Serialization::decode_vstr(bufp, remainp);
+    m_files.push_back(std::make_pair(ag_name, file));
+  }
+}
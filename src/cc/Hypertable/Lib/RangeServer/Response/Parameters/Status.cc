@@ -29,6 +29,8 @@
 
 #include "Status.h"
 
+#include <Common/Serialization.h>
+
 using namespace Hypertable;
 using namespace Hypertable::Lib::RangeServer;
 
@@ -37,7 +39,8 @@ uint8_t Response::Parameters::Status::encoding_version() const {
 }
 
 size_t Response::Parameters::Status::encoded_length_internal() const {
-  return m_status.encoded_length();
+  return m_status.encoded_length() +
+    Serialization::encoded_length_vstr(m_latency_report);
 }
 
 /// @details
@@ -51,13 +54,22 @@ size_t Response::Parameters::Status::encoded_length_internal() const {
 /// <td>Hypertable::Status</td>
 /// <td>%Status information</td>
 /// </tr>
+/// <tr>
+/// <td>vstr</td>
+/// <td>Latency histogram report, empty if not requested.  Appended without
+/// a version bump; older decoders skip it.</td>
+/// </tr>
 /// </table>
 void Response::Parameters::Status::encode_internal(uint8_t **bufp) const {
   m_status.encode(bufp);
+  Serialization::encode_vstr(bufp, m_latency_report);
 }
 
 void Response::Parameters::Status::decode_internal(uint8_t version,
                                                    const uint8_t **bufp,
                                                    size_t *remainp) {
   m_status.decode(bufp, remainp);
+  // Encodings from older servers end here
+  if (*remainp > 0)
+    m_latency_report = Serialization::decode_vstr(bufp, remainp);
 }
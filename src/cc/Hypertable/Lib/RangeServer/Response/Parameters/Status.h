@@ -59,10 +59,23 @@ namespace Parameters {
     /// @param status %Status information
     Status(const Hypertable::Status &status) : m_status(status) {}
 
+    /// Constructor.
+    /// Initializes with parameters for encoding.  Initializes #m_status with
+    /// <code>status</code> and #m_latency_report with
+    /// <code>latency_report</code>.
+    /// @param status %Status information
+    /// @param latency_report Latency histogram report
+    Status(const Hypertable::Status &status, const std::string &latency_report)
+      : m_status(status), m_latency_report(latency_report) {}
+
     /// Gets status information
     /// @return %Status information
     const Hypertable::Status &status() const { return m_status; }
 
+    /// Gets latency histogram report.
+    /// @return Latency histogram report (empty if not requested)
+    const std::string &latency_report() const { return m_latency_report; }
+
   private:
 
     /// Returns encoding version.
@@ -90,6 +103,9 @@ namespace Parameters {
     /// %Status information
     Hypertable::Status m_status;
 
+    /// Latency histogram report
+    std::string m_latency_report;
+
   };
 
   /// @}
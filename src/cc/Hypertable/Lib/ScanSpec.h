@@ -136,6 +136,17 @@ namespace Lib {
       return false;
     }
 
+    /// Checks if results can be held in the range scan cache.
+    /// Scans that are cacheable() are left to the query cache.  Scans with
+    /// a row or cell offset are excluded since the skipped counts returned
+    /// to the client are not cached.
+    /// @return <i>true</i> if scan is a cacheable multi-row scan,
+    /// <i>false</i> otherwise
+    bool range_cacheable() const {
+      return !do_not_cache && !rebuild_indices && !row_offset && !cell_offset &&
+        !cacheable();
+    }
+
     const char *cache_key() const {
       if (!row_intervals.empty())
         return row_intervals[0].start;
@@ -45,6 +45,8 @@ namespace {
     "quicklz",
     "snappy",
     "zstd",
+    "lz4",
+    "zstd_dict",
     "",
     0
   };
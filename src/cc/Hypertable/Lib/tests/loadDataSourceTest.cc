@@ -33,12 +33,31 @@ extern "C" {
 
 #include "Hypertable/Lib/KeySpec.h"
 #include "Hypertable/Lib/LoadDataSource.h"
+#include "Hypertable/Lib/LoadDataSourceChunk.h"
 #include "Hypertable/Lib/LoadDataSourceFactory.h"
 #include "FsBroker/Lib/Client.h"
 
 using namespace Hypertable;
 using namespace std;
 
+namespace {
+
+  void display(KeySpec &key, uint8_t *value, bool is_delete) {
+    cerr << "row=" << (const char *)key.row;
+    if (key.column_family) {
+      cerr << "\tcolumn_family=" << key.column_family;
+      if (key.column_qualifier_len > 0)
+        cerr << "\tcolumn_qualifier=" << (const char *)key.column_qualifier;
+    }
+    cerr << "\tvalue=" << (const char *)value;
+    if (is_delete)
+      cerr << "\tDELETE\n";
+    else
+      cerr << "\n";
+  }
+
+}
+
 int main(int argc, char **argv) {
   LoadDataSourcePtr lds;
   KeySpec key;
@@ -71,25 +90,44 @@ int main(int argc, char **argv) {
                                             dat_fn.c_str(), LOCAL_FILE, "", LOCAL_FILE,
                                             key_columns, "", '\t', 0, 0));
 
-    while (lds->next(&key, &value, &value_len, &is_delete, 0)) {
-      cerr << "row=" << (const char *)key.row;
-      if (key.column_family) {
-        cerr << "\tcolumn_family=" << key.column_family;
-        if (key.column_qualifier_len > 0)
-          cerr << "\tcolumn_qualifier=" << (const char *)key.column_qualifier;
-      }
-      cerr << "\tvalue=" << (const char *)value;
-      if (is_delete)
-        cerr << "\tDELETE\n";
-      else
-        cerr << "\n";
-    }
+    while (lds->next(&key, &value, &value_len, &is_delete, 0))
+      display(key, value, is_delete);
     cerr << flush;
 
     String golden_fn = testnames[i] + ".golden";
     String sys_cmd = "diff " + output_fn + " " + golden_fn;
     if (system(sys_cmd.c_str()) != 0)
       return 1;
+
+    // Parse the same input in small chunks, as parallel LOAD DATA INFILE
+    // does, and verify that the output is identical
+    output_fn = testnames[i] + "-chunked.output";
+    if ((fd = open(output_fn.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644)) < 0) {
+      perror("open");
+      return 1;
+    }
+
+    close(2);
+    dup(fd);
+
+    lds.reset(LoadDataSourceFactory::create(null_dfs_client,
+                                            dat_fn.c_str(), LOCAL_FILE, "", LOCAL_FILE,
+                                            key_columns, "", '\t', 0, 0));
+    LoadDataSourceChunk chunk_parser(*lds);
+    DynamicBuffer chunk;
+    int64_t start_line;
+    uint64_t consumed;
+
+    while (lds->next_chunk(chunk, 64, &start_line, &consumed)) {
+      chunk_parser.reset(chunk, start_line);
+      while (chunk_parser.next(&key, &value, &value_len, &is_delete, 0))
+        display(key, value, is_delete);
+    }
+    cerr << flush;
+
+    sys_cmd = "diff " + output_fn + " " + golden_fn;
+    if (system(sys_cmd.c_str()) != 0)
+      return 1;
   }
 
   return 0;
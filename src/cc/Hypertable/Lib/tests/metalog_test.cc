@@ -22,6 +22,7 @@
 #include <Common/Compat.h>
 
 #include <Hypertable/Lib/Config.h>
+#include <Hypertable/Lib/MetaLog.h>
 #include <Hypertable/Lib/MetaLogDefinition.h>
 #include <Hypertable/Lib/MetaLogEntity.h>
 #include <Hypertable/Lib/MetaLogReader.h>
@@ -40,10 +41,16 @@
 #include <Common/Serialization.h>
 #include <Common/StringExt.h>
 
+#include <boost/algorithm/string/predicate.hpp>
+
+#include <chrono>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <sstream>
+#include <thread>
 
 using namespace Hypertable;
 using namespace Config;
@@ -157,7 +164,7 @@ namespace {
     writer->record_state(g_entities);
   }
 
-  void display_entities(ofstream &out) {
+  void display_entities(ostream &out) {
     for (size_t i=0; i<g_entities.size(); i++) {
       if (g_entities[i])
         out << *g_entities[i] << "\n";
@@ -165,6 +172,23 @@ namespace {
     out << flush;
   }
 
+  bool has_compaction_marker(FilesystemPtr &fs, const String &dir) {
+    vector<Filesystem::Dirent> listing;
+    fs->readdir(dir, listing);
+    for (auto &entry : listing)
+      if (boost::ends_with(entry.name, ".compacting"))
+        return true;
+    return false;
+  }
+
+  void create_file(FilesystemPtr &fs, const String &name, size_t length) {
+    int fd = fs->create(name, Filesystem::OPEN_FLAG_OVERWRITE, -1, -1, -1);
+    StaticBuffer buf(length);
+    memset(buf.base, 0xff, length);
+    fs->append(fd, buf);
+    fs->close(fd);
+  }
+
 } // local namespace
 
 
@@ -268,6 +292,72 @@ main(int ac, char *av[]) {
       HT_ASSERT(system("diff metalog_test3.out metalog_test3.golden") == 0);
     }
 
+    /**
+     *  Background compaction test
+     */
+    String logdir = testdir + "/" + g_test_definition->name();
+    properties->set("Hypertable.MetaLog.MaxFileSize", (int64_t)100000000);
+    properties->set("Hypertable.MetaLog.Compaction.Ratio", (int32_t)1);
+    properties->set("Hypertable.MetaLog.Compaction.MinimumSize", (int64_t)0);
+    reader = make_shared<MetaLog::Reader>(fs, g_test_definition, logdir);
+    int32_t writer_file_id = reader->next_file_number();
+    reader.reset();
+    writer = make_shared<MetaLog::Writer>(fs, g_test_definition, logdir,
+                                          g_entities);
+
+    {
+      ostringstream expected, out;
+      for (size_t i=0; i<100 && writer->compaction_count() == 0; i++) {
+        randomly_set_values(writer);
+        this_thread::sleep_for(chrono::milliseconds(100));
+      }
+      HT_ASSERT(writer->compaction_count() > 0);
+      HT_ASSERT(!has_compaction_marker(fs, logdir));
+      display_entities(expected);
+      writer.reset();
+      reader = make_shared<MetaLog::Reader>(fs, g_test_definition, logdir);
+      // compacted file replaced the one the writer started with
+      HT_ASSERT(reader->next_file_number() > writer_file_id + 1);
+      int32_t incomplete_id = reader->next_file_number();
+      g_entities.clear();
+      reader->get_entities(g_entities);
+      display_entities(out);
+      reader.reset();
+      HT_ASSERT(out.str() == expected.str());
+
+      // reader skips an incomplete compacted file left behind by a crash
+      create_file(fs, logdir + "/" + incomplete_id, 1024);
+      create_file(fs, MetaLog::compaction_marker_file(logdir, incomplete_id), 0);
+      reader = make_shared<MetaLog::Reader>(fs, g_test_definition, logdir);
+      HT_ASSERT(reader->next_file_number() == incomplete_id + 1);
+      g_entities.clear();
+      reader->get_entities(g_entities);
+      out.str("");
+      display_entities(out);
+      reader.reset();
+      HT_ASSERT(out.str() == expected.str());
+
+      // writer removes a stale marker for the file it is about to create
+      properties->set("Hypertable.MetaLog.Compaction.Ratio", (int32_t)0);
+      String stale_marker =
+        MetaLog::compaction_marker_file(logdir, incomplete_id + 1);
+      create_file(fs, stale_marker, 0);
+      writer = make_shared<MetaLog::Writer>(fs, g_test_definition, logdir,
+                                            g_entities);
+      HT_ASSERT(!fs->exists(stale_marker));
+      randomly_set_values(writer);
+      expected.str("");
+      display_entities(expected);
+      writer.reset();
+      reader = make_shared<MetaLog::Reader>(fs, g_test_definition, logdir);
+      g_entities.clear();
+      reader->get_entities(g_entities);
+      out.str("");
+      display_entities(out);
+      reader.reset();
+      HT_ASSERT(out.str() == expected.str());
+    }
+
     /**
      *  Write another log and skip the RECOVER entry
      */
@@ -7,10 +7,36 @@
 #include <iostream>
 
 #include <Hypertable/Lib/StatsRangeServer.h>
+#include <Hypertable/Lib/RangeServer/Response/Parameters/Status.h>
 
 using namespace Hypertable;
 using namespace std;
 
+namespace {
+
+  /// Status response parameters as encoded and decoded by releases that
+  /// predate the latency report
+  class StatusV1 : public Serializable {
+  public:
+    StatusV1() {}
+    StatusV1(const Status &status) : m_status(status) {}
+    const Status &status() const { return m_status; }
+  private:
+    uint8_t encoding_version() const override { return 1; }
+    size_t encoded_length_internal() const override {
+      return m_status.encoded_length();
+    }
+    void encode_internal(uint8_t **bufp) const override {
+      m_status.encode(bufp);
+    }
+    void decode_internal(uint8_t version, const uint8_t **bufp,
+                         size_t *remainp) override {
+      m_status.decode(bufp, remainp);
+    }
+    Status m_status;
+  };
+
+}
 
 int main(int argc, char *argv[]) {
   Config::init(argc, argv);
@@ -102,4 +128,59 @@ int main(int argc, char *argv[]) {
 
   HT_ASSERT(*stats1 == *stats2);
 
+  delete [] buf;
+
+  // Status response, with and without a latency report, decoded into a
+  // default-constructed object as the client does
+  for (const string &report : { string("update.commit: p50=12us p99=340us\n"),
+                               string() }) {
+    Lib::RangeServer::Response::Parameters::Status
+      status1(Status(Status::Code::WARNING, "disk 90% full"), report);
+    len = status1.encoded_length();
+    buf = new uint8_t [ len ];
+    ptr = buf;
+    status1.encode(&ptr);
+    HT_ASSERT((size_t)(ptr-buf) == len);
+
+    Lib::RangeServer::Response::Parameters::Status status2;
+    ptr2 = buf;
+    status2.decode(&ptr2, &len);
+    HT_ASSERT(len == 0);
+    HT_ASSERT(status2.latency_report() == report);
+    Status::Code code;
+    string text;
+    status2.status().get(&code, text);
+    HT_ASSERT(code == Status::Code::WARNING && text == "disk 90% full");
+
+    // older clients skip the latency report
+    StatusV1 status3;
+    ptr2 = buf;
+    len = status1.encoded_length();
+    status3.decode(&ptr2, &len);
+    HT_ASSERT(len == 0 && ptr2 == ptr);
+    status3.status().get(&code, text);
+    HT_ASSERT(code == Status::Code::WARNING && text == "disk 90% full");
+    delete [] buf;
+  }
+
+  // Status response from an older server
+  {
+    StatusV1 status1(Status(Status::Code::CRITICAL, "no space"));
+    len = status1.encoded_length();
+    buf = new uint8_t [ len ];
+    ptr = buf;
+    status1.encode(&ptr);
+
+    Lib::RangeServer::Response::Parameters::Status status2;
+    ptr2 = buf;
+    status2.decode(&ptr2, &len);
+    HT_ASSERT(len == 0);
+    HT_ASSERT(status2.latency_report().empty());
+    Status::Code code;
+    string text;
+    status2.status().get(&code, text);
+    HT_ASSERT(code == Status::Code::CRITICAL && text == "no space");
+    delete [] buf;
+  }
+
 }
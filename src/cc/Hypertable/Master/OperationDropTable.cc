@@ -121,7 +121,8 @@ OperationDropTable::OperationDropTable(ContextPtr &context, EventPtr &event)
 /// <td><ul>
 /// <li>Handles result of qualifier index dropping sub operation with a call
 ///     to validate_subops(), returning if it failed</li>
-/// <li>Drops the name/id mapping for table in %Hyperspace</li>
+/// <li>Drops the name/id mapping and table file for table in %Hyperspace
+///     with a single compound request</li>
 /// <li>Removes the table directory from the brokered FS</li>
 /// <li>Dependencies set to Dependency::METADATA and "<table-id> move range",
 /// the latter causing the drop table operation to wait for all in-progress
@@ -313,9 +314,12 @@ void OperationDropTable::execute() {
   case OperationState::UPDATE_HYPERSPACE:
 
     try {
-      m_context->namemap->drop_mapping(m_params.name());
+      // Drop mapping and table file in one transaction
+      Hyperspace::CompoundRequest request;
+      m_context->namemap->drop_mapping(m_params.name(), request);
       string filename = m_context->toplevel_dir + "/tables/" + m_id;
-      m_context->hyperspace->unlink(filename.c_str());
+      request.unlink(filename, Hyperspace::CompoundRequest::FLAG_IGNORE_NOT_FOUND);
+      m_context->hyperspace->execute(request);
     }
     catch (Exception &e) {
       if (e.code() != Error::HYPERSPACE_FILE_NOT_FOUND &&
@@ -37,8 +37,10 @@
 #include <boost/graph/topological_sort.hpp>
 #include <boost/graph/graphviz.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <iomanip>
+#include <iterator>
 #include <sstream>
 #include <thread>
 #include <unordered_map>
@@ -47,6 +49,11 @@ using namespace Hypertable;
 using namespace boost;
 using namespace std;
 
+namespace {
+  /// Time a surplus worker waits for work before exiting
+  const std::chrono::milliseconds IDLE_WORKER_TIMEOUT {60000};
+}
+
 OperationProcessor::ThreadContext::ThreadContext(ContextPtr &mctx)
   : master_context(mctx), current_blocked(0), busy_count(0),
     need_order_recompute(false), shutdown(false), paused(false) {
@@ -58,7 +65,8 @@ OperationProcessor::ThreadContext::~ThreadContext() {
 }
 
 
-OperationProcessor::OperationProcessor(ContextPtr &context, size_t thread_count)
+OperationProcessor::OperationProcessor(ContextPtr &context, size_t thread_count,
+                                       size_t max_thread_count)
   : m_context(context) {
 
   if (context->props->get_bool("Hypertable.Master.RecordGraphvizStream")) {
@@ -70,9 +78,12 @@ OperationProcessor::OperationProcessor(ContextPtr &context, size_t thread_count)
 
   m_context.execution_order_iter = m_context.execution_order.end();
   m_context.op = this;
-  Worker worker(m_context);
+  m_context.min_workers = thread_count;
+  m_context.max_workers = std::max(thread_count, max_thread_count);
+
+  std::lock_guard<std::mutex> lock(m_context.mutex);
   for (size_t i=0; i<thread_count; ++i)
-    m_threads.create_thread(worker);
+    add_worker();
 }
 
 OperationProcessor::~OperationProcessor() {
@@ -128,6 +139,28 @@ void OperationProcessor::add_operations(std::vector<OperationPtr> &operations) {
   }
 }
 
+void OperationProcessor::add_worker() {
+
+  // Join workers that have exited
+  for (auto id : m_context.retired_workers) {
+    auto iter = m_workers.find(id);
+    HT_ASSERT(iter != m_workers.end());
+    iter->second->join();
+    m_threads.remove_thread(iter->second);
+    delete iter->second;
+    m_workers.erase(iter);
+  }
+  m_context.retired_workers.clear();
+
+  // New thread blocks on m_context.mutex, so it can't exit before it's
+  // registered in m_workers
+  Worker worker(m_context);
+  Thread *thread = new Thread(worker);
+  m_threads.add_thread(thread);
+  m_workers[thread->get_id()] = thread;
+  m_context.worker_count++;
+}
+
 void OperationProcessor::add_operation_internal(OperationPtr &operation) {
 
   if (operation->exclusive()) {
@@ -280,6 +313,7 @@ void OperationProcessor::activate(const String &name) {
 void OperationProcessor::Worker::operator()() {
   Vertex vertex;
   OperationPtr operation;
+  uint64_t generation {};
   bool current_needs_loading = true;
 
   try {
@@ -316,7 +350,23 @@ void OperationProcessor::Worker::operator()() {
           if (m_context.shutdown)
             return;
 
-          m_context.cond.wait(lock);
+          m_context.idle_workers++;
+          if (m_context.worker_count > m_context.min_workers) {
+            // Exit if surplus worker stays idle
+            if (m_context.cond.wait_for(lock, IDLE_WORKER_TIMEOUT) ==
+                std::cv_status::timeout &&
+                m_context.current_iter == m_context.current.end() &&
+                !m_context.need_order_recompute &&
+                m_context.worker_count > m_context.min_workers) {
+              m_context.idle_workers--;
+              m_context.worker_count--;
+              m_context.retired_workers.push_back(ThisThread::get_id());
+              return;
+            }
+          }
+          else
+            m_context.cond.wait(lock);
+          m_context.idle_workers--;
 
           if (m_context.shutdown)
             return;
@@ -327,6 +377,13 @@ void OperationProcessor::Worker::operator()() {
         operation = m_context.ops[vertex];
         m_context.busy[vertex] = true;
         m_context.busy_count++;
+        generation = m_context.current_generation;
+
+        // Grow pool if runnable operations are left and no worker is idle
+        if (m_context.current_iter != m_context.current.end() &&
+            m_context.idle_workers == 0 &&
+            m_context.worker_count < m_context.max_workers)
+          m_context.op->add_worker();
       }
 
       try {
@@ -346,7 +403,7 @@ void OperationProcessor::Worker::operator()() {
           else if (operation->is_blocked())
             m_context.current_blocked++;
           else
-            m_context.op->update_operation(vertex, operation);
+            m_context.op->update_operation(vertex, operation, generation);
         }
       }
       catch (Exception &e) {
@@ -433,6 +490,7 @@ void OperationProcessor::add_exclusivity(Vertex v, const String &name) {
   }
 
   m_context.exclusivity_index.insert(DependencyIndex::value_type(name, v));
+  m_context.vertex_keys[v].exclusivities.insert(name);
 }
 
 
@@ -476,6 +534,7 @@ void OperationProcessor::add_dependency(Vertex v, const String &name) {
     add_edge(v, bound.first->second);
 
   m_context.dependency_index.insert(DependencyIndex::value_type(name, v));
+  m_context.vertex_keys[v].dependencies.insert(name);
 }
 
 
@@ -500,54 +559,73 @@ void OperationProcessor::add_obstruction(Vertex v, const String &name) {
     add_edge(bound.first->second, v);
 
   m_context.obstruction_index.insert(DependencyIndex::value_type(name, v));
+  m_context.vertex_keys[v].obstructions.insert(name);
 }
 
 
 void OperationProcessor::purge_from_dependency_index(Vertex v) {
-  DependencyIndex::iterator iter, del_iter;
-
-  // Purge from dependency index
-  iter = m_context.dependency_index.begin();
-  while (iter != m_context.dependency_index.end()) {
-    if (iter->second == v) {
-      del_iter = iter++;
-      m_context.dependency_index.erase(del_iter);
-    }
-    else
-      ++iter;
-  }
+  auto iter = m_context.vertex_keys.find(v);
+  if (iter != m_context.vertex_keys.end())
+    purge_from_index(m_context.dependency_index, v, iter->second.dependencies);
 }
 
 
 void OperationProcessor::purge_from_exclusivity_index(Vertex v) {
-  DependencyIndex::iterator iter, del_iter;
-
-  // Purge from exclusivity index
-  iter = m_context.exclusivity_index.begin();
-  while (iter != m_context.exclusivity_index.end()) {
-    if (iter->second == v) {
-      del_iter = iter++;
-      m_context.exclusivity_index.erase(del_iter);
+  auto iter = m_context.vertex_keys.find(v);
+  if (iter != m_context.vertex_keys.end())
+    purge_from_index(m_context.exclusivity_index, v, iter->second.exclusivities);
+}
+
+
+void OperationProcessor::purge_from_obstruction_index(Vertex v) {
+  auto iter = m_context.vertex_keys.find(v);
+  if (iter != m_context.vertex_keys.end())
+    purge_from_index(m_context.obstruction_index, v, iter->second.obstructions);
+}
+
+
+void OperationProcessor::purge_from_index(DependencyIndex &index, Vertex v,
+                                          DependencySet &names) {
+  for (const auto &name : names) {
+    auto bound = index.equal_range(name);
+    while (bound.first != bound.second) {
+      if (bound.first->second == v)
+        bound.first = index.erase(bound.first);
+      else
+        ++bound.first;
     }
-    else
-      ++iter;
   }
+  names.clear();
 }
 
 
-void OperationProcessor::purge_from_obstruction_index(Vertex v) {
-  DependencyIndex::iterator iter, del_iter;
-
-  // Purge from obstruction index
-  iter = m_context.obstruction_index.begin();
-  while (iter != m_context.obstruction_index.end()) {
-    if (iter->second == v) {
-      del_iter = iter++;
-      m_context.obstruction_index.erase(del_iter);
+bool OperationProcessor::dependencies_unchanged(Vertex v,
+                                                OperationPtr &operation) {
+  auto iter = m_context.vertex_keys.find(v);
+  if (iter == m_context.vertex_keys.end())
+    return false;
+
+  DependencySet names;
+  operation->exclusivities(names);
+  if (names != iter->second.exclusivities)
+    return false;
+  operation->obstructions(names);
+  if (names != iter->second.obstructions)
+    return false;
+  operation->dependencies(names);
+  if (names != iter->second.dependencies)
+    return false;
+
+  // Dependencies that would activate a perpetual operation require a re-add
+  DependencySet obstructions;
+  for (auto &perpetual_op : m_context.perpetual_ops) {
+    perpetual_op->obstructions(obstructions);
+    for (const auto &name : names) {
+      if (obstructions.count(name) > 0)
+        return false;
     }
-    else
-      ++iter;
   }
+  return true;
 }
 
 
@@ -577,6 +655,8 @@ void OperationProcessor::state_description(String &output) {
 
   oss << "Num vertices = " << num_vertices(m_context.graph) << "\n";
   oss << "Busy count = " << m_context.busy_count << "\n";
+  oss << "Worker count = " << m_context.worker_count << " (idle "
+      << m_context.idle_workers << ", max " << m_context.max_workers << ")\n";
   oss << "Active set size = " << m_context.current_active.size() << "\n";
   oss << "Need order recompute = " << (m_context.need_order_recompute ? "true\n" : "false\n");
   oss << "Shutdown = " << (m_context.shutdown ? "true\n" : "false\n");
@@ -672,6 +752,7 @@ void OperationProcessor::retire_operation(Vertex v, OperationPtr &operation) {
   m_context.op->purge_from_obstruction_index(v);
   m_context.op->purge_from_dependency_index(v);
   m_context.op->purge_from_exclusivity_index(v);
+  m_context.vertex_keys.erase(v);
   if (in_degree(v, m_context.graph) > 0)
     m_context.need_order_recompute = true;
   clear_vertex(v, m_context.graph);
@@ -696,9 +777,30 @@ void OperationProcessor::retire_operation(Vertex v, OperationPtr &operation) {
 }
 
 
-void OperationProcessor::update_operation(Vertex v, OperationPtr &operation) {
+void OperationProcessor::update_operation(Vertex v, OperationPtr &operation,
+                                          uint64_t generation) {
   not_permanent np(m_context);
 
+  // Gather sub-operations that need to be added
+  std::vector<OperationPtr> sub_ops, new_sub_ops;
+  operation->fetch_sub_operations(sub_ops);
+  for (auto &op : sub_ops) {
+    if (m_context.op_ids.count(op->id()) == 0 && !op->is_complete())
+      new_sub_ops.push_back(op);
+  }
+
+  // If graph is unaffected, put operation back on current set
+  if (new_sub_ops.empty() && !m_context.need_order_recompute &&
+      generation == m_context.current_generation &&
+      m_context.op->dependencies_unchanged(v, operation)) {
+    m_context.current.push_back(vertex_info(v));
+    m_context.current_active.insert(v);
+    if (m_context.current_iter == m_context.current.end())
+      m_context.current_iter = std::prev(m_context.current.end());
+    m_context.cond.notify_all();
+    return;
+  }
+
   m_context.op->purge_from_obstruction_index(v);
   m_context.op->purge_from_dependency_index(v);
 
@@ -708,12 +810,9 @@ void OperationProcessor::update_operation(Vertex v, OperationPtr &operation) {
   m_context.op->add_dependencies(v, operation);
 
   // Add sub-operations
-  std::vector<OperationPtr> sub_ops;
-  operation->fetch_sub_operations(sub_ops);
-  for (auto op : sub_ops) {
-    if (m_context.op_ids.count(op->id()) == 0 && !op->is_complete()) {
+  for (auto &op : new_sub_ops) {
+    if (m_context.op_ids.count(op->id()) == 0)
       m_context.op->add_operation_internal(op);
-    }
   }
 
   m_context.need_order_recompute = true;
@@ -797,6 +896,7 @@ bool OperationProcessor::load_current() {
   m_context.current.clear();
   m_context.current_active.clear();
   m_context.current_blocked = 0;
+  m_context.current_generation++;
   for (int time_slot = m_context.exec_time[m_context.execution_order_iter->vertex];
        m_context.execution_order_iter != m_context.execution_order.end() && time_slot == m_context.exec_time[m_context.execution_order_iter->vertex];
        ++m_context.execution_order_iter) {
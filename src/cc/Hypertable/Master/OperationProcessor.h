@@ -49,6 +49,7 @@
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace Hypertable {
 
@@ -57,10 +58,23 @@ namespace Hypertable {
    */
 
   /** Runs a set of operaions with dependency relationships.
+   * The size of the worker pool adapts to the number of runnable operations.
+   * It starts with <code>thread_count</code> workers and a new worker is
+   * added whenever a runnable operation is waiting and no worker is idle, up
+   * to <code>max_thread_count</code>.  Surplus workers that stay idle for
+   * longer than a minute exit.
    */
   class OperationProcessor {
   public:
-    OperationProcessor(ContextPtr &context, size_t thread_count);
+
+    /** Constructor.
+     * @param context %Master context
+     * @param thread_count Minimum number of worker threads
+     * @param max_thread_count Maximum number of worker threads (0 means fixed
+     * at <code>thread_count</code>)
+     */
+    OperationProcessor(ContextPtr &context, size_t thread_count,
+                       size_t max_thread_count = 0);
     ~OperationProcessor();
     void add_operation(OperationPtr operation);
     void add_operations(std::vector<OperationPtr> &operations);
@@ -82,6 +96,13 @@ namespace Hypertable {
 
     void add_operation_internal(OperationPtr &operation);
 
+    /** Starts a new worker thread.
+     * Joins and frees any workers that have exited since the last call.
+     * @note <code>m_context.mutex</code> must be locked when calling this
+     * method
+     */
+    void add_worker();
+
     struct operation_t {
       typedef boost::vertex_property_tag kind;
     };
@@ -129,6 +150,16 @@ namespace Hypertable {
 
     typedef std::multimap<const String, Vertex> DependencyIndex;
 
+    /// Dependency strings under which a vertex is registered in each index
+    struct VertexKeys {
+      DependencySet exclusivities;
+      DependencySet dependencies;
+      DependencySet obstructions;
+    };
+
+    /// Map from vertex to its index registrations
+    typedef std::unordered_map<Vertex, VertexKeys> VertexKeyMap;
+
     void add_dependencies(Vertex v, OperationPtr &operation);
     void add_exclusivity(Vertex v, const String &name);
     void add_dependency(Vertex v, const String &name);
@@ -136,6 +167,26 @@ namespace Hypertable {
     void purge_from_dependency_index(Vertex v);
     void purge_from_exclusivity_index(Vertex v);
     void purge_from_obstruction_index(Vertex v);
+
+    /** Removes vertex entries from a dependency index.
+     * Only the entries for the strings in <code>names</code> are visited, so
+     * the cost is independent of the number of operations in the graph.
+     * @param index Dependency index
+     * @param v Vertex to remove
+     * @param names Strings under which <code>v</code> is registered (cleared)
+     */
+    void purge_from_index(DependencyIndex &index, Vertex v,
+                          DependencySet &names);
+
+    /** Checks if an operation's dependency strings match its registrations.
+     * Also checks that no perpetual operation would be activated by the
+     * operation's dependencies.
+     * @param v Vertex of operation
+     * @param operation Reference to operation smart pointer
+     * @return <i>true</i> if dependency relationships of the operation are
+     * unchanged, <i>false</i> otherwise
+     */
+    bool dependencies_unchanged(Vertex v, OperationPtr &operation);
     void add_edge(Vertex v, Vertex u);
     void add_edge_permanent(Vertex v, Vertex u);
 
@@ -148,10 +199,19 @@ namespace Hypertable {
     void retire_operation(Vertex v, OperationPtr &operation);
 
     /** Updates dependency relationship of an operation.
+     * If the operation's dependency strings are unchanged, it has no new
+     * sub-operations, and the current set has not been reloaded since it was
+     * taken (<code>generation</code>), the operation is put back on the
+     * current set without recomputing the execution order.
+     * @param v Vertex of operation
+     * @param operation Reference to operation smart pointer
+     * @param generation Value of <code>m_context.current_generation</code>
+     * when the operation was taken
      * @note <code>m_context.mutex</code> must be locked when calling this
      * method
      */
-    void update_operation(Vertex v, OperationPtr &operation);
+    void update_operation(Vertex v, OperationPtr &operation,
+                          uint64_t generation);
 
     /** Recomputes operation execution order.
      * @note <code>m_context.mutex</code> must be locked when calling this
@@ -200,6 +260,19 @@ namespace Hypertable {
       DependencyIndex dependency_index;
       DependencyIndex obstruction_index;
       PerpetualSet perpetual_ops;
+      VertexKeyMap vertex_keys;
+      /// Incremented each time the current set is reloaded
+      uint64_t current_generation {};
+      /// Minimum number of worker threads
+      size_t min_workers {};
+      /// Maximum number of worker threads
+      size_t max_workers {};
+      /// Number of running worker threads
+      size_t worker_count {};
+      /// Number of worker threads waiting for work
+      size_t idle_workers {};
+      /// IDs of worker threads that have exited and need to be joined
+      std::vector<Thread::id> retired_workers;
       size_t busy_count;
       bool need_order_recompute;
       bool shutdown;
@@ -241,6 +314,7 @@ namespace Hypertable {
 
     ThreadContext m_context;
     ThreadGroup m_threads;
+    std::map<Thread::id, Thread *> m_workers;
     std::unique_ptr<std::ofstream> m_graphviz_out;
   };
 
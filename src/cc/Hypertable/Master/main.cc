@@ -55,6 +55,7 @@
 #include <Common/Init.h>
 #include <Common/System.h>
 
+#include <algorithm>
 #include <sstream>
 
 extern "C" {
@@ -138,7 +139,12 @@ int main(int argc, char **argv) {
       Hyperspace::SessionPtr hyperspace = make_shared<Hyperspace::Session>(Comm::instance(), properties);
       context = make_shared<Context>(properties, hyperspace);
       context->monitoring = make_shared<Monitoring>(context.get());
-      context->op = std::make_unique<OperationProcessor>(context, get_i32("workers"));
+      // A configured worker maximum below Workers.Minimum lowers the minimum
+      int32_t max_workers = get_i32("workers");
+      int32_t min_workers = std::min(get_i32("Hypertable.Master.Workers.Minimum"),
+                                     max_workers);
+      context->op =
+        std::make_unique<OperationProcessor>(context, min_workers, max_workers);
 
       ConnectionHandlerFactoryPtr connection_handler_factory(new HandlerFactory(context));
       context->comm->listen(listen_addr, connection_handler_factory);
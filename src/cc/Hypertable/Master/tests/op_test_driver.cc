@@ -29,6 +29,7 @@
 #include <Hypertable/Master/OperationCreateTable.h>
 #include <Hypertable/Master/OperationDropNamespace.h>
 #include <Hypertable/Master/OperationDropTable.h>
+#include <Hypertable/Master/OperationEphemeral.h>
 #include <Hypertable/Master/OperationInitialize.h>
 #include <Hypertable/Master/OperationMoveRange.h>
 #include <Hypertable/Master/OperationProcessor.h>
@@ -64,6 +65,7 @@
 #include <boost/algorithm/string.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstdlib>
 #include <fstream>
@@ -102,6 +104,7 @@ namespace {
                    "  balance_plan_authority\n"
                    "  toggle_table_maintenance\n"
                    "  recreate_index_tables\n"
+                   "  throughput (benchmark)\n"
                    "\nOptions");
       cmdline_hidden_desc().add_options()
       ("test", str(), "test to run")
@@ -351,6 +354,92 @@ namespace {
     return true;
   }
 
+  /// Ephemeral operation for measuring OperationProcessor throughput.
+  /// Carries the dependency strings of a move range or create table operation
+  /// and passes through #STEPS states, sleeping in each one to simulate an
+  /// RPC.
+  class OperationThroughput : public OperationEphemeral {
+  public:
+    static const int STEPS = 3;
+    OperationThroughput(ContextPtr &context, const String &name,
+                        std::atomic<int64_t> &completed)
+      : OperationEphemeral(context, MetaLog::EntityType::OPERATION_TEST),
+        m_name(name), m_completed(completed) { }
+
+    /// Sets up dependencies of a move range operation.
+    void as_move(const String &table_id, int range) {
+      String range_name = format("%s[%06d..%06d]", table_id.c_str(),
+                                 range, range+1);
+      m_exclusivities.insert(range_name + " OperationMoveRange");
+      m_dependencies.insert(Dependency::INIT);
+      m_dependencies.insert(Dependency::SERVERS);
+      m_dependencies.insert(Dependency::ROOT);
+      m_dependencies.insert(Dependency::METADATA);
+      m_dependencies.insert(Dependency::SYSTEM);
+      m_dependencies.insert(range_name);
+      m_obstructions.insert(String("OperationMove ") + range_name);
+      m_obstructions.insert(table_id + " move range");
+    }
+
+    /// Sets up dependencies of a create table operation.
+    void as_create() {
+      m_exclusivities.insert(m_name);
+      m_dependencies.insert(Dependency::INIT);
+      m_dependencies.insert(Dependency::METADATA);
+      m_dependencies.insert(Dependency::SYSTEM);
+    }
+
+    void execute() override {
+      this_thread::sleep_for(chrono::milliseconds(1));
+      if (++m_step == STEPS) {
+        complete_ok();
+        m_completed++;
+      }
+    }
+    const String name() override { return "OperationThroughput"; }
+    const String label() override { return "OperationThroughput " + m_name; }
+    void display_state(std::ostream &os) override { os << " " << m_name; }
+
+  private:
+    String m_name;
+    std::atomic<int64_t> &m_completed;
+    int m_step {};
+  };
+
+  /// Runs operations through an OperationProcessor and reports throughput.
+  void run_throughput(ContextPtr &context, size_t min_workers,
+                      size_t max_workers, int move_count, int create_count) {
+    std::atomic<int64_t> completed {};
+    std::vector<OperationPtr> operations;
+
+    for (int i=0; i<move_count; i++) {
+      auto op = make_shared<OperationThroughput>(context, format("move-%d", i),
+                                                 completed);
+      op->as_move(format("4/%d", i%10), i);
+      operations.push_back(op);
+    }
+    for (int i=0; i<create_count; i++) {
+      auto op = make_shared<OperationThroughput>(context,
+                                                 format("/bench/table%d", i),
+                                                 completed);
+      op->as_create();
+      operations.push_back(op);
+    }
+
+    OperationProcessor processor(context, min_workers, max_workers);
+    auto start = chrono::steady_clock::now();
+    processor.add_operations(operations);
+    processor.wait_for_empty();
+    auto millis = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    processor.shutdown();
+    processor.join();
+
+    HT_ASSERT(completed == move_count + create_count);
+    cout << format("workers=%d..%d moves=%d creates=%d elapsed=%lldms "
+                   "throughput=%.1f ops/s", (int)min_workers, (int)max_workers,
+                   move_count, create_count, (Lld)millis,
+                   (double)completed * 1000.0 / (millis ? millis : 1)) << endl;
+  }
 
 } // local namespace
 
@@ -367,6 +456,7 @@ void move_range_test(ContextPtr &context);
 void balance_plan_authority_test(ContextPtr &context);
 void toggle_table_maintenance_test(ContextPtr &context);
 void recreate_index_tables_test(ContextPtr &context);
+void throughput_test(ContextPtr &context);
 
 
 int main(int argc, char **argv) {
@@ -442,6 +532,8 @@ int main(int argc, char **argv) {
       toggle_table_maintenance_test(context);
     else if (testname == "recreate_index_tables")
       recreate_index_tables_test(context);
+    else if (testname == "throughput")
+      throughput_test(context);
     else {
       HT_ERRORF("Unrecognized test name: %s", testname.c_str());
       quick_exit(EXIT_FAILURE);
@@ -1084,3 +1176,12 @@ void recreate_index_tables_test(ContextPtr &context) {
   context = 0;
   quick_exit(EXIT_SUCCESS);
 }
+
+
+void throughput_test(ContextPtr &context) {
+  run_throughput(context, 4, 4, 5000, 1000);
+  run_throughput(context, 4, 100, 5000, 1000);
+  run_throughput(context, 10, 400, 20000, 5000);
+  context = 0;
+  quick_exit(EXIT_SUCCESS);
+}
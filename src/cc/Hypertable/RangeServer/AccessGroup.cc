@@ -32,6 +32,7 @@
 #include <Hypertable/RangeServer/CellStoreFactory.h>
 #include <Hypertable/RangeServer/CellStoreReleaseCallback.h>
 #include <Hypertable/RangeServer/CellStoreV7.h>
+#include <Hypertable/RangeServer/CompactionPolicyFactory.h>
 #include <Hypertable/RangeServer/Config.h>
 #include <Hypertable/RangeServer/Global.h>
 #include <Hypertable/RangeServer/MaintenanceFlag.h>
@@ -42,18 +43,26 @@
 #include <Common/DynamicBuffer.h>
 #include <Common/Error.h>
 #include <Common/FailureInducer.h>
+#include <Common/Time.h>
 #include <Common/md5.h>
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
 #include <iterator>
+#include <set>
 #include <vector>
 
 using namespace Hypertable;
 using namespace std;
 
+namespace {
+  /// Bytes of compaction I/O to accumulate before charging the throttle
+  const int64_t THROTTLE_CHUNK_SIZE = 65536;
+}
+
 AccessGroup::AccessGroup(const TableIdentifier *identifier,
                          SchemaPtr &schema, AccessGroupSpec *ag_spec,
                          const RangeSpec *range, const Hints *hints)
@@ -122,6 +131,9 @@ void AccessGroup::update_schema(SchemaPtr &schema,
         m_cellstore_props);
     }
 
+    CompactionPolicyPtr compaction_policy =
+      CompactionPolicyFactory::create(ag_spec->get_option_compaction_policy());
+
     for (auto cf_spec : ag_spec->columns()) {
       iter = m_column_families.find(cf_spec->get_id());
       if (iter == m_column_families.end()) {
@@ -142,6 +154,7 @@ void AccessGroup::update_schema(SchemaPtr &schema,
     // Update schema ptr
     lock_guard<mutex> lock(m_mutex);
     m_schema = schema;
+    m_compaction_policy = compaction_policy;
   }
 }
 
@@ -372,9 +385,35 @@ AccessGroup::get_maintenance_data(ByteArena &arena, time_t now, int flags) {
   mdata->disk_used = m_disk_usage;
   int64_t du = m_in_memory ? 0 : m_disk_usage;
   mdata->disk_estimate = du + (int64_t)(m_compression_ratio * (float)mdata->mem_used);
-  mdata->outstanding_scanners = m_outstanding_scanner_count;
   mdata->in_memory = m_in_memory;
 
+  {
+    lock_guard<mutex> lock(m_outstanding_scanner_mutex);
+    mdata->outstanding_scanners = m_outstanding_scanner_count;
+    if (MaintenanceFlag::rotate_scan_statistics(flags)) {
+      m_scan_stats_decayed.scans = (m_scan_stats_decayed.scans + m_scan_stats.scans) / 2.0;
+      m_scan_stats_decayed.stores_touched = (m_scan_stats_decayed.stores_touched + m_scan_stats.stores_touched) / 2.0;
+      m_scan_stats_decayed.cells_scanned = (m_scan_stats_decayed.cells_scanned + m_scan_stats.cells_scanned) / 2.0;
+      m_scan_stats_decayed.cells_returned = (m_scan_stats_decayed.cells_returned + m_scan_stats.cells_returned) / 2.0;
+      m_scan_stats_decayed.point_lookups = (m_scan_stats_decayed.point_lookups + m_scan_stats.point_lookups) / 2.0;
+      m_scan_stats_decayed.range_bytes_returned = (m_scan_stats_decayed.range_bytes_returned + m_scan_stats.range_bytes_returned) / 2.0;
+      m_scan_stats = ScanStatistics();
+    }
+    mdata->scans = m_scan_stats_decayed.scans;
+    if (m_scan_stats_decayed.scans > 0.0) {
+      mdata->stores_per_scan =
+        m_scan_stats_decayed.stores_touched / m_scan_stats_decayed.scans;
+      mdata->point_lookup_ratio =
+        m_scan_stats_decayed.point_lookups / m_scan_stats_decayed.scans;
+      mdata->cells_per_scan =
+        m_scan_stats_decayed.cells_returned / m_scan_stats_decayed.scans;
+    }
+    if (m_scan_stats_decayed.cells_scanned > 0.0)
+      mdata->read_amplification = m_scan_stats_decayed.cells_scanned /
+        std::max(m_scan_stats_decayed.cells_returned, 1.0);
+    mdata->adaptive_blocksize = m_adaptive_blocksize;
+  }
+
   CellStoreMaintenanceData **tailp = 0;
   mdata->csdata = 0;
   for (size_t i=0; i<m_stores.size(); i++) {
@@ -421,8 +460,14 @@ AccessGroup::get_maintenance_data(ByteArena &arena, time_t now, int flags) {
   // If immutable cache installed, compaction in progress
   if (m_cell_cache_manager->immutable_cache())
     mdata->gc_needed = false;
-  else
+  else {
     mdata->gc_needed = m_garbage_tracker.check_needed(now);
+    int64_t now_ns = (int64_t)now * 1000000000LL;
+    for (auto &csi : m_stores) {
+      if (m_garbage_tracker.check_expired(csi, now_ns))
+        mdata->expired_file_count++;
+    }
+  }
 
   mdata->needs_merging = m_needs_merging;
   mdata->end_merge = m_end_merge;
@@ -435,11 +480,14 @@ AccessGroup::get_maintenance_data(ByteArena &arena, time_t now, int flags) {
 
 void AccessGroup::load_cellstore(CellStorePtr &cellstore) {
 
-  // Record the latest stored revision
-  int64_t revision = boost::any_cast<int64_t>
-    (cellstore->get_trailer()->get("revision"));
-  if (revision > m_latest_stored_revision)
-    m_latest_stored_revision = revision;
+  // Record the latest stored revision (bulk loaded stores don't cover any
+  // part of the commit log)
+  if (!cellstore->bulk_loaded()) {
+    int64_t revision = boost::any_cast<int64_t>
+      (cellstore->get_trailer()->get("revision"));
+    if (revision > m_latest_stored_revision)
+      m_latest_stored_revision = revision;
+  }
 
   if (m_in_memory) {
     HT_ASSERT(m_stores.empty());
@@ -502,6 +550,11 @@ void AccessGroup::run_compaction(int maintenance_flags, Hints *hints) {
   hints->ag_name = m_name;
   m_file_tracker.get_file_list(hints->files);
 
+  if (MaintenanceFlag::drop_expired(maintenance_flags)) {
+    drop_expired_cellstores(hints);
+    return;
+  }
+
   while (abort_loop) {
     lock_guard<mutex> lock(m_mutex);
     if (m_in_memory) {
@@ -570,6 +623,18 @@ void AccessGroup::run_compaction(int maintenance_flags, Hints *hints) {
     cellstore_props = m_cellstore_props;
   }
 
+  if (Config::get_bool("Hypertable.RangeServer.CellStore.AdaptiveBlockSize")) {
+    int32_t blocksize = compute_adaptive_blocksize();
+    if (blocksize) {
+      cellstore_props = make_shared<Properties>(*cellstore_props);
+      cellstore_props->set("blocksize", blocksize);
+      HT_INFOF("Compaction of %s using adaptive block size %d",
+               m_full_name.c_str(), (int)blocksize);
+    }
+    lock_guard<mutex> lock(m_outstanding_scanner_mutex);
+    m_adaptive_blocksize = blocksize;
+  }
+
   time_t now = time(0);
   int64_t max_num_entries;
   CellListScannerPtr scanner;
@@ -671,11 +736,22 @@ void AccessGroup::run_compaction(int maintenance_flags, Hints *hints) {
     cellstore = make_shared<CellStoreV7>(Global::dfs.get(), m_schema);
     cellstore->create(cs_file.c_str(), max_num_entries, cellstore_props, &m_identifier);
 
+    // Charge I/O to the compaction throttle in chunks to keep lock
+    // traffic low
+    CompactionThrottle::Class io_class =
+      CompactionThrottle::classify(maintenance_flags);
+    int64_t io_bytes = 0;
+
     if (mscanner) {
       while (mscanner->get(key, value)) {
         cellstore->add(key, value);
         if (m_in_memory)
           filtered_cache->add(key, value);
+        io_bytes += key.length + value.length();
+        if (io_bytes >= THROTTLE_CHUNK_SIZE && Global::compaction_throttle) {
+          Global::compaction_throttle->acquire(io_class, io_bytes);
+          io_bytes = 0;
+        }
         mscanner->forward();
       }
     }
@@ -684,10 +760,18 @@ void AccessGroup::run_compaction(int maintenance_flags, Hints *hints) {
         cellstore->add(key, value);
         if (m_in_memory)
           filtered_cache->add(key, value);
+        io_bytes += key.length + value.length();
+        if (io_bytes >= THROTTLE_CHUNK_SIZE && Global::compaction_throttle) {
+          Global::compaction_throttle->acquire(io_class, io_bytes);
+          io_bytes = 0;
+        }
         scanner->forward();
       }
     }
 
+    if (io_bytes && Global::compaction_throttle)
+      Global::compaction_throttle->acquire(io_class, io_bytes);
+
     CellStoreTrailerV7 *trailer = dynamic_cast<CellStoreTrailerV7 *>(cellstore->get_trailer());
 
     if (major)
@@ -847,6 +931,80 @@ void AccessGroup::run_compaction(int maintenance_flags, Hints *hints) {
   }
 }
 
+int64_t AccessGroup::adopt_cellstores(const vector<String> &files,
+                                      int64_t revision_limit, Hints *hints) {
+  String prefix = format("%s/tables/%s/%s/", Global::toplevel_dir.c_str(),
+                         m_identifier.id, m_name.c_str());
+  vector<CellStorePtr> cellstores;
+  set<String> adopted;
+  int64_t total_index_entries = 0;
+  int64_t latest_revision = TIMESTAMP_MIN;
+
+  if (m_in_memory)
+    HT_THROWF(Error::NOT_IMPLEMENTED, "Bulk load into in memory access "
+              "group %s", m_full_name.c_str());
+
+  {
+    lock_guard<mutex> lock(m_mutex);
+    for (auto &csinfo : m_stores)
+      adopted.insert(csinfo.cs->get_filename());
+  }
+
+  for (auto &fname : files) {
+    if (fname.compare(0, prefix.length(), prefix))
+      HT_THROWF(Error::RANGESERVER_BAD_CELLSTORE_FILENAME,
+                "%s is not located under %s", fname.c_str(), prefix.c_str());
+    // A retried request re-sends files that were already adopted
+    if (!adopted.insert(fname).second) {
+      HT_INFOF("Skipping %s, already adopted by %s", fname.c_str(),
+               m_full_name.c_str());
+      continue;
+    }
+    CellStorePtr cellstore = CellStoreFactory::open(fname, m_start_row.c_str(),
+                                                    m_end_row.c_str());
+    if (!cellstore->bulk_loaded())
+      HT_THROWF(Error::RANGESERVER_BAD_CELLSTORE_FILENAME,
+                "%s was not written by a bulk loader", fname.c_str());
+    int64_t revision = boost::any_cast<int64_t>
+      (cellstore->get_trailer()->get("revision"));
+    if (revision > revision_limit)
+      HT_THROWF(Error::RANGESERVER_CLOCK_SKEW, "Revision %lld of %s is ahead "
+                "of the RangeServer clock (%lld)", (Lld)revision,
+                fname.c_str(), (Lld)revision_limit);
+    if (revision > latest_revision)
+      latest_revision = revision;
+    cellstores.push_back(cellstore);
+  }
+
+  if (cellstores.empty()) {
+    load_hints(hints);
+    return latest_revision;
+  }
+
+  {
+    lock_guard<mutex> lock(m_mutex);
+    for (auto &cellstore : cellstores)
+      m_stores.push_back(cellstore);
+    m_garbage_tracker.update_cellstore_info(m_stores, time(0), false);
+    get_merge_info(m_needs_merging, m_end_merge);
+    recompute_compression_ratio(&total_index_entries);
+    hints->latest_stored_revision = m_latest_stored_revision;
+    hints->disk_usage = m_disk_usage;
+  }
+
+  vector<String> removed_files;
+  for (auto &cellstore : cellstores)
+    m_file_tracker.update_live(cellstore->get_filename(), removed_files,
+                               m_next_cs_id, total_index_entries);
+  m_file_tracker.update_files_column();
+  hints->ag_name = m_name;
+  m_file_tracker.get_file_list(hints->files);
+
+  HT_INFOF("Adopted %d bulk loaded cell stores into %s",
+           (int)cellstores.size(), m_full_name.c_str());
+  return latest_revision;
+}
+
 void AccessGroup::load_hints(Hints *hints) {
   hints->ag_name = m_name;
   m_file_tracker.get_file_list(hints->files);
@@ -1022,6 +1180,65 @@ void AccessGroup::release_files(const vector<String> &files) {
 }
 
 
+void AccessGroup::record_scan(size_t stores_touched, int64_t cells_scanned,
+                              int64_t cells_returned, int64_t bytes_returned,
+                              bool point_lookup) {
+  lock_guard<mutex> lock(m_outstanding_scanner_mutex);
+  m_scan_stats.scans += 1.0;
+  m_scan_stats.stores_touched += (double)stores_touched;
+  m_scan_stats.cells_scanned += (double)cells_scanned;
+  m_scan_stats.cells_returned += (double)cells_returned;
+  if (point_lookup)
+    m_scan_stats.point_lookups += 1.0;
+  else
+    m_scan_stats.range_bytes_returned += (double)bytes_returned;
+}
+
+
+int32_t AccessGroup::compute_adaptive_blocksize() {
+  double scans, point_lookups, range_bytes_returned;
+  {
+    lock_guard<mutex> lock(m_outstanding_scanner_mutex);
+    scans = m_scan_stats_decayed.scans + m_scan_stats.scans;
+    point_lookups =
+      m_scan_stats_decayed.point_lookups + m_scan_stats.point_lookups;
+    range_bytes_returned = m_scan_stats_decayed.range_bytes_returned +
+      m_scan_stats.range_bytes_returned;
+  }
+
+  return adaptive_blocksize(scans, point_lookups, range_bytes_returned,
+      Config::get_i32("Hypertable.RangeServer.CellStore.MinBlockSize"),
+      Config::get_i32("Hypertable.RangeServer.CellStore.MaxBlockSize"),
+      Config::get_i32("Hypertable.RangeServer.CellStore.AdaptiveBlockSize.MinScans"));
+}
+
+
+int32_t AccessGroup::adaptive_blocksize(double scans, double point_lookups,
+                                        double range_bytes_returned,
+                                        int32_t min_blocksize,
+                                        int32_t max_blocksize,
+                                        int32_t min_scans) {
+
+  if (scans < std::max((double)min_scans, 1.0) || min_blocksize <= 0 ||
+      max_blocksize < min_blocksize)
+    return 0;
+
+  double point_ratio = point_lookups / scans;
+  double range_scans = scans - point_lookups;
+  double range_target = (range_scans >= 1.0) ?
+    range_bytes_returned / range_scans : (double)min_blocksize;
+  range_target = std::min(std::max(range_target, (double)min_blocksize),
+                          (double)max_blocksize);
+
+  double target = exp(point_ratio * log((double)min_blocksize) +
+                      (1.0 - point_ratio) * log(range_target));
+
+  // Round to nearest power of two within [min, max]
+  int32_t blocksize = 1 << (int)lround(log2(target));
+  return std::min(std::max(blocksize, min_blocksize), max_blocksize);
+}
+
+
 void AccessGroup::stage_compaction() {
   lock_guard<mutex> lock(m_mutex);
   HT_ASSERT(m_cell_cache_manager->immutable_cache_empty());
@@ -1043,6 +1260,52 @@ void AccessGroup::unstage_compaction() {
 }
 
 
+void AccessGroup::drop_expired_cellstores(Hints *hints) {
+  vector<String> removed_files;
+  int64_t total_index_entries = 0;
+  int64_t now = get_ts64();
+
+  {
+    lock_guard<mutex> lock(m_mutex);
+
+    vector<CellStoreInfo> new_stores;
+    new_stores.reserve(m_stores.size());
+    for (auto &csi : m_stores) {
+      if (m_garbage_tracker.check_expired(csi, now))
+        removed_files.push_back(csi.cs->get_filename());
+      else
+        new_stores.push_back(csi);
+    }
+
+    if (!removed_files.empty()) {
+      m_stores.swap(new_stores);
+      m_garbage_tracker.update_cellstore_info(m_stores, now/1000000000LL, false);
+      get_merge_info(m_needs_merging, m_end_merge);
+      recompute_compression_ratio(&total_index_entries);
+    }
+
+    hints->latest_stored_revision = m_latest_stored_revision;
+    hints->disk_usage = m_disk_usage;
+  }
+
+  if (removed_files.empty())
+    return;
+
+  try {
+    m_file_tracker.update_live("", removed_files, m_next_cs_id,
+                               total_index_entries);
+    m_file_tracker.update_files_column();
+    m_file_tracker.get_file_list(hints->files);
+  }
+  catch (Exception &e) {
+    HT_FATALF("Problem dropping expired cell stores of %s: %s - %s",
+              m_full_name.c_str(), Error::get_text(e.code()), e.what());
+  }
+
+  HT_INFOF("Dropped %d expired cell stores from %s without compaction",
+           (int)removed_files.size(), m_full_name.c_str());
+}
+
 /**
  * Assumes mutex is locked
  */
@@ -1128,85 +1391,17 @@ void AccessGroup::recompute_compression_ratio(int64_t *total_index_entriesp) {
 
 
 bool AccessGroup::find_merge_run(size_t *indexp, size_t *lenp) {
-  size_t index = 0;
-  size_t i = 0;
-  size_t count;
-  int64_t running_total = 0;
-
   if (m_in_memory || m_stores.size() <= 1)
     return false;
 
-  vector<int64_t> disk_usage(m_stores.size());
-
-  // If in "low activity" window, first try to be more aggresive
-  if (Global::low_activity_time.within_window()) {
-    bool run_found = false;
-    for (int64_t target = Global::cellstore_target_size_min*2;
-         target <= Global::cellstore_target_size_max;
-         target += Global::cellstore_target_size_min) {
-      index = 0;
-      i = 0;
-      running_total = 0;
-
-      do {
-        disk_usage[i] = m_stores[i].cs->disk_usage();
-        running_total += disk_usage[i];
-
-        if (running_total >= target) {
-          count = (i - index) + 1;
-          if (count >= (size_t)2) {
-            if (indexp)
-              *indexp = index;
-            if (lenp)
-              *lenp = count;
-            run_found = true;
-            break;
-          }
-          // Otherwise, move the index forward by one and try again
-          running_total -= disk_usage[index];
-          index++;
-        }
-        i++;
-      } while (i < m_stores.size());
-      if (i == m_stores.size())
-        break;
-    }
-    if (run_found)
-      return true;
-  }
-
-  index = 0;
-  i = 0;
-  running_total = 0;
-  do {
-    disk_usage[i] = m_stores[i].cs->disk_usage();
-    running_total += disk_usage[i];
-
-    if (running_total >= Global::cellstore_target_size_min) {
-      count = (i - index) + 1;
-      if (count >= (size_t)Global::merge_cellstore_run_length_threshold) {
-        if (indexp)
-          *indexp = index;
-        if (lenp)
-          *lenp = count;
-        return true;
-      }
-      // Otherwise, move the index forward by one and try again
-      running_total -= disk_usage[index];
-      index++;
-    }
-    i++;
-  } while (i < m_stores.size());
-
-  if ((i-index) >= (size_t)Global::merge_cellstore_run_length_threshold) {
-    if (indexp)
-      *indexp = index;
-    if (lenp)
-      *lenp = i-index;
-    return true;
+  vector<CompactionPolicy::StoreInfo> stores(m_stores.size());
+  for (size_t i=0; i<m_stores.size(); i++) {
+    stores[i].disk_usage = m_stores[i].cs->disk_usage();
+    stores[i].timestamp_min = m_stores[i].timestamp_min;
+    stores[i].timestamp_max = m_stores[i].timestamp_max;
   }
 
-  return false;
+  return m_compaction_policy->find_merge_run(stores, get_ts64(), indexp, lenp);
 }
 
 namespace {
@@ -1267,6 +1462,7 @@ ostream &Hypertable::operator<<(ostream &os, const AccessGroup::MaintenanceData
   os << "key_bytes=" << mdata.key_bytes << "\n";
   os << "value_bytes=" << mdata.value_bytes << "\n";
   os << "file_count=" << mdata.file_count << "\n";
+  os << "expired_file_count=" << mdata.expired_file_count << "\n";
   os << "deletes=" << mdata.deletes << "\n";
   os << "outstanding_scanners=" << mdata.outstanding_scanners << "\n";
   os << "compression_ratio=" << mdata.compression_ratio << "\n";
@@ -1277,8 +1473,15 @@ ostream &Hypertable::operator<<(ostream &os, const AccessGroup::MaintenanceData
   os << "bloom_filter_maybes=" << mdata.bloom_filter_maybes << "\n";
   os << "bloom_filter_fps=" << mdata.bloom_filter_fps << "\n";
   os << "shadow_cache_memory=" << mdata.shadow_cache_memory << "\n";
+  os << "scans=" << mdata.scans << "\n";
+  os << "stores_per_scan=" << mdata.stores_per_scan << "\n";
+  os << "read_amplification=" << mdata.read_amplification << "\n";
+  os << "point_lookup_ratio=" << mdata.point_lookup_ratio << "\n";
+  os << "cells_per_scan=" << mdata.cells_per_scan << "\n";
+  os << "adaptive_blocksize=" << mdata.adaptive_blocksize << "\n";
   os << "in_memory=" << (mdata.in_memory ? "true" : "false") << "\n";
   os << "gc_needed=" << (mdata.gc_needed ? "true" : "false") << "\n";
   os << "needs_merging=" << (mdata.needs_merging ? "true" : "false") << "\n";
+  os << "end_merge=" << (mdata.end_merge ? "true" : "false") << "\n";
   return os;
 }
@@ -31,6 +31,7 @@
 #include <Hypertable/RangeServer/CellCacheManager.h>
 #include <Hypertable/RangeServer/CellStore.h>
 #include <Hypertable/RangeServer/CellStoreInfo.h>
+#include <Hypertable/RangeServer/CompactionPolicy.h>
 #include <Hypertable/RangeServer/LiveFileTracker.h>
 #include <Hypertable/RangeServer/MaintenanceFlag.h>
 #include <Hypertable/RangeServer/MergeScannerAccessGroup.h>
@@ -95,6 +96,7 @@ namespace Hypertable {
       int64_t key_bytes;
       int64_t value_bytes;
       uint32_t file_count;
+      uint32_t expired_file_count;
       int32_t deletes;
       int32_t outstanding_scanners;
       float    compression_ratio;
@@ -105,6 +107,19 @@ namespace Hypertable {
       uint32_t bloom_filter_maybes;
       uint32_t bloom_filter_fps;
       uint64_t shadow_cache_memory;
+      /// Decayed number of scans per maintenance interval
+      float    scans;
+      /// Average number of cell stores merged per scan
+      float    stores_per_scan;
+      /// Cells scanned per cell returned
+      float    read_amplification;
+      /// Fraction of scans that were single row lookups
+      float    point_lookup_ratio;
+      /// Average number of cells returned per scan
+      float    cells_per_scan;
+      /// Block size chosen by the last compaction in adaptive block size
+      /// mode, 0 if the configured block size was used
+      int32_t  adaptive_blocksize;
       bool     in_memory;
       bool     gc_needed;
       bool     needs_merging;
@@ -193,6 +208,27 @@ namespace Hypertable {
 
     void run_compaction(int maintenance_flags, Hints *hints);
 
+    /** Adds CellStores written offline by a bulk loader.
+     * Opens each file restricted to this access group's row interval,
+     * appends it to #m_stores, and updates the live file set and the
+     * <i>Files</i> column of the METADATA table.  Files must be located in
+     * this access group's table directory and must have been written
+     * with the CellStoreTrailerV7::BULK_LOAD flag.  The latest stored
+     * revision is left unchanged since bulk loaded data does not cover
+     * anything in the commit log.  Files that are already among this
+     * access group's stores are skipped, so a retried request does not
+     * adopt a file twice.
+     * @param files CellStore files to adopt
+     * @param revision_limit Largest revision an adopted file may carry
+     * @param hints Compaction hints to update
+     * @return Largest revision of the newly adopted files, or
+     * TIMESTAMP_MIN if none were adopted
+     * @throws Exception with code Error::RANGESERVER_CLOCK_SKEW if a file's
+     * revision is greater than <code>revision_limit</code>
+     */
+    int64_t adopt_cellstores(const std::vector<String> &files,
+                             int64_t revision_limit, Hints *hints);
+
     uint64_t purge_memory(MaintenanceFlag::Map &subtask_map);
 
     MaintenanceData *get_maintenance_data(ByteArena &arena, time_t now,
@@ -214,6 +250,20 @@ namespace Hypertable {
 
     void release_files(const std::vector<String> &files);
 
+    /// Records statistics of a completed scan.
+    /// Called by CellStoreReleaseCallback::record_scan() when a
+    /// non-compaction MergeScannerAccessGroup is destroyed.  The statistics
+    /// are reported in the <code>scans</code>, <code>stores_per_scan</code>,
+    /// and <code>read_amplification</code> fields of MaintenanceData.
+    /// @param stores_touched Number of cell stores (or shadow caches) merged
+    /// @param cells_scanned Number of cells read from the merged scanners
+    /// @param cells_returned Number of cells returned by the scan
+    /// @param bytes_returned Key and value bytes returned by the scan
+    /// @param point_lookup <i>true</i> if the scan was a single row lookup
+    void record_scan(size_t stores_touched, int64_t cells_scanned,
+                     int64_t cells_returned, int64_t bytes_returned,
+                     bool point_lookup);
+
     void recovery_initialize() { m_recovering = true; }
     void recovery_finalize() { m_recovering = false; }
 
@@ -238,10 +288,41 @@ namespace Hypertable {
 
     String describe();
 
+    /// Computes an adaptive block size from scan statistics.
+    /// Single row lookups favor <code>min_blocksize</code>, while range
+    /// scans favor the average number of bytes they return, clamped to
+    /// [<code>min_blocksize</code>, <code>max_blocksize</code>].  The result
+    /// is the geometric mean of the two, weighted by the fraction of scans
+    /// that were point lookups, rounded to a power of two and clamped to the
+    /// same interval.
+    /// @param scans Number of (decayed) scans
+    /// @param point_lookups Number of (decayed) single row lookups
+    /// @param range_bytes_returned Bytes returned by the other scans
+    /// @param min_blocksize Smallest block size
+    /// @param max_blocksize Largest block size
+    /// @param min_scans Number of scans required before adapting
+    /// @return Block size, or 0 if there were fewer than
+    /// <code>min_scans</code> scans or the block size limits are invalid
+    static int32_t adaptive_blocksize(double scans, double point_lookups,
+                                      double range_bytes_returned,
+                                      int32_t min_blocksize,
+                                      int32_t max_blocksize,
+                                      int32_t min_scans);
+
   private:
 
     void purge_stored_cells_from_cache();
     void merge_caches();
+
+    /** Removes cell stores whose cells have all expired due to TTL.
+     * Drops each cell store for which
+     * AccessGroupGarbageTracker::check_expired() returns <i>true</i> from
+     * #m_stores and updates the live file set and the <i>Files</i> column of
+     * the METADATA table.  No cell store data is read or written.
+     * @param hints Compaction hints to update
+     */
+    void drop_expired_cellstores(Hints *hints);
+
     void range_dir_initialize();
     void recompute_compression_ratio(int64_t *total_index_entriesp=0);
 
@@ -264,11 +345,45 @@ namespace Hypertable {
 
     void sort_cellstores_by_timestamp();
 
+    /// Chooses the block size of a new cell store from the scan statistics.
+    /// Calls adaptive_blocksize() with the current and decayed statistics and
+    /// the Hypertable.RangeServer.CellStore.MinBlockSize,
+    /// Hypertable.RangeServer.CellStore.MaxBlockSize and
+    /// Hypertable.RangeServer.CellStore.AdaptiveBlockSize.MinScans
+    /// properties.
+    /// @return Block size, or 0 if too few scans have been recorded
+    int32_t compute_adaptive_blocksize();
+
+    /// Scan statistics.
+    struct ScanStatistics {
+      /// Number of scans
+      double scans {};
+      /// Cell stores merged
+      double stores_touched {};
+      /// Cells read from merged scanners
+      double cells_scanned {};
+      /// Cells returned
+      double cells_returned {};
+      /// Single row lookups
+      double point_lookups {};
+      /// Bytes returned by scans that were not single row lookups
+      double range_bytes_returned {};
+    };
+
     std::mutex m_mutex;
     std::mutex m_schema_mutex;
     std::mutex m_outstanding_scanner_mutex;
     std::condition_variable m_outstanding_scanner_cond;
     int32_t m_outstanding_scanner_count {};
+    /// Scans completed in current maintenance interval (protected by
+    /// #m_outstanding_scanner_mutex)
+    ScanStatistics m_scan_stats;
+    /// Decayed scan statistics of previous maintenance intervals, halved each
+    /// interval (protected by #m_outstanding_scanner_mutex)
+    ScanStatistics m_scan_stats_decayed;
+    /// Block size chosen by last compaction in adaptive mode (protected by
+    /// #m_outstanding_scanner_mutex)
+    int32_t m_adaptive_blocksize {};
     TableIdentifierManaged m_identifier;
     SchemaPtr m_schema;
     std::set<uint8_t> m_column_families;
@@ -281,6 +396,7 @@ namespace Hypertable {
     String m_range_name;
     std::vector<CellStoreInfo> m_stores;
     PropertiesPtr m_cellstore_props;
+    CompactionPolicyPtr m_compaction_policy;
     CellCacheManagerPtr m_cell_cache_manager;
     uint32_t m_next_cs_id {};
     uint64_t m_disk_usage {};
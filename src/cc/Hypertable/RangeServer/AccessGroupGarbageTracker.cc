@@ -54,6 +54,8 @@ void AccessGroupGarbageTracker::update_schema(AccessGroupSpec *ag_spec) {
   lock_guard<mutex> lock(m_mutex);
   m_have_max_versions = false;
   m_min_ttl = 0;
+  m_max_ttl = 0;
+  m_all_have_ttl = true;
   m_in_memory = ag_spec->get_option_in_memory();
   for (auto cf_spec : ag_spec->columns()) {
     if (cf_spec->get_option_max_versions() > 0)
@@ -63,7 +65,11 @@ void AccessGroupGarbageTracker::update_schema(AccessGroupSpec *ag_spec) {
         m_min_ttl = (time_t)cf_spec->get_option_ttl();
       else if (cf_spec->get_option_ttl() < m_min_ttl)
         m_min_ttl = cf_spec->get_option_ttl();
+      if (cf_spec->get_option_ttl() > m_max_ttl)
+        m_max_ttl = cf_spec->get_option_ttl();
     }
+    else if (!cf_spec->get_deleted())
+      m_all_have_ttl = false;
   }
   m_elapsed_target_minimum = m_elapsed_target = m_min_ttl/10;
 }
@@ -118,6 +124,18 @@ bool AccessGroupGarbageTracker::check_needed(time_t now) {
 }
 
 
+bool AccessGroupGarbageTracker::check_expired(const CellStoreInfo &csi,
+                                              int64_t now) {
+  lock_guard<mutex> lock(m_mutex);
+  if (m_in_memory || !m_all_have_ttl || m_max_ttl == 0)
+    return false;
+  // Timestamp range unknown or empty
+  if (csi.timestamp_min > csi.timestamp_max)
+    return false;
+  return csi.timestamp_max < now - ((int64_t)m_max_ttl * 1000000000LL);
+}
+
+
 void
 AccessGroupGarbageTracker::adjust_targets(time_t now,
                                           MergeScannerAccessGroup *mscanner) {
@@ -144,6 +144,20 @@ namespace Hypertable {
     /// otherwise
     bool check_needed(time_t now);
 
+    /// Checks if every cell in a cell store has expired due to TTL.
+    /// A cell store is fully expired if every (non-deleted) column family in
+    /// the access group has a non-zero TTL and the cell store's maximum
+    /// timestamp, as recorded in its trailer, is older than <code>now</code>
+    /// minus #m_max_ttl.  Since TTL filtering is applied before deletes and
+    /// MAX_VERSIONS, and any cell shadowed by a delete record in the cell
+    /// store is at least as old as the delete record, such a cell store can be
+    /// removed without changing the result of any scan.
+    /// @param csi Cell store information
+    /// @param now Current time in nanoseconds since the epoch
+    /// @return <i>true</i> if all cells in the cell store have expired,
+    /// <i>false</i> otherwise
+    bool check_expired(const CellStoreInfo &csi, int64_t now);
+
     /// Determines if garbage collection is actually needed.
     /// Measures the fraction of actual garbage, <code>garbage / total</code>,
     /// in the access group and compares it to #m_garbage_threshold.  If the
@@ -340,6 +354,12 @@ namespace Hypertable {
     /// Minimum TTL found in access group schema
     time_t m_min_ttl {};
 
+    /// Maximum TTL found in access group schema
+    time_t m_max_ttl {};
+
+    /// <i>true</i> if all column families have a non-zero TTL
+    bool m_all_have_ttl {};
+
     /// <i>true</i> if any column families have non-zero MAX_VERSIONS
     bool m_have_max_versions {};
 
@@ -43,7 +43,8 @@ CellCacheScanner::CellCacheScanner(CellCachePtr cellcache,
   Key current;
   String tmp_str;
 
-  m_keys_only = (scan_ctx->spec) ? (scan_ctx->spec->keys_only && !scan_ctx->spec->value_regexp) : false;
+  m_keys_only = scan_ctx->keys_only;
+  m_pushdown = scan_ctx->pushdown;
 
   current_buf.grow(scan_ctx->start_key.row_len +
                    scan_ctx->start_key.column_qualifier_len +
@@ -159,7 +160,13 @@ bool CellCacheScanner::internal_get() {
     return true;
   }
 
-  if (!m_eos) {
+  while (!m_eos) {
+    if (m_pushdown &&
+        m_scan_context_ptr->pushdown_filter(m_cur_entry.key, m_cur_entry.value)) {
+      m_cells_filtered++;
+      internal_forward();
+      continue;
+    }
     if (m_keys_only)
       m_cur_entry.value = (ByteString)0;
     return true;
@@ -68,6 +68,7 @@ namespace Hypertable {
     bool                           m_in_deletes {};
     bool                           m_eos {};
     bool                           m_keys_only {};
+    bool                           m_pushdown {};
   };
 }
 
@@ -45,8 +45,13 @@ namespace Hypertable {
     virtual int64_t get_disk_read() = 0;
     void add_disk_read(int64_t amount) { m_disk_read += amount; }
 
+    /// Returns number of cells dropped by ScanContext::pushdown_filter().
+    /// @return Number of cells filtered before reaching the merge
+    int64_t get_filtered_cells() { return m_cells_filtered; }
+
   protected:
     uint64_t m_disk_read {};
+    int64_t m_cells_filtered {};
     ScanContext *m_scan_context_ptr {};
   };
 
@@ -38,6 +38,10 @@ const char CellStore::INDEX_FIXED_BLOCK_MAGIC[10]    =
     { 'I','d','x','F','i','x','-','-','-','-' };
 const char CellStore::INDEX_VARIABLE_BLOCK_MAGIC[10] =
     { 'I','d','x','V','a','r','-','-','-','-' };
+const char CellStore::DICTIONARY_BLOCK_MAGIC[10]     =
+    { 'D','i','c','t','-','-','-','-','-','-' };
+const char CellStore::VALUE_BLOCK_MAGIC[10]          =
+    { 'V','a','l','u','e','-','-','-','-','-' };
 
 KeyDecompressor *CellStore::create_key_decompressor() {
   return new KeyDecompressorNone();
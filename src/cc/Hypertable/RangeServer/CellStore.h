@@ -226,6 +226,38 @@ namespace Hypertable {
      */
     virtual KeyDecompressor *create_key_decompressor();
 
+    /**
+     * Checks if data blocks end with a restart point array.
+     * Restart points are entries whose key is stored without prefix
+     * compression, allowing a scanner to binary search a block instead of
+     * decompressing it from the start.
+     *
+     * @return <i>true</i> if data blocks carry restart points
+     */
+    virtual bool has_restart_points() { return false; }
+
+    /**
+     * Checks if data blocks store their values in a separate section.
+     * In this layout each data block is a compressed key section whose
+     * entries hold a vint32 offset into a separately compressed value
+     * section that immediately follows it.  The uncompressed key section
+     * ends with the 32-bit on-disk length of the value section.  Scanners
+     * only inflate the value section when a cell of the block is returned
+     * with its value.
+     *
+     * @return <i>true</i> if data blocks have a separate value section
+     */
+    virtual bool has_separate_values() { return false; }
+
+    /**
+     * Checks if this cell store was written offline by a bulk loader.
+     * Bulk loaded cell stores don't cover any part of the commit log, so
+     * their revision must not advance the latest stored revision.
+     *
+     * @return <i>true</i> if written by a bulk loader
+     */
+    virtual bool bulk_loaded() { return false; }
+
     /**
      * Sets the cell store files replaced by this CellStore
      */
@@ -337,6 +369,8 @@ namespace Hypertable {
     static const char DATA_BLOCK_MAGIC[10];
     static const char INDEX_FIXED_BLOCK_MAGIC[10];
     static const char INDEX_VARIABLE_BLOCK_MAGIC[10];
+    static const char DICTIONARY_BLOCK_MAGIC[10];
+    static const char VALUE_BLOCK_MAGIC[10];
 
   protected:
 
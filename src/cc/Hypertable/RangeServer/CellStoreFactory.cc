@@ -104,7 +104,8 @@ CellStorePtr CellStoreFactory::open(const String &name,
     Global::dfs->open(smartfd_ptr);
   }
 
-  if (version == 7) {
+  // Version 8 uses the version 7 trailer; see CellStoreTrailerV7::set_version()
+  if (version == 7 || version == 8) {
     CellStoreTrailerV7 trailer_v7;
 
     if (amount < trailer_v7.size())
@@ -37,3 +37,11 @@ CellStoreReleaseCallback::CellStoreReleaseCallback(AccessGroup *ag)
 void CellStoreReleaseCallback::operator()() const {
   m_access_group->release_files(m_filenames);
 }
+
+void CellStoreReleaseCallback::record_scan(int64_t cells_scanned,
+                                           int64_t cells_returned,
+                                           int64_t bytes_returned,
+                                           bool point_lookup) const {
+  m_access_group->record_scan(m_filenames.size(), cells_scanned,
+                              cells_returned, bytes_returned, point_lookup);
+}
@@ -40,6 +40,16 @@ namespace Hypertable {
 
     void operator()() const;
 
+    /// Records statistics of a completed scan with the access group.
+    /// The number of cell stores touched is the number of files added with
+    /// add_file().
+    /// @param cells_scanned Number of cells read from the merged scanners
+    /// @param cells_returned Number of cells returned by the scan
+    /// @param bytes_returned Key and value bytes returned by the scan
+    /// @param point_lookup <i>true</i> if the scan was a single row lookup
+    void record_scan(int64_t cells_scanned, int64_t cells_returned,
+                     int64_t bytes_returned, bool point_lookup) const;
+
     operator bool () const {
       return m_access_group != 0;
     }
@@ -45,7 +45,8 @@ CellStoreScanner<IndexT>::CellStoreScanner(CellStorePtr &&cellstore, ScanContext
   CellListScanner(scan_ctx), m_cellstore(cellstore), m_decrement_blockindex_refcount(index!=0) {
   SerializedKey start_key, end_key;
 
-  m_keys_only = (scan_ctx->spec) ? (scan_ctx->spec->keys_only && !scan_ctx->spec->value_regexp) : false;
+  m_keys_only = scan_ctx->keys_only;
+  m_pushdown = scan_ctx->pushdown;
 
   if (scan_ctx->has_cell_interval) {
 
@@ -163,16 +164,13 @@ bool CellStoreScanner<IndexT>::get(Key &key, ByteString &value) {
   if (m_eos)
     return false;
 
-  if (m_interval_scanners[m_interval_index]->get(key, value)) {
-    if (m_keys_only)
-      value = 0;
-    return true;
-  }
-
-  m_interval_index++;
-
   while (m_interval_index < m_interval_max) {
     if (m_interval_scanners[m_interval_index]->get(key, value)) {
+      if (m_pushdown && m_scan_context_ptr->pushdown_filter(key, value)) {
+        m_cells_filtered++;
+        m_interval_scanners[m_interval_index]->forward();
+        continue;
+      }
       if (m_keys_only)
         value = 0;
       return true;
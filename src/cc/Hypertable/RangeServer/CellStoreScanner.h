@@ -60,6 +60,7 @@ namespace Hypertable {
     size_t m_interval_max {};
     DynamicBuffer m_key_buf;
     bool m_keys_only {};
+    bool m_pushdown {};
     bool m_eos {};
     bool m_decrement_blockindex_refcount {};
   };
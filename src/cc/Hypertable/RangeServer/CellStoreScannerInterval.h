@@ -23,6 +23,8 @@
 #define HYPERTABLE_CELLSTORESCANNERINTERVAL_H
 
 #include "Common/ByteString.h"
+#include "Common/Error.h"
+#include "Common/Serialization.h"
 #include "Hypertable/Lib/Key.h"
 
 namespace Hypertable {
@@ -41,7 +43,96 @@ namespace Hypertable {
       int64_t zlength;
       const uint8_t *base;
       const uint8_t *end;
+      const uint8_t *restarts;
+      uint32_t restart_count;
+      int64_t value_zlength;
     };
+
+    /** Decodes the value section length at the end of a key section.
+     * Blocks of cell stores with separate values end with the 32-bit
+     * on-disk length of the value section that follows the key section.
+     * This method sets <code>block.value_zlength</code> and moves
+     * <code>block.end</code> back past it.  It must be called before
+     * load_restart_points().
+     * @param block Block with <code>base</code> and <code>end</code> set
+     */
+    static void load_value_section_length(BlockInfo &block) {
+      if (block.end - block.base < 4)
+        HT_THROW(Error::RANGESERVER_CORRUPT_CELLSTORE,
+                 "Data block too small for value section length");
+      const uint8_t *ptr = block.end - 4;
+      size_t remaining = 4;
+      block.value_zlength = Serialization::decode_i32(&ptr, &remaining);
+      block.end -= 4;
+    }
+
+    /** Returns end of entry.
+     * @param value Pointer returned by KeyDecompressor::add(), either the
+     * value or, with separate values, the offset of the value in the value
+     * section
+     * @param separate_values <i>true</i> if values are stored separately
+     * @return Pointer to the next entry
+     */
+    static const uint8_t *entry_end(const uint8_t *value, bool separate_values) {
+      if (separate_values) {
+        Serialization::decode_vi32(&value);
+        return value;
+      }
+      return value + ByteString(value).length();
+    }
+
+    /** Returns value of entry from value section.
+     * @param values Start of inflated value section
+     * @param values_length Length of inflated value section
+     * @param ref Value offset of entry
+     * @return Value of entry
+     */
+    static ByteString section_value(const uint8_t *values,
+                                    uint32_t values_length,
+                                    const uint8_t *ref) {
+      uint32_t offset = Serialization::decode_vi32(&ref);
+      if (offset >= values_length)
+        HT_THROWF(Error::RANGESERVER_CORRUPT_CELLSTORE,
+                  "Value offset %u beyond end of value section (%u)",
+                  (unsigned)offset, (unsigned)values_length);
+      return ByteString(values + offset);
+    }
+
+    /** Decodes the restart point array at the end of a data block.
+     * Blocks written with restart points end with an array of 32-bit
+     * offsets of the entries whose key is stored uncompressed, followed by
+     * the number of restart points.  This method points
+     * <code>block.restarts</code> at the offset array and moves
+     * <code>block.end</code> back to the end of the last entry.
+     * @param block Block with <code>base</code> and <code>end</code> set
+     */
+    static void load_restart_points(BlockInfo &block) {
+      size_t remaining = block.end - block.base;
+      if (remaining < 4)
+        HT_THROW(Error::RANGESERVER_CORRUPT_CELLSTORE,
+                 "Data block too small for restart point array");
+      const uint8_t *ptr = block.end - 4;
+      remaining = 4;
+      block.restart_count = Serialization::decode_i32(&ptr, &remaining);
+      if ((size_t)(block.end - block.base) < 4 + 4*(size_t)block.restart_count)
+        HT_THROWF(Error::RANGESERVER_CORRUPT_CELLSTORE,
+                  "Bad restart point count (%u) in data block",
+                  (unsigned)block.restart_count);
+      block.restarts = block.end - 4 - 4*block.restart_count;
+      block.end = block.restarts;
+    }
+
+    /** Returns start of entry for restart point.
+     * @param block Block with restart points loaded
+     * @param i Index of restart point
+     * @return Pointer to the entry at restart point <code>i</code>
+     */
+    static const uint8_t *restart_point(const BlockInfo &block, uint32_t i) {
+      const uint8_t *ptr = block.restarts + 4*i;
+      size_t remaining = 4;
+      return block.base + Serialization::decode_i32(&ptr, &remaining);
+    }
+
     uint64_t m_disk_read;
   };
 
@@ -56,6 +56,9 @@ CellStoreScannerIntervalBlockIndex<IndexT>::CellStoreScannerIntervalBlockIndex(C
   m_file_id = m_cellstore->get_file_id();
   m_zcodec = m_cellstore->create_block_compression_codec();
   m_key_decompressor = m_cellstore->create_key_decompressor();
+  m_restart_points = m_cellstore->has_restart_points();
+  m_separate_values = m_cellstore->has_separate_values();
+  m_values_needed = !scan_ctx->keys_only;
 
   m_end_row = (m_end_key) ? m_end_key.row() : Key::END_ROW_MARKER;
   m_smartfd_ptr = m_cellstore->get_smartfd_ptr();
@@ -70,8 +73,10 @@ CellStoreScannerIntervalBlockIndex<IndexT>::CellStoreScannerIntervalBlockIndex(C
 
   if (m_start_key) {
     const uint8_t *ptr;
+    if (m_restart_points)
+      seek_restart_point(m_start_key);
     while (m_key_decompressor->less_than(m_start_key)) {
-      ptr = m_cur_value.ptr + m_cur_value.length();
+      ptr = entry_end(m_cur_value.ptr, m_separate_values);
       if (ptr >= m_block.end) {
         if (!fetch_next_block(true)) {
           m_iter = m_index->end();
@@ -104,12 +109,9 @@ CellStoreScannerIntervalBlockIndex<IndexT>::CellStoreScannerIntervalBlockIndex(C
 
 template <typename IndexT>
 CellStoreScannerIntervalBlockIndex<IndexT>::~CellStoreScannerIntervalBlockIndex() {
-  if (m_block.base != 0) {
-    if (m_cached)
-      Global::block_cache->checkin(m_file_id, m_block.offset);
-    else
-      delete [] m_block.base;
-  }
+  if (m_block.base != 0 && m_cached)
+    Global::block_cache->checkin(m_file_id, m_block.offset);
+  release_values();
   delete m_zcodec;
   delete m_key_decompressor;
 }
@@ -121,7 +123,15 @@ bool CellStoreScannerIntervalBlockIndex<IndexT>::get(Key &key, ByteString &value
     return false;
 
   key = m_key;
-  value = m_cur_value;
+  if (!m_separate_values)
+    value = m_cur_value;
+  else if (m_values_needed) {
+    if (m_values_base == 0)
+      load_values();
+    value = section_value(m_values_base, m_values_length, m_cur_value.ptr);
+  }
+  else
+    value = 0;
 
   return true;
 }
@@ -137,7 +147,7 @@ void CellStoreScannerIntervalBlockIndex<IndexT>::forward() {
     if (m_iter == m_index->end())
       return;
 
-    ptr = m_cur_value.ptr + m_cur_value.length();
+    ptr = entry_end(m_cur_value.ptr, m_separate_values);
 
     if (ptr >= m_block.end) {
       if (!fetch_next_block(true)) {
@@ -186,12 +196,12 @@ void CellStoreScannerIntervalBlockIndex<IndexT>::forward() {
 template <typename IndexT>
 bool CellStoreScannerIntervalBlockIndex<IndexT>::fetch_next_block(bool eob) {
 
-  // If we're at the end of the current block, deallocate and move to next
+  // If we're at the end of the current block, release it and move to next.
+  // Uncached blocks live in m_block_buf, which is kept for the next block.
   if (m_block.base != 0 && eob) {
     if (m_cached)
       Global::block_cache->checkin(m_file_id, m_block.offset);
-    else
-      delete [] m_block.base;
+    release_values();
     memset(&m_block, 0, sizeof(m_block));
     ++m_iter;
 
@@ -203,7 +213,6 @@ bool CellStoreScannerIntervalBlockIndex<IndexT>::fetch_next_block(bool eob) {
   }
 
   if (m_block.base == 0 && m_iter != m_index->end()) {
-    DynamicBuffer expand_buf;
     uint32_t len;
 
     m_block.offset = m_iter.value();
@@ -221,102 +230,23 @@ bool CellStoreScannerIntervalBlockIndex<IndexT>::fetch_next_block(bool eob) {
       m_block.zlength = it_next.value() - m_block.offset;
     }
 
-    /**
-     * Cache lookup / block read
-     */
-    if (Global::block_cache == 0 || Global::block_cache->compressed() ||
-        !Global::block_cache->checkout(m_file_id, m_block.offset,
-				       (uint8_t **)&m_block.base, &len)) {
-      bool second_try {};
-      bool checked_out {};
-
-    try_again:
-      try {
-        DynamicBuffer buf;
-        EventPtr event;
-
-	if (Global::block_cache == 0 || !Global::block_cache->compressed() ||
-            !Global::block_cache->checkout(m_file_id, m_block.offset,
-				           (uint8_t **)&buf.base, &len)) {
-
-	  /** Read compressed block **/
-          DispatchHandlerSynchronizer sync_handler;
-	        Global::dfs->pread(m_smartfd_ptr, m_block.zlength, m_block.offset, 
-                             second_try, &sync_handler);
-          if (!sync_handler.wait_for_reply(event))
-            HT_THROW(Protocol::response_code(event.get()),
-                     Protocol::string_format_message(event).c_str());
-          {
-            uint32_t length;
-            uint64_t off;
-            const void *data;
-            Global::dfs->decode_response_read(event, &data, &off, &length);
-            buf.base = (uint8_t *)data;
-            buf.own = false;
-          }
-
-	  checked_out = false;
-	}
-	else {
-	  HT_ASSERT(len == m_block.zlength);
-	  buf.size = m_block.zlength;
-	  buf.own = false;
-	  checked_out = true;
-	}
-
-	buf.ptr = buf.base + m_block.zlength;
-
-        /** inflate compressed block **/
-        BlockHeaderCellStore header(m_cellstore->block_header_format());
-
-        m_zcodec->inflate(buf, expand_buf, header);
-
-        if (!checked_out)
-          m_disk_read += expand_buf.fill();
-
-        if (!header.check_magic(CellStore::DATA_BLOCK_MAGIC))
-          HT_THROW(Error::BLOCK_COMPRESSOR_BAD_MAGIC,
-                   "Error inflating cell store block - magic string mismatch");
-
-        /** Insert or checkin compressed block into cache  **/
-        if (Global::block_cache && Global::block_cache->compressed()) {
-          if (checked_out)
-            Global::block_cache->checkin(m_file_id, m_block.offset);
-          else
-            Global::block_cache->insert(m_file_id, m_block.offset,
-                                        (uint8_t *)buf.base, m_block.zlength,
-                                        event, false);
-        }
-      }
-      catch (Exception &e) {
-        HT_WARN_OUT << "Error reading cell store " << m_smartfd_ptr->to_str() 
-                    << " : " << e << HT_END;
-        HT_WARN_OUT << "pread(" << m_smartfd_ptr->to_str() << ", zlen="
-                    << m_block.zlength << ", offset=" << m_block.offset
-                    << HT_END;
-        if (second_try)
-          throw;
-
-        HT_INFO("Retrying with dfs checksum enabled");
-        second_try = true;
-        goto try_again;
-      }
-
-      /** take ownership of inflate buffer **/
-      size_t fill;
-      m_block.base = expand_buf.release(&fill);
-      len = fill;
+    m_cached = read_block(m_block.offset, m_block.zlength,
+                          CellStore::DATA_BLOCK_MAGIC, m_block_buf,
+                          &m_block.base, &len);
 
-      /** Insert uncompressed block into cache  **/
-      m_cached = Global::block_cache && !Global::block_cache->compressed() &&
-          Global::block_cache->insert(m_file_id, m_block.offset,
-				      (uint8_t *)m_block.base, len, EventPtr(), true);
+    m_block.end = m_block.base + len;
+    if (m_separate_values) {
+      load_value_section_length(m_block);
+      if (m_block.value_zlength > m_block.zlength)
+        HT_THROWF(Error::RANGESERVER_CORRUPT_CELLSTORE,
+                  "Bad value section length %lld in block at offset %lld of %s",
+                  (Lld)m_block.value_zlength, (Lld)m_block.offset,
+                  m_smartfd_ptr->to_str().c_str());
     }
-    else
-      m_cached = true;
+    if (m_restart_points)
+      load_restart_points(m_block);
 
     m_key_decompressor->reset();
-    m_block.end = m_block.base + len;
     m_cur_value.ptr = m_key_decompressor->add(m_block.base);
 
     return true;
@@ -324,6 +254,169 @@ bool CellStoreScannerIntervalBlockIndex<IndexT>::fetch_next_block(bool eob) {
   return false;
 }
 
+/**
+ * Reads and inflates a block, going through the block cache.
+ * If the block is found in the uncompressed block cache it is checked out,
+ * otherwise it is read (or checked out of the compressed block cache) and
+ * inflated into <code>inflate_buf</code>, which is handed over to the
+ * uncompressed block cache if it accepts it.
+ *
+ * @param offset File offset of block
+ * @param zlength Length of block on disk
+ * @param magic Expected magic string of block header
+ * @param inflate_buf Buffer to inflate block into
+ * @param basep Address of pointer to set to the start of the inflated block
+ * @param lenp Address of variable to hold length of inflated block
+ * @return <i>true</i> if the block is checked out of the block cache and
+ * must be checked in when no longer needed
+ */
+template <typename IndexT>
+bool CellStoreScannerIntervalBlockIndex<IndexT>::read_block(int64_t offset,
+        int64_t zlength, const char *magic, DynamicBuffer &inflate_buf,
+        const uint8_t **basep, uint32_t *lenp) {
+  bool cached;
+  uint32_t len;
+
+  /**
+   * Cache lookup / block read
+   */
+  if (Global::block_cache == 0 || Global::block_cache->compressed() ||
+      !Global::block_cache->checkout(m_file_id, offset,
+                                     (uint8_t **)basep, &len)) {
+    LatencyHistogram::ScopedTimer miss_timer(Global::block_cache_miss_latency.get());
+    bool second_try {};
+    bool checked_out {};
+
+  try_again:
+    try {
+      DynamicBuffer buf;
+      EventPtr event;
+
+      if (Global::block_cache == 0 || !Global::block_cache->compressed() ||
+          !Global::block_cache->checkout(m_file_id, offset,
+                                         (uint8_t **)&buf.base, &len)) {
+
+        /** Read compressed block **/
+        DispatchHandlerSynchronizer sync_handler;
+        Global::dfs->pread(m_smartfd_ptr, zlength, offset, second_try,
+                           &sync_handler);
+        if (!sync_handler.wait_for_reply(event))
+          HT_THROW(Protocol::response_code(event.get()),
+                   Protocol::string_format_message(event).c_str());
+        {
+          uint32_t length;
+          uint64_t off;
+          const void *data;
+          Global::dfs->decode_response_read(event, &data, &off, &length);
+          buf.base = (uint8_t *)data;
+          buf.own = false;
+        }
+
+        checked_out = false;
+      }
+      else {
+        HT_ASSERT(len == zlength);
+        buf.size = zlength;
+        buf.own = false;
+        checked_out = true;
+      }
+
+      buf.ptr = buf.base + zlength;
+
+      /** inflate compressed block **/
+      BlockHeaderCellStore header(m_cellstore->block_header_format());
+
+      inflate_buf.clear();
+      m_zcodec->inflate(buf, inflate_buf, header);
+
+      if (!checked_out)
+        m_disk_read += inflate_buf.fill();
+
+      if (!header.check_magic(magic))
+        HT_THROW(Error::BLOCK_COMPRESSOR_BAD_MAGIC,
+                 "Error inflating cell store block - magic string mismatch");
+
+      /** Insert or checkin compressed block into cache  **/
+      if (Global::block_cache && Global::block_cache->compressed()) {
+        if (checked_out)
+          Global::block_cache->checkin(m_file_id, offset);
+        else
+          Global::block_cache->insert(m_file_id, offset, (uint8_t *)buf.base,
+                                      zlength, event, false);
+      }
+    }
+    catch (Exception &e) {
+      HT_WARN_OUT << "Error reading cell store " << m_smartfd_ptr->to_str() 
+                  << " : " << e << HT_END;
+      HT_WARN_OUT << "pread(" << m_smartfd_ptr->to_str() << ", zlen="
+                  << zlength << ", offset=" << offset << HT_END;
+      if (second_try)
+        throw;
+
+      HT_INFO("Retrying with dfs checksum enabled");
+      second_try = true;
+      goto try_again;
+    }
+
+    *basep = inflate_buf.base;
+    len = inflate_buf.fill();
+
+    /** Insert uncompressed block into cache  **/
+    cached = Global::block_cache && !Global::block_cache->compressed() &&
+      Global::block_cache->insert(m_file_id, offset, (uint8_t *)*basep, len,
+                                  EventPtr(), true);
+
+    /** cache took ownership of inflate buffer **/
+    if (cached)
+      inflate_buf.release();
+  }
+  else
+    cached = true;
+
+  *lenp = len;
+  return cached;
+}
+
+template <typename IndexT>
+void CellStoreScannerIntervalBlockIndex<IndexT>::load_values() {
+  m_values_offset = m_block.offset + m_block.zlength - m_block.value_zlength;
+  m_values_cached = read_block(m_values_offset, m_block.value_zlength,
+                               CellStore::VALUE_BLOCK_MAGIC, m_value_buf,
+                               &m_values_base, &m_values_length);
+}
+
+template <typename IndexT>
+void CellStoreScannerIntervalBlockIndex<IndexT>::release_values() {
+  if (m_values_base != 0 && m_values_cached)
+    Global::block_cache->checkin(m_file_id, m_values_offset);
+  m_values_base = 0;
+  m_values_length = 0;
+}
+
+template <typename IndexT>
+void CellStoreScannerIntervalBlockIndex<IndexT>::seek_restart_point(SerializedKey key) {
+
+  // The first entry is already loaded, nothing to skip if it's not less
+  if (m_block.restart_count < 2 || !m_key_decompressor->less_than(key))
+    return;
+
+  // Invariant: key at restart point lo is less than key
+  uint32_t lo = 0;
+  uint32_t hi = m_block.restart_count;
+  while (hi - lo > 1) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    m_key_decompressor->reset();
+    m_key_decompressor->add(restart_point(m_block, mid));
+    if (m_key_decompressor->less_than(key))
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  m_key_decompressor->reset();
+  m_cur_value.ptr = m_key_decompressor->add(restart_point(m_block, lo));
+}
+
 namespace Hypertable {
   template class CellStoreScannerIntervalBlockIndex<CellStoreBlockIndexArray<uint32_t> >;
   template class CellStoreScannerIntervalBlockIndex<CellStoreBlockIndexArray<int64_t> >;
@@ -59,6 +59,21 @@ namespace Hypertable {
 
     bool fetch_next_block(bool eob=false);
 
+    bool read_block(int64_t offset, int64_t zlength, const char *magic,
+                    DynamicBuffer &inflate_buf, const uint8_t **basep,
+                    uint32_t *lenp);
+
+    /// Inflates the value section of the current block.
+    void load_values();
+
+    /// Releases the value section of the current block.
+    void release_values();
+
+    /// Positions #m_key_decompressor at the last restart point of the
+    /// current block whose key is less than <code>key</code>.
+    /// @param key Key being sought
+    void seek_restart_point(SerializedKey key);
+
     CellStorePtr          m_cellstore;
     IndexT               *m_index {};
     IndexIteratorT        m_iter;
@@ -70,10 +85,29 @@ namespace Hypertable {
     SerializedKey         m_end_key;
     const char *          m_end_row {};
     DynamicBuffer         m_key_buf;
+    /// Inflate buffer reused for blocks that could not be inserted into the
+    /// block cache, so a scan that misses the cache does not allocate per block
+    DynamicBuffer         m_block_buf;
+    /// Inflate buffer for value sections that could not be inserted into the
+    /// block cache
+    DynamicBuffer         m_value_buf;
+    /// Start of inflated value section of current block (null if not loaded)
+    const uint8_t        *m_values_base {};
+    /// Length of inflated value section of current block
+    uint32_t              m_values_length {};
+    /// File offset of value section of current block
+    int64_t               m_values_offset {};
+    /// <i>true</i> if value section is checked out of the block cache
+    bool                  m_values_cached {};
     BlockCompressionCodec *m_zcodec {};
     KeyDecompressor       *m_key_decompressor {};
     Filesystem::SmartFdPtr m_smartfd_ptr;
     bool                  m_cached {};
+    bool                  m_restart_points {};
+    /// <i>true</i> if cell store blocks store values in a separate section
+    bool                  m_separate_values {};
+    /// <i>true</i> unless the scan returns keys only
+    bool                  m_values_needed {};
     bool                  m_check_for_range_end {};
     int                   m_file_id {};
     ScanContext          *m_scan_ctx {};
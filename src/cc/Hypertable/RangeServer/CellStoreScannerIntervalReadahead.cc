@@ -55,6 +55,8 @@ CellStoreScannerIntervalReadahead<IndexT>::CellStoreScannerIntervalReadahead(Cel
   memset(&m_block, 0, sizeof(m_block));
   m_zcodec = m_cellstore->create_block_compression_codec();
   m_key_decompressor = m_cellstore->create_key_decompressor();
+  m_separate_values = m_cellstore->has_separate_values();
+  m_values_needed = !scan_ctx->keys_only;
 
   uint16_t csversion = boost::any_cast<uint16_t>(cellstore->get_trailer()->get("version"));
   if (csversion >= 4)
@@ -114,7 +116,7 @@ CellStoreScannerIntervalReadahead<IndexT>::CellStoreScannerIntervalReadahead(Cel
   if (start_key) {
     const uint8_t *ptr;
     while (m_key_decompressor->less_than(start_key)) {
-      ptr = m_cur_value.ptr + m_cur_value.length();
+      ptr = entry_end(m_cur_value.ptr, m_separate_values);
       if (ptr >= m_block.end) {
         if (!fetch_next_block_readahead(true)) {
           m_eos = true;
@@ -151,6 +153,7 @@ CellStoreScannerIntervalReadahead<IndexT>::~CellStoreScannerIntervalReadahead()
       try{Global::dfs->close(m_smartfd_ptr);}catch(...){}
     }
     delete [] m_block.base;
+    delete [] m_values_base;
     delete m_zcodec;
     delete m_key_decompressor;
   }
@@ -171,7 +174,12 @@ bool CellStoreScannerIntervalReadahead<IndexT>::get(Key &key, ByteString &value)
     return false;
 
   key = m_key;
-  value = m_cur_value;
+  if (!m_separate_values)
+    value = m_cur_value;
+  else if (m_values_base)
+    value = section_value(m_values_base, m_values_length, m_cur_value.ptr);
+  else
+    value = 0;
 
   return true;
 }
@@ -187,7 +195,7 @@ void CellStoreScannerIntervalReadahead<IndexT>::forward() {
     if (m_eos)
       return;
 
-    ptr = m_cur_value.ptr + m_cur_value.length();
+    ptr = entry_end(m_cur_value.ptr, m_separate_values);
 
     if (ptr >= m_block.end) {
       if (!fetch_next_block_readahead(true)) {
@@ -240,6 +248,9 @@ bool CellStoreScannerIntervalReadahead<IndexT>::fetch_next_block_readahead(bool
   // If we're at the end of the current block, deallocate and move to next
   if (m_block.base != 0 && eob) {
     delete [] m_block.base;
+    delete [] m_values_base;
+    m_values_base = 0;
+    m_values_length = 0;
     memset(&m_block, 0, sizeof(m_block));
   }
 
@@ -248,45 +259,25 @@ bool CellStoreScannerIntervalReadahead<IndexT>::fetch_next_block_readahead(bool
 
   if (m_block.base == 0 && !m_eos) {
     DynamicBuffer expand_buf(0);
-    uint32_t len;
-    uint32_t nread;
+    size_t fill;
 
     m_block.offset = m_offset;
 
-    /** Read header **/
     try {
-      BlockHeaderCellStore header(m_cellstore->block_header_format());
-      DynamicBuffer input_buf( header.encoded_length() );
-
-      nread = Global::dfs->read(m_smartfd_ptr, input_buf.base, header.encoded_length() );
-      HT_EXPECT(nread == header.encoded_length(), Error::RANGESERVER_SHORT_CELLSTORE_READ);
-
-      size_t remaining = nread;
-
-      header.decode((const uint8_t **)&input_buf.ptr, &remaining);
-
-      size_t extra = 0;
-      if (m_oflags & Filesystem::OPEN_FLAG_DIRECTIO) {
-        if ((header.encoded_length()+header.get_data_zlength())%HT_DIRECT_IO_ALIGNMENT)
-          extra = HT_DIRECT_IO_ALIGNMENT - ((header.encoded_length()+header.get_data_zlength())%HT_DIRECT_IO_ALIGNMENT);
+      read_block_readahead(CellStore::DATA_BLOCK_MAGIC, expand_buf, true);
+      if (m_separate_values) {
+        // The value section immediately follows the key section; it has to
+        // be read regardless, but is only inflated if values are returned
+        DynamicBuffer value_buf(0);
+        read_block_readahead(CellStore::VALUE_BLOCK_MAGIC, value_buf,
+                             m_values_needed);
+        if (m_values_needed) {
+          m_values_base = value_buf.release(&fill);
+          m_values_length = fill;
+        }
       }
-
-      input_buf.grow( input_buf.fill() + header.get_data_zlength() + extra );
-      nread = Global::dfs->read(m_smartfd_ptr, input_buf.ptr,  header.get_data_zlength()+extra);
-      HT_EXPECT(nread == header.get_data_zlength()+extra, Error::RANGESERVER_SHORT_CELLSTORE_READ);
-      input_buf.ptr += header.get_data_zlength() + extra;
-
-      if (m_offset + (int64_t)input_buf.fill() >= m_end_offset && m_end_key)
+      if (m_offset >= m_end_offset && m_end_key)
         m_check_for_range_end = true;
-      m_offset += input_buf.fill();
-
-      m_zcodec->inflate(input_buf, expand_buf, header);
-
-      m_disk_read += expand_buf.fill();
-
-      if (!header.check_magic(CellStore::DATA_BLOCK_MAGIC))
-        HT_THROW(Error::BLOCK_COMPRESSOR_BAD_MAGIC,
-                 "Error inflating cell store block - magic string mismatch");
     }
     catch (Exception &e) {
       HT_ERROR_OUT <<"Error reading cell store " << m_smartfd_ptr->to_str() 
@@ -295,12 +286,15 @@ bool CellStoreScannerIntervalReadahead<IndexT>::fetch_next_block_readahead(bool
     }
 
     /** take ownership of inflate buffer **/
-    size_t fill;
     m_block.base = expand_buf.release(&fill);
-    len = fill;
+
+    m_block.end = m_block.base + fill;
+    if (m_separate_values)
+      load_value_section_length(m_block);
+    if (m_cellstore->has_restart_points())
+      load_restart_points(m_block);
 
     m_key_decompressor->reset();
-    m_block.end = m_block.base + len;
     m_cur_value.ptr = m_key_decompressor->add(m_block.base);
 
     return true;
@@ -308,6 +302,56 @@ bool CellStoreScannerIntervalReadahead<IndexT>::fetch_next_block_readahead(bool
   return false;
 }
 
+/**
+ * Reads the next block from the readahead stream.
+ * Reads the block header and compressed data, including any direct I/O
+ * alignment padding, advances #m_offset past it and optionally inflates it.
+ *
+ * @param magic Expected magic string of block header
+ * @param expand_buf Buffer to inflate block into
+ * @param inflate <i>false</i> to skip over the block without inflating it
+ */
+template <typename IndexT>
+void CellStoreScannerIntervalReadahead<IndexT>::read_block_readahead(const char *magic,
+        DynamicBuffer &expand_buf, bool inflate) {
+  uint32_t nread;
+
+  /** Read header **/
+  BlockHeaderCellStore header(m_cellstore->block_header_format());
+  DynamicBuffer input_buf( header.encoded_length() );
+
+  nread = Global::dfs->read(m_smartfd_ptr, input_buf.base, header.encoded_length() );
+  HT_EXPECT(nread == header.encoded_length(), Error::RANGESERVER_SHORT_CELLSTORE_READ);
+
+  size_t remaining = nread;
+
+  header.decode((const uint8_t **)&input_buf.ptr, &remaining);
+
+  size_t extra = 0;
+  if (m_oflags & Filesystem::OPEN_FLAG_DIRECTIO) {
+    if ((header.encoded_length()+header.get_data_zlength())%HT_DIRECT_IO_ALIGNMENT)
+      extra = HT_DIRECT_IO_ALIGNMENT - ((header.encoded_length()+header.get_data_zlength())%HT_DIRECT_IO_ALIGNMENT);
+  }
+
+  input_buf.grow( input_buf.fill() + header.get_data_zlength() + extra );
+  nread = Global::dfs->read(m_smartfd_ptr, input_buf.ptr,  header.get_data_zlength()+extra);
+  HT_EXPECT(nread == header.get_data_zlength()+extra, Error::RANGESERVER_SHORT_CELLSTORE_READ);
+  input_buf.ptr += header.get_data_zlength() + extra;
+
+  m_offset += input_buf.fill();
+
+  if (!inflate)
+    return;
+
+  m_zcodec->inflate(input_buf, expand_buf, header);
+
+  m_disk_read += expand_buf.fill();
+
+  if (!header.check_magic(magic))
+    HT_THROW(Error::BLOCK_COMPRESSOR_BAD_MAGIC,
+             "Error inflating cell store block - magic string mismatch");
+}
+
 namespace Hypertable {
   template class CellStoreScannerIntervalReadahead<CellStoreBlockIndexArray<uint32_t> >;
   template class CellStoreScannerIntervalReadahead<CellStoreBlockIndexArray<int64_t> >;
@@ -59,11 +59,19 @@ namespace Hypertable {
 
     bool fetch_next_block_readahead(bool eob=false);
 
+    void read_block_readahead(const char *magic, DynamicBuffer &expand_buf,
+                              bool inflate);
+
     CellStorePtr           m_cellstore;
     BlockInfo              m_block;
     Key                    m_key;
     SerializedKey          m_end_key;
     ByteString             m_cur_value;
+    /// Inflated value section of current block (null if values are not
+    /// separate or not needed)
+    uint8_t               *m_values_base {};
+    /// Length of inflated value section
+    uint32_t               m_values_length {};
     BlockCompressionCodec *m_zcodec {};
     KeyDecompressor       *m_key_decompressor {};
     Filesystem::SmartFdPtr m_smartfd_ptr;
@@ -71,6 +79,10 @@ namespace Hypertable {
     int64_t                m_end_offset {};
     bool                   m_check_for_range_end {};
     bool                   m_eos {};
+    /// <i>true</i> if cell store blocks store values in a separate section
+    bool                   m_separate_values {};
+    /// <i>true</i> unless the scan returns keys only
+    bool                   m_values_needed {};
     ScanContext           *m_scan_ctx {};
     uint32_t               m_oflags {};
 
@@ -26,6 +26,7 @@
 
 #include <Common/Compat.h>
 #include "CellStoreTrailerV7.h"
+#include "KeyCompressor.h"
 
 #include <Hypertable/Lib/KeySpec.h>
 #include <Hypertable/Lib/Schema.h>
@@ -92,6 +93,18 @@ void CellStoreTrailerV7::clear() {
 
 
 
+/**
+ */
+void CellStoreTrailerV7::set_version() {
+  if ((flags & (RESTART_POINTS | SEPARATE_VALUES)) ||
+      key_compression_scheme == KeyCompressionType::PREFIX_DELTA)
+    version = 8;
+  else
+    version = 7;
+}
+
+
+
 /**
  */
 void CellStoreTrailerV7::serialize(uint8_t *buf) {
@@ -134,7 +147,7 @@ void CellStoreTrailerV7::serialize(uint8_t *buf) {
   encode_i32(&base, trailer_checksum);
   base -= 4;
 
-  assert(version == 7);
+  assert(version == 7 || version == 8);
   assert((buf-base) == (int)CellStoreTrailerV7::size());
   (void)base;
 }
@@ -221,6 +234,14 @@ void CellStoreTrailerV7::display(std::ostream &os) {
     os << " 64BIT_INDEX";
   if (flags & MAJOR_COMPACTION)
     os << " MAJOR_COMPACTION";
+  if (flags & RESTART_POINTS)
+    os << " RESTART_POINTS";
+  if (flags & BULK_LOAD)
+    os << " BULK_LOAD";
+  if (flags & DICTIONARY)
+    os << " DICTIONARY";
+  if (flags & SEPARATE_VALUES)
+    os << " SEPARATE_VALUES";
   os << " )";
   os << ", alignment=" << alignment;
   os << ", compression_ratio=" << compression_ratio;
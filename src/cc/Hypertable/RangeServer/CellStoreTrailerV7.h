@@ -48,6 +48,14 @@ namespace Hypertable {
     virtual void display(std::ostream &os);
     virtual void display_multiline(std::ostream &os);
 
+    /// Sets #version from the block layout recorded in #flags and
+    /// #key_compression_scheme.  Version 8 shares the version 7 trailer but
+    /// marks files whose blocks carry restart points, delta encoded
+    /// timestamps or separate value sections, which a version 7 reader would
+    /// misparse; such files are rejected by older releases as an
+    /// unrecognized version.
+    void set_version();
+
     int32_t trailer_checksum;
     int64_t fix_index_offset;
     int64_t var_index_offset;
@@ -87,7 +95,11 @@ namespace Hypertable {
 
     enum Flags { INDEX_64BIT = 1,
                  MAJOR_COMPACTION = 2,
-                 SPLIT = 4
+                 SPLIT = 4,
+                 RESTART_POINTS = 8,
+                 BULK_LOAD = 16,
+                 DICTIONARY = 32,
+                 SEPARATE_VALUES = 64
     };
 
     boost::any get(const String& prop) {
@@ -41,6 +41,7 @@
 
 #include "AsyncComm/Protocol.h"
 
+#include "Hypertable/Lib/BlockCompressionCodecNone.h"
 #include "Hypertable/Lib/BlockHeaderCellStore.h"
 #include "Hypertable/Lib/CompressorFactory.h"
 #include "Hypertable/Lib/Key.h"
@@ -55,7 +56,9 @@
 #include "Global.h"
 #include "Config.h"
 #include "KeyCompressorPrefix.h"
+#include "KeyCompressorPrefixDelta.h"
 #include "KeyDecompressorPrefix.h"
+#include "KeyDecompressorPrefixDelta.h"
 
 using namespace std;
 using namespace Hypertable;
@@ -63,6 +66,8 @@ using namespace Hypertable;
 namespace {
   const uint32_t MAX_APPENDS_OUTSTANDING = 3;
   const uint16_t BLOCK_HEADER_VERSION = 1;
+  /// Length of the samples the dictionary is trained from
+  const size_t DICTIONARY_SAMPLE_LENGTH = 1024;
 }
 
 
@@ -98,17 +103,22 @@ CellStoreV7::~CellStoreV7() {
     HT_ERROR_OUT << e << HT_END;
   }
 
-  Global::memory_tracker->subtract( sizeof(CellStoreV7) + sizeof(CellStoreInfo) + m_index_stats.bloom_filter_memory + m_index_stats.block_index_memory );
+  Global::memory_tracker->subtract( sizeof(CellStoreV7) + sizeof(CellStoreInfo) + m_index_stats.bloom_filter_memory + m_index_stats.block_index_memory + m_dictionary_memory );
 
 }
 
 
 BlockCompressionCodec *CellStoreV7::create_block_compression_codec() {
-  return CompressorFactory::create_block_codec(
+  BlockCompressionCodec *codec = CompressorFactory::create_block_codec(
       (BlockCompressionCodec::Type)m_trailer.compression_type);
+  if (m_dictionary && codec->get_type() == BlockCompressionCodec::ZSTD_DICT)
+    static_cast<BlockCompressionCodecZstdDict *>(codec)->set_dictionary(m_dictionary);
+  return codec;
 }
 
 KeyDecompressor *CellStoreV7::create_key_decompressor() {
+  if (m_trailer.key_compression_scheme == KeyCompressionType::PREFIX_DELTA)
+    return new KeyDecompressorPrefixDelta();
   return new KeyDecompressorPrefix();
 }
 
@@ -188,8 +198,6 @@ CellStoreV7::create(const char *fname, size_t max_entries,
   int64_t blocksize = props->get("blocksize", 0);
   String compressor = props->get("compressor", String());
 
-  m_key_compressor = make_shared<KeyCompressorPrefix>();
-
   assert(Config::properties); // requires Config::init* first
   m_replication = get_replication(props, table_id);
   m_create_cs_with_tmp = Config::get<gBool>("Hypertable.RangeServer.CellStore"
@@ -222,6 +230,30 @@ CellStoreV7::create(const char *fname, size_t max_entries,
   m_trailer.blocksize = blocksize;
   m_uncompressed_blocksize = blocksize;
 
+  m_restart_interval = Config::get_i32("Hypertable.RangeServer.CellStore"
+                                       ".RestartInterval");
+  if (m_restart_interval > 0)
+    m_trailer.flags |= CellStoreTrailerV7::RESTART_POINTS;
+
+  if (props->get("bulk-load", false))
+    m_trailer.flags |= CellStoreTrailerV7::BULK_LOAD;
+
+  m_separate_values = Config::get_bool("Hypertable.RangeServer.CellStore"
+                                       ".SeparateValues");
+  if (m_separate_values) {
+    m_trailer.flags |= CellStoreTrailerV7::SEPARATE_VALUES;
+    m_value_buffer.reserve(blocksize*4);
+  }
+
+  if (Config::get_bool("Hypertable.RangeServer.CellStore.DeltaEncodeTimestamps")) {
+    m_key_compressor = make_shared<KeyCompressorPrefixDelta>();
+    m_trailer.key_compression_scheme = KeyCompressionType::PREFIX_DELTA;
+  }
+  else {
+    m_key_compressor = make_shared<KeyCompressorPrefix>();
+    m_trailer.key_compression_scheme = KeyCompressionType::PREFIX;
+  }
+
   // set up the "column_ttl" vector
   HT_ASSERT(m_schema);
   ColumnFamilySpecs &column_family_specs = m_schema->get_column_families();
@@ -246,6 +278,13 @@ CellStoreV7::create(const char *fname, size_t max_entries,
   m_compressor = CompressorFactory::create_block_codec(
       (BlockCompressionCodec::Type)m_trailer.compression_type,
       m_compressor_args);
+
+  if (m_trailer.compression_type == BlockCompressionCodec::ZSTD_DICT) {
+    m_dictionary_capacity = Config::get_i32("Hypertable.RangeServer.CellStore"
+                                            ".Dictionary.MaxSize");
+    m_dictionary_sample_size = Config::get_i32("Hypertable.RangeServer"
+                                               ".CellStore.Dictionary.SampleSize");
+  }
   
   if(m_create_cs_with_tmp)
     m_smartfd_ptr = m_filesys->create_local_temp(m_filename);
@@ -427,6 +466,63 @@ void CellStoreV7::load_bloom_filter() {
 }
 
 
+void CellStoreV7::load_dictionary() {
+  BlockCompressionCodecNone codec((BlockCompressionCodec::Args()));
+  BlockHeaderCellStore header(BLOCK_HEADER_VERSION);
+  DynamicBuffer dict_buf;
+  bool second_try = false;
+  size_t len;
+
+  // The dictionary block sits between the replaced files and the trailer
+  int64_t offset = m_trailer.replaced_files_length;
+  if (!HT_IO_ALIGNED(offset))
+    offset += HT_IO_ALIGNMENT_PADDING(offset);
+  offset += m_trailer.replaced_files_offset;
+  int64_t amount = m_file_length - HT_DIRECT_IO_ALIGNMENT - offset;
+
+  if (amount <= 0)
+    HT_THROWF(Error::RANGESERVER_CORRUPT_CELLSTORE,
+              "Bad dictionary offset %lld in CellStore %s, length=%lld",
+              (Lld)offset, m_smartfd_ptr->to_str().c_str(),
+              (Lld)m_file_length);
+
+  DynamicBuffer buf(amount);
+
+  while (true) {
+    try {
+      len = m_filesys->pread(m_smartfd_ptr, buf.base, amount, offset,
+                             second_try);
+    }
+    catch (Exception &e) {
+      if (!second_try) {
+        second_try = true;
+        continue;
+      }
+      HT_THROW2(e.code(), e, format("Error loading dictionary for CellStore %s",
+                                    m_smartfd_ptr->to_str().c_str()));
+    }
+    break;
+  }
+
+  if (len != (size_t)amount)
+    HT_THROWF(Error::FSBROKER_IO_ERROR, "Problem loading dictionary for "
+              "CellStore %s : tried to read %lld but only got %lld",
+              m_smartfd_ptr->to_str().c_str(), (Lld)amount, (Lld)len);
+
+  m_bytes_read += len;
+
+  buf.ptr = buf.base + len;
+  codec.inflate(buf, dict_buf, header);
+
+  if (!header.check_magic(DICTIONARY_BLOCK_MAGIC))
+    HT_THROW(Error::BLOCK_COMPRESSOR_BAD_MAGIC, m_filename);
+
+  m_dictionary = std::make_shared<ZstdDictionary>(dict_buf.base,
+                                                  dict_buf.fill());
+  m_dictionary_memory = m_dictionary->memory_used();
+}
+
+
 
 uint64_t CellStoreV7::purge_indexes() {
   uint64_t memory_purged = 0;
@@ -459,8 +555,6 @@ uint64_t CellStoreV7::purge_indexes() {
 
 
 void CellStoreV7::add(const Key &key, const ByteString value) {
-  EventPtr event_ptr;
-  DynamicBuffer zbuf;
 
   if (key.revision > m_trailer.revision)
     m_trailer.revision = key.revision;
@@ -472,58 +566,16 @@ void CellStoreV7::add(const Key &key, const ByteString value) {
       m_trailer.timestamp_max = key.timestamp;
   }
 
-  if (m_buffer.fill() > (size_t)m_uncompressed_blocksize) {
-    BlockHeaderCellStore header(BLOCK_HEADER_VERSION, DATA_BLOCK_MAGIC);
+  if (m_buffer.fill() + m_value_buffer.fill() > (size_t)m_uncompressed_blocksize)
+    add_block();
 
-    m_index_builder.add_entry(m_key_compressor, m_offset);
-
-    m_uncompressed_data += (float)m_buffer.fill();
-    m_compressor->deflate(m_buffer, zbuf, header, HT_DIRECT_IO_ALIGNMENT);
-    m_compressed_data += (float)zbuf.fill();
-    m_buffer.clear();
-
-    uint64_t llval = ((uint64_t)m_trailer.blocksize
-        * (uint64_t)m_uncompressed_data) / (uint64_t)m_compressed_data;
-    m_uncompressed_blocksize = (int64_t)llval;
-
-    if(!m_create_cs_with_tmp
-       && m_outstanding_appends >= MAX_APPENDS_OUTSTANDING) {
-      if (!m_sync_handler.wait_for_reply(event_ptr)) {
-        if (event_ptr->type == Event::MESSAGE)
-          HT_THROWF(Hypertable::Protocol::response_code(event_ptr),
-             "Problem writing to FS %s : %s", m_smartfd_ptr->to_str().c_str(),
-             Hypertable::Protocol::string_format_message(event_ptr).c_str());
-        HT_THROWF(event_ptr->error,
-                  "Problem writing to FS %s", m_smartfd_ptr->to_str().c_str());
-      }
-      m_outstanding_appends--;
+  if (m_restart_interval > 0) {
+    if (m_block_entries % m_restart_interval == 0) {
+      // store this key without prefix compression
+      m_key_compressor->reset();
+      m_restart_offsets.push_back(m_buffer.fill());
     }
-
-
-    if (!HT_IO_ALIGNED(zbuf.fill())) {
-      memset(zbuf.ptr, 0, HT_IO_ALIGNMENT_PADDING(zbuf.fill()));
-      zbuf.ptr += HT_IO_ALIGNMENT_PADDING(zbuf.fill());
-    }
-
-    size_t zlen = zbuf.fill();
-    StaticBuffer send_buf(zbuf);
-
-    try { 
-      if(m_create_cs_with_tmp)
-        m_filesys->append_to_temp(m_smartfd_ptr, send_buf);
-      else {
-        m_filesys->append(m_smartfd_ptr, send_buf, 
-                          Filesystem::Flags::NONE, &m_sync_handler); 
-        m_outstanding_appends++;
-      }
-    }
-    catch (Exception &e) {
-      HT_THROW2F(e.code(), e, "Problem writing to FS %s",
-                 m_smartfd_ptr->to_str().c_str());
-    }
-    
-    m_offset += zlen;
-    m_key_compressor->reset();
+    m_block_entries++;
   }
 
   m_key_compressor->add(key);
@@ -543,12 +595,22 @@ void CellStoreV7::add(const Key &key, const ByteString value) {
   if (key.flag <= FLAG_DELETE_CELL_VERSION)
     m_trailer.delete_count++;
 
-  m_buffer.ensure(key_len + value_len);
+  if (m_separate_values) {
+    m_buffer.ensure(key_len + 5);
+    m_key_compressor->write(m_buffer.ptr);
+    m_buffer.ptr += key_len;
+    Serialization::encode_vi32(&m_buffer.ptr, m_value_buffer.fill());
+    m_value_buffer.ensure(value_len);
+    m_value_buffer.add_unchecked(value.ptr, value_len);
+  }
+  else {
+    m_buffer.ensure(key_len + value_len);
 
-  m_key_compressor->write(m_buffer.ptr);
-  m_buffer.ptr += key_len;
+    m_key_compressor->write(m_buffer.ptr);
+    m_buffer.ptr += key_len;
 
-  m_buffer.add_unchecked(value.ptr, value_len);
+    m_buffer.add_unchecked(value.ptr, value_len);
+  }
 
   if (m_bloom_filter_mode != BLOOM_FILTER_DISABLED) {
     if (m_trailer.total_entries < m_max_approx_items) {
@@ -579,54 +641,172 @@ void CellStoreV7::add(const Key &key, const ByteString value) {
 }
 
 
-void CellStoreV7::finalize(TableIdentifier *table_identifier) {
-  EventPtr event_ptr;
-  size_t zlen;
-  DynamicBuffer zbuf(0);
-  SerializedKey key;
-  StaticBuffer send_buf;
-  int64_t index_memory = 0;
+void CellStoreV7::add_block() {
+
+  if (m_restart_interval > 0)
+    append_restart_points();
+
+  if (m_dictionary_sample_size) {
+    // Hold the block back until there is enough data to train the dictionary
+    PendingBlock block;
+    block.offset = m_pending_data.fill();
+    block.length = m_buffer.fill();
+    block.value_length = m_value_buffer.fill();
+    block.key.resize(m_key_compressor->length_uncompressed());
+    m_key_compressor->write_uncompressed((uint8_t *)&block.key[0]);
+    m_pending_data.ensure(m_buffer.fill() + m_value_buffer.fill());
+    m_pending_data.add_unchecked(m_buffer.base, m_buffer.fill());
+    m_pending_data.add_unchecked(m_value_buffer.base, m_value_buffer.fill());
+    m_pending_blocks.push_back(block);
+    if (m_pending_data.fill() >= m_dictionary_sample_size)
+      train_dictionary();
+  }
+  else {
+    m_index_builder.add_entry(m_key_compressor, m_offset);
+    write_data_block(m_buffer, m_value_buffer);
+  }
 
-  if (m_buffer.fill() > 0) {
-    BlockHeaderCellStore header(BLOCK_HEADER_VERSION, DATA_BLOCK_MAGIC);
+  m_buffer.clear();
+  m_value_buffer.clear();
+  m_key_compressor->reset();
+}
 
-    m_index_builder.add_entry(m_key_compressor, m_offset);
 
-    m_uncompressed_data += (float)m_buffer.fill();
-    m_compressor->deflate(m_buffer, zbuf, header, HT_DIRECT_IO_ALIGNMENT);
-    m_compressed_data += (float)zbuf.fill();
+void CellStoreV7::write_data_block(const DynamicBuffer &keys,
+                                   const DynamicBuffer &values) {
+  if (!m_separate_values) {
+    write_block(keys);
+    return;
+  }
+
+  // The value section is compressed first so that its on-disk length can be
+  // appended to the key section, letting readers locate it from the block
+  // index alone
+  DynamicBuffer zvalues;
+  compress_block(values, VALUE_BLOCK_MAGIC, zvalues);
+
+  DynamicBuffer block(keys.fill() + 4);
+  block.add_unchecked(keys.base, keys.fill());
+  Serialization::encode_i32(&block.ptr, zvalues.fill());
+  write_block(block);
+  append_block(zvalues);
+}
 
-    if (!HT_IO_ALIGNED(zbuf.fill())) {
-      memset(zbuf.ptr, 0, HT_IO_ALIGNMENT_PADDING(zbuf.fill()));
-      zbuf.ptr += HT_IO_ALIGNMENT_PADDING(zbuf.fill());
+
+void CellStoreV7::write_block(const DynamicBuffer &block) {
+  DynamicBuffer zbuf;
+  compress_block(block, DATA_BLOCK_MAGIC, zbuf);
+  append_block(zbuf);
+}
+
+
+void CellStoreV7::compress_block(const DynamicBuffer &block, const char *magic,
+                                 DynamicBuffer &zbuf) {
+  BlockHeaderCellStore header(BLOCK_HEADER_VERSION, magic);
+
+  m_uncompressed_data += (float)block.fill();
+  m_compressor->deflate(block, zbuf, header, HT_DIRECT_IO_ALIGNMENT);
+  m_compressed_data += (float)zbuf.fill();
+
+  uint64_t llval = ((uint64_t)m_trailer.blocksize
+      * (uint64_t)m_uncompressed_data) / (uint64_t)m_compressed_data;
+  m_uncompressed_blocksize = (int64_t)llval;
+
+  if (!HT_IO_ALIGNED(zbuf.fill())) {
+    memset(zbuf.ptr, 0, HT_IO_ALIGNMENT_PADDING(zbuf.fill()));
+    zbuf.ptr += HT_IO_ALIGNMENT_PADDING(zbuf.fill());
+  }
+}
+
+
+void CellStoreV7::append_block(DynamicBuffer &zbuf) {
+  EventPtr event_ptr;
+
+  if(!m_create_cs_with_tmp
+     && m_outstanding_appends >= MAX_APPENDS_OUTSTANDING) {
+    if (!m_sync_handler.wait_for_reply(event_ptr)) {
+      if (event_ptr->type == Event::MESSAGE)
+        HT_THROWF(Hypertable::Protocol::response_code(event_ptr),
+           "Problem writing to FS %s : %s", m_smartfd_ptr->to_str().c_str(),
+           Hypertable::Protocol::string_format_message(event_ptr).c_str());
+      HT_THROWF(event_ptr->error,
+                "Problem writing to FS %s", m_smartfd_ptr->to_str().c_str());
     }
-    zlen = zbuf.fill();
-    send_buf = zbuf;
+    m_outstanding_appends--;
+  }
 
+  size_t zlen = zbuf.fill();
+  StaticBuffer send_buf(zbuf);
+
+  try { 
     if(m_create_cs_with_tmp)
       m_filesys->append_to_temp(m_smartfd_ptr, send_buf);
     else {
-      if (m_outstanding_appends >= MAX_APPENDS_OUTSTANDING) {
-        if (!m_sync_handler.wait_for_reply(event_ptr))
-          HT_THROWF(Protocol::response_code(event_ptr),
-                    "Problem finalizing CellStore file %s : %s",
-                    m_smartfd_ptr->to_str().c_str(),
-                    Protocol::string_format_message(event_ptr).c_str());
-        m_outstanding_appends--;
-      }
-
       m_filesys->append(m_smartfd_ptr, send_buf, 
-        Filesystem::Flags::NONE, &m_sync_handler);
+                        Filesystem::Flags::NONE, &m_sync_handler); 
       m_outstanding_appends++;
     }
+  }
+  catch (Exception &e) {
+    HT_THROW2F(e.code(), e, "Problem writing to FS %s",
+               m_smartfd_ptr->to_str().c_str());
+  }
+
+  m_offset += zlen;
+}
 
 
-    m_offset += zlen;
+void CellStoreV7::train_dictionary() {
+
+  // Too little data to train a dictionary that pays for itself
+  if (m_pending_data.fill() >= 8 * m_dictionary_capacity)
+    m_dictionary = ZstdDictionary::train(m_pending_data.base,
+                                         m_pending_data.fill(),
+                                         DICTIONARY_SAMPLE_LENGTH,
+                                         m_dictionary_capacity);
+  m_dictionary_sample_size = 0;
+
+  if (m_dictionary) {
+    static_cast<BlockCompressionCodecZstdDict *>(m_compressor)->set_dictionary(m_dictionary);
+    m_trailer.flags |= CellStoreTrailerV7::DICTIONARY;
+  }
+
+  for (auto &block : m_pending_blocks) {
+    DynamicBuffer buf(0, false);
+    buf.base = m_pending_data.base + block.offset;
+    buf.ptr = buf.base + block.length;
+    DynamicBuffer value_buf(0, false);
+    value_buf.base = buf.ptr;
+    value_buf.ptr = value_buf.base + block.value_length;
+    m_index_builder.add_entry((const uint8_t *)block.key.data(),
+                              block.key.length(), m_offset);
+    write_data_block(buf, value_buf);
   }
 
+  m_pending_blocks.clear();
+  m_pending_data.free();
+}
+
+
+void CellStoreV7::finalize(TableIdentifier *table_identifier) {
+  EventPtr event_ptr;
+  size_t zlen;
+  DynamicBuffer zbuf(0);
+  SerializedKey key;
+  StaticBuffer send_buf;
+  int64_t index_memory = 0;
+
+  if (m_buffer.fill() > 0)
+    add_block();
+
+  // Fewer blocks were written than are needed to train the dictionary
+  if (m_dictionary_sample_size)
+    train_dictionary();
+
   m_key_compressor = 0;
 
   m_buffer.free();
+  m_value_buffer.free();
 
   m_trailer.fix_index_offset = m_offset;
   if (m_uncompressed_data == 0)
@@ -634,8 +814,6 @@ void CellStoreV7::finalize(TableIdentifier *table_identifier) {
   else
     m_trailer.compression_ratio = m_compressed_data / m_uncompressed_data;
 
-  m_trailer.key_compression_scheme = KeyCompressionType::PREFIX;
-
   /**
    * Chop the Index buffers down to the exact length
    */
@@ -734,7 +912,10 @@ void CellStoreV7::finalize(TableIdentifier *table_identifier) {
     compressed_len += compressor.length();
   }
 
-  if (HT_IO_ALIGNMENT_PADDING(compressed_len) >= m_trailer.size()) {
+  // The dictionary is located relative to the end of the replaced files,
+  // so it cannot follow them into the trailer block
+  if (!m_dictionary &&
+      HT_IO_ALIGNMENT_PADDING(compressed_len) >= m_trailer.size()) {
     coalesce_with_trailer = true;
     zbuf.reserve(compressed_len + m_trailer.size() +
                  HT_IO_ALIGNMENT_PADDING(compressed_len+m_trailer.size()));
@@ -769,6 +950,31 @@ void CellStoreV7::finalize(TableIdentifier *table_identifier) {
     m_offset += zlen;
   }
 
+  // Write dictionary
+  if (m_dictionary) {
+    BlockCompressionCodecNone codec((BlockCompressionCodec::Args()));
+    BlockHeaderCellStore header(BLOCK_HEADER_VERSION, DICTIONARY_BLOCK_MAGIC);
+    DynamicBuffer dict_buf(0, false);
+    dict_buf.base = (uint8_t *)m_dictionary->data();
+    dict_buf.ptr = dict_buf.base + m_dictionary->size();
+    codec.deflate(dict_buf, zbuf, header, HT_DIRECT_IO_ALIGNMENT);
+    if (!HT_IO_ALIGNED(zbuf.fill())) {
+      memset(zbuf.ptr, 0, HT_IO_ALIGNMENT_PADDING(zbuf.fill()));
+      zbuf.ptr += HT_IO_ALIGNMENT_PADDING(zbuf.fill());
+    }
+    zlen = zbuf.fill();
+    send_buf = zbuf;
+
+    if(m_create_cs_with_tmp)
+      m_filesys->append_to_temp(m_smartfd_ptr, send_buf);
+    else {
+      m_filesys->append(m_smartfd_ptr, send_buf, Filesystem::Flags::NONE, &m_sync_handler);
+      m_outstanding_appends++;
+    }
+    m_offset += zlen;
+    m_dictionary_memory = m_dictionary->memory_used();
+  }
+
   m_64bit_index = m_index_builder.big_int();
 
   /** Set up index **/
@@ -804,6 +1010,7 @@ void CellStoreV7::finalize(TableIdentifier *table_identifier) {
   m_trailer.create_time = get_ts64();
 
   m_trailer.block_header_version = BLOCK_HEADER_VERSION;
+  m_trailer.set_version();
 
   // write trailer
   if (!coalesce_with_trailer) {
@@ -864,12 +1071,29 @@ void CellStoreV7::finalize(TableIdentifier *table_identifier) {
   delete [] m_column_ttl;
   m_column_ttl = 0;
 
-  Global::memory_tracker->add( sizeof(CellStoreV7) + sizeof(CellStoreInfo) + m_index_stats.block_index_memory + m_index_stats.bloom_filter_memory );
+  Global::memory_tracker->add( sizeof(CellStoreV7) + sizeof(CellStoreInfo) + m_index_stats.block_index_memory + m_index_stats.bloom_filter_memory + m_dictionary_memory );
 }
 
 
 void CellStoreV7::IndexBuilder::add_entry(KeyCompressorPtr &key_compressor,
                                           int64_t offset) {
+  // Add key to variable buffer
+  size_t key_len = key_compressor->length_uncompressed();
+  m_variable.ensure(key_len);
+  key_compressor->write_uncompressed(m_variable.ptr);
+  m_variable.ptr += key_len;
+
+  add_offset(offset);
+}
+
+void CellStoreV7::IndexBuilder::add_entry(const uint8_t *key, size_t key_len,
+                                          int64_t offset) {
+  m_variable.ensure(key_len);
+  m_variable.add_unchecked(key, key_len);
+  add_offset(offset);
+}
+
+void CellStoreV7::IndexBuilder::add_offset(int64_t offset) {
 
   // switch to 64-bit offsets if offset being added is >= 2^32
   if (!m_bigint && offset >= 4294967296LL) {
@@ -888,13 +1112,7 @@ void CellStoreV7::IndexBuilder::add_entry(KeyCompressorPtr &key_compressor,
     m_bigint = true;
   }
 
-  // Add key to variable buffer
-  size_t key_len = key_compressor->length_uncompressed();
-  m_variable.ensure(key_len);
-  key_compressor->write_uncompressed(m_variable.ptr);
-  m_variable.ptr += key_len;
-
-    // Serialize offset into fix index buffer
+  // Serialize offset into fix index buffer
   if (m_bigint) {
     m_fixed.ensure(8);
     memcpy(m_fixed.ptr, &offset, 8);
@@ -942,7 +1160,7 @@ CellStoreV7::open(Filesystem::SmartFdPtr smartfd_ptr, const String &start_row,
   m_bloom_filter_mode = (BloomFilterMode)m_trailer.bloom_filter_mode;
 
   /** Sanity check trailer **/
-  HT_ASSERT(m_trailer.version == 7);
+  HT_ASSERT(m_trailer.version == 7 || m_trailer.version == 8);
 
   if (m_trailer.flags & CellStoreTrailerV7::INDEX_64BIT)
     m_64bit_index = true;
@@ -955,10 +1173,21 @@ CellStoreV7::open(Filesystem::SmartFdPtr smartfd_ptr, const String &start_row,
            (Lld)m_trailer.var_index_offset, (Llu)m_file_length, 
            m_smartfd_ptr->to_str().c_str());
 
+  if (m_trailer.key_compression_scheme != KeyCompressionType::PREFIX &&
+      m_trailer.key_compression_scheme != KeyCompressionType::PREFIX_DELTA)
+    HT_THROWF(Error::RANGESERVER_CORRUPT_CELLSTORE,
+              "Unsupported key compression scheme %d in CellStore %s",
+              (int)m_trailer.key_compression_scheme,
+              m_smartfd_ptr->to_str().c_str());
+
+  // The index blocks are compressed with the dictionary too
+  if (m_trailer.flags & CellStoreTrailerV7::DICTIONARY)
+    load_dictionary();
+
   // This is necessary to get m_disk_usage and m_block_count set properly
   load_block_index();
 
-  Global::memory_tracker->add( sizeof(CellStoreV7) + sizeof(CellStoreInfo) );
+  Global::memory_tracker->add( sizeof(CellStoreV7) + sizeof(CellStoreInfo) + m_dictionary_memory );
 
 }
 
@@ -1163,6 +1392,15 @@ void CellStoreV7::display_block_info() {
 }
 
 
+void CellStoreV7::append_restart_points() {
+  m_buffer.ensure(4*m_restart_offsets.size() + 4);
+  for (auto offset : m_restart_offsets)
+    Serialization::encode_i32(&m_buffer.ptr, offset);
+  Serialization::encode_i32(&m_buffer.ptr, m_restart_offsets.size());
+  m_restart_offsets.clear();
+  m_block_entries = 0;
+}
+
 uint16_t CellStoreV7::block_header_format() {
   return BLOCK_HEADER_VERSION;
 }
@@ -34,6 +34,7 @@
 #include "KeyCompressor.h"
 
 #include <Hypertable/Lib/BlockCompressionCodec.h>
+#include <Hypertable/Lib/BlockCompressionCodecZstdDict.h>
 #include <Hypertable/Lib/SerializedKey.h>
 
 #include <AsyncComm/DispatchHandlerSynchronizer.h>
@@ -64,12 +65,14 @@ namespace Hypertable {
     public:
       IndexBuilder() : m_bigint(false) { }
       void add_entry(KeyCompressorPtr &key_compressor, int64_t offset);
+      void add_entry(const uint8_t *key, size_t key_len, int64_t offset);
       DynamicBuffer &fixed_buf() { return m_fixed; }
       DynamicBuffer &variable_buf() { return m_variable; }
       bool big_int() { return m_bigint; }
       void chop();
       void release_fixed_buf() { delete [] m_fixed.release(); }
     private:
+      void add_offset(int64_t offset);
       DynamicBuffer m_fixed;
       DynamicBuffer m_variable;
       bool m_bigint;
@@ -114,6 +117,15 @@ namespace Hypertable {
     CellListScannerPtr create_scanner(ScanContext *scan_ctx) override;
     BlockCompressionCodec *create_block_compression_codec() override;
     KeyDecompressor *create_key_decompressor() override;
+    bool has_restart_points() override {
+      return (m_trailer.flags & CellStoreTrailerV7::RESTART_POINTS) != 0;
+    }
+    bool has_separate_values() override {
+      return (m_trailer.flags & CellStoreTrailerV7::SEPARATE_VALUES) != 0;
+    }
+    bool bulk_loaded() override {
+      return (m_trailer.flags & CellStoreTrailerV7::BULK_LOAD) != 0;
+    }
     void display_block_info() override;
     int64_t end_of_last_block() override { return m_trailer.fix_index_offset; }
 
@@ -162,6 +174,30 @@ namespace Hypertable {
     uint16_t block_header_format() override;
 
   protected:
+
+    /// Uncompressed data block held back until the dictionary is trained.
+    struct PendingBlock {
+      /// Offset of block in #m_pending_data
+      size_t offset;
+      /// Length of block (key section if values are separate)
+      size_t length;
+      /// Length of value section following the block, 0 if values are not
+      /// separate
+      size_t value_length;
+      /// Last key of block, uncompressed
+      std::string key;
+    };
+
+    void add_block();
+    void write_data_block(const DynamicBuffer &keys,
+                          const DynamicBuffer &values);
+    void write_block(const DynamicBuffer &block);
+    void compress_block(const DynamicBuffer &block, const char *magic,
+                        DynamicBuffer &zbuf);
+    void append_block(DynamicBuffer &zbuf);
+    void train_dictionary();
+    void load_dictionary();
+    void append_restart_points();
     void create_bloom_filter(bool is_approx = false);
     void load_bloom_filter();
     void load_block_index();
@@ -178,6 +214,11 @@ namespace Hypertable {
     CellStoreTrailerV7 m_trailer;
     BlockCompressionCodec *m_compressor {};
     DynamicBuffer m_buffer;
+    /// Value section of the block being built when values are stored
+    /// separately
+    DynamicBuffer m_value_buffer;
+    /// Store values in a separate section of each data block
+    bool m_separate_values {};
     IndexBuilder m_index_builder;
     DispatchHandlerSynchronizer m_sync_handler;
     uint32_t m_outstanding_appends {};
@@ -197,9 +238,28 @@ namespace Hypertable {
     float m_bloom_bits_per_item {};
     float m_filter_false_positive_prob {};
     KeyCompressorPtr m_key_compressor;
+    /// Number of entries between restart points (0 disables restart points)
+    int32_t m_restart_interval {};
+    /// Number of entries in the block being built
+    int32_t m_block_entries {};
+    /// Offsets of restart points in the block being built
+    std::vector<uint32_t> m_restart_offsets;
     bool m_restricted_range;
     int64_t *m_column_ttl {};
     bool m_replaced_files_loaded {};
+    /// Dictionary used by the zstd_dict compressor (null if none)
+    ZstdDictionaryPtr m_dictionary;
+    /// Memory used by #m_dictionary
+    int64_t m_dictionary_memory {};
+    /// Amount of block data to buffer for training the dictionary, 0 once
+    /// trained or if not needed
+    size_t m_dictionary_sample_size {};
+    /// Maximum dictionary size
+    size_t m_dictionary_capacity {};
+    /// Data blocks buffered while waiting to train the dictionary
+    DynamicBuffer m_pending_data;
+    /// Data blocks in #m_pending_data
+    std::vector<PendingBlock> m_pending_blocks;
 
     // Member that require mutex protection
 
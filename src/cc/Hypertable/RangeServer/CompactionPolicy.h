@@ -0,0 +1,86 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Declarations for CompactionPolicy.
+/// This file contains type declarations for CompactionPolicy, an abstract base
+/// class for policies that select the cell stores of an access group that are
+/// to be merged by a merging compaction.
+
+#ifndef Hypertable_RangeServer_CompactionPolicy_h
+#define Hypertable_RangeServer_CompactionPolicy_h
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Hypertable {
+
+  /// @addtogroup RangeServer
+  /// @{
+
+  /// Abstract base class for merging compaction policies.
+  /// An access group holds its cell stores in a list ordered from oldest to
+  /// newest and a merging compaction replaces a contiguous run of that list
+  /// with a single cell store.  A compaction policy decides which run, if any,
+  /// should be merged.  The policy is selected per access group with the
+  /// <code>COMPACTION_POLICY</code> schema option (see
+  /// AccessGroupOptions::set_compaction_policy()).
+  class CompactionPolicy {
+  public:
+
+    /// Cell store summary passed to find_merge_run().
+    struct StoreInfo {
+      /// Disk usage of cell store
+      int64_t disk_usage {};
+      /// Minimum cell timestamp (TIMESTAMP_MAX if unknown)
+      int64_t timestamp_min {};
+      /// Maximum cell timestamp (TIMESTAMP_MIN if unknown)
+      int64_t timestamp_max {};
+    };
+
+    /// Destructor.
+    virtual ~CompactionPolicy() { }
+
+    /// Finds a run of cell stores to merge.
+    /// If the run returned ends with the last cell store in <code>stores</code>
+    /// the caller may include the cell cache in the merging compaction.
+    /// @param stores Cell store summaries, ordered oldest to newest
+    /// @param now Current time in nanoseconds since the epoch
+    /// @param indexp Address of variable to hold index of start of run
+    /// @param lenp Address of variable to hold length of run
+    /// @return <i>true</i> if a run was found, <i>false</i> otherwise
+    virtual bool find_merge_run(const std::vector<StoreInfo> &stores,
+                                int64_t now, size_t *indexp,
+                                size_t *lenp) = 0;
+
+    /// Returns policy name.
+    /// @return Policy name as it appears in the schema
+    virtual const char *name() const = 0;
+  };
+
+  /// Smart pointer to CompactionPolicy
+  typedef std::shared_ptr<CompactionPolicy> CompactionPolicyPtr;
+
+  /// @}
+}
+
+#endif // Hypertable_RangeServer_CompactionPolicy_h
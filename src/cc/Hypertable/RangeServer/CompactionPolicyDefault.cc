@@ -0,0 +1,114 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Definitions for CompactionPolicyDefault.
+/// This file contains type definitions for CompactionPolicyDefault, the
+/// merging compaction policy used when an access group does not specify one.
+
+#include <Common/Compat.h>
+
+#include "CompactionPolicyDefault.h"
+
+#include <Hypertable/RangeServer/Global.h>
+
+using namespace Hypertable;
+using namespace std;
+
+bool CompactionPolicyDefault::find_merge_run(const vector<StoreInfo> &stores,
+                                             int64_t now, size_t *indexp,
+                                             size_t *lenp) {
+  size_t index = 0;
+  size_t i = 0;
+  size_t count;
+  int64_t running_total = 0;
+
+  if (stores.size() <= 1)
+    return false;
+
+  // If in "low activity" window, first try to be more aggresive
+  if (Global::low_activity_time.within_window()) {
+    bool run_found = false;
+    for (int64_t target = Global::cellstore_target_size_min*2;
+         target <= Global::cellstore_target_size_max;
+         target += Global::cellstore_target_size_min) {
+      index = 0;
+      i = 0;
+      running_total = 0;
+
+      do {
+        running_total += stores[i].disk_usage;
+
+        if (running_total >= target) {
+          count = (i - index) + 1;
+          if (count >= (size_t)2) {
+            if (indexp)
+              *indexp = index;
+            if (lenp)
+              *lenp = count;
+            run_found = true;
+            break;
+          }
+          // Otherwise, move the index forward by one and try again
+          running_total -= stores[index].disk_usage;
+          index++;
+        }
+        i++;
+      } while (i < stores.size());
+      if (i == stores.size())
+        break;
+    }
+    if (run_found)
+      return true;
+  }
+
+  index = 0;
+  i = 0;
+  running_total = 0;
+  do {
+    running_total += stores[i].disk_usage;
+
+    if (running_total >= Global::cellstore_target_size_min) {
+      count = (i - index) + 1;
+      if (count >= (size_t)Global::merge_cellstore_run_length_threshold) {
+        if (indexp)
+          *indexp = index;
+        if (lenp)
+          *lenp = count;
+        return true;
+      }
+      // Otherwise, move the index forward by one and try again
+      running_total -= stores[index].disk_usage;
+      index++;
+    }
+    i++;
+  } while (i < stores.size());
+
+  if ((i-index) >= (size_t)Global::merge_cellstore_run_length_threshold) {
+    if (indexp)
+      *indexp = index;
+    if (lenp)
+      *lenp = i-index;
+    return true;
+  }
+
+  return false;
+}
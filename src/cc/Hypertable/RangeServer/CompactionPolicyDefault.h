@@ -0,0 +1,55 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Declarations for CompactionPolicyDefault.
+/// This file contains type declarations for CompactionPolicyDefault, the
+/// merging compaction policy used when an access group does not specify one.
+
+#ifndef Hypertable_RangeServer_CompactionPolicyDefault_h
+#define Hypertable_RangeServer_CompactionPolicyDefault_h
+
+#include <Hypertable/RangeServer/CompactionPolicy.h>
+
+namespace Hypertable {
+
+  /// @addtogroup RangeServer
+  /// @{
+
+  /// Default merging compaction policy.
+  /// Looks for a run of cell stores whose combined size reaches
+  /// <code>Hypertable.RangeServer.CellStore.TargetSize.Minimum</code> and
+  /// whose length is at least
+  /// <code>Hypertable.RangeServer.CellStore.Merge.RunLengthThreshold</code>.
+  /// During the low activity window it first tries to find runs of at least
+  /// two cell stores that add up to progressively larger targets up to
+  /// <code>Hypertable.RangeServer.CellStore.TargetSize.Maximum</code>.
+  class CompactionPolicyDefault : public CompactionPolicy {
+  public:
+    bool find_merge_run(const std::vector<StoreInfo> &stores, int64_t now,
+                        size_t *indexp, size_t *lenp) override;
+    const char *name() const override { return "default"; }
+  };
+
+  /// @}
+}
+
+#endif // Hypertable_RangeServer_CompactionPolicyDefault_h
@@ -0,0 +1,60 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Definitions for CompactionPolicyFactory.
+/// This file contains type definitions for CompactionPolicyFactory, a class
+/// for creating CompactionPolicy objects from schema specifications.
+
+#include <Common/Compat.h>
+
+#include "CompactionPolicyFactory.h"
+
+#include <Hypertable/RangeServer/CompactionPolicyDefault.h>
+#include <Hypertable/RangeServer/CompactionPolicySizeTiered.h>
+#include <Hypertable/RangeServer/CompactionPolicyTimeWindow.h>
+
+#include <Hypertable/Lib/AccessGroupSpec.h>
+
+using namespace Hypertable;
+using namespace std;
+
+CompactionPolicyPtr CompactionPolicyFactory::create(const std::string &spec) {
+
+  if (spec.empty())
+    return make_shared<CompactionPolicyDefault>();
+
+  PropertiesPtr props = make_shared<Properties>();
+  AccessGroupOptions::parse_compaction_policy(spec, props);
+
+  std::string type = props->get_str("compaction-policy-type");
+
+  if (type == "size-tiered")
+    return make_shared<CompactionPolicySizeTiered>(props->get_i32("min-threshold"),
+                                                   props->get_i32("max-threshold"),
+                                                   props->get_f64("size-ratio"));
+  else if (type == "time-window")
+    return make_shared<CompactionPolicyTimeWindow>(props->get_i32("window"),
+                                                   props->get_i32("min-threshold"),
+                                                   props->get_i32("max-threshold"));
+
+  return make_shared<CompactionPolicyDefault>();
+}
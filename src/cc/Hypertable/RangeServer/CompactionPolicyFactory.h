@@ -0,0 +1,58 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Declarations for CompactionPolicyFactory.
+/// This file contains type declarations for CompactionPolicyFactory, a class
+/// for creating CompactionPolicy objects from schema specifications.
+
+#ifndef Hypertable_RangeServer_CompactionPolicyFactory_h
+#define Hypertable_RangeServer_CompactionPolicyFactory_h
+
+#include <Hypertable/RangeServer/CompactionPolicy.h>
+
+#include <string>
+
+namespace Hypertable {
+
+  /// @addtogroup RangeServer
+  /// @{
+
+  /// Factory class for creating CompactionPolicy objects.
+  class CompactionPolicyFactory {
+  public:
+
+    /// Creates a compaction policy from a specification.
+    /// Parses <code>spec</code> with
+    /// AccessGroupOptions::parse_compaction_policy() and creates the
+    /// corresponding policy object.  An empty specification yields a
+    /// CompactionPolicyDefault object.
+    /// @param spec Compaction policy specification
+    /// @return Newly created compaction policy
+    /// @throws Exception with code set to Error::BAD_SCHEMA if
+    /// <code>spec</code> is invalid
+    static CompactionPolicyPtr create(const std::string &spec);
+  };
+
+  /// @}
+}
+
+#endif // Hypertable_RangeServer_CompactionPolicyFactory_h
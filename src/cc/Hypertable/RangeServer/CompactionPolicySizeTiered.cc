@@ -0,0 +1,66 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Definitions for CompactionPolicySizeTiered.
+/// This file contains type definitions for CompactionPolicySizeTiered, a
+/// merging compaction policy that merges runs of similarly sized cell stores.
+
+#include <Common/Compat.h>
+
+#include "CompactionPolicySizeTiered.h"
+
+#include <algorithm>
+
+using namespace Hypertable;
+using namespace std;
+
+bool CompactionPolicySizeTiered::find_merge_run(const vector<StoreInfo> &stores,
+                                                int64_t now, size_t *indexp,
+                                                size_t *lenp) {
+
+  if (stores.size() < m_min_threshold)
+    return false;
+
+  for (size_t index = 0; index + m_min_threshold <= stores.size(); index++) {
+    double total = (double)std::max(stores[index].disk_usage, (int64_t)1);
+    size_t length = 1;
+
+    while (index + length < stores.size() && length < m_max_threshold) {
+      double average = total / (double)length;
+      double size = (double)std::max(stores[index+length].disk_usage, (int64_t)1);
+      if (size > average * m_size_ratio || size * m_size_ratio < average)
+        break;
+      total += size;
+      length++;
+    }
+
+    if (length >= m_min_threshold) {
+      if (indexp)
+        *indexp = index;
+      if (lenp)
+        *lenp = length;
+      return true;
+    }
+  }
+
+  return false;
+}
@@ -0,0 +1,76 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Declarations for CompactionPolicySizeTiered.
+/// This file contains type declarations for CompactionPolicySizeTiered, a
+/// merging compaction policy that merges runs of similarly sized cell stores.
+
+#ifndef Hypertable_RangeServer_CompactionPolicySizeTiered_h
+#define Hypertable_RangeServer_CompactionPolicySizeTiered_h
+
+#include <Hypertable/RangeServer/CompactionPolicy.h>
+
+namespace Hypertable {
+
+  /// @addtogroup RangeServer
+  /// @{
+
+  /// Size-tiered merging compaction policy.
+  /// Merges a contiguous run of at least <code>min_threshold</code> (and at
+  /// most <code>max_threshold</code>) cell stores whose sizes are all within a
+  /// factor of <code>size_ratio</code> of the run's average size.  Since a
+  /// merge produces a cell store roughly <code>min_threshold</code> times
+  /// larger than its inputs, each cell is rewritten about once per tier
+  /// instead of on every merge, which suits append-heavy workloads.
+  class CompactionPolicySizeTiered : public CompactionPolicy {
+  public:
+
+    /// Constructor.
+    /// @param min_threshold Minimum run length
+    /// @param max_threshold Maximum run length
+    /// @param size_ratio Maximum size ratio between a cell store and the
+    /// average size of the run
+    CompactionPolicySizeTiered(int32_t min_threshold, int32_t max_threshold,
+                               double size_ratio)
+      : m_min_threshold(min_threshold), m_max_threshold(max_threshold),
+        m_size_ratio(size_ratio) { }
+
+    bool find_merge_run(const std::vector<StoreInfo> &stores, int64_t now,
+                        size_t *indexp, size_t *lenp) override;
+    const char *name() const override { return "size-tiered"; }
+
+  private:
+
+    /// Minimum run length
+    size_t m_min_threshold;
+
+    /// Maximum run length
+    size_t m_max_threshold;
+
+    /// Maximum size ratio within a tier
+    double m_size_ratio;
+  };
+
+  /// @}
+}
+
+#endif // Hypertable_RangeServer_CompactionPolicySizeTiered_h
@@ -0,0 +1,75 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Definitions for CompactionPolicyTimeWindow.
+/// This file contains type definitions for CompactionPolicyTimeWindow, a
+/// merging compaction policy that groups cell stores into time windows.
+
+#include <Common/Compat.h>
+
+#include "CompactionPolicyTimeWindow.h"
+
+using namespace Hypertable;
+using namespace std;
+
+int64_t CompactionPolicyTimeWindow::window_of(const StoreInfo &info) const {
+  if (info.timestamp_min > info.timestamp_max || info.timestamp_min < 0)
+    return -1;
+  int64_t window = info.timestamp_min / m_window;
+  if (info.timestamp_max / m_window != window)
+    return -1;
+  return window;
+}
+
+bool CompactionPolicyTimeWindow::find_merge_run(const vector<StoreInfo> &stores,
+                                                int64_t now, size_t *indexp,
+                                                size_t *lenp) {
+  int64_t current_window = now / m_window;
+
+  // The newest cell store is excluded, see class description
+  if (stores.size() <= 2)
+    return false;
+  size_t count = stores.size() - 1;
+
+  size_t index = 0;
+  while (index < count) {
+    int64_t window = window_of(stores[index]);
+    size_t length = 1;
+    while (index + length < count && length < m_max_threshold &&
+           window_of(stores[index+length]) == window)
+      length++;
+
+    if (window != -1) {
+      size_t threshold = (window < current_window) ? 2 : m_min_threshold;
+      if (length >= threshold) {
+        if (indexp)
+          *indexp = index;
+        if (lenp)
+          *lenp = length;
+        return true;
+      }
+    }
+    index += length;
+  }
+
+  return false;
+}
@@ -0,0 +1,87 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Declarations for CompactionPolicyTimeWindow.
+/// This file contains type declarations for CompactionPolicyTimeWindow, a
+/// merging compaction policy that groups cell stores into time windows.
+
+#ifndef Hypertable_RangeServer_CompactionPolicyTimeWindow_h
+#define Hypertable_RangeServer_CompactionPolicyTimeWindow_h
+
+#include <Hypertable/RangeServer/CompactionPolicy.h>
+
+namespace Hypertable {
+
+  /// @addtogroup RangeServer
+  /// @{
+
+  /// Time-windowed merging compaction policy.
+  /// Assigns each cell store to the window of <code>window</code> seconds that
+  /// contains both its <code>timestamp_min</code> and
+  /// <code>timestamp_max</code>.  Cell stores that span a window boundary, or
+  /// whose timestamp range is unknown, belong to no window and are never
+  /// merged.  Only contiguous cell stores of the same window are merged, so a
+  /// cell store never mixes data from different windows and, once its window
+  /// has expired, it can be dropped as a whole by TTL garbage collection.
+  /// Runs in the current window are merged once they reach
+  /// <code>min_threshold</code> cell stores; runs in windows that have ended
+  /// are collapsed as soon as they contain two.  The newest cell store is
+  /// never included in a run so that the cell cache, which may hold data for
+  /// a later window, is not merged into an older window.
+  class CompactionPolicyTimeWindow : public CompactionPolicy {
+  public:
+
+    /// Constructor.
+    /// @param window Window size in seconds
+    /// @param min_threshold Minimum run length for the current window
+    /// @param max_threshold Maximum run length
+    CompactionPolicyTimeWindow(int32_t window, int32_t min_threshold,
+                               int32_t max_threshold)
+      : m_window(window * 1000000000LL), m_min_threshold(min_threshold),
+        m_max_threshold(max_threshold) { }
+
+    bool find_merge_run(const std::vector<StoreInfo> &stores, int64_t now,
+                        size_t *indexp, size_t *lenp) override;
+    const char *name() const override { return "time-window"; }
+
+    /// Returns window of a cell store.
+    /// @param info Cell store summary
+    /// @return Window number, or -1 if cell store spans a window boundary or
+    /// has an unknown timestamp range
+    int64_t window_of(const StoreInfo &info) const;
+
+  private:
+
+    /// Window size in nanoseconds
+    int64_t m_window;
+
+    /// Minimum run length for the current window
+    size_t m_min_threshold;
+
+    /// Maximum run length
+    size_t m_max_threshold;
+  };
+
+  /// @}
+}
+
+#endif // Hypertable_RangeServer_CompactionPolicyTimeWindow_h
@@ -0,0 +1,125 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Definitions for CompactionThrottle.
+/// This file contains type definitions for CompactionThrottle, a token bucket
+/// rate limiter shared by the maintenance threads to bound compaction and split
+/// I/O throughput.
+
+#include <Common/Compat.h>
+
+#include "CompactionThrottle.h"
+
+#include <Hypertable/RangeServer/MaintenanceFlag.h>
+
+#include <Common/Logger.h>
+
+#include <algorithm>
+
+using namespace Hypertable;
+using namespace std;
+
+CompactionThrottle::CompactionThrottle(gInt32tPtr rate,
+                                       gInt32tPtr background_reserve)
+  : m_rate(rate), m_background_reserve(background_reserve) {
+  HT_ASSERT(m_rate && m_background_reserve);
+  m_last_refill = chrono::steady_clock::now();
+  // Start with a full bucket
+  m_tokens = (double)m_rate->get() * (double)MiB;
+}
+
+CompactionThrottle::Class CompactionThrottle::classify(int maintenance_flags) {
+  if (MaintenanceFlag::split(maintenance_flags) ||
+      MaintenanceFlag::relinquish(maintenance_flags))
+    return NORMAL;
+  if (MaintenanceFlag::minor_compaction(maintenance_flags))
+    return URGENT;
+  return BACKGROUND;
+}
+
+void CompactionThrottle::acquire(Class io_class, int64_t amount) {
+  unique_lock<mutex> lock(m_mutex);
+  auto now = chrono::steady_clock::now();
+  auto wait_start = now;
+  double threshold;
+  int64_t rate;
+
+  m_bytes[io_class] += amount;
+
+  while (true) {
+
+    rate = refill(now);
+
+    // Unlimited
+    if (rate == 0)
+      break;
+
+    if (io_class == URGENT)
+      threshold = -(double)rate;
+    else if (io_class == NORMAL)
+      threshold = 0.0;
+    else {
+      int32_t reserve = std::min(std::max(m_background_reserve->get(), 0), 100);
+      threshold = ((double)rate * (double)reserve) / 100.0;
+    }
+
+    if (m_tokens >= threshold) {
+      m_tokens -= (double)amount;
+      break;
+    }
+
+    // Sleep until enough tokens have accrued, but re-check at least once
+    // a second in case the rate was changed
+    int64_t wait_millis = (int64_t)(((threshold - m_tokens) * 1000.0) / (double)rate);
+    wait_millis = std::min(std::max(wait_millis, (int64_t)1), (int64_t)1000);
+    m_cond.wait_for(lock, chrono::milliseconds(wait_millis));
+    now = chrono::steady_clock::now();
+  }
+
+  m_wait_millis[io_class] +=
+    chrono::duration_cast<chrono::milliseconds>(now - wait_start).count();
+}
+
+void CompactionThrottle::get_statistics(Statistics *stats) {
+  lock_guard<mutex> lock(m_mutex);
+  stats->rate = refill(chrono::steady_clock::now());
+  stats->debt = (m_tokens < 0.0) ? (int64_t)-m_tokens : 0;
+  for (int i=0; i<CLASS_COUNT; i++) {
+    stats->bytes[i] = m_bytes[i];
+    stats->wait_millis[i] = m_wait_millis[i];
+    m_bytes[i] = 0;
+    m_wait_millis[i] = 0;
+  }
+}
+
+int64_t CompactionThrottle::refill(chrono::steady_clock::time_point now) {
+  int64_t rate = (int64_t)m_rate->get() * MiB;
+  if (rate <= 0) {
+    m_tokens = 0.0;
+    m_last_refill = now;
+    return 0;
+  }
+  double elapsed = chrono::duration<double>(now - m_last_refill).count();
+  m_tokens = std::min(m_tokens + (elapsed * (double)rate), (double)rate);
+  m_last_refill = now;
+  return rate;
+}
@@ -0,0 +1,146 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Declarations for CompactionThrottle.
+/// This file contains type declarations for CompactionThrottle, a token bucket
+/// rate limiter shared by the maintenance threads to bound compaction and split
+/// I/O throughput.
+
+#ifndef Hypertable_RangeServer_CompactionThrottle_h
+#define Hypertable_RangeServer_CompactionThrottle_h
+
+#include <Common/Properties.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace Hypertable {
+
+  /// @addtogroup RangeServer
+  /// @{
+
+  /// Token bucket rate limiter for compaction and split I/O.
+  /// A single instance is shared by all maintenance queue workers.  Tokens
+  /// (bytes) are replenished at the rate given by the
+  /// <code>Hypertable.RangeServer.Maintenance.Throttle.Rate</code> property
+  /// (MB/s) which is re-read on every call, so it can be adjusted at runtime.
+  /// The bucket holds at most one second worth of tokens.  Callers are
+  /// classified into I/O classes that get different shares of the budget:
+  ///   - URGENT callers (minor compactions that free memory or commit log
+  ///     space) may run the bucket up to one second into debt before waiting
+  ///   - NORMAL callers (splits and relinquishes) wait for a non-negative
+  ///     balance
+  ///   - BACKGROUND callers (merging, major and GC compactions) wait until the
+  ///     balance exceeds the reserve given by
+  ///     <code>Hypertable.RangeServer.Maintenance.Throttle.BackgroundReserve</code>
+  ///     (percent of the bucket), leaving headroom for the other classes
+  class CompactionThrottle {
+  public:
+
+    /// I/O scheduling class.
+    enum Class {
+      URGENT = 0,
+      NORMAL = 1,
+      BACKGROUND = 2,
+      CLASS_COUNT = 3
+    };
+
+    /// Throttle statistics.
+    struct Statistics {
+      /// Configured rate in bytes/s (0 means unlimited)
+      int64_t rate {};
+      /// Bytes charged in excess of the available tokens
+      int64_t debt {};
+      /// Bytes charged per class since last call to get_statistics()
+      int64_t bytes[CLASS_COUNT] {};
+      /// Milliseconds spent waiting per class since last call to
+      /// get_statistics()
+      int64_t wait_millis[CLASS_COUNT] {};
+    };
+
+    /// Constructor.
+    /// @param rate Pointer to guarded rate property value (MB/s)
+    /// @param background_reserve Pointer to guarded background reserve
+    /// property value (percent)
+    CompactionThrottle(gInt32tPtr rate, gInt32tPtr background_reserve);
+
+    /// Determines I/O class for a compaction.
+    /// @param maintenance_flags Maintenance flags passed to
+    /// AccessGroup::run_compaction()
+    /// @return I/O class for compaction described by
+    /// <code>maintenance_flags</code>
+    static Class classify(int maintenance_flags);
+
+    /// Charges <code>amount</code> bytes of I/O to the bucket.
+    /// Blocks until the bucket balance satisfies the admission threshold of
+    /// <code>io_class</code>, then deducts <code>amount</code>.
+    /// @param io_class I/O class of caller
+    /// @param amount Number of bytes read or written
+    void acquire(Class io_class, int64_t amount);
+
+    /// Returns current statistics and resets per-class counters.
+    /// @param stats Address of statistics structure to fill in
+    void get_statistics(Statistics *stats);
+
+  private:
+
+    /// Replenishes tokens for the time elapsed since the last call.
+    /// @param now Current time
+    /// @return Current rate in bytes/s (0 means unlimited)
+    /// @warning Must be called with #m_mutex locked
+    int64_t refill(std::chrono::steady_clock::time_point now);
+
+    /// %Mutex for serializing access to members
+    std::mutex m_mutex;
+
+    /// Condition variable used for timed waits
+    std::condition_variable m_cond;
+
+    /// Rate property value (MB/s)
+    gInt32tPtr m_rate {};
+
+    /// Background reserve property value (percent)
+    gInt32tPtr m_background_reserve {};
+
+    /// Current bucket balance in bytes (negative when in debt)
+    double m_tokens {};
+
+    /// Time of last refill
+    std::chrono::steady_clock::time_point m_last_refill;
+
+    /// Per-class bytes charged
+    int64_t m_bytes[CLASS_COUNT] {};
+
+    /// Per-class milliseconds spent waiting
+    int64_t m_wait_millis[CLASS_COUNT] {};
+  };
+
+  /// Smart pointer to CompactionThrottle
+  typedef std::shared_ptr<CompactionThrottle> CompactionThrottlePtr;
+
+  /// @}
+}
+
+#endif // Hypertable_RangeServer_CompactionThrottle_h
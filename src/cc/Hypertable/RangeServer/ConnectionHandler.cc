@@ -25,6 +25,7 @@
 
 #include <Hypertable/RangeServer/RangeServer.h>
 #include <Hypertable/RangeServer/Request/Handler/AcknowledgeLoad.h>
+#include <Hypertable/RangeServer/Request/Handler/AdoptCellStores.h>
 #include <Hypertable/RangeServer/Request/Handler/CommitLogSync.h>
 #include <Hypertable/RangeServer/Request/Handler/Compact.h>
 #include <Hypertable/RangeServer/Request/Handler/CreateScanner.h>
@@ -211,6 +212,10 @@ void ConnectionHandler::handle(EventPtr &event) {
         handler = new Request::Handler::TableMaintenanceDisable(m_comm, m_range_server, event);
         break;
 
+      case Lib::RangeServer::Protocol::COMMAND_ADOPT_CELLSTORES:
+        handler = new Request::Handler::AdoptCellStores(m_comm, m_range_server, event);
+        break;
+
       default:
         HT_THROWF(Error::PROTOCOL_ERROR, "Unimplemented command (%llu)",
                   (Llu)event->header.command);
@@ -0,0 +1,147 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Declarations for ContainingRangeCache.
+/// This file contains type declarations for ContainingRangeCache, a class that
+/// remembers the most recently located range so that runs of sorted rows can be
+/// routed without a range set lookup per row.
+
+#ifndef Hypertable_RangeServer_ContainingRangeCache_h
+#define Hypertable_RangeServer_ContainingRangeCache_h
+
+#include <Hypertable/RangeServer/Range.h>
+
+#include <Common/String.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace Hypertable {
+
+  /// @addtogroup RangeServer
+  /// @{
+
+  /// Caches the range that contains the most recently looked up row.
+  /// Update buffers arrive sorted, so consecutive rows almost always belong to
+  /// the same range.  find() compares the row against the cached boundary rows
+  /// and only falls back to <code>find_containing_range()</code> on the range
+  /// set (e.g. TableInfo) when the row falls outside of them.  The boundary
+  /// rows and lookup key are held in member strings whose capacity is reused,
+  /// so a hit does no allocation or locking and a miss allocates only when a
+  /// row is longer than any seen before.  The cache does not observe changes
+  /// to the range set, so callers must invalidate() it when a cached range is
+  /// found to have shrunk, and reset() it when switching range sets.
+  class ContainingRangeCache {
+  public:
+
+    /// Locates range containing <code>row</code>.
+    /// If the cached range contains <code>row</code>, it is returned
+    /// immediately.  Otherwise <code>range_set.find_containing_range()</code>
+    /// is called and its result is cached.
+    /// @param range_set %Range set providing
+    /// <code>find_containing_range(const String &, RangePtr &, String &,
+    /// String &)</code>
+    /// @param row Row key to locate
+    /// @return <i>true</i> if containing range was found, <i>false</i>
+    /// otherwise
+    template <typename RangeSetT>
+    bool find(RangeSetT &range_set, const char *row) {
+      if (contains(row)) {
+        m_hits++;
+        return true;
+      }
+      m_misses++;
+      m_row = row;
+      m_valid = range_set.find_containing_range(m_row, m_range, m_start_row,
+                                                m_end_row);
+      return m_valid;
+    }
+
+    /// Checks if cached range contains <code>row</code>.
+    /// @param row Row key
+    /// @return <i>true</i> if cache is valid and <code>row</code> lies within
+    /// (#m_start_row .. #m_end_row], <i>false</i> otherwise
+    bool contains(const char *row) const {
+      return m_valid && strcmp(row, m_start_row.c_str()) > 0 &&
+        (m_end_row.empty() || strcmp(row, m_end_row.c_str()) <= 0);
+    }
+
+    /// Invalidates cached range.
+    /// The next call to find() will consult the range set.
+    void invalidate() { m_valid = false; }
+
+    /// Invalidates cached range and drops reference to it.
+    void reset() {
+      m_valid = false;
+      m_range.reset();
+    }
+
+    /// Returns cached range.
+    /// @return Cached range (only meaningful after find() returned
+    /// <i>true</i>)
+    const RangePtr &range() const { return m_range; }
+
+    /// Returns start row of cached range.
+    /// @return Start row of cached range
+    const String &start_row() const { return m_start_row; }
+
+    /// Returns end row of cached range.
+    /// @return End row of cached range
+    const String &end_row() const { return m_end_row; }
+
+    /// Returns number of lookups satisfied by cached range.
+    /// @return Number of cache hits
+    int64_t hits() const { return m_hits; }
+
+    /// Returns number of lookups that consulted the range set.
+    /// @return Number of cache misses
+    int64_t misses() const { return m_misses; }
+
+  private:
+
+    /// Cached range
+    RangePtr m_range;
+
+    /// Start row of cached range
+    String m_start_row;
+
+    /// End row of cached range
+    String m_end_row;
+
+    /// Lookup key buffer reused across misses
+    String m_row;
+
+    /// Number of cache hits
+    int64_t m_hits {};
+
+    /// Number of cache misses
+    int64_t m_misses {};
+
+    /// Flag indicating if #m_range, #m_start_row, and #m_end_row are valid
+    bool m_valid {};
+  };
+
+  /// @}
+}
+
+#endif // Hypertable_RangeServer_ContainingRangeCache_h
@@ -37,7 +37,10 @@ namespace Hypertable {
     ScanContext *scan_context = scanner->scan_context();
     bool keys_only = scan_context->spec->keys_only;
     char numbuf[24];
-    DynamicBuffer counter_value;
+    // encoded counter value (vint length + digits), kept on the stack so
+    // converting counters does not allocate
+    uint8_t counter_value[32];
+    uint8_t *counter_ptr;
     bool counter;
     String empty_value("");
 
@@ -51,7 +54,6 @@ namespace Hypertable {
 
       if (keys_only) {
         value.ptr = 0;
-        counter_value.clear();
         value_len = 0;
       }
       else {
@@ -72,9 +74,10 @@ namespace Hypertable {
           //convert counter to ascii
           sprintf(numbuf, "%lld", (Lld) count);
           value_len = strlen(numbuf);
-          counter_value.clear();
-          append_as_byte_string(counter_value, numbuf, value_len);
-          value_len = counter_value.fill();
+          counter_ptr = counter_value;
+          Serialization::encode_vi32(&counter_ptr, value_len);
+          memcpy(counter_ptr, numbuf, value_len);
+          value_len += counter_ptr - counter_value;
         }
         else
           value_len = value.length();
@@ -99,7 +102,7 @@ namespace Hypertable {
         dbuf.add_unchecked(key.serial.ptr, key.length);
 
         if (counter)
-          dbuf.add_unchecked(counter_value.base, value_len);
+          dbuf.add_unchecked(counter_value, value_len);
         else
           dbuf.add_unchecked(value.ptr, value_len);
 
@@ -35,6 +35,15 @@ namespace Hypertable {
   FilesystemPtr          Global::log_dfs;
   ApplicationQueuePtr    Global::app_queue;
   MaintenanceQueuePtr    Global::maintenance_queue;
+  CompactionThrottlePtr  Global::compaction_throttle;
+  LatencyHistogramPtr    Global::update_qualify_latency;
+  LatencyHistogramPtr    Global::update_commit_latency;
+  LatencyHistogramPtr    Global::update_sync_latency;
+  LatencyHistogramPtr    Global::update_respond_latency;
+  LatencyHistogramPtr    Global::create_scanner_latency;
+  LatencyHistogramPtr    Global::fetch_scanblock_latency;
+  LatencyHistogramPtr    Global::block_cache_miss_latency;
+  LatencyHistogramPtr    Global::request_wait_latency;
   Lib::Master::ClientPtr Global::master_client;
   RangeLocatorPtr        Global::range_locator = 0;
   PseudoTables          *Global::pseudo_tables = 0;
@@ -60,6 +69,7 @@ namespace Hypertable {
   int32_t                Global::access_group_max_mem = 0;
   int32_t                Global::cell_cache_scanner_cache_size = 0;
   FileBlockCache        *Global::block_cache = 0;
+  RangeScanCachePtr      Global::range_scan_cache;
   TablePtr               Global::metadata_table = 0;
   TablePtr               Global::rs_metrics_table = 0;
   int64_t                Global::range_metadata_split_size = 0;
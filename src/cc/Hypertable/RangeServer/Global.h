@@ -28,6 +28,7 @@
 
 #include "Common/Properties.h"
 #include "Common/Filesystem.h"
+#include "Common/LatencyHistogram.h"
 #include "Common/TimeWindow.h"
 
 #include "AsyncComm/Comm.h"
@@ -42,6 +43,7 @@
 #include "Hypertable/Lib/RangeSpec.h"
 #include "Hypertable/Lib/TableIdentifier.h"
 
+#include "CompactionThrottle.h"
 #include "FileBlockCache.h"
 #include "LoadStatistics.h"
 #include "LocationInitializer.h"
@@ -49,6 +51,7 @@
 #include "MemoryTracker.h"
 #include "MetaLogEntityTask.h"
 #include "MetaLogEntityRemoveOkLogs.h"
+#include "RangeScanCache.h"
 #include "TableInfo.h"
 
 #include <mutex>
@@ -65,6 +68,16 @@ namespace Hypertable {
     static Hypertable::FilesystemPtr log_dfs;
     static Hypertable::ApplicationQueuePtr app_queue;
     static Hypertable::MaintenanceQueuePtr maintenance_queue;
+    static CompactionThrottlePtr compaction_throttle;
+    // latency histograms (microseconds) for hot request paths
+    static LatencyHistogramPtr update_qualify_latency;
+    static LatencyHistogramPtr update_commit_latency;
+    static LatencyHistogramPtr update_sync_latency;
+    static LatencyHistogramPtr update_respond_latency;
+    static LatencyHistogramPtr create_scanner_latency;
+    static LatencyHistogramPtr fetch_scanblock_latency;
+    static LatencyHistogramPtr block_cache_miss_latency;
+    static LatencyHistogramPtr request_wait_latency;
     static Hypertable::Lib::Master::ClientPtr master_client;
     static Hypertable::RangeLocatorPtr range_locator;
     static Hypertable::PseudoTables *pseudo_tables;
@@ -89,6 +102,7 @@ namespace Hypertable {
     static int32_t        access_group_max_mem;
     static int32_t        cell_cache_scanner_cache_size;
     static Hypertable::FileBlockCache *block_cache;
+    static RangeScanCachePtr range_scan_cache;
     static TablePtr       metadata_table;
     static TablePtr       rs_metrics_table;
     static int64_t        range_metadata_split_size;
@@ -29,7 +29,7 @@
 namespace Hypertable {
 
   namespace KeyCompressionType {
-    enum { NONE=0, PREFIX=1 };
+    enum { NONE=0, PREFIX=1, PREFIX_DELTA=2 };
   }
 
   class KeyCompressor {
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <Common/Compat.h>
+
+#include "KeyCompressorPrefixDelta.h"
+
+#include <Common/Serialization.h>
+
+using namespace Hypertable;
+
+namespace {
+
+  uint64_t decode_word(const uint8_t *ptr) {
+    uint64_t word = 0;
+    for (int i=0; i<8; i++)
+      word = (word << 8) | ptr[i];
+    return word;
+  }
+
+  void encode_word(uint8_t **bufp, uint64_t word) {
+    for (int i=7; i>=0; i--)
+      *(*bufp)++ = (uint8_t)(word >> (i*8));
+  }
+
+  uint64_t zigzag(uint64_t delta) {
+    return (delta << 1) ^ (uint64_t)((int64_t)delta >> 63);
+  }
+
+}
+
+void KeyCompressorPrefixDelta::reset() {
+  m_last_base.clear();
+  m_compressed_key.clear();
+  m_uncompressed_key.clear();
+  m_last_timestamp = 0;
+  m_last_revision = 0;
+}
+
+void KeyCompressorPrefixDelta::add(const Key &key) {
+  HT_ASSERT(key.serial.ptr);
+  const uint8_t *ptr;
+  size_t length = key.serial.decode_length(&ptr);
+  uint8_t control = *ptr++;
+  const uint8_t *base = ptr;
+  const uint8_t *end = base + (length - 1);
+
+  bool have_timestamp = (control & Key::HAVE_TIMESTAMP) != 0;
+  bool have_revision = (control & Key::HAVE_REVISION) &&
+    !(control & Key::REV_IS_TS);
+
+  if (have_revision)
+    end -= 8;
+  if (have_timestamp)
+    end -= 8;
+  size_t base_length = end - base;
+
+  size_t n = std::min(base_length, m_last_base.fill());
+  size_t matching = 0;
+  while (matching < n && base[matching] == m_last_base.base[matching])
+    matching++;
+  size_t suffix_length = base_length - matching;
+
+  uint64_t timestamp_delta = 0;
+  uint64_t revision_delta = 0;
+  size_t total = 1 + Serialization::encoded_length_vi32(matching) +
+    Serialization::encoded_length_vi32(suffix_length) + suffix_length;
+  if (have_timestamp) {
+    uint64_t word = decode_word(end);
+    timestamp_delta = zigzag(word - m_last_timestamp);
+    total += Serialization::encoded_length_vi64(timestamp_delta);
+    m_last_timestamp = word;
+  }
+  if (have_revision) {
+    uint64_t word = decode_word(end + (have_timestamp ? 8 : 0));
+    revision_delta = zigzag(word - m_last_revision);
+    total += Serialization::encoded_length_vi64(revision_delta);
+    m_last_revision = word;
+  }
+
+  m_compressed_key.clear();
+  m_compressed_key.ensure(total + 5);
+  Serialization::encode_vi32(&m_compressed_key.ptr, total);
+  *m_compressed_key.ptr++ = control;
+  Serialization::encode_vi32(&m_compressed_key.ptr, matching);
+  Serialization::encode_vi32(&m_compressed_key.ptr, suffix_length);
+  m_compressed_key.add_unchecked(base + matching, suffix_length);
+  if (have_timestamp)
+    Serialization::encode_vi64(&m_compressed_key.ptr, timestamp_delta);
+  if (have_revision)
+    Serialization::encode_vi64(&m_compressed_key.ptr, revision_delta);
+
+  m_last_base.clear();
+  m_last_base.reserve(base_length);
+  m_last_base.add_unchecked(base, base_length);
+  m_last_control = control;
+  m_uncompressed_key.clear();
+}
+
+size_t KeyCompressorPrefixDelta::length() {
+  return m_compressed_key.fill();
+}
+
+size_t KeyCompressorPrefixDelta::length_uncompressed() {
+  if (m_uncompressed_key.empty())
+    render_uncompressed();
+  return m_uncompressed_key.fill();
+}
+
+void KeyCompressorPrefixDelta::write(uint8_t *buf) {
+  memcpy(buf, m_compressed_key.base, m_compressed_key.fill());
+}
+
+void KeyCompressorPrefixDelta::write_uncompressed(uint8_t *buf) {
+  if (m_uncompressed_key.empty())
+    render_uncompressed();
+  memcpy(buf, m_uncompressed_key.base, m_uncompressed_key.fill());
+}
+
+void KeyCompressorPrefixDelta::render_uncompressed() {
+  bool have_timestamp = (m_last_control & Key::HAVE_TIMESTAMP) != 0;
+  bool have_revision = (m_last_control & Key::HAVE_REVISION) &&
+    !(m_last_control & Key::REV_IS_TS);
+  uint32_t length = 1 + m_last_base.fill() +
+    (have_timestamp ? 8 : 0) + (have_revision ? 8 : 0);
+
+  m_uncompressed_key.clear();
+  m_uncompressed_key.ensure(5 + length);
+  Serialization::encode_vi32(&m_uncompressed_key.ptr, length);
+  *m_uncompressed_key.ptr++ = m_last_control;
+  m_uncompressed_key.add_unchecked(m_last_base.base, m_last_base.fill());
+  if (have_timestamp)
+    encode_word(&m_uncompressed_key.ptr, m_last_timestamp);
+  if (have_revision)
+    encode_word(&m_uncompressed_key.ptr, m_last_revision);
+}
@@ -0,0 +1,58 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#ifndef Hypertable_RangeServer_KeyCompressorPrefixDelta_h
+#define Hypertable_RangeServer_KeyCompressorPrefixDelta_h
+
+#include "KeyCompressor.h"
+
+#include <Common/DynamicBuffer.h>
+
+namespace Hypertable {
+
+  /// Prefix key compressor that also delta encodes timestamp and revision.
+  /// The row, column family, qualifier and flag are prefix compressed against
+  /// the previous key, as with KeyCompressorPrefix.  The encoded timestamp and
+  /// revision words are then written as zigzag vint64 differences from those
+  /// of the previous key, which for cells written close together in time
+  /// shrinks each one from eight bytes to one or two.  State is cleared by
+  /// reset(), which is called at the start of every block and restart point.
+  class KeyCompressorPrefixDelta : public KeyCompressor {
+  public:
+    void reset() override;
+    void add(const Key &key) override;
+    size_t length() override;
+    size_t length_uncompressed() override;
+    void write(uint8_t *buf) override;
+    void write_uncompressed(uint8_t *buf) override;
+  private:
+    void render_uncompressed();
+    DynamicBuffer m_last_base;
+    DynamicBuffer m_compressed_key;
+    DynamicBuffer m_uncompressed_key;
+    uint8_t m_last_control {};
+    uint64_t m_last_timestamp {};
+    uint64_t m_last_revision {};
+  };
+
+}
+
+#endif // Hypertable_RangeServer_KeyCompressorPrefixDelta_h
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <Common/Compat.h>
+
+#include "KeyDecompressorPrefixDelta.h"
+
+#include <Common/Serialization.h>
+
+using namespace Hypertable;
+
+namespace {
+
+  void encode_word(uint8_t **bufp, uint64_t word) {
+    for (int i=7; i>=0; i--)
+      *(*bufp)++ = (uint8_t)(word >> (i*8));
+  }
+
+  uint64_t unzigzag(uint64_t value) {
+    return (value >> 1) ^ (~(value & 1) + 1);
+  }
+
+}
+
+void KeyDecompressorPrefixDelta::reset() {
+  m_bufs[0].clear();
+  m_bufs[1].clear();
+  m_current_base = 0;
+  m_current_base_length = 0;
+  m_last_timestamp = 0;
+  m_last_revision = 0;
+  m_serialized_key.ptr = 0;
+  m_first = false;
+}
+
+const uint8_t *KeyDecompressorPrefixDelta::add(const uint8_t *next_base) {
+  int next = m_first ? 1 : 0;
+  const uint8_t *next_ptr;
+  SerializedKey serkey(next_base);
+  size_t remaining = serkey.decode_length(&next_ptr);
+  const uint8_t *end = next_ptr + remaining;
+  uint8_t control = *next_ptr++;
+  remaining--;
+  uint32_t matching = Serialization::decode_vi32(&next_ptr, &remaining);
+  uint32_t suffix_length = Serialization::decode_vi32(&next_ptr, &remaining);
+
+  HT_ASSERT(matching <= m_current_base_length && suffix_length <= remaining);
+
+  bool have_timestamp = (control & Key::HAVE_TIMESTAMP) != 0;
+  bool have_revision = (control & Key::HAVE_REVISION) &&
+    !(control & Key::REV_IS_TS);
+  size_t length = 1 + matching + suffix_length +
+    (have_timestamp ? 8 : 0) + (have_revision ? 8 : 0);
+
+  m_bufs[next].clear();
+  m_bufs[next].ensure(5 + length);
+  Serialization::encode_vi32(&m_bufs[next].ptr, length);
+  *(m_bufs[next].ptr)++ = control;
+  if (matching)
+    memcpy(m_bufs[next].ptr, m_current_base, matching);
+  m_current_base = m_bufs[next].ptr;
+  m_current_base_length = matching + suffix_length;
+  m_bufs[next].ptr += matching;
+  m_bufs[next].add_unchecked(next_ptr, suffix_length);
+  next_ptr += suffix_length;
+  remaining -= suffix_length;
+
+  if (have_timestamp) {
+    m_last_timestamp += unzigzag(Serialization::decode_vi64(&next_ptr, &remaining));
+    encode_word(&m_bufs[next].ptr, m_last_timestamp);
+  }
+  if (have_revision) {
+    m_last_revision += unzigzag(Serialization::decode_vi64(&next_ptr, &remaining));
+    encode_word(&m_bufs[next].ptr, m_last_revision);
+  }
+  HT_ASSERT(next_ptr == end);
+
+  m_serialized_key.ptr = m_bufs[next].base;
+  m_first = !m_first;
+  return end;
+}
+
+
+bool KeyDecompressorPrefixDelta::less_than(SerializedKey serialized_key) {
+  return m_serialized_key < serialized_key;
+}
+
+
+void KeyDecompressorPrefixDelta::load(Key &key) {
+  key.load(m_serialized_key);
+}
@@ -0,0 +1,362 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Definitions for LogReplayPipeline.
+/// This file contains type definitions for LogReplayPipeline, a multithreaded
+/// pipeline for replaying a commit log into the ranges loaded at startup.
+
+#include <Common/Compat.h>
+
+#include "LogReplayPipeline.h"
+
+#include <Hypertable/RangeServer/ContainingRangeCache.h>
+
+#include <Hypertable/Lib/CompressorFactory.h>
+#include <Hypertable/Lib/Key.h>
+#include <Hypertable/Lib/LegacyDecoder.h>
+#include <Hypertable/Lib/SerializedKey.h>
+
+#include <Common/Error.h>
+#include <Common/Logger.h>
+
+#include <chrono>
+#include <unordered_map>
+
+using namespace Hypertable;
+using namespace std;
+
+namespace {
+
+  int64_t micros_since(chrono::steady_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+  }
+
+  void decode_table_id(const uint8_t **bufp, size_t *remainp,
+                       TableIdentifier *tid) {
+    const uint8_t *buf_saved = *bufp;
+    size_t remain_saved = *remainp;
+    try {
+      tid->decode(bufp, remainp);
+    }
+    catch (Exception &e) {
+      if (e.code() == Error::PROTOCOL_ERROR) {
+        *bufp = buf_saved;
+        *remainp = remain_saved;
+        legacy_decode(bufp, remainp, tid);
+      }
+      else
+        throw;
+    }
+  }
+
+  /// Maps a range to an apply thread.  Range objects are large and similarly
+  /// aligned, so the address is mixed before taking the modulus.
+  size_t apply_index(const Range *range, size_t count) {
+    uint64_t h = (uint64_t)(uintptr_t)range * 0x9E3779B97F4A7C15ULL;
+    return (size_t)((h >> 32) % count);
+  }
+
+}
+
+LogReplayPipeline::LogReplayPipeline(TableInfoMap &replay_map,
+                                     size_t thread_count)
+  : m_replay_map(replay_map), m_thread_count(thread_count) {
+  HT_ASSERT(m_thread_count > 0);
+  m_max_in_flight = 4 * m_thread_count;
+}
+
+void LogReplayPipeline::replay(CommitLogReaderPtr &log_reader) {
+  auto start_time = chrono::steady_clock::now();
+  uint64_t sequence = 0;
+
+  m_stats = Statistics();
+  m_log_reader = log_reader.get();
+  m_inflate_queue.clear();
+  m_completed.clear();
+  m_apply_queues.clear();
+  m_apply_queues.resize(m_thread_count);
+  m_next_sequence = 0;
+  m_in_flight = 0;
+  m_error = nullptr;
+  m_shutdown = false;
+
+  for (size_t i=0; i<m_thread_count; i++)
+    m_threads.push_back(thread(&LogReplayPipeline::inflate_worker, this));
+  for (size_t i=0; i<m_thread_count; i++)
+    m_threads.push_back(thread(&LogReplayPipeline::apply_worker, this, i));
+
+  try {
+    while (true) {
+      BlockPtr block = make_shared<Block>();
+      auto read_start = chrono::steady_clock::now();
+      if (!log_reader->next_compressed(block->zblock, &block->header,
+                                       &block->fragment))
+        break;
+      m_stats.read_micros += micros_since(read_start);
+      block->sequence = sequence++;
+      block->runs.resize(m_thread_count);
+
+      unique_lock<mutex> lock(m_mutex);
+      m_cond.wait(lock, [this](){
+          return m_in_flight < m_max_in_flight || m_error; });
+      if (m_error)
+        break;
+      m_stats.blocks++;
+      m_stats.compressed_bytes += block->zblock.fill();
+      m_in_flight++;
+      m_inflate_queue.push_back(block);
+      m_cond.notify_all();
+    }
+  }
+  catch (...) {
+    set_error(current_exception());
+  }
+
+  {
+    unique_lock<mutex> lock(m_mutex);
+    m_cond.wait(lock, [this](){ return m_in_flight == 0 || m_error; });
+    m_shutdown = true;
+    m_cond.notify_all();
+  }
+
+  for (auto &t : m_threads)
+    t.join();
+  m_threads.clear();
+
+  m_stats.elapsed_micros = micros_since(start_time);
+
+  if (m_error)
+    rethrow_exception(m_error);
+
+  log_reader->finish_compressed();
+}
+
+void LogReplayPipeline::inflate_worker() {
+  unordered_map<uint16_t, BlockCompressionCodecPtr> codecs;
+  ContainingRangeCache range_cache;
+  int64_t inflate_micros = 0;
+  int64_t partition_micros = 0;
+  int64_t bytes = 0;
+  BlockPtr block;
+
+  try {
+    while (true) {
+
+      {
+        unique_lock<mutex> lock(m_mutex);
+        m_cond.wait(lock, [this](){
+            return !m_inflate_queue.empty() || m_shutdown; });
+        if (m_shutdown)
+          break;
+        block = m_inflate_queue.front();
+        m_inflate_queue.pop_front();
+      }
+
+      auto phase_start = chrono::steady_clock::now();
+      try {
+        uint16_t ztype = block->header.get_compression_type();
+        if (ztype >= BlockCompressionCodec::COMPRESSION_TYPE_LIMIT)
+          HT_THROWF(Error::BLOCK_COMPRESSOR_UNSUPPORTED_TYPE,
+                    "Invalid compression type '%d'", (int)ztype);
+        BlockCompressionCodecPtr &codec = codecs[ztype];
+        if (!codec)
+          codec.reset(CompressorFactory::create_block_codec((BlockCompressionCodec::Type)ztype));
+        codec->inflate(block->zblock, block->buffer, block->header);
+        m_log_reader->add_revision(block->fragment,
+                                   block->header.get_revision());
+      }
+      catch (Exception &e) {
+        HT_ERRORF("Inflate error in CommitLog block %llu - %s",
+                  (Llu)block->sequence, Error::get_text(e.code()));
+        block->buffer.clear();
+      }
+      block->zblock.free();
+      inflate_micros += micros_since(phase_start);
+
+      phase_start = chrono::steady_clock::now();
+      if (block->buffer.fill())
+        partition(block.get(), range_cache);
+      partition_micros += micros_since(phase_start);
+      bytes += block->buffer.fill();
+
+      {
+        lock_guard<mutex> lock(m_mutex);
+        m_completed[block->sequence] = block;
+        dispatch_completed();
+      }
+      block.reset();
+    }
+  }
+  catch (...) {
+    set_error(current_exception());
+  }
+
+  lock_guard<mutex> lock(m_mutex);
+  m_stats.inflate_micros += inflate_micros;
+  m_stats.partition_micros += partition_micros;
+  m_stats.bytes += bytes;
+}
+
+void LogReplayPipeline::partition(Block *block,
+                                  ContainingRangeCache &range_cache) {
+  TableIdentifier table_id;
+  TableInfoPtr table_info;
+  SerializedKey skey;
+  ByteString value;
+  Run run;
+  const uint8_t *ptr = block->buffer.base;
+  const uint8_t *end = block->buffer.base + block->buffer.fill();
+  const uint8_t *cell;
+  size_t len = block->buffer.fill();
+
+  decode_table_id(&ptr, &len, &table_id);
+
+  if (!m_replay_map.lookup(table_id.id, table_info))
+    return;
+
+  range_cache.reset();
+  run.base = run.end = 0;
+
+  while (ptr < end) {
+    cell = ptr;
+    skey.ptr = ptr;
+    ptr += skey.length();
+    if (ptr > end)
+      HT_THROW(Error::REQUEST_TRUNCATED, "Problem decoding key");
+    value.ptr = ptr;
+    ptr += value.length();
+    if (ptr > end)
+      HT_THROW(Error::REQUEST_TRUNCATED, "Problem decoding value");
+
+    // Extend current run
+    if (run.base && range_cache.contains(skey.row())) {
+      run.end = ptr;
+      continue;
+    }
+
+    if (run.base) {
+      block->runs[apply_index(run.range.get(), m_thread_count)].push_back(run);
+      run.base = 0;
+    }
+
+    // Cells outside of the ranges being replayed are dropped
+    if (!range_cache.find(*table_info, skey.row()))
+      continue;
+
+    run.range = range_cache.range();
+    run.base = cell;
+    run.end = ptr;
+  }
+
+  if (run.base)
+    block->runs[apply_index(run.range.get(), m_thread_count)].push_back(run);
+}
+
+void LogReplayPipeline::dispatch_completed() {
+  while (!m_completed.empty() &&
+         m_completed.begin()->first == m_next_sequence) {
+    BlockPtr block = m_completed.begin()->second;
+    m_completed.erase(m_completed.begin());
+    m_next_sequence++;
+    for (size_t i=0; i<m_thread_count; i++) {
+      if (!block->runs[i].empty()) {
+        m_apply_queues[i].push_back(block);
+        block->outstanding++;
+      }
+    }
+    if (block->outstanding == 0)
+      retire(block.get());
+  }
+  m_cond.notify_all();
+}
+
+void LogReplayPipeline::apply_worker(size_t index) {
+  SerializedKey skey;
+  ByteString value;
+  Key key;
+  int64_t apply_micros = 0;
+  int64_t cells = 0;
+  BlockPtr block;
+
+  try {
+    while (true) {
+
+      {
+        unique_lock<mutex> lock(m_mutex);
+        m_cond.wait(lock, [this, index](){
+            return !m_apply_queues[index].empty() || m_shutdown; });
+        if (m_shutdown)
+          break;
+        block = m_apply_queues[index].front();
+        m_apply_queues[index].pop_front();
+      }
+
+      auto apply_start = chrono::steady_clock::now();
+      for (auto &run : block->runs[index]) {
+        lock_guard<Range> lock(*run.range);
+        for (const uint8_t *ptr = run.base; ptr < run.end; ) {
+          skey.ptr = ptr;
+          key.load(skey);
+          ptr += skey.length();
+          value.ptr = ptr;
+          ptr += value.length();
+          run.range->add(key, value);
+          cells++;
+        }
+      }
+      apply_micros += micros_since(apply_start);
+
+      {
+        lock_guard<mutex> lock(m_mutex);
+        if (--block->outstanding == 0)
+          retire(block.get());
+      }
+      block.reset();
+    }
+  }
+  catch (...) {
+    set_error(current_exception());
+  }
+
+  lock_guard<mutex> lock(m_mutex);
+  m_stats.apply_micros += apply_micros;
+  m_stats.cells += cells;
+}
+
+void LogReplayPipeline::retire(Block *block) {
+  // Drop range references and buffers now rather than when the last
+  // reference to the block goes away
+  block->runs.clear();
+  block->buffer.free();
+  HT_ASSERT(m_in_flight > 0);
+  m_in_flight--;
+  m_cond.notify_all();
+}
+
+void LogReplayPipeline::set_error(exception_ptr error) {
+  lock_guard<mutex> lock(m_mutex);
+  if (!m_error)
+    m_error = error;
+  m_shutdown = true;
+  m_cond.notify_all();
+}
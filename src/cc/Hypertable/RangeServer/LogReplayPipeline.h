@@ -0,0 +1,223 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Declarations for LogReplayPipeline.
+/// This file contains type declarations for LogReplayPipeline, a multithreaded
+/// pipeline for replaying a commit log into the ranges loaded at startup.
+
+#ifndef Hypertable_RangeServer_LogReplayPipeline_h
+#define Hypertable_RangeServer_LogReplayPipeline_h
+
+#include <Hypertable/RangeServer/Range.h>
+#include <Hypertable/RangeServer/TableInfoMap.h>
+
+#include <Hypertable/Lib/BlockHeaderCommitLog.h>
+#include <Hypertable/Lib/CommitLogReader.h>
+
+#include <Common/DynamicBuffer.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Hypertable {
+
+  class ContainingRangeCache;
+
+  /// @addtogroup RangeServer
+  /// @{
+
+  /// Multithreaded commit log replay.
+  /// The calling thread reads compressed blocks from the log in order and
+  /// hands them to a pool of inflate threads, which decompress them and
+  /// partition their cells into runs of consecutive cells destined for the
+  /// same range.  Blocks are then released, in log order, to a pool of apply
+  /// threads.  All runs for a given range are applied by the same apply
+  /// thread, in log order, so the per-range revision order of a sequential
+  /// replay is preserved.  The number of blocks in flight is bounded to limit
+  /// memory usage.
+  class LogReplayPipeline {
+  public:
+
+    /// Replay statistics.
+    /// Times of the inflate, partition, and apply phases are summed over all
+    /// threads of the phase.
+    struct Statistics {
+      /// Blocks read
+      int64_t blocks {};
+      /// Compressed bytes read
+      int64_t compressed_bytes {};
+      /// Uncompressed bytes
+      int64_t bytes {};
+      /// Cells applied to ranges
+      int64_t cells {};
+      /// Microseconds spent reading blocks
+      int64_t read_micros {};
+      /// Microseconds spent decompressing blocks
+      int64_t inflate_micros {};
+      /// Microseconds spent partitioning cells by range
+      int64_t partition_micros {};
+      /// Microseconds spent adding cells to ranges
+      int64_t apply_micros {};
+      /// Elapsed microseconds
+      int64_t elapsed_micros {};
+    };
+
+    /// Constructor.
+    /// @param replay_map Map of tables and ranges being replayed
+    /// @param thread_count Number of inflate threads and of apply threads
+    LogReplayPipeline(TableInfoMap &replay_map, size_t thread_count);
+
+    /// Replays a commit log.
+    /// Starts the inflate and apply threads, feeds them the blocks returned
+    /// by <code>log_reader->next_compressed()</code>, and waits for all of
+    /// them to be applied.  Cells whose table or row is not in
+    /// #m_replay_map are skipped.  Blocks that fail to decompress are logged
+    /// and skipped, and only the revisions of blocks that decompress are
+    /// recorded with <code>log_reader->add_revision()</code>.
+    /// @param log_reader Commit log reader
+    /// @throws Exception with code Error::REQUEST_TRUNCATED if a block is
+    /// malformed, or any exception thrown while adding cells to a range
+    void replay(CommitLogReaderPtr &log_reader);
+
+    /// Returns replay statistics.
+    /// @return Statistics collected by last call to replay()
+    const Statistics &get_statistics() const { return m_stats; }
+
+  private:
+
+    /// Run of serialized key/value pairs within a block destined for a range.
+    struct Run {
+      /// Destination range
+      RangePtr range;
+      /// Beginning of first key/value pair
+      const uint8_t *base;
+      /// End of last key/value pair
+      const uint8_t *end;
+    };
+
+    /// Commit log block in flight.
+    struct Block {
+      /// Position of block in log
+      uint64_t sequence {};
+      /// Block header
+      BlockHeaderCommitLog header;
+      /// Log fragment containing block
+      CommitLogFileInfo *fragment {};
+      /// Compressed block
+      DynamicBuffer zblock;
+      /// Uncompressed block
+      DynamicBuffer buffer;
+      /// Runs, indexed by apply thread
+      std::vector<std::vector<Run>> runs;
+      /// Number of apply threads that have not yet processed this block
+      size_t outstanding {};
+    };
+
+    /// Smart pointer to Block
+    typedef std::shared_ptr<Block> BlockPtr;
+
+    /// Thread function for inflate threads.
+    /// Decompresses blocks from #m_inflate_queue, partitions their cells with
+    /// partition(), and releases them to the apply threads in sequence order.
+    void inflate_worker();
+
+    /// Thread function for apply threads.
+    /// Adds the runs of the blocks in the apply queue to their ranges.
+    /// @param index Index of apply thread
+    void apply_worker(size_t index);
+
+    /// Partitions cells of an uncompressed block into runs.
+    /// @param block Block to partition
+    /// @param range_cache Cache of most recently located range
+    void partition(Block *block, ContainingRangeCache &range_cache);
+
+    /// Queues completed blocks to apply threads in sequence order.
+    /// @warning Must be called with #m_mutex locked
+    void dispatch_completed();
+
+    /// Records block as fully applied.
+    /// @param block Block to retire
+    /// @warning Must be called with #m_mutex locked
+    void retire(Block *block);
+
+    /// Records first worker exception and tells the pipeline to stop.
+    /// @param error Exception to record
+    void set_error(std::exception_ptr error);
+
+    /// Map of tables and ranges being replayed
+    TableInfoMap &m_replay_map;
+
+    /// Commit log reader passed to replay()
+    CommitLogReader *m_log_reader {};
+
+    /// Number of inflate threads and of apply threads
+    size_t m_thread_count {};
+
+    /// Maximum number of blocks in flight
+    size_t m_max_in_flight {};
+
+    /// %Mutex protecting the queues and counters below
+    std::mutex m_mutex;
+
+    /// Condition variable signaling queue or counter changes
+    std::condition_variable m_cond;
+
+    /// Blocks waiting to be decompressed
+    std::deque<BlockPtr> m_inflate_queue;
+
+    /// Partitioned blocks waiting to be released in sequence order
+    std::map<uint64_t, BlockPtr> m_completed;
+
+    /// Blocks waiting to be applied, indexed by apply thread
+    std::vector<std::deque<BlockPtr>> m_apply_queues;
+
+    /// Sequence number of next block to release to apply threads
+    uint64_t m_next_sequence {};
+
+    /// Number of blocks read but not yet fully applied
+    size_t m_in_flight {};
+
+    /// Replay statistics
+    Statistics m_stats;
+
+    /// First exception thrown by a worker thread
+    std::exception_ptr m_error;
+
+    /// Flag indicating that worker threads should exit
+    bool m_shutdown {};
+
+    /// Inflate and apply threads
+    std::vector<std::thread> m_threads;
+  };
+
+  /// @}
+}
+
+#endif // Hypertable_RangeServer_LogReplayPipeline_h
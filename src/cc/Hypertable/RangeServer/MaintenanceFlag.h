@@ -52,12 +52,16 @@ namespace Hypertable {
       COMPACT_MERGING           = 0x00000204, //!< Mergin compaction mask
       COMPACT_GC                = 0x00000208, //!< GC compaction mask
       COMPACT_MOVE              = 0x00000210, //!< Merging compaction mask
+      COMPACT_DROP_EXPIRED      = 0x00000220, //!< Expired %CellStore drop mask
       MEMORY_PURGE              = 0x00000400, //!< Memory purge mask
       MEMORY_PURGE_SHADOW_CACHE = 0x00000401, //!< Memory shadow cache purge mask
       MEMORY_PURGE_CELLSTORE    = 0x00000402, //!< Memory cellstore index purge mask
       RELINQUISH                = 0x00000800,  //!< Relinquish mask
       /// Recompute %CellStore merge run to test if merging compaction needed
-      RECOMPUTE_MERGE_RUN = 0x00010000
+      RECOMPUTE_MERGE_RUN = 0x00010000,
+      /// Fold scans of the last maintenance interval into the access group
+      /// scan statistics
+      ROTATE_SCAN_STATISTICS = 0x00020000
     };
 
     /** Tests the RELINQUISH bit of <code>flags</code>
@@ -132,6 +136,15 @@ namespace Hypertable {
       return (flags & COMPACT_MOVE) == COMPACT_MOVE;
     }
 
+    /** Tests the COMPACT_DROP_EXPIRED bit of <code>flags</code>
+     * @param flags Bit field of maintenance types
+     * @return <i>true</i> if COMPACT_DROP_EXPIRED bit is set, <i>false</i>
+     * otherwise.
+     */
+    inline bool drop_expired(int flags) {
+      return (flags & COMPACT_DROP_EXPIRED) == COMPACT_DROP_EXPIRED;
+    }
+
     /** Tests the PURGE_SHADOW_CACHE bit of <code>flags</code>
      * @param flags Bit field of maintenance types
      * @return <i>true</i> if PURGE_SHADOW_CACHE bit is set, <i>false</i>
@@ -159,6 +172,15 @@ namespace Hypertable {
       return (flags & RECOMPUTE_MERGE_RUN) == RECOMPUTE_MERGE_RUN;
     }
 
+    /** Tests the ROTATE_SCAN_STATISTICS bit of <code>flags</code>
+     * @param flags Bit field of maintenance types
+     * @return <i>true</i> if ROTATE_SCAN_STATISTICS bit is set, <i>false</i>
+     * otherwise.
+     */
+    inline bool rotate_scan_statistics(int flags) {
+      return (flags & ROTATE_SCAN_STATISTICS) == ROTATE_SCAN_STATISTICS;
+    }
+
     /** Hash function class for pointers. */
     class Hash {
     public:
@@ -23,6 +23,7 @@
 #include "Common/ScopeGuard.h"
 #include "Common/StringExt.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
@@ -53,6 +54,24 @@ namespace {
     }
   };
 
+  /// Read cost of an access group, used to order merging compactions.
+  /// Scans that merge many cell stores and skip many cells (deletes,
+  /// expired versions) benefit most from merging.
+  double read_heat(const AccessGroup::MaintenanceData *agdata) {
+    return (double)agdata->scans * std::max(agdata->stores_per_scan, 1.0f) *
+      std::max(agdata->read_amplification, 1.0f);
+  }
+
+  struct MergeHeatOrderingDescending {
+    bool operator()(const StatsRec &x, const StatsRec &y) const {
+      double x_heat = read_heat(x.agdata);
+      double y_heat = read_heat(y.agdata);
+      if (x_heat == y_heat)
+        return x.agdata->file_count > y.agdata->file_count;
+      return x_heat > y_heat;
+    }
+  };
+
   struct ShadowCacheSortOrdering {
     bool operator()(const AccessGroup::CellStoreMaintenanceData *x,
 		    const AccessGroup::CellStoreMaintenanceData *y) const {
@@ -303,6 +322,8 @@ MaintenancePrioritizer::schedule_necessary_compactions(std::vector<RangeData> &r
 
   // Other compactions
 
+  std::vector<StatsRec> merges;
+
   for (size_t i=0; i<range_data.size(); i++) {
 
     if (range_data[i].data->busy)
@@ -323,6 +344,18 @@ MaintenancePrioritizer::schedule_necessary_compactions(std::vector<RangeData> &r
         if (memory_state.need_more())
           memory_state.decrement_needed(ag_data->mem_allocated);
       }
+      // Drop cell stores that have fully expired, no need to rewrite them
+      else if (ag_data->expired_file_count) {
+        range_data[i].data->maintenance_flags |= MaintenanceFlag::COMPACT;
+        ag_data->maintenance_flags |= MaintenanceFlag::COMPACT_DROP_EXPIRED;
+        if (range_data[i].data->priority == 0)
+          range_data[i].data->priority = priority++;
+        if (trace)
+          *trace +=format("%d %u expired cell stores %s (priority=%d)\n",
+                          __LINE__, (unsigned)ag_data->expired_file_count,
+                          ag_data->ag->get_full_name(),
+                          range_data[i].data->priority);
+      }
       // Schedule compaction for AGs that need garbage collection
       else if (ag_data->gc_needed) {
         range_data[i].data->maintenance_flags |= MaintenanceFlag::COMPACT;
@@ -357,26 +390,39 @@ MaintenancePrioritizer::schedule_necessary_compactions(std::vector<RangeData> &r
                            (Lld)ag_data->mem_used, range_data[i].data->priority,
                            (Lld)memory_state.needed);
       }
-      // Merging compactions
-      else if (ag_data->needs_merging) {
-        if (range_data[i].data->priority == 0)
-          range_data[i].data->priority = priority++;
-        range_data[i].data->maintenance_flags |= MaintenanceFlag::COMPACT;
-        ag_data->maintenance_flags |= MaintenanceFlag::COMPACT_MERGING;
-        // If it's an "end merge" then the cell cache will be included so
-        // decrement the memory occupied by the cell cache
-        if (ag_data->end_merge && memory_state.need_more())
-          memory_state.decrement_needed(ag_data->mem_allocated);
-        if (trace)
-          *trace += format("%d needs merging %s (priority=%d, "
-                           "mem_needed=%lld)\n", __LINE__,
-                           ag_data->ag->get_full_name(),
-                           range_data[i].data->priority,
-                           (Lld)memory_state.needed);
-      }
+      // Merging compactions, scheduled below by read heat
+      else if (ag_data->needs_merging)
+        merges.push_back(StatsRec(ag_data, range_data[i].data));
     }
   }
 
+  // Merging compactions, hottest first so that ranges whose scans merge the
+  // most cell stores get the limited merge slots
+  {
+    struct MergeHeatOrderingDescending ordering;
+    stable_sort(merges.begin(), merges.end(), ordering);
+  }
+
+  for (auto &rec : merges) {
+    ag_data = rec.agdata;
+    if (rec.rangedata->priority == 0)
+      rec.rangedata->priority = priority++;
+    rec.rangedata->maintenance_flags |= MaintenanceFlag::COMPACT;
+    ag_data->maintenance_flags |= MaintenanceFlag::COMPACT_MERGING;
+    // If it's an "end merge" then the cell cache will be included so
+    // decrement the memory occupied by the cell cache
+    if (ag_data->end_merge && memory_state.need_more())
+      memory_state.decrement_needed(ag_data->mem_allocated);
+    if (trace)
+      *trace += format("%d needs merging %s (priority=%d, scans=%.1f, "
+                       "stores_per_scan=%.1f, read_amplification=%.1f, "
+                       "mem_needed=%lld)\n", __LINE__,
+                       ag_data->ag->get_full_name(), rec.rangedata->priority,
+                       ag_data->scans, ag_data->stores_per_scan,
+                       ag_data->read_amplification,
+                       (Lld)memory_state.needed);
+  }
+
   return memory_state.need_more();
 }
 
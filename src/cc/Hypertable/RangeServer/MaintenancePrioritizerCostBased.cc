@@ -0,0 +1,257 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Definitions for MaintenancePrioritizerCostBased.
+/// This file contains type definitions for MaintenancePrioritizerCostBased, a
+/// maintenance prioritizer that orders compactions and memory purges of user
+/// ranges by the score assigned to them by a MaintenanceScorer.
+
+#include <Common/Compat.h>
+
+#include "MaintenancePrioritizerCostBased.h"
+
+#include <Hypertable/RangeServer/Global.h>
+#include <Hypertable/RangeServer/MaintenanceFlag.h>
+
+#include <Common/Config.h>
+#include <Common/StringExt.h>
+
+using namespace Hypertable;
+using namespace Hypertable::Config;
+using namespace std;
+
+MaintenancePrioritizerCostBased::MaintenancePrioritizerCostBased(MaintenanceScorerPtr scorer)
+  : m_scorer(scorer) {
+  HT_ASSERT(m_scorer);
+  m_garbage_threshold =
+    get_i32("Hypertable.RangeServer.AccessGroup.GarbageThreshold.Percentage");
+}
+
+void
+MaintenancePrioritizerCostBased::prioritize(std::vector<RangeData> &range_data,
+                                            MemoryState &memory_state,
+                                            int32_t priority, String *trace) {
+  LoadStatistics::Bundle load_stats;
+  std::vector<RangeData> range_data_root;
+  std::vector<RangeData> range_data_metadata;
+  std::vector<RangeData> range_data_system;
+  std::vector<RangeData> range_data_user;
+
+  for (size_t i=0; i<range_data.size(); i++) {
+    if (range_data[i].range->is_root())
+      range_data_root.push_back(range_data[i]);
+    else if (range_data[i].data->is_metadata)
+      range_data_metadata.push_back(range_data[i]);
+    else if (range_data[i].data->is_system)
+      range_data_system.push_back(range_data[i]);
+    else
+      range_data_user.push_back(range_data[i]);
+  }
+
+  m_uninitialized_ranges_seen = false;
+
+  if (!range_data_root.empty())
+    assign_priorities(range_data_root, Global::root_log,
+                      Global::log_prune_threshold_min,
+                      memory_state, priority, trace);
+
+  if (!range_data_metadata.empty())
+    assign_priorities(range_data_metadata, Global::metadata_log,
+                      Global::log_prune_threshold_min,
+                      memory_state, priority, trace);
+
+  Global::load_statistics->get(&load_stats);
+  int64_t prune_threshold = (int64_t)(load_stats.update_mbps * (double)Global::log_prune_threshold_max);
+  if (prune_threshold < Global::log_prune_threshold_min)
+    prune_threshold = Global::log_prune_threshold_min;
+  else if (prune_threshold > Global::log_prune_threshold_max)
+    prune_threshold = Global::log_prune_threshold_max;
+  if (trace)
+    *trace += format("%d prune threshold\t%lld\n", __LINE__, (Lld)prune_threshold);
+
+  if (!range_data_system.empty())
+    assign_priorities(range_data_system, Global::system_log, prune_threshold,
+                      memory_state, priority, trace);
+
+  if (!range_data_user.empty()) {
+    schedule_initialization_operations(range_data_user, priority);
+    schedule_inprogress_operations(range_data_user, memory_state, priority, trace);
+    schedule_splits_and_relinquishes(range_data_user, memory_state, priority, trace);
+    schedule_scored_actions(range_data_user, Global::user_log, prune_threshold,
+                            memory_state, priority, trace);
+  }
+
+  if (m_uninitialized_ranges_seen == false)
+    m_initialization_complete = true;
+
+  // Nothing left to score, take the rest from the block cache
+  if (memory_state.need_more() && Global::block_cache) {
+    Global::block_cache->cap_memory_use();
+    memory_state.decrement_needed( Global::block_cache->decrease_limit(memory_state.needed) );
+  }
+
+}
+
+
+void
+MaintenancePrioritizerCostBased::assign_priorities(std::vector<RangeData> &range_data,
+              CommitLogPtr &log, int64_t prune_threshold, MemoryState &memory_state,
+              int32_t &priority, String *trace) {
+  schedule_initialization_operations(range_data, priority);
+  schedule_inprogress_operations(range_data, memory_state, priority, trace);
+  schedule_splits_and_relinquishes(range_data, memory_state, priority, trace);
+  schedule_necessary_compactions(range_data, log, prune_threshold,
+                                 memory_state, priority, trace);
+}
+
+
+void
+MaintenancePrioritizerCostBased::schedule_scored_actions(std::vector<RangeData> &range_data,
+              CommitLogPtr &log, int64_t prune_threshold, MemoryState &memory_state,
+              int32_t &priority, String *trace) {
+  CommitLog::CumulativeSizeMap cumulative_size_map;
+  CommitLog::CumulativeSizeMap::iterator iter;
+  AccessGroup::MaintenanceData *ag_data;
+  AccessGroup::CellStoreMaintenanceData *cs_data;
+  Range::MaintenanceData *range_maintenance_data;
+  MaintenanceScorer::AccessGroupState state;
+  MaintenanceScorer::Parameters params;
+  std::vector<MaintenanceCandidate> candidates;
+
+  // Without an active fragment nothing is pinned
+  if (!log->load_cumulative_size_map(cumulative_size_map))
+    HT_WARN("MaintenancePrioritizerCostBased, no active commitlog fragment");
+
+  params.prune_threshold = prune_threshold;
+  params.access_group_max_mem = Global::access_group_max_mem;
+  params.garbage_threshold = m_garbage_threshold;
+
+  for (size_t i=0; i<range_data.size(); i++) {
+
+    if (range_data[i].data->busy ||
+        range_data[i].data->maintenance_flags & (MaintenanceFlag::SPLIT|MaintenanceFlag::RELINQUISH))
+      continue;
+
+    for (ag_data = range_data[i].data->agdata; ag_data; ag_data = ag_data->next) {
+
+      ag_data->user_data = (void *)range_data[i].data;
+
+      if (ag_data->earliest_cached_revision != TIMESTAMP_MAX &&
+          !cumulative_size_map.empty()) {
+        iter = cumulative_size_map.lower_bound(ag_data->earliest_cached_revision);
+        if (iter != cumulative_size_map.end())
+          ag_data->log_space_pinned = (*iter).second.cumulative_size;
+      }
+
+      // Maintenance already scheduled for this AG
+      if (ag_data->maintenance_flags != 0)
+        continue;
+
+      state.owner = ag_data;
+      state.mem_used = ag_data->mem_used;
+      state.mem_allocated = ag_data->mem_allocated;
+      state.disk_used = ag_data->disk_used;
+      state.log_space_pinned = ag_data->log_space_pinned;
+      state.shadow_cache_memory = ag_data->shadow_cache_memory;
+      state.index_memory = ag_data->block_index_memory + ag_data->bloom_filter_memory;
+      state.scans = ag_data->scans;
+      state.stores_per_scan = ag_data->stores_per_scan;
+      state.read_amplification = ag_data->read_amplification;
+      state.file_count = ag_data->file_count;
+      state.expired_file_count = ag_data->expired_file_count;
+      state.compression_ratio = ag_data->compression_ratio;
+      state.compaction_type_needed = range_data[i].data->compaction_type_needed;
+      state.in_memory = ag_data->in_memory;
+      state.gc_needed = ag_data->gc_needed;
+      state.needs_merging = ag_data->needs_merging;
+      state.end_merge = ag_data->end_merge;
+      MaintenanceScorer::generate(state, params, candidates);
+    }
+  }
+
+  int64_t memory_needed = memory_state.needed;
+  m_scorer->schedule(candidates, memory_needed);
+
+  for (auto &candidate : candidates) {
+
+    if (!candidate.selected)
+      continue;
+
+    ag_data = (AccessGroup::MaintenanceData *)candidate.owner;
+    range_maintenance_data = (Range::MaintenanceData *)ag_data->user_data;
+
+    if (range_maintenance_data->priority == 0)
+      range_maintenance_data->priority = priority++;
+
+    switch (candidate.action) {
+    case MaintenanceCandidate::MINOR_COMPACTION:
+      if (memory_state.need_more()) {
+        range_maintenance_data->maintenance_flags |= MaintenanceFlag::COMPACT|MaintenanceFlag::MEMORY_PURGE;
+        ag_data->maintenance_flags |= MaintenanceFlag::COMPACT_MINOR|MaintenanceFlag::MEMORY_PURGE_SHADOW_CACHE;
+      }
+      else {
+        range_maintenance_data->maintenance_flags |= MaintenanceFlag::COMPACT;
+        ag_data->maintenance_flags |= MaintenanceFlag::COMPACT_MINOR;
+      }
+      break;
+    case MaintenanceCandidate::MERGING_COMPACTION:
+      range_maintenance_data->maintenance_flags |= MaintenanceFlag::COMPACT;
+      ag_data->maintenance_flags |= MaintenanceFlag::COMPACT_MERGING;
+      break;
+    case MaintenanceCandidate::GC_COMPACTION:
+      range_maintenance_data->maintenance_flags |= MaintenanceFlag::COMPACT;
+      ag_data->maintenance_flags |= MaintenanceFlag::COMPACT_GC;
+      break;
+    case MaintenanceCandidate::DROP_EXPIRED:
+      range_maintenance_data->maintenance_flags |= MaintenanceFlag::COMPACT;
+      ag_data->maintenance_flags |= MaintenanceFlag::COMPACT_DROP_EXPIRED;
+      break;
+    case MaintenanceCandidate::MANUAL_COMPACTION:
+      range_maintenance_data->maintenance_flags |= MaintenanceFlag::COMPACT;
+      ag_data->maintenance_flags |= range_maintenance_data->compaction_type_needed;
+      break;
+    case MaintenanceCandidate::MEMORY_PURGE:
+      range_maintenance_data->maintenance_flags |= MaintenanceFlag::MEMORY_PURGE;
+      ag_data->maintenance_flags |= MaintenanceFlag::MEMORY_PURGE;
+      for (cs_data=ag_data->csdata; cs_data; cs_data=cs_data->next) {
+        if (cs_data->shadow_cache_size > 0)
+          cs_data->maintenance_flags |= MaintenanceFlag::MEMORY_PURGE_SHADOW_CACHE;
+        if (cs_data->index_stats.bloom_filter_memory > 0 ||
+            cs_data->index_stats.block_index_memory > 0)
+          cs_data->maintenance_flags |= MaintenanceFlag::MEMORY_PURGE_CELLSTORE;
+      }
+      break;
+    }
+
+    memory_state.decrement_needed(candidate.memory_freed);
+
+    if (trace)
+      *trace += format("%d %s %s (score=%.3f, io=%lld, priority=%d, "
+                       "mem_needed=%lld)\n", __LINE__,
+                       MaintenanceCandidate::action_name(candidate.action),
+                       ag_data->ag->get_full_name(), candidate.score,
+                       (Lld)candidate.io_bytes,
+                       range_maintenance_data->priority,
+                       (Lld)memory_state.needed);
+  }
+}
@@ -0,0 +1,99 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Declarations for MaintenancePrioritizerCostBased.
+/// This file contains type declarations for MaintenancePrioritizerCostBased, a
+/// maintenance prioritizer that orders compactions and memory purges of user
+/// ranges by the score assigned to them by a MaintenanceScorer.
+
+#ifndef Hypertable_RangeServer_MaintenancePrioritizerCostBased_h
+#define Hypertable_RangeServer_MaintenancePrioritizerCostBased_h
+
+#include <Hypertable/RangeServer/MaintenancePrioritizer.h>
+#include <Hypertable/RangeServer/MaintenanceScorer.h>
+
+namespace Hypertable {
+
+  /// @addtogroup RangeServer
+  /// @{
+
+  /// Cost-based maintenance prioritizer.
+  /// ROOT, METADATA, and system ranges are prioritized the same way as with
+  /// MaintenancePrioritizerLogCleanup.  For user ranges, deferred
+  /// initialization, in-progress operations, splits and relinquishes are
+  /// scheduled first.  Compactions and memory purges are then generated as
+  /// MaintenanceCandidate objects, scored and selected by the scorer, and
+  /// assigned priorities in score order.  The same prioritizer is used in
+  /// low memory mode, where the memory need makes memory freeing candidates
+  /// worth selecting.  Selected with the
+  /// <code>Hypertable.RangeServer.Maintenance.Prioritizer</code> property.
+  class MaintenancePrioritizerCostBased : public MaintenancePrioritizer {
+  public:
+
+    /// Constructor.
+    /// @param scorer Scorer used to order user range maintenance
+    MaintenancePrioritizerCostBased(MaintenanceScorerPtr scorer);
+
+    void prioritize(std::vector<RangeData> &range_data,
+                    MemoryState &memory_state, int32_t priority,
+                    String *trace) override;
+
+  private:
+
+    /// Assigns priorities to ROOT, METADATA or system ranges.
+    /// @param range_data Ranges to prioritize
+    /// @param log Commit log for ranges
+    /// @param prune_threshold Commit log prune threshold
+    /// @param memory_state Memory state
+    /// @param priority Next priority to assign
+    /// @param trace Address of trace string, or 0
+    void assign_priorities(std::vector<RangeData> &range_data,
+                           CommitLogPtr &log, int64_t prune_threshold,
+                           MemoryState &memory_state, int32_t &priority,
+                           String *trace);
+
+    /// Schedules scored compactions and memory purges.
+    /// Sets the <code>log_space_pinned</code> field of each access group's
+    /// maintenance data so that it shows up in scheduler debug output.
+    /// @param range_data Ranges to prioritize
+    /// @param log Commit log for ranges
+    /// @param prune_threshold Commit log prune threshold
+    /// @param memory_state Memory state
+    /// @param priority Next priority to assign
+    /// @param trace Address of trace string, or 0
+    void schedule_scored_actions(std::vector<RangeData> &range_data,
+                                 CommitLogPtr &log, int64_t prune_threshold,
+                                 MemoryState &memory_state, int32_t &priority,
+                                 String *trace);
+
+    /// Scorer
+    MaintenanceScorerPtr m_scorer;
+
+    /// Garbage percentage that triggers GC compactions
+    int32_t m_garbage_threshold;
+  };
+
+  /// @}
+}
+
+#endif // Hypertable_RangeServer_MaintenancePrioritizerCostBased_h
@@ -31,6 +31,7 @@
 #include <Hypertable/RangeServer/Global.h>
 #include <Hypertable/RangeServer/MaintenanceFlag.h>
 #include <Hypertable/RangeServer/MaintenancePrioritizerLogCleanup.h>
+#include <Hypertable/RangeServer/MaintenanceScorerWeighted.h>
 #include <Hypertable/RangeServer/MaintenanceTaskCompaction.h>
 #include <Hypertable/RangeServer/MaintenanceTaskDeferredInitialization.h>
 #include <Hypertable/RangeServer/MaintenanceTaskMemoryPurge.h>
@@ -70,9 +71,28 @@ MaintenanceScheduler::MaintenanceScheduler(MaintenanceQueuePtr &queue,
     m_initialized(false), m_low_memory_mode(false) {
   m_prioritizer = &m_prioritizer_log_cleanup;
   m_maintenance_interval = get_i32("Hypertable.RangeServer.Maintenance.Interval");
-  m_query_cache_memory = get_i64("Hypertable.RangeServer.QueryCache.MaxMemory");
+  m_query_cache_memory = get_i64("Hypertable.RangeServer.QueryCache.MaxMemory") +
+    get_i64("Hypertable.RangeServer.RangeScanCache.MaxMemory");
   m_low_memory_prioritization = get_bool("Hypertable.RangeServer.Maintenance.LowMemoryPrioritization");
 
+  String prioritizer = get_str("Hypertable.RangeServer.Maintenance.Prioritizer");
+  if (prioritizer == "cost-based") {
+    MaintenanceScorerWeighted::Weights weights;
+    weights.memory = get_f64("Hypertable.RangeServer.Maintenance.Scoring.MemoryWeight");
+    weights.log = get_f64("Hypertable.RangeServer.Maintenance.Scoring.LogWeight");
+    weights.disk = get_f64("Hypertable.RangeServer.Maintenance.Scoring.DiskWeight");
+    weights.read_cost = (double)get_i32("Hypertable.RangeServer.Maintenance.Scoring.ReadCost");
+    weights.cpu = get_f64("Hypertable.RangeServer.Maintenance.Scoring.CpuWeight");
+    weights.min_score = get_f64("Hypertable.RangeServer.Maintenance.Scoring.MinScore");
+    m_prioritizer_cost_based =
+      std::make_unique<MaintenancePrioritizerCostBased>(make_shared<MaintenanceScorerWeighted>(weights));
+    m_prioritizer = m_prioritizer_cost_based.get();
+  }
+  else if (prioritizer != "default")
+    HT_THROWF(Error::CONFIG_BAD_VALUE,
+              "Invalid value for Hypertable.RangeServer.Maintenance.Prioritizer"
+              " (%s), must be 'default' or 'cost-based'", prioritizer.c_str());
+
   // Setup to immediately schedule maintenance
   m_last_low_memory = chrono::steady_clock::now();
   m_last_check = m_last_low_memory;
@@ -187,11 +207,12 @@ void MaintenanceScheduler::schedule() {
   StringSet remove_ok_logs, removed_logs;
   m_live_map->get_ranges(ranges, &remove_ok_logs);
   time_t current_time = time(0);
-  int flags = 0;
+  // Scan statistics decay once per scheduling pass
+  int flags = MaintenanceFlag::ROTATE_SCAN_STATISTICS;
   /// Update current time to compute "low activity" window
   if (Global::low_activity_time.update_current_time()) {
     if (Global::low_activity_time.is_window_enabled())
-      flags = MaintenanceFlag::RECOMPUTE_MERGE_RUN;
+      flags |= MaintenanceFlag::RECOMPUTE_MERGE_RUN;
     HT_INFOF("%s low activity window", Global::low_activity_time.within_window()
              ? "Entering" : "Exiting");
   }
@@ -445,7 +466,8 @@ void MaintenanceScheduler::schedule() {
           for (AccessGroup::MaintenanceData *ag_data=rd.data->agdata; ag_data; ag_data=ag_data->next) {
             if (MaintenanceFlag::minor_compaction(ag_data->maintenance_flags) ||
                 MaintenanceFlag::major_compaction(ag_data->maintenance_flags) ||
-                MaintenanceFlag::gc_compaction(ag_data->maintenance_flags))
+                MaintenanceFlag::gc_compaction(ag_data->maintenance_flags) ||
+                MaintenanceFlag::drop_expired(ag_data->maintenance_flags))
               task->add_subtask(ag_data->ag, ag_data->maintenance_flags);
             else if (MaintenanceFlag::merging_compaction(ag_data->maintenance_flags)) {
               if (merges_created < m_merges_per_interval) {
@@ -520,6 +542,7 @@ void MaintenanceScheduler::write_debug_output(chrono::steady_clock::time_point n
   out.open(output_fname.c_str());
   out << header_str << "\n";
   for (auto &rd : ranges.array) {
+    out << "RANGE " << rd.range->get_name() << "\n";
     out << *rd.data << "\n";
     for (ag_data = rd.data->agdata; ag_data; ag_data = ag_data->next)
       out << *ag_data << "\n";
@@ -528,7 +551,7 @@ void MaintenanceScheduler::write_debug_output(chrono::steady_clock::time_point n
   Global::remove_ok_logs->get(logs);
   out << "RemoveOkLogs:\n";
   for (const auto &log : logs)
-    cout << log << "\n";
+    out << log << "\n";
   out.close();
   FileUtils::unlink(System::install_dir + "/run/debug-scheduler");
 }
@@ -28,6 +28,7 @@
 #ifndef Hypertable_RangeServer_MaintenanceScheduler_h
 #define Hypertable_RangeServer_MaintenanceScheduler_h
 
+#include <Hypertable/RangeServer/MaintenancePrioritizerCostBased.h>
 #include <Hypertable/RangeServer/MaintenancePrioritizerLogCleanup.h>
 #include <Hypertable/RangeServer/MaintenancePrioritizerLowMemory.h>
 #include <Hypertable/RangeServer/LoadStatistics.h>
@@ -61,8 +62,13 @@ namespace Hypertable {
     void exclude(const TableIdentifier &table);
 
     /// Sets <i>low memory</i> maintenance prioritization.
+    /// The cost-based prioritizer, if configured, is used in both modes.
     void set_low_memory_mode(bool on) {
-      if (on) {
+      if (m_prioritizer_cost_based) {
+        if (m_low_memory_mode && !on)
+          m_last_low_memory = chrono::steady_clock::now();
+      }
+      else if (on) {
         if (!m_low_memory_mode && m_low_memory_prioritization)
           m_prioritizer = &m_prioritizer_low_memory;
       }
@@ -108,6 +114,8 @@ namespace Hypertable {
     MaintenancePrioritizer *m_prioritizer;
     MaintenancePrioritizerLogCleanup m_prioritizer_log_cleanup;
     MaintenancePrioritizerLowMemory  m_prioritizer_low_memory;
+    /// Cost-based prioritizer (null unless configured)
+    std::unique_ptr<MaintenancePrioritizerCostBased> m_prioritizer_cost_based;
     std::chrono::steady_clock::time_point m_last_low_memory;
     std::chrono::steady_clock::time_point m_last_check;
     int64_t m_query_cache_memory;
@@ -0,0 +1,216 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Definitions for MaintenanceScorer.
+/// This file contains type definitions for MaintenanceScorer, an abstract base
+/// class for scoring candidate maintenance actions by the ratio of their
+/// benefit to their cost, and MaintenanceCandidate, the candidate action
+/// description that is scored.
+
+#include <Common/Compat.h>
+
+#include "MaintenanceScorer.h"
+
+#include <algorithm>
+#include <set>
+
+using namespace Hypertable;
+using namespace std;
+
+const char *MaintenanceCandidate::action_name(Action action) {
+  switch (action) {
+  case MINOR_COMPACTION:   return "minor";
+  case MERGING_COMPACTION: return "merging";
+  case GC_COMPACTION:      return "gc";
+  case DROP_EXPIRED:       return "drop-expired";
+  case MANUAL_COMPACTION:  return "manual";
+  case MEMORY_PURGE:       return "memory-purge";
+  }
+  return "unknown";
+}
+
+void MaintenanceScorer::estimate(const AccessGroupState &ag,
+                                 const Parameters &params,
+                                 MaintenanceCandidate::Action action,
+                                 MaintenanceCandidate &candidate) {
+  double ratio = (ag.compression_ratio > 0.0) ? ag.compression_ratio : 1.0;
+  int64_t cache_write = (int64_t)(ratio * (double)ag.mem_used);
+  // Only log space pinned in excess of the prune threshold counts as
+  // released, otherwise every non-empty cell cache would look like a win
+  int64_t log_excess = std::max(ag.log_space_pinned - params.prune_threshold,
+                                (int64_t)0);
+  double stores_removed = (ag.file_count > 1) ? (double)(ag.file_count-1) : 0.0;
+  // Scans only read the stores that overlap their key range
+  if (ag.stores_per_scan > 0.0)
+    stores_removed = std::min(stores_removed,
+                              std::max(ag.stores_per_scan - 1.0, 0.0));
+  // Cells skipped (deleted, expired) are read again by every scan until a
+  // compaction removes them
+  double amplification = std::max(ag.read_amplification, 1.0);
+
+  candidate.action = action;
+  candidate.owner = ag.owner;
+  candidate.io_bytes = 0;
+  candidate.cpu_bytes = 0;
+  candidate.memory_freed = 0;
+  candidate.log_bytes_released = 0;
+  candidate.disk_reclaimed = 0;
+  candidate.reads_avoided = 0.0;
+
+  switch (action) {
+
+  case MaintenanceCandidate::MINOR_COMPACTION:
+    candidate.io_bytes = cache_write;
+    candidate.cpu_bytes = ag.mem_used;
+    candidate.memory_freed = ag.mem_allocated;
+    candidate.log_bytes_released = log_excess;
+    // Adds a cell store that subsequent scans have to read
+    candidate.reads_avoided = -ag.scans;
+    break;
+
+  case MaintenanceCandidate::MERGING_COMPACTION:
+    {
+      // The merge run is not part of the maintenance data, assume it covers
+      // half of the stores
+      int64_t run_length = std::max((int64_t)ag.file_count / 2, (int64_t)2);
+      int64_t run_bytes = ag.file_count ?
+        (ag.disk_used * run_length) / ag.file_count : 0;
+      candidate.io_bytes = 2 * run_bytes;
+      candidate.cpu_bytes = (int64_t)((double)run_bytes / ratio);
+      if (ag.end_merge) {
+        candidate.io_bytes += cache_write;
+        candidate.cpu_bytes += ag.mem_used;
+        candidate.memory_freed = ag.mem_allocated;
+        candidate.log_bytes_released = log_excess;
+      }
+      double run_removed = (double)(run_length - 1);
+      if (ag.stores_per_scan > 0.0)
+        run_removed = std::min(run_removed,
+                               std::max(ag.stores_per_scan - 1.0, 0.0));
+      candidate.reads_avoided = ag.scans * run_removed * amplification;
+    }
+    break;
+
+  case MaintenanceCandidate::GC_COMPACTION:
+  case MaintenanceCandidate::MANUAL_COMPACTION:
+    candidate.io_bytes = (2 * ag.disk_used) + cache_write;
+    candidate.cpu_bytes = (int64_t)((double)ag.disk_used / ratio) + ag.mem_used;
+    candidate.memory_freed = ag.mem_allocated;
+    candidate.log_bytes_released = log_excess;
+    if (action == MaintenanceCandidate::GC_COMPACTION)
+      candidate.disk_reclaimed = (ag.disk_used * params.garbage_threshold) / 100;
+    candidate.reads_avoided = ag.scans * stores_removed * amplification;
+    break;
+
+  case MaintenanceCandidate::DROP_EXPIRED:
+    // Expired stores are dropped without being read or rewritten
+    if (ag.file_count)
+      candidate.disk_reclaimed =
+        (ag.disk_used * ag.expired_file_count) / ag.file_count;
+    candidate.reads_avoided = ag.scans * (double)ag.expired_file_count;
+    break;
+
+  case MaintenanceCandidate::MEMORY_PURGE:
+    // Purged indexes are re-read from disk on next access
+    candidate.io_bytes = ag.index_memory;
+    candidate.memory_freed = ag.shadow_cache_memory + ag.index_memory;
+    break;
+  }
+}
+
+void MaintenanceScorer::generate(const AccessGroupState &ag,
+                                 const Parameters &params,
+                                 std::vector<MaintenanceCandidate> &candidates) {
+  MaintenanceCandidate candidate;
+  bool have_compaction = true;
+
+  candidate.required = true;
+
+  if (ag.compaction_type_needed)
+    estimate(ag, params, MaintenanceCandidate::MANUAL_COMPACTION, candidate);
+  else if (ag.expired_file_count)
+    estimate(ag, params, MaintenanceCandidate::DROP_EXPIRED, candidate);
+  else if (ag.gc_needed)
+    estimate(ag, params, MaintenanceCandidate::GC_COMPACTION, candidate);
+  else if (ag.mem_used > 0 &&
+           (ag.log_space_pinned > params.prune_threshold ||
+            (!ag.in_memory && ag.mem_used > params.access_group_max_mem)))
+    estimate(ag, params, MaintenanceCandidate::MINOR_COMPACTION, candidate);
+  else if (ag.needs_merging)
+    estimate(ag, params, MaintenanceCandidate::MERGING_COMPACTION, candidate);
+  else if (ag.mem_used > 0 && !ag.in_memory) {
+    estimate(ag, params, MaintenanceCandidate::MINOR_COMPACTION, candidate);
+    candidate.required = false;
+  }
+  else
+    have_compaction = false;
+
+  if (have_compaction)
+    candidates.push_back(candidate);
+
+  if (ag.shadow_cache_memory > 0 || ag.index_memory > 0) {
+    estimate(ag, params, MaintenanceCandidate::MEMORY_PURGE, candidate);
+    candidate.required = false;
+    candidates.push_back(candidate);
+  }
+}
+
+namespace {
+  struct CandidateScoreDescending {
+    bool operator()(const MaintenanceCandidate &x,
+                    const MaintenanceCandidate &y) const {
+      return x.score > y.score;
+    }
+  };
+}
+
+void MaintenanceScorer::schedule(std::vector<MaintenanceCandidate> &candidates,
+                                 int64_t &memory_needed) {
+  std::set<const void *> required_owners;
+  std::set<const void *> selected_owners;
+
+  for (auto &candidate : candidates) {
+    candidate.score = score(candidate, memory_needed);
+    candidate.selected = false;
+    if (candidate.required)
+      required_owners.insert(candidate.owner);
+  }
+
+  stable_sort(candidates.begin(), candidates.end(), CandidateScoreDescending());
+
+  for (auto &candidate : candidates) {
+    if (!candidate.required) {
+      if (required_owners.count(candidate.owner) ||
+          selected_owners.count(candidate.owner))
+        continue;
+      candidate.score = score(candidate, memory_needed);
+      if (candidate.score <= min_score())
+        continue;
+    }
+    candidate.selected = true;
+    selected_owners.insert(candidate.owner);
+    if (memory_needed > 0)
+      memory_needed = std::max(memory_needed - candidate.memory_freed,
+                               (int64_t)0);
+  }
+}
@@ -0,0 +1,233 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Declarations for MaintenanceScorer.
+/// This file contains type declarations for MaintenanceScorer, an abstract base
+/// class for scoring candidate maintenance actions by the ratio of their
+/// benefit to their cost, and MaintenanceCandidate, the candidate action
+/// description that is scored.
+
+#ifndef Hypertable_RangeServer_MaintenanceScorer_h
+#define Hypertable_RangeServer_MaintenanceScorer_h
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Hypertable {
+
+  /// @addtogroup RangeServer
+  /// @{
+
+  /// Candidate maintenance action.
+  /// Describes a single action that could be carried out on an access group
+  /// along with estimates of what it costs and what it buys.  Candidates are
+  /// generated by MaintenanceScorer::generate() and ordered by
+  /// MaintenanceScorer::schedule().
+  class MaintenanceCandidate {
+  public:
+
+    /// Action type.
+    enum Action {
+      /// Minor compaction of the cell cache
+      MINOR_COMPACTION = 0,
+      /// Merging compaction of a run of cell stores
+      MERGING_COMPACTION = 1,
+      /// Garbage collection (major) compaction
+      GC_COMPACTION = 2,
+      /// Drop fully expired cell stores
+      DROP_EXPIRED = 3,
+      /// Manually requested compaction
+      MANUAL_COMPACTION = 4,
+      /// Purge of shadow caches and cell store indexes
+      MEMORY_PURGE = 5
+    };
+
+    /// Returns printable name of an action.
+    /// @param action Action type
+    /// @return Printable name of <code>action</code>
+    static const char *action_name(Action action);
+
+    /// Action type
+    Action action {};
+
+    /// <i>true</i> if the action is needed regardless of score (log pruning,
+    /// manual, garbage collection, ...), <i>false</i> if it is opportunistic
+    bool required {};
+
+    /// Estimated bytes of disk I/O (read plus written)
+    int64_t io_bytes {};
+
+    /// Estimated bytes of data passed through the merge and compression code
+    int64_t cpu_bytes {};
+
+    /// Estimated bytes of memory freed
+    int64_t memory_freed {};
+
+    /// Estimated bytes of commit log that become eligible for removal
+    int64_t log_bytes_released {};
+
+    /// Estimated disk space reclaimed
+    int64_t disk_reclaimed {};
+
+    /// Estimated cell store reads avoided per maintenance interval
+    double reads_avoided {};
+
+    /// Score assigned by MaintenanceScorer::schedule()
+    double score {};
+
+    /// Set by MaintenanceScorer::schedule() if action was selected
+    bool selected {};
+
+    /// Access group that the action applies to.  At most one candidate is
+    /// selected per owner.
+    const void *owner {};
+  };
+
+  /// Abstract base class for maintenance action scorers.
+  /// A scorer assigns a score to candidate maintenance actions.  Candidates
+  /// are selected in descending score order: required candidates are always
+  /// selected, optional ones only if their score exceeds min_score().
+  /// The memory term of a candidate's benefit only counts while there is
+  /// still memory to be freed, so memory purges and memory-driven minor
+  /// compactions stop being selected once the memory need is satisfied.
+  /// Scorers are independent of live Range and AccessGroup objects so that
+  /// they can be driven by the offline simulation tool
+  /// (<code>ht_maintenance_sim</code>).
+  class MaintenanceScorer {
+  public:
+
+    /// Access group state from which candidates are generated.
+    struct AccessGroupState {
+      /// Access group identity, copied into MaintenanceCandidate::owner
+      const void *owner {};
+      /// Cell cache memory used
+      int64_t mem_used {};
+      /// Cell cache memory allocated
+      int64_t mem_allocated {};
+      /// Disk used by cell stores
+      int64_t disk_used {};
+      /// Commit log bytes pinned by cell cache.  Only the amount in excess of
+      /// Parameters::prune_threshold counts as released by a compaction.
+      int64_t log_space_pinned {};
+      /// Memory held by shadow caches
+      int64_t shadow_cache_memory {};
+      /// Memory held by cell store block indexes and bloom filters
+      int64_t index_memory {};
+      /// Scans per maintenance interval (decayed average)
+      double scans {};
+      /// Average number of cell stores merged per scan (0 if unknown)
+      double stores_per_scan {};
+      /// Cells scanned per cell returned (0 if unknown)
+      double read_amplification {};
+      /// Number of cell stores
+      uint32_t file_count {};
+      /// Number of cell stores that have fully expired
+      uint32_t expired_file_count {};
+      /// Ratio of compressed to uncompressed size
+      float compression_ratio {1.0};
+      /// Manually requested compaction type (0 if none)
+      int32_t compaction_type_needed {};
+      /// Access group is in memory
+      bool in_memory {};
+      /// Garbage collection needed
+      bool gc_needed {};
+      /// Merging compaction needed
+      bool needs_merging {};
+      /// Merge run includes the newest cell store (cell cache is merged too)
+      bool end_merge {};
+    };
+
+    /// Generation parameters.
+    struct Parameters {
+      /// Commit log prune threshold
+      int64_t prune_threshold {};
+      /// Cell cache size above which a minor compaction is required
+      int64_t access_group_max_mem {};
+      /// Garbage percentage that triggers GC compactions
+      int32_t garbage_threshold {20};
+    };
+
+    /// Destructor.
+    virtual ~MaintenanceScorer() { }
+
+    /// Generates candidate actions for an access group.
+    /// At most one compaction candidate is generated, chosen with the same
+    /// precedence the fixed prioritizers use (manual, expired, GC, log prune
+    /// or oversized cell cache, merging).  If no compaction is required, an
+    /// optional minor compaction is generated for a non-empty cell cache.  An
+    /// optional memory purge is generated if the access group holds shadow
+    /// cache or index memory.
+    /// @param ag Access group state
+    /// @param params Generation parameters
+    /// @param candidates Vector to which candidates are appended
+    static void generate(const AccessGroupState &ag, const Parameters &params,
+                         std::vector<MaintenanceCandidate> &candidates);
+
+    /// Estimates cost and benefit of an action.
+    /// Fills in the action, owner, cost and benefit fields of
+    /// <code>candidate</code>; the <code>required</code>, <code>score</code>
+    /// and <code>selected</code> fields are left untouched.
+    /// @param ag Access group state
+    /// @param params Generation parameters
+    /// @param action Action to estimate
+    /// @param candidate Candidate to fill in
+    static void estimate(const AccessGroupState &ag, const Parameters &params,
+                         MaintenanceCandidate::Action action,
+                         MaintenanceCandidate &candidate);
+
+    /// Scores a candidate.
+    /// @param candidate Candidate to score
+    /// @param memory_needed Bytes of memory still to be freed
+    /// @return Score of <code>candidate</code>, higher is better
+    virtual double score(const MaintenanceCandidate &candidate,
+                         int64_t memory_needed) = 0;
+
+    /// Returns minimum score for optional candidates.
+    /// @return Minimum score for optional candidates
+    virtual double min_score() const = 0;
+
+    /// Returns scorer name.
+    /// @return Scorer name
+    virtual const char *name() const = 0;
+
+    /// Scores, orders, and selects candidates.
+    /// Candidates are scored against the initial memory need and stably
+    /// sorted by descending score.  They are then visited in order and
+    /// rescored against the remaining memory need; a candidate is selected if
+    /// no other candidate has been selected for its owner and it is either
+    /// required or scores above min_score().  The memory freed by each
+    /// selected candidate is subtracted from <code>memory_needed</code>.
+    /// @param candidates Candidates to schedule, reordered on return
+    /// @param memory_needed Reference to bytes of memory to be freed
+    void schedule(std::vector<MaintenanceCandidate> &candidates,
+                  int64_t &memory_needed);
+  };
+
+  /// Smart pointer to MaintenanceScorer
+  typedef std::shared_ptr<MaintenanceScorer> MaintenanceScorerPtr;
+
+  /// @}
+}
+
+#endif // Hypertable_RangeServer_MaintenanceScorer_h
@@ -0,0 +1,59 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Definitions for MaintenanceScorerLegacy.
+/// This file contains type definitions for MaintenanceScorerLegacy, a
+/// maintenance scorer that approximates the fixed ordering of
+/// MaintenancePrioritizerLogCleanup and MaintenancePrioritizerLowMemory.
+
+#include <Common/Compat.h>
+
+#include "MaintenanceScorerLegacy.h"
+
+#include <Common/Property.h>
+
+using namespace Hypertable;
+using namespace std;
+
+double MaintenanceScorerLegacy::score(const MaintenanceCandidate &candidate,
+                                      int64_t memory_needed) {
+
+  if (candidate.required) {
+    if (candidate.action == MaintenanceCandidate::MINOR_COMPACTION &&
+        candidate.log_bytes_released > 0)
+      return 4.0;
+    return 3.0;
+  }
+
+  if (memory_needed <= 0 || candidate.memory_freed <= 0)
+    return 0.0;
+
+  // Larger first within tier
+  double fraction = (double)candidate.memory_freed /
+    (double)(candidate.memory_freed + MiB);
+
+  // Shadow caches are purged before cell caches are compacted
+  if (candidate.action == MaintenanceCandidate::MEMORY_PURGE)
+    return 2.0 + fraction;
+  return 1.0 + fraction;
+}
@@ -0,0 +1,59 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Declarations for MaintenanceScorerLegacy.
+/// This file contains type declarations for MaintenanceScorerLegacy, a
+/// maintenance scorer that approximates the fixed ordering of
+/// MaintenancePrioritizerLogCleanup and MaintenancePrioritizerLowMemory.
+
+#ifndef Hypertable_RangeServer_MaintenanceScorerLegacy_h
+#define Hypertable_RangeServer_MaintenanceScorerLegacy_h
+
+#include <Hypertable/RangeServer/MaintenanceScorer.h>
+
+namespace Hypertable {
+
+  /// @addtogroup RangeServer
+  /// @{
+
+  /// Maintenance scorer approximating the fixed prioritizers.
+  /// Candidates are placed in tiers that mirror the order in which the fixed
+  /// prioritizers schedule work: log pruning compactions first, then the
+  /// other required compactions in input order, then (only while memory is
+  /// needed) memory purges and minor compactions, largest first.  Costs are
+  /// ignored.  It serves as the baseline in offline simulations.
+  class MaintenanceScorerLegacy : public MaintenanceScorer {
+  public:
+
+    double score(const MaintenanceCandidate &candidate,
+                 int64_t memory_needed) override;
+
+    double min_score() const override { return 0.0; }
+
+    const char *name() const override { return "legacy"; }
+  };
+
+  /// @}
+}
+
+#endif // Hypertable_RangeServer_MaintenanceScorerLegacy_h
@@ -0,0 +1,49 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Definitions for MaintenanceScorerWeighted.
+/// This file contains type definitions for MaintenanceScorerWeighted, a
+/// maintenance scorer that divides a weighted sum of benefits by a weighted sum
+/// of costs.
+
+#include <Common/Compat.h>
+
+#include "MaintenanceScorerWeighted.h"
+
+#include <algorithm>
+
+using namespace Hypertable;
+using namespace std;
+
+double MaintenanceScorerWeighted::score(const MaintenanceCandidate &candidate,
+                                        int64_t memory_needed) {
+  double benefit = m_weights.log * (double)candidate.log_bytes_released +
+    m_weights.disk * (double)candidate.disk_reclaimed +
+    m_weights.read_cost * candidate.reads_avoided;
+  if (memory_needed > 0)
+    benefit += m_weights.memory *
+      (double)std::min(candidate.memory_freed, memory_needed);
+  double cost = (double)candidate.io_bytes +
+    m_weights.cpu * (double)candidate.cpu_bytes;
+  return benefit / std::max(cost, 1.0);
+}
@@ -0,0 +1,89 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Declarations for MaintenanceScorerWeighted.
+/// This file contains type declarations for MaintenanceScorerWeighted, a
+/// maintenance scorer that divides a weighted sum of benefits by a weighted sum
+/// of costs.
+
+#ifndef Hypertable_RangeServer_MaintenanceScorerWeighted_h
+#define Hypertable_RangeServer_MaintenanceScorerWeighted_h
+
+#include <Hypertable/RangeServer/MaintenanceScorer.h>
+
+namespace Hypertable {
+
+  /// @addtogroup RangeServer
+  /// @{
+
+  /// Benefit/cost maintenance scorer.
+  /// Benefits and costs are both expressed in bytes.  The score of a
+  /// candidate is:
+  /// <pre>
+  ///   benefit = memory * min(memory_freed, memory_needed)
+  ///           + log * log_bytes_released
+  ///           + disk * disk_reclaimed
+  ///           + read_cost * reads_avoided
+  ///   cost    = max(io_bytes + cpu * cpu_bytes, 1)
+  ///   score   = benefit / cost
+  /// </pre>
+  class MaintenanceScorerWeighted : public MaintenanceScorer {
+  public:
+
+    /// Scoring weights.
+    struct Weights {
+      /// Weight of memory freed
+      double memory {1.0};
+      /// Weight of commit log bytes released
+      double log {1.0};
+      /// Weight of disk space reclaimed
+      double disk {0.5};
+      /// Bytes of I/O charged per cell store read
+      double read_cost {65536.0};
+      /// Weight of bytes passed through merge and compression code
+      double cpu {0.25};
+      /// Minimum score for optional candidates
+      double min_score {0.0};
+    };
+
+    /// Constructor.
+    /// @param weights Scoring weights
+    MaintenanceScorerWeighted(const Weights &weights) : m_weights(weights) { }
+
+    double score(const MaintenanceCandidate &candidate,
+                 int64_t memory_needed) override;
+
+    double min_score() const override { return m_weights.min_score; }
+
+    const char *name() const override { return "weighted"; }
+
+  private:
+
+    /// Scoring weights
+    Weights m_weights;
+  };
+
+  /// @}
+}
+
+#endif // Hypertable_RangeServer_MaintenanceScorerWeighted_h
@@ -0,0 +1,193 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Definitions for MaintenanceSnapshot.
+/// This file contains type definitions for MaintenanceSnapshot, a class for
+/// loading the maintenance scheduler debug output written by
+/// MaintenanceScheduler::write_debug_output().
+
+#include <Common/Compat.h>
+
+#include "MaintenanceSnapshot.h"
+
+#include <cstdlib>
+#include <cstring>
+
+using namespace Hypertable;
+using namespace std;
+
+namespace {
+
+  int64_t to_i64(const string &value) {
+    return strtoll(value.c_str(), 0, 0);
+  }
+
+  bool to_bool(const string &value) {
+    return value == "true";
+  }
+
+  void set_range_field(MaintenanceSnapshot::RangeRecord &range,
+                       const string &key, const string &value) {
+    if (key == "table_id")
+      range.table_id = value;
+    else if (key == "scans")
+      range.scans = to_i64(value);
+    else if (key == "priority")
+      range.priority = (int32_t)to_i64(value);
+    else if (key == "maintenance_flags")
+      range.maintenance_flags = (int32_t)to_i64(value);
+    else if (key == "compaction_type_needed")
+      range.compaction_type_needed = (int32_t)to_i64(value);
+    else if (key == "busy")
+      range.busy = to_bool(value);
+    else if (key == "is_metadata")
+      range.is_metadata = to_bool(value);
+    else if (key == "is_system")
+      range.is_system = to_bool(value);
+  }
+
+  void set_ag_field(MaintenanceSnapshot::AccessGroupRecord &ag,
+                    const string &key, const string &value) {
+    MaintenanceScorer::AccessGroupState &state = ag.state;
+    if (key == "mem_used")
+      state.mem_used = to_i64(value);
+    else if (key == "mem_allocated")
+      state.mem_allocated = to_i64(value);
+    else if (key == "disk_used")
+      state.disk_used = to_i64(value);
+    else if (key == "log_space_pinned")
+      state.log_space_pinned = to_i64(value);
+    else if (key == "file_count")
+      state.file_count = (uint32_t)to_i64(value);
+    else if (key == "expired_file_count")
+      state.expired_file_count = (uint32_t)to_i64(value);
+    else if (key == "compression_ratio")
+      state.compression_ratio = (float)strtod(value.c_str(), 0);
+    else if (key == "block_index_memory" || key == "bloom_filter_memory")
+      state.index_memory += to_i64(value);
+    else if (key == "shadow_cache_memory")
+      state.shadow_cache_memory = to_i64(value);
+    else if (key == "in_memory")
+      state.in_memory = to_bool(value);
+    else if (key == "gc_needed")
+      state.gc_needed = to_bool(value);
+    else if (key == "needs_merging")
+      state.needs_merging = to_bool(value);
+    else if (key == "end_merge")
+      state.end_merge = to_bool(value);
+    else if (key == "maintenance_flags")
+      ag.maintenance_flags = (int32_t)to_i64(value);
+    else if (key == "scans") {
+      state.scans = strtod(value.c_str(), 0);
+      ag.has_scan_statistics = true;
+    }
+    else if (key == "stores_per_scan")
+      state.stores_per_scan = strtod(value.c_str(), 0);
+    else if (key == "read_amplification")
+      state.read_amplification = strtod(value.c_str(), 0);
+  }
+
+}
+
+void MaintenanceSnapshot::load(std::istream &in) {
+  string line, key, value;
+  bool in_header = true;
+  bool in_access_group = false;
+  size_t pos;
+
+  ranges.clear();
+  memory_needed = 0;
+  prune_threshold = 0;
+  low_memory = false;
+
+  while (getline(in, line)) {
+
+    if (line.compare(0, 6, "RANGE ") == 0) {
+      ranges.push_back(RangeRecord());
+      ranges.back().name = line.substr(6);
+      in_header = in_access_group = false;
+      continue;
+    }
+
+    if (line.compare(0, 13, "ACCESS GROUP ") == 0) {
+      if (ranges.empty())
+        ranges.push_back(RangeRecord());
+      ranges.back().access_groups.push_back(AccessGroupRecord());
+      ranges.back().access_groups.back().name = line.substr(13);
+      in_header = false;
+      in_access_group = true;
+      continue;
+    }
+
+    if (line.compare(0, 13, "RemoveOkLogs:") == 0)
+      break;
+
+    if (in_header) {
+      // Start of range record in snapshot without range names
+      if (line.compare(0, 9, "table_id=") == 0)
+        in_header = false;
+      else {
+        if ((pos = line.find('\t')) == string::npos)
+          continue;
+        key = line.substr(0, pos);
+        value = line.substr(pos+1);
+        if (key == "low_memory")
+          low_memory = to_bool(value);
+        else if (key == "memory_state.needed")
+          memory_needed = to_i64(value);
+        else if (key.length() > 15 &&
+                 key.compare(key.length()-15, 15, "prune threshold") == 0)
+          prune_threshold = to_i64(value);
+        continue;
+      }
+    }
+
+    if ((pos = line.find('=')) == string::npos)
+      continue;
+    key = line.substr(0, pos);
+    value = line.substr(pos+1);
+
+    if (key == "table_id") {
+      // Snapshots without range names start each range with its table ID
+      if (ranges.empty() || !ranges.back().table_id.empty() ||
+          in_access_group)
+        ranges.push_back(RangeRecord());
+      in_access_group = false;
+    }
+
+    if (in_access_group)
+      set_ag_field(ranges.back().access_groups.back(), key, value);
+    else if (!ranges.empty())
+      set_range_field(ranges.back(), key, value);
+  }
+
+  for (auto &range : ranges) {
+    for (auto &ag : range.access_groups) {
+      ag.state.owner = &ag;
+      // Older snapshots only carry the range scan counter
+      if (!ag.has_scan_statistics)
+        ag.state.scans = (double)range.scans;
+      ag.state.compaction_type_needed = range.compaction_type_needed;
+    }
+  }
+}
@@ -0,0 +1,116 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Declarations for MaintenanceSnapshot.
+/// This file contains type declarations for MaintenanceSnapshot, a class for
+/// loading the maintenance scheduler debug output written by
+/// MaintenanceScheduler::write_debug_output().
+
+#ifndef Hypertable_RangeServer_MaintenanceSnapshot_h
+#define Hypertable_RangeServer_MaintenanceSnapshot_h
+
+#include <Hypertable/RangeServer/MaintenanceScorer.h>
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace Hypertable {
+
+  /// @addtogroup RangeServer
+  /// @{
+
+  /// Maintenance scheduler snapshot.
+  /// When the <code>run/debug-scheduler</code> signal file exists, the
+  /// maintenance scheduler writes the maintenance data of every range and
+  /// access group, along with the decisions it made, to
+  /// <code>run/scheduler.output</code>.  This class loads that file so that
+  /// the scheduling round can be replayed offline with different scorers.
+  /// Unknown fields are ignored so that snapshots written by older and newer
+  /// servers can be loaded.
+  class MaintenanceSnapshot {
+  public:
+
+    /// Access group record.
+    struct AccessGroupRecord {
+      /// Full access group name
+      std::string name;
+      /// State used to generate candidates
+      MaintenanceScorer::AccessGroupState state;
+      /// Maintenance flags assigned by the server
+      int32_t maintenance_flags {};
+      /// Snapshot includes per-access-group scan statistics
+      bool has_scan_statistics {};
+    };
+
+    /// Range record.
+    struct RangeRecord {
+      /// Range name (empty for snapshots that predate range names)
+      std::string name;
+      /// Table ID
+      std::string table_id;
+      /// Scans in last maintenance interval
+      int64_t scans {};
+      /// Priority assigned by the server (0 if none)
+      int32_t priority {};
+      /// Maintenance flags assigned by the server
+      int32_t maintenance_flags {};
+      /// Manually requested compaction type
+      int32_t compaction_type_needed {};
+      /// Range was busy
+      bool busy {};
+      /// Range belongs to METADATA table
+      bool is_metadata {};
+      /// Range belongs to a system table
+      bool is_system {};
+      /// Access group records
+      std::vector<AccessGroupRecord> access_groups;
+    };
+
+    /// Loads snapshot.
+    /// Parses the scheduler header values (memory need and prune threshold)
+    /// followed by the range and access group records.  The
+    /// MaintenanceScorer::AccessGroupState::owner field of each access group
+    /// record is set to the address of the record, and the range scan count
+    /// and manual compaction type are copied into it.
+    /// @param in Input stream
+    void load(std::istream &in);
+
+    /// Range records in the order they were written
+    std::vector<RangeRecord> ranges;
+
+    /// Memory that needed to be freed
+    int64_t memory_needed {};
+
+    /// Commit log prune threshold for user ranges (0 if not recorded)
+    int64_t prune_threshold {};
+
+    /// Scheduler was in low memory mode
+    bool low_memory {};
+  };
+
+  /// @}
+}
+
+#endif // Hypertable_RangeServer_MaintenanceSnapshot_h
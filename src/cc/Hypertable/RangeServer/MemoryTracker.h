@@ -29,6 +29,7 @@
 
 #include <Hypertable/RangeServer/FileBlockCache.h>
 #include <Hypertable/RangeServer/QueryCache.h>
+#include <Hypertable/RangeServer/RangeScanCache.h>
 
 #include <memory>
 #include <mutex>
@@ -45,8 +46,11 @@ namespace Hypertable {
     /// Constructor.
     /// @param block_cache Pointer to block cache
     /// @param query_cache Pointer to query cache
-    MemoryTracker(FileBlockCache *block_cache, QueryCachePtr query_cache) 
-      : m_block_cache(block_cache), m_query_cache(query_cache) { }
+    /// @param range_scan_cache Pointer to range scan cache
+    MemoryTracker(FileBlockCache *block_cache, QueryCachePtr query_cache,
+                  RangeScanCachePtr range_scan_cache=RangeScanCachePtr())
+      : m_block_cache(block_cache), m_query_cache(query_cache),
+        m_range_scan_cache(range_scan_cache) { }
 
     /// Add to memory used.
     /// @param amount Amount of memory to add
@@ -64,13 +68,14 @@ namespace Hypertable {
 
     /// Return total range server memory used.
     /// This member function returns the total amount of memory used, computed
-    /// as #m_memory_used plus block cache memory used plus query cache memory
-    /// used.
+    /// as #m_memory_used plus block cache memory used plus query cache and
+    /// range scan cache memory used.
     /// @return Total range server memory used
     int64_t balance() {
       std::lock_guard<std::mutex> lock(m_mutex);
       return m_memory_used + (m_block_cache ? m_block_cache->memory_used() : 0) +
-        (m_query_cache ? m_query_cache->memory_used() : 0);
+        (m_query_cache ? m_query_cache->memory_used() : 0) +
+        (m_range_scan_cache ? m_range_scan_cache->memory_used() : 0);
     }
 
   private:
@@ -86,6 +91,9 @@ namespace Hypertable {
 
     /// Pointer to query cache
     QueryCachePtr m_query_cache;
+
+    /// Pointer to range scan cache
+    RangeScanCachePtr m_range_scan_cache;
   };
 
   /// @}
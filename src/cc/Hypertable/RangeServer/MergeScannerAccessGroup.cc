@@ -33,6 +33,8 @@
 
 #include "Common/Logger.h"
 
+#include <algorithm>
+
 using namespace Hypertable;
 
 
@@ -41,7 +43,8 @@ MergeScannerAccessGroup::MergeScannerAccessGroup(String &table_name,
                                                  uint32_t flags)
   : m_flags(flags), m_return_deletes(flags & RETURN_DELETES),
     m_accumulate_counters(flags & ACCUMULATE_COUNTERS), m_prev_cf(-1),
-    m_counted_value(12), m_scan_context(scan_ctx)
+    m_counted_value(12), m_single_row(scan_ctx->single_row),
+    m_scan_context(scan_ctx)
 { 
   m_start_timestamp = scan_ctx->time_interval.first;
   m_end_timestamp = scan_ctx->time_interval.second;
@@ -76,8 +79,12 @@ MergeScannerAccessGroup::MergeScannerAccessGroup(String &table_name,
 
 MergeScannerAccessGroup::~MergeScannerAccessGroup() {
   try {
-    if (m_release_callback)
+    if (m_release_callback) {
+      if ((m_flags & IS_COMPACTION) == 0)
+        m_release_callback.record_scan(m_cells_input, m_cells_output,
+                                       m_bytes_output, m_single_row);
       m_release_callback();
+    }
   }
   catch (Hypertable::Exception &e) {
     HT_ERROR_OUT << "Problem destroying MergeScannerAccessGroup : " << e
@@ -193,7 +200,7 @@ void MergeScannerAccessGroup::forward() {
       }
       else if (sstate.key.flag == FLAG_DELETE_CELL_VERSION) {
         if (matches_deleted_cell_version(sstate.key)) {
-          m_deleted_cell_version_set.insert(sstate.key.timestamp);
+          m_deleted_cell_version_set.push_back(sstate.key.timestamp);
         }
         else
           update_deleted_cell_version(sstate.key);
@@ -210,7 +217,9 @@ void MergeScannerAccessGroup::forward() {
               m_deleted_cell_version.clear();
               m_deleted_cell_version_set.clear();
             }
-            else if (m_deleted_cell_version_set.find(sstate.key.timestamp) !=
+            else if (std::find(m_deleted_cell_version_set.begin(),
+                               m_deleted_cell_version_set.end(),
+                               sstate.key.timestamp) !=
                      m_deleted_cell_version_set.end()) {
               // apply previously seen delete cell version to this cell
               if (m_index_updater)
@@ -264,7 +273,8 @@ void MergeScannerAccessGroup::forward() {
                 (const uint8_t *)sstate.key.row + 1;
 
         if (m_prev_key.fill()==0) {
-          m_prev_key.set(latest_key, latest_key_len);
+          m_prev_key.clear();
+          m_prev_key.add(latest_key, latest_key_len);
           m_prev_cf = sstate.key.column_family_code;
           m_revs_count=0;
           m_revs_limit = cp.max_versions;
@@ -272,7 +282,8 @@ void MergeScannerAccessGroup::forward() {
         else if (m_prev_key.fill() != latest_key_len ||
             memcmp(latest_key, m_prev_key.base, latest_key_len)) {
 
-          m_prev_key.set(latest_key, latest_key_len);
+          m_prev_key.clear();
+          m_prev_key.add(latest_key, latest_key_len);
           m_prev_cf = sstate.key.column_family_code;
           m_revs_count=0;
           m_revs_limit = cp.max_versions;
@@ -291,14 +302,18 @@ void MergeScannerAccessGroup::forward() {
           if (cmp > 0)
             continue;
         }
-        // cell predicate match
+        // cell predicate match (the value is absent in keys only scans
+        // without value predicates)
 
-        const uint8_t *value;
-        size_t value_len = sstate.value.decode_length(&value);
+        const uint8_t *value = 0;
+        size_t value_len =
+          sstate.value.ptr ? sstate.value.decode_length(&value) : 0;
         if (!cp.matches(sstate.key.column_qualifier,
                         (size_t)sstate.key.column_qualifier_len,
-                        (const char *)value, value_len))
+                        (const char *)value, value_len)) {
+          m_cells_filtered++;
           continue;
+        }
         // row regexp
         if (m_scan_context->row_regexp) {
           bool cached, match;
@@ -308,16 +323,20 @@ void MergeScannerAccessGroup::forward() {
                         *(m_scan_context->row_regexp));
             m_regexp_cache.set_rowkey(sstate.key.row, match);
           }
-          if (!match)
+          if (!match) {
+            m_cells_filtered++;
             continue;
+          }
         }
          // filter but value regexp last since its probly the most expensive
         if (m_scan_context->value_regexp && !counter) {
           const uint8_t *dptr;
           if (!RE2::PartialMatch(re2::StringPiece(sstate.value.str(),
                             sstate.value.decode_length(&dptr)), 
-                            *(m_scan_context->value_regexp)))
+                            *(m_scan_context->value_regexp))) {
+            m_cells_filtered++;
             continue;
+          }
         }
         break;
       }
@@ -379,6 +398,14 @@ bool MergeScannerAccessGroup::get(Key &key, ByteString &value) {
 
 
 
+int64_t MergeScannerAccessGroup::get_pushdown_filtered_cells() {
+  int64_t cells = 0;
+  for (size_t i=0; i<m_scanners.size(); i++)
+    cells += m_scanners[i]->get_filtered_cells();
+  return cells;
+}
+
+
 int64_t MergeScannerAccessGroup::get_disk_read() {
   int64_t amount = m_disk_read;
   for (size_t i=0; i<m_scanners.size(); i++)
@@ -485,14 +512,16 @@ void MergeScannerAccessGroup::initialize() {
                 (const uint8_t *)sstate.key.row + 1;
 
       if (m_prev_key.fill()==0) {
-        m_prev_key.set(latest_key, latest_key_len);
+        m_prev_key.clear();
+        m_prev_key.add(latest_key, latest_key_len);
         m_prev_cf = sstate.key.column_family_code;
         m_revs_count=0;
         m_revs_limit = cp.max_versions;
       }
       else if (m_prev_key.fill() != latest_key_len ||
           memcmp(latest_key, m_prev_key.base, latest_key_len)) {
-        m_prev_key.set(latest_key, latest_key_len);
+        m_prev_key.clear();
+        m_prev_key.add(latest_key, latest_key_len);
         m_prev_cf = sstate.key.column_family_code;
         m_revs_count=0;
         m_revs_limit = cp.max_versions;
@@ -523,10 +552,12 @@ void MergeScannerAccessGroup::initialize() {
         }
       }
       // value match (exact match or prefix match)
-      value_len = sstate.value.decode_length(&value);
+      value = 0;
+      value_len = sstate.value.ptr ? sstate.value.decode_length(&value) : 0;
       if (!cp.matches(sstate.key.column_qualifier,
                       (size_t)sstate.key.column_qualifier_len,
                       (const char *)value, value_len)) {
+        m_cells_filtered++;
         m_queue.pop();
         sstate.scanner->forward();
         if (sstate.scanner->get(sstate.key, sstate.value))
@@ -537,6 +568,7 @@ void MergeScannerAccessGroup::initialize() {
       if (m_scan_context->row_regexp)
         if (!RE2::PartialMatch(sstate.key.row, 
             *(m_scan_context->row_regexp))) {
+          m_cells_filtered++;
           m_queue.pop();
           sstate.scanner->forward();
           if (sstate.scanner->get(sstate.key, sstate.value))
@@ -548,6 +580,7 @@ void MergeScannerAccessGroup::initialize() {
         value_len = sstate.value.decode_length(&value);
         if (!RE2::PartialMatch(re2::StringPiece((const char *)value, value_len),
                                *(m_scan_context->value_regexp))) {
+          m_cells_filtered++;
           m_queue.pop();
           sstate.scanner->forward();
           if (sstate.scanner->get(sstate.key, sstate.value))
@@ -557,7 +590,8 @@ void MergeScannerAccessGroup::initialize() {
       }
 
       m_delete_present = false;
-      m_prev_key.set(sstate.key.row, sstate.key.flag_ptr
+      m_prev_key.clear();
+      m_prev_key.add(sstate.key.row, sstate.key.flag_ptr
                      - (const uint8_t *)sstate.key.row + 1);
       m_prev_cf = sstate.key.column_family_code;
       m_revs_limit = cp.max_versions;
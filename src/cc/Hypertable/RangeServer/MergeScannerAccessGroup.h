@@ -152,6 +152,16 @@ namespace Hypertable {
     int64_t get_input_bytes() { return m_bytes_input; }
     int64_t get_output_bytes() { return m_bytes_output; }
 
+    /// Returns number of cells dropped by the cell store and cell cache
+    /// scanners before reaching the merge.
+    /// @return Number of cells filtered by predicate pushdown
+    int64_t get_pushdown_filtered_cells();
+
+    /// Returns number of cells that reached the merge and were then dropped
+    /// by the column predicates, row regexp or value regexp.
+    /// @return Number of cells filtered during the merge
+    int64_t get_merge_filtered_cells() { return m_cells_filtered; }
+
     void add_disk_read(int64_t amount) { m_disk_read += amount; }
     int64_t get_disk_read();
 
@@ -245,7 +255,7 @@ namespace Hypertable {
       m_deleted_cell_version.ensure(len);
       memcpy(m_deleted_cell_version.base, key.row, len);
       m_deleted_cell_version.ptr = m_deleted_cell_version.base + len;
-      m_deleted_cell_version_set.insert(key.timestamp);
+      m_deleted_cell_version_set.push_back(key.timestamp);
       m_delete_present = true;
     }
 
@@ -283,7 +293,8 @@ namespace Hypertable {
       Serialization::encode_i64(&ptr, m_count);
       *ptr++ = '=';
 
-      m_prev_key.set(m_counted_key.row, m_counted_key.len_cell());
+      m_prev_key.clear();
+      m_prev_key.add(m_counted_key.row, m_counted_key.len_cell());
       m_prev_cf = m_counted_key.column_family_code;
       m_no_forward = true;
       m_count_present = false;
@@ -326,6 +337,7 @@ namespace Hypertable {
     int64_t m_bytes_output {};
     int64_t m_cells_input {};
     int64_t m_cells_output {};
+    int64_t m_cells_filtered {};
     int64_t m_disk_read {};
 
     // if this is true, return a delete even if it doesn't satisfy
@@ -360,9 +372,14 @@ namespace Hypertable {
     DynamicBuffer m_deleted_cell {};
     int64_t m_deleted_cell_timestamp;
     DynamicBuffer m_deleted_cell_version {};
-    std::set<int64_t> m_deleted_cell_version_set;
+    /// Timestamps of deleted versions of the current cell; a vector reused
+    /// across cells so the scan does not allocate a node per delete
+    std::vector<int64_t> m_deleted_cell_version_set;
     IndexUpdaterPtr m_index_updater;
 
+    /// <i>true</i> if scan is a single row lookup
+    bool m_single_row {};
+
     ScanContext*  m_scan_context;
 
   };
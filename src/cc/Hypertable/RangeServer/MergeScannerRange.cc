@@ -146,7 +146,8 @@ forward:
         }
         else
           m_skip_this_row = false;
-        m_prev_key.set(latest_key, latest_key_len);
+        m_prev_key.clear();
+        m_prev_key.add(latest_key, latest_key_len);
         m_prev_cf = sstate.key.column_family_code;
         m_prev_timestamp = sstate.key.timestamp;
       }
@@ -170,7 +171,8 @@ forward:
           m_cell_count_per_family = 1;
         }
 
-        m_prev_key.set(latest_key, latest_key_len);
+        m_prev_key.clear();
+        m_prev_key.add(latest_key, latest_key_len);
         m_prev_cf = sstate.key.column_family_code;
         m_prev_timestamp = sstate.key.timestamp;
       }
@@ -278,7 +280,8 @@ void MergeScannerRange::initialize() {
     assert(m_prev_key.fill()==0);
 
     m_cell_count_per_family = 1;
-    m_prev_key.set(sstate.key.row, (sstate.key.flag_ptr+1)
+    m_prev_key.clear();
+    m_prev_key.add(sstate.key.row, (sstate.key.flag_ptr+1)
                    - (const uint8_t *)sstate.key.row);
     m_prev_cf = sstate.key.column_family_code;
     m_prev_timestamp = sstate.key.timestamp;
@@ -331,6 +334,20 @@ int64_t MergeScannerRange::get_input_bytes() {
   return bytes;
 }
 
+int64_t MergeScannerRange::get_pushdown_filtered_cells() {
+  int64_t cells = 0;
+  for (auto scanner : m_scanners)
+    cells += scanner->get_pushdown_filtered_cells();
+  return cells;
+}
+
+int64_t MergeScannerRange::get_merge_filtered_cells() {
+  int64_t cells = 0;
+  for (auto scanner : m_scanners)
+    cells += scanner->get_merge_filtered_cells();
+  return cells;
+}
+
 int64_t MergeScannerRange::get_disk_read() {
   int64_t amount = 0;
   for (auto scanner : m_scanners)
@@ -88,6 +88,18 @@ namespace Hypertable {
     /// @return Number of cells output.
     int64_t get_output_bytes() { return m_bytes_output; }
 
+    /// Returns number of cells filtered by predicate pushdown.
+    /// Calls MergeScannerAccessGroup::get_pushdown_filtered_cells() on each
+    /// scanner in #m_scanners and returns the aggregated result.
+    /// @return Number of cells filtered below the merge
+    int64_t get_pushdown_filtered_cells();
+
+    /// Returns number of cells filtered during the merge.
+    /// Calls MergeScannerAccessGroup::get_merge_filtered_cells() on each
+    /// scanner in #m_scanners and returns the aggregated result.
+    /// @return Number of cells filtered during the merge
+    int64_t get_merge_filtered_cells();
+
     int64_t get_disk_read();
 
     ScanContext *scan_context() { return m_scan_context.get(); }
@@ -190,3 +190,23 @@ void QueryCache::invalidate(const char *tablename, const char *row, std::set<uin
       p.first++;
   }
 }
+
+void QueryCache::invalidate(const char *tablename, const char *start_row,
+                            const char *end_row) {
+  lock_guard<MutexWithStatistics> lock(m_mutex);
+  Sequence &sequence = m_cache.get<0>();
+  Sequence::iterator iter = sequence.begin();
+  uint64_t length;
+
+  while (iter != sequence.end()) {
+    if (!strcmp(iter->row_key.tablename, tablename) &&
+        strcmp(iter->row_key.row, start_row) > 0 &&
+        strcmp(iter->row_key.row, end_row) <= 0) {
+      length = iter->result_length + OVERHEAD + strlen(iter->row_key.row);
+      m_avail_memory += length;
+      iter = sequence.erase(iter);
+    }
+    else
+      ++iter;
+  }
+}
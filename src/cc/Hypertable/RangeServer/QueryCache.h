@@ -146,6 +146,17 @@ namespace Hypertable {
     /// @param columns Columns of entries to invalidate
     void invalidate(const char * tablename, const char *row, std::set<uint8_t> &columns);
 
+    /// Invalidates cache entries for a row interval.
+    /// Invalidates all cache entries for table <code>tablename</code> whose
+    /// row falls within the interval (<code>start_row</code>,
+    /// <code>end_row</code>].  This requires a walk of the entire cache and
+    /// should only be used for infrequent operations such as bulk loads.
+    /// @param tablename %Table of entries to invalidate
+    /// @param start_row Start row (exclusive) of interval to invalidate
+    /// @param end_row End row (inclusive) of interval to invalidate
+    void invalidate(const char *tablename, const char *start_row,
+                    const char *end_row);
+
     /// Gets available memory.
     /// Returns #m_avail_memory
     /// @return Available memory
@@ -47,6 +47,7 @@
 #include <Common/Random.h>
 #include <Common/ScopeGuard.h>
 #include <Common/StringExt.h>
+#include <Common/Time.h>
 #include <Common/md5.h>
 
 #include <boost/algorithm/string.hpp>
@@ -54,8 +55,10 @@
 
 #include <re2/re2.h>
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <map>
 #include <string>
 #include <thread>
 #include <vector>
@@ -1460,8 +1463,10 @@ void Range::compact(MaintenanceFlag::Map &subtask_map) {
       Barrier::ScopedActivator block_updates(m_update_barrier);
       lock_guard<mutex> lock(m_mutex);
       for (size_t i=0; i<ag_vector.size(); i++) {
+        // Dropping expired cell stores does not involve the cell cache
         if (m_metalog_entity->get_needs_compaction() ||
-            subtask_map.compaction(ag_vector[i].get()))
+            (subtask_map.compaction(ag_vector[i].get()) &&
+             !MaintenanceFlag::drop_expired(subtask_map.flags(ag_vector[i].get()))))
           ag_vector[i]->stage_compaction();
       }
     }
@@ -1568,6 +1573,62 @@ void Range::purge_memory(MaintenanceFlag::Map &subtask_map) {
 }
 
 
+/**
+ * The maintenance guard keeps compactions and splits from changing the
+ * access group stores while files are adopted.
+ */
+void Range::adopt_cellstores(const vector<pair<String, String>> &files) {
+
+  if (!m_initialized)
+    deferred_initialization();
+
+  RangeMaintenanceGuard::Activator activator(m_maintenance_guard);
+  AccessGroupVector ag_vector(0);
+  map<String, vector<String>> ag_files;
+
+  if (m_metalog_entity->get_state() != RangeState::STEADY)
+    HT_THROWF(Error::RANGESERVER_RANGE_BUSY, "Range %s is in state %s",
+              m_name.c_str(),
+              RangeState::get_text(m_metalog_entity->get_state()).c_str());
+
+  {
+    lock_guard<mutex> lock(m_schema_mutex);
+    ag_vector = m_access_group_vector;
+    for (auto &entry : files) {
+      if (m_access_group_map.find(entry.first) == m_access_group_map.end())
+        HT_THROWF(Error::BAD_SCHEMA, "Access group '%s' not found in range %s",
+                  entry.first.c_str(), m_name.c_str());
+      ag_files[entry.first].push_back(entry.second);
+    }
+  }
+
+  // Revisions this server assigns from now on are no smaller than this, so
+  // adopted cells can't be ordered after updates that follow them
+  int64_t revision_limit = get_ts64();
+  int64_t latest_revision = TIMESTAMP_MIN;
+
+  std::vector<AccessGroup::Hints> hints(ag_vector.size());
+  for (size_t i=0; i<ag_vector.size(); i++) {
+    auto iter = ag_files.find(ag_vector[i]->get_name());
+    if (iter != ag_files.end())
+      latest_revision = std::max(latest_revision,
+              ag_vector[i]->adopt_cellstores(iter->second, revision_limit,
+                                             &hints[i]));
+    else
+      ag_vector[i]->load_hints(&hints[i]);
+  }
+  m_hints_file.set(hints);
+  m_hints_file.write(Global::location_initializer->get());
+
+  {
+    lock_guard<mutex> lock(m_mutex);
+    // Make the adopted cells visible to scans that start now
+    if (latest_revision > m_latest_revision)
+      m_latest_revision = latest_revision;
+    m_maintenance_generation++;
+  }
+}
+
 /**
  * This method is called when the range is offline so no locking is needed
  */
@@ -1749,6 +1810,7 @@ std::ostream &Hypertable::operator<<(std::ostream &os, const Range::MaintenanceD
   os << "priority=" << mdata.priority << "\n";
   os << "state=" << mdata.state << "\n";
   os << "maintenance_flags=" << mdata.maintenance_flags << "\n";
+  os << "compaction_type_needed=" << mdata.compaction_type_needed << "\n";
   os << "file_count=" << mdata.file_count << "\n";
   os << "cell_count=" << mdata.cell_count << "\n";
   os << "memory_used=" << mdata.memory_used << "\n";
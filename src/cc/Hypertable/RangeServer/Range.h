@@ -58,6 +58,7 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 namespace Hypertable {
@@ -191,6 +192,21 @@ namespace Hypertable {
 
     void purge_memory(MaintenanceFlag::Map &subtask_map);
 
+    /// Adopts bulk loaded cell stores.
+    /// Adds each (access group, file) pair in <code>files</code> to the named
+    /// access group (see AccessGroup::adopt_cellstores) and persists the new
+    /// file lists to the hints file.  Files already adopted are skipped, so
+    /// the request may be retried.  The latest revision is advanced to that
+    /// of the adopted files so that scans see them immediately.  The range
+    /// must be in the RangeState::STEADY state and not undergoing
+    /// maintenance.
+    /// @param files Vector of (access group name, cell store path) pairs
+    /// @throws Exception with code Error::RANGESERVER_RANGE_BUSY if range is
+    /// undergoing maintenance or is not in the steady state, or with code
+    /// Error::RANGESERVER_CLOCK_SKEW if a file's revision is ahead of this
+    /// server's clock
+    void adopt_cellstores(const std::vector<std::pair<String, String>> &files);
+
     void schedule_relinquish() { m_relinquish = true; }
     bool get_relinquish() const { return m_relinquish; }
 
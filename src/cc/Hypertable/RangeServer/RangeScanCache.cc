@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Definitions for RangeScanCache.
+/// This file contains definitions for RangeScanCache, a class for caching
+/// the results of small multi-row scans.
+
+#include <Common/Compat.h>
+#include "RangeScanCache.h"
+
+#include <Hypertable/Lib/Key.h>
+#include <Hypertable/Lib/SerializedKey.h>
+
+#include <Common/Logger.h>
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+using namespace Hypertable;
+using namespace std;
+
+#define OVERHEAD 128
+
+bool
+RangeScanCache::insert(uint64_t sequence, Key *key, const char *tablename,
+                       const char *range_end_row, const char *start_row,
+                       const char *end_row, std::set<uint8_t> &columns,
+                       uint32_t cell_count, const uint8_t *result,
+                       uint32_t result_length) {
+
+  if (result_length > m_max_result_size)
+    return false;
+
+  size_t tablename_len = strlen(tablename) + 1;
+  size_t range_end_row_len = strlen(range_end_row) + 1;
+  size_t start_row_len = strlen(start_row) + 1;
+  size_t end_row_len = strlen(end_row) + 1;
+  size_t buffer_len = result_length + tablename_len + range_end_row_len +
+    start_row_len + end_row_len;
+  uint64_t length = buffer_len + OVERHEAD;
+
+  if (length > m_max_memory)
+    return false;
+
+  boost::shared_array<uint8_t> buffer(new uint8_t [ buffer_len ]);
+  uint8_t *ptr = buffer.get();
+  memcpy(ptr, result, result_length);
+  ptr += result_length;
+  char *tablename_ptr = (char *)ptr;
+  memcpy(ptr, tablename, tablename_len);
+  ptr += tablename_len;
+  char *range_end_row_ptr = (char *)ptr;
+  memcpy(ptr, range_end_row, range_end_row_len);
+  ptr += range_end_row_len;
+  char *start_row_ptr = (char *)ptr;
+  memcpy(ptr, start_row, start_row_len);
+  ptr += start_row_len;
+  char *end_row_ptr = (char *)ptr;
+  memcpy(ptr, end_row, end_row_len);
+
+  lock_guard<mutex> lock(m_mutex);
+
+  // the range was invalidated while the scan ran
+  if (m_sequences[sequence_slot(tablename, range_end_row)] != sequence)
+    return false;
+
+  LookupHashIndex &hash_index = m_cache.get<1>();
+  LookupHashIndex::iterator lookup_iter;
+
+  if ((lookup_iter = hash_index.find(*key)) != hash_index.end()) {
+    m_avail_memory += lookup_iter->length;
+    hash_index.erase(lookup_iter);
+  }
+
+  // make room
+  if (m_avail_memory < length) {
+    Cache::iterator iter = m_cache.begin();
+    while (iter != m_cache.end()) {
+      m_avail_memory += iter->length;
+      iter = m_cache.erase(iter);
+      if (m_avail_memory >= length)
+        break;
+    }
+  }
+
+  if (m_avail_memory < length)
+    return false;
+
+  RangeScanCacheEntry entry(*key, tablename_ptr, range_end_row_ptr,
+                            start_row_ptr, end_row_ptr, columns, cell_count,
+                            buffer, result_length, length);
+
+  auto insert_result = m_cache.push_back(entry);
+  assert(insert_result.second);
+  (void)insert_result;
+
+  m_avail_memory -= length;
+
+  return true;
+}
+
+
+bool RangeScanCache::lookup(Key *key, boost::shared_array<uint8_t> &result,
+                            uint32_t *lenp, uint32_t *cell_count) {
+  lock_guard<mutex> lock(m_mutex);
+  LookupHashIndex &hash_index = m_cache.get<1>();
+  LookupHashIndex::iterator iter;
+
+  if (m_total_lookup_count > 0 && (m_total_lookup_count % 1000) == 0) {
+    HT_INFOF("RangeScanCache hit rate over last 1000 lookups, cumulative = %f, %f",
+             ((double)m_recent_hit_count / (double)1000)*100.0,
+             ((double)m_total_hit_count / (double)m_total_lookup_count)*100.0);
+    m_recent_hit_count = 0;
+  }
+
+  m_total_lookup_count++;
+
+  if ((iter = hash_index.find(*key)) == hash_index.end())
+    return false;
+
+  // move to back of LRU list
+  m_cache.relocate(m_cache.end(), m_cache.project<0>(iter));
+
+  result = iter->buffer;
+  *lenp = iter->result_length;
+  *cell_count = iter->cell_count;
+
+  m_total_hit_count++;
+  m_recent_hit_count++;
+  return true;
+}
+
+
+void RangeScanCache::invalidate(const char *tablename,
+                                const char *range_end_row,
+                                const char *start_row, const char *end_row,
+                                std::set<uint8_t> &columns) {
+  lock_guard<mutex> lock(m_mutex);
+  InvalidateHashIndex &hash_index = m_cache.get<2>();
+  RangeKey range_key(tablename, range_end_row);
+  auto p = hash_index.equal_range(range_key);
+
+  m_sequences[range_key.hash % SEQUENCE_SLOTS]++;
+
+  while (p.first != p.second) {
+    if (strcmp(end_row, p.first->start_row) >= 0 &&
+        strcmp(start_row, p.first->end_row) <= 0 &&
+        columns_intersect(*p.first, columns)) {
+      m_avail_memory += p.first->length;
+      p.first = hash_index.erase(p.first);
+    }
+    else
+      ++p.first;
+  }
+}
+
+
+void RangeScanCache::invalidate(const char *tablename, const char *start_row,
+                                const char *end_row) {
+  lock_guard<mutex> lock(m_mutex);
+  Sequence &sequence = m_cache.get<0>();
+  Sequence::iterator iter = sequence.begin();
+
+  // ranges are not known by row interval, so advance them all
+  for (auto &range_sequence : m_sequences)
+    range_sequence++;
+
+  while (iter != sequence.end()) {
+    if (!strcmp(iter->range_key.tablename, tablename) &&
+        strcmp(iter->end_row, start_row) > 0 &&
+        strcmp(iter->start_row, end_row) <= 0) {
+      m_avail_memory += iter->length;
+      iter = sequence.erase(iter);
+    }
+    else
+      ++iter;
+  }
+}
+
+
+void RangeScanCache::dump_keys(ofstream &out) {
+  lock_guard<mutex> lock(m_mutex);
+  Sequence &sequence_index = m_cache.get<0>();
+  out << "\nRange Scan Cache:\n";
+  for (auto &entry : sequence_index) {
+    out << entry.range_key.tablename << "[" << entry.range_key.end_row
+        << "] rows=['" << entry.start_row << "'..'" << entry.end_row
+        << "'] cols={";
+    bool first {true};
+    for (uint8_t cf : entry.columns) {
+      if (!first)
+        out << ",";
+      else
+        first = false;
+      out << (int)cf;
+    }
+    out << "} Length=" << entry.result_length << " CellCount=" << entry.cell_count;
+    if (entry.cell_count > 0) {
+      SerializedKey serkey;
+      serkey.ptr = (uint8_t *)(entry.buffer.get() + 4);
+      Hypertable::Key key(serkey);
+      out << " FirstKey=(" << key << ")";
+    }
+    out << "\n";
+  }
+}
+
+
+bool RangeScanCache::columns_intersect(const RangeScanCacheEntry &entry,
+                                       const std::set<uint8_t> &columns) {
+  if (entry.columns.empty() || columns.empty())
+    return true;
+  auto iter1 = entry.columns.begin();
+  auto iter2 = columns.begin();
+  while (iter1 != entry.columns.end() && iter2 != columns.end()) {
+    if (*iter1 < *iter2)
+      ++iter1;
+    else if (*iter2 < *iter1)
+      ++iter2;
+    else
+      return true;
+  }
+  return false;
+}
@@ -0,0 +1,317 @@
+/* -*- c++ -*-
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Declarations for RangeScanCache.
+/// This file contains type declarations for RangeScanCache, a class for
+/// caching the results of small multi-row scans.
+
+#ifndef Hypertable_RangeServer_RangeScanCache_h
+#define Hypertable_RangeServer_RangeScanCache_h
+
+#include <Hypertable/RangeServer/QueryCache.h>
+
+#include <Common/Checksum.h>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/mem_fun.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/shared_array.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace Hypertable {
+  using namespace boost::multi_index;
+
+  /// @addtogroup RangeServer
+  /// @{
+
+  /// Range scan result cache.
+  /// QueryCache only holds the results of single-row queries.  This class
+  /// caches the results of scans over a row interval that complete in a single
+  /// scan block and whose result is no larger than a configurable threshold.
+  /// Entries are looked up by a digest of the create scanner request, which
+  /// covers the table schema generation, the range boundaries, and the scan
+  /// specification, so a range split or schema change is never served from
+  /// the cache.  Each entry is also filed under the range it was computed
+  /// from (table ID plus range end row) along with the row interval it
+  /// covers, so an update only walks the entries of the range it was applied
+  /// to and invalidates those whose interval and columns it touches.
+  /// A scan that misses an update can finish after that update's
+  /// invalidation has run, so each range also has an invalidation sequence
+  /// that callers take with sequence() before scanning and pass to insert(),
+  /// which drops the result if the sequence has moved.
+  class RangeScanCache {
+
+  public:
+
+    /// Hash key to cache (digest of create scanner request).
+    typedef QueryCache::Key Key;
+
+    /// %Range identifier used to group entries for invalidation.
+    class RangeKey {
+    public:
+      /// Constructor.
+      /// Initializes #tablename to <code>t</code> and #end_row to
+      /// <code>r</code>, which must remain valid for the lifetime of the
+      /// object, and sets #hash to the fletcher32 checksum of both.
+      /// @param t %Table ID
+      /// @param r %Range end row
+      RangeKey(const char *t, const char *r) : tablename(t), end_row(r) {
+        hash = fletcher32(t, strlen(t)) ^ fletcher32(r, strlen(r));
+      }
+      /// Equality operator.
+      /// @param other Other key to compare
+      /// @return <i>true</i> if keys are equal, <i>false</i> otherwise.
+      bool operator==(const RangeKey &other) const {
+        return !strcmp(tablename, other.tablename) &&
+          !strcmp(end_row, other.end_row);
+      }
+      /// %Table ID
+      const char *tablename;
+      /// %Range end row
+      const char *end_row;
+      /// Hash code computed from #tablename and #end_row
+      uint32_t hash;
+    };
+
+    /// Constructor.
+    /// @param max_memory Maximum amount of memory to be used by the cache
+    /// @param max_result_size Largest result that will be cached
+    RangeScanCache(uint64_t max_memory, uint32_t max_result_size)
+      : m_max_memory(max_memory), m_avail_memory(max_memory),
+        m_max_result_size(max_result_size), m_sequences(SEQUENCE_SLOTS) { }
+
+    /// Returns largest result that will be cached.
+    /// @return Maximum result size
+    uint32_t max_result_size() const { return m_max_result_size; }
+
+    /// Returns invalidation sequence of a range.
+    /// @param tablename %Table ID
+    /// @param range_end_row %Range end row
+    /// @return Current invalidation sequence of the range
+    uint64_t sequence(const char *tablename, const char *range_end_row) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      return m_sequences[sequence_slot(tablename, range_end_row)];
+    }
+
+    /// Inserts a scan result.
+    /// Copies <code>result</code> and the row strings into a single buffer
+    /// owned by the cache entry.  Results larger than #m_max_result_size are
+    /// rejected, as are results of scans that an invalidation of the range
+    /// raced with.  An existing entry for <code>key</code> is replaced and the
+    /// least recently used entries are evicted to make room.
+    /// @param sequence Sequence returned by sequence() for the range before
+    /// the scan was run
+    /// @param key Hash key for entry to be inserted
+    /// @param tablename %Table ID
+    /// @param range_end_row End row of range the scan was run against
+    /// @param start_row First row covered by the scan
+    /// @param end_row Last row covered by the scan
+    /// @param columns Column family IDs selected by the scan (empty for all)
+    /// @param cell_count Count of cells in result
+    /// @param result Scan result
+    /// @param result_length Length of scan result
+    /// @return <i>true</i> if result was inserted, <i>false</i> otherwise.
+    bool insert(uint64_t sequence, Key *key, const char *tablename,
+                const char *range_end_row,
+                const char *start_row, const char *end_row,
+                std::set<uint8_t> &columns, uint32_t cell_count,
+                const uint8_t *result, uint32_t result_length);
+
+    /// Lookup.
+    /// Looks up the entry with key <code>key</code> and, if found, returns the
+    /// result in <code>result</code>, <code>lenp</code>, and
+    /// <code>cell_count</code> and moves the entry to the back of the LRU
+    /// list.
+    /// @param key Hash key
+    /// @param result Reference to shared array to hold result
+    /// @param lenp Pointer to variable to hold result length
+    /// @param cell_count Pointer to variable to hold count of cells in result
+    /// @return <i>true</i> if an entry was found, <i>false</i> otherwise
+    bool lookup(Key *key, boost::shared_array<uint8_t> &result, uint32_t *lenp,
+                uint32_t *cell_count);
+
+    /// Invalidates entries touched by an update to a range.
+    /// Advances the invalidation sequence of the range identified by
+    /// <code>tablename</code> and <code>range_end_row</code>, then walks the
+    /// entries filed under it and invalidates those whose row interval
+    /// overlaps [<code>start_row</code>, <code>end_row</code>] and whose
+    /// columns intersect with <code>columns</code>.  Empty column sets match
+    /// all columns.
+    /// @param tablename %Table ID
+    /// @param range_end_row End row of updated range
+    /// @param start_row Lowest row updated
+    /// @param end_row Highest row updated
+    /// @param columns Column family IDs updated
+    void invalidate(const char *tablename, const char *range_end_row,
+                    const char *start_row, const char *end_row,
+                    std::set<uint8_t> &columns);
+
+    /// Invalidates all entries for a row interval.
+    /// Invalidates all entries for table <code>tablename</code> whose row
+    /// interval overlaps (<code>start_row</code>, <code>end_row</code>] and
+    /// advances the invalidation sequence of every range.
+    /// This requires a walk of the entire cache and should only be used for
+    /// infrequent operations such as range loads and bulk loads.
+    /// @param tablename %Table ID
+    /// @param start_row Start row (exclusive) of interval to invalidate
+    /// @param end_row End row (inclusive) of interval to invalidate
+    void invalidate(const char *tablename, const char *start_row,
+                    const char *end_row);
+
+    /// Gets memory used.
+    /// @return Memory used
+    uint64_t memory_used() {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      return m_max_memory-m_avail_memory;
+    }
+
+    /// Gets available memory.
+    /// @return Available memory
+    uint64_t available_memory() {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      return m_avail_memory;
+    }
+
+    /// Dumps entries to output file.
+    /// @param out Output file to dump entries to
+    void dump_keys(std::ofstream &out);
+
+  private:
+
+    /// Internal cache entry.
+    class RangeScanCacheEntry {
+    public:
+      RangeScanCacheEntry(Key &k, const char *tname, const char *rend,
+                          const char *srow, const char *erow,
+                          std::set<uint8_t> &column_ids, uint32_t cells,
+                          boost::shared_array<uint8_t> &buf, uint32_t rlen,
+                          uint64_t len) :
+        key(k), range_key(tname, rend), start_row(srow), end_row(erow),
+        buffer(buf), result_length(rlen), cell_count(cells), length(len) {
+        columns.swap(column_ids);
+      }
+      Key lookup_key() const { return key; }
+      RangeKey invalidate_key() const { return range_key; }
+      Key key;
+      RangeKey range_key;
+      const char *start_row;
+      const char *end_row;
+      std::set<uint8_t> columns;
+      /// Result followed by the row strings referenced above
+      boost::shared_array<uint8_t> buffer;
+      uint32_t result_length;
+      uint32_t cell_count;
+      /// Memory accounted to this entry
+      uint64_t length;
+    };
+
+    struct KeyHash {
+      std::size_t operator()(const Key k) const {
+        return (std::size_t)k.digest[0];
+      }
+    };
+
+    struct RangeKeyHash {
+      std::size_t operator()(const RangeKey k) const {
+        return k.hash;
+      }
+    };
+
+    typedef boost::multi_index_container<
+      RangeScanCacheEntry,
+      indexed_by<
+        sequenced<>,
+        hashed_unique<const_mem_fun<RangeScanCacheEntry, Key,
+                      &RangeScanCacheEntry::lookup_key>, KeyHash>,
+        hashed_non_unique<const_mem_fun<RangeScanCacheEntry, RangeKey,
+                          &RangeScanCacheEntry::invalidate_key>, RangeKeyHash>
+      >
+    > Cache;
+
+    typedef Cache::nth_index<0>::type Sequence;
+    typedef Cache::nth_index<1>::type LookupHashIndex;
+    typedef Cache::nth_index<2>::type InvalidateHashIndex;
+
+    /// Checks if an entry's columns intersect with <code>columns</code>.
+    /// @param entry Cache entry
+    /// @param columns Column family IDs (empty for all)
+    /// @return <i>true</i> if columns intersect, <i>false</i> otherwise
+    static bool columns_intersect(const RangeScanCacheEntry &entry,
+                                  const std::set<uint8_t> &columns);
+
+    /// Number of invalidation sequences.  Ranges share a sequence when
+    /// their RangeKey hashes collide, which only causes extra results to be
+    /// dropped.
+    static constexpr size_t SEQUENCE_SLOTS = 1024;
+
+    /// Returns index into #m_sequences of a range's invalidation sequence.
+    /// @param tablename %Table ID
+    /// @param range_end_row %Range end row
+    /// @return Index of invalidation sequence
+    static size_t sequence_slot(const char *tablename,
+                                const char *range_end_row) {
+      return RangeKey(tablename, range_end_row).hash % SEQUENCE_SLOTS;
+    }
+
+    /// %Mutex to serialize member access
+    std::mutex m_mutex;
+
+    /// Internal cache data structure
+    Cache m_cache;
+
+    /// Maximum memory to be used by cache
+    uint64_t m_max_memory {};
+
+    /// Available memory
+    uint64_t m_avail_memory {};
+
+    /// Largest result that will be cached
+    uint32_t m_max_result_size {};
+
+    /// Invalidation sequences, indexed by sequence_slot()
+    std::vector<uint64_t> m_sequences;
+
+    /// Total lookup count
+    uint64_t m_total_lookup_count {};
+
+    /// Total hit count
+    uint64_t m_total_hit_count {};
+
+    /// Recent hit count (for logging)
+    uint32_t m_recent_hit_count {};
+  };
+
+  /// Smart pointer to RangeScanCache
+  typedef std::shared_ptr<RangeScanCache> RangeScanCachePtr;
+
+  /// @}
+
+}
+
+#endif // Hypertable_RangeServer_RangeScanCache_h
@@ -38,6 +38,7 @@
 #include <Hypertable/RangeServer/MaintenanceScheduler.h>
 #include <Hypertable/RangeServer/MaintenanceTaskCompaction.h>
 #include <Hypertable/RangeServer/MaintenanceTaskRelinquish.h>
+#include <Hypertable/RangeServer/LogReplayPipeline.h>
 #include <Hypertable/RangeServer/MaintenanceTaskSplit.h>
 #include <Hypertable/RangeServer/MergeScannerRange.h>
 #include <Hypertable/RangeServer/MetaLogDefinitionRangeServer.h>
@@ -115,6 +116,25 @@ Apps::RangeServer::RangeServer(PropertiesPtr &props, ConnectionManagerPtr &conn_
   m_ganglia_collector =
     std::make_shared<MetricsCollectorGanglia>("rangeserver", props);
 
+  // Create latency histograms
+  Global::update_qualify_latency = make_shared<LatencyHistogram>("updateQualify");
+  Global::update_commit_latency = make_shared<LatencyHistogram>("updateCommit");
+  Global::update_sync_latency = make_shared<LatencyHistogram>("updateSync");
+  Global::update_respond_latency = make_shared<LatencyHistogram>("updateRespond");
+  Global::create_scanner_latency = make_shared<LatencyHistogram>("createScanner");
+  Global::fetch_scanblock_latency = make_shared<LatencyHistogram>("fetchScanblock");
+  Global::block_cache_miss_latency = make_shared<LatencyHistogram>("blockCacheMiss");
+  m_latency_histograms.push_back(Global::update_qualify_latency.get());
+  m_latency_histograms.push_back(Global::update_commit_latency.get());
+  m_latency_histograms.push_back(Global::update_sync_latency.get());
+  m_latency_histograms.push_back(Global::update_respond_latency.get());
+  m_latency_histograms.push_back(Global::create_scanner_latency.get());
+  m_latency_histograms.push_back(Global::fetch_scanblock_latency.get());
+  m_latency_histograms.push_back(Global::block_cache_miss_latency.get());
+  if (Global::request_wait_latency)
+    m_latency_histograms.push_back(Global::request_wait_latency.get());
+  m_latency_snapshots.resize(m_latency_histograms.size());
+
   m_context = std::make_shared<RangeServerContext>();
   m_context->props = props;
   m_context->comm = conn_mgr->get_comm();
@@ -257,7 +277,22 @@ Apps::RangeServer::RangeServer(PropertiesPtr &props, ConnectionManagerPtr &conn_
     m_query_cache = std::make_shared<QueryCache>(query_cache_memory);
   }
 
-  Global::memory_tracker = new MemoryTracker(Global::block_cache, m_query_cache);
+  int64_t range_scan_cache_memory = cfg.get_i64("RangeScanCache.MaxMemory");
+  if (range_scan_cache_memory > 0) {
+    // reduce range scan cache if required
+    if ((double)range_scan_cache_memory > (double)Global::memory_limit * 0.1) {
+      range_scan_cache_memory = (int64_t)((double)Global::memory_limit * 0.1);
+      props->set("Hypertable.RangeServer.RangeScanCache.MaxMemory", range_scan_cache_memory);
+      HT_INFOF("Maximum size of range scan cache has been reduced to %.2fMB",
+               (double)range_scan_cache_memory / MiB);
+    }
+    Global::range_scan_cache =
+      std::make_shared<RangeScanCache>(range_scan_cache_memory,
+                                       cfg.get_i32("RangeScanCache.MaxResultSize"));
+  }
+
+  Global::memory_tracker = new MemoryTracker(Global::block_cache, m_query_cache,
+                                             Global::range_scan_cache);
 
   FsBroker::Lib::ClientPtr dfsclient = std::make_shared<FsBroker::Lib::Client>(conn_mgr, props);
 
@@ -292,6 +327,13 @@ Apps::RangeServer::RangeServer(PropertiesPtr &props, ConnectionManagerPtr &conn_
   // Create the maintenance queue
   Global::maintenance_queue = make_shared<MaintenanceQueue>(maintenance_threads);
 
+  // Create the compaction and split I/O throttle
+  {
+    gInt32tPtr rate = props->get_ptr<gInt32t>("Hypertable.RangeServer.Maintenance.Throttle.Rate");
+    gInt32tPtr reserve = props->get_ptr<gInt32t>("Hypertable.RangeServer.Maintenance.Throttle.BackgroundReserve");
+    Global::compaction_throttle = make_shared<CompactionThrottle>(rate, reserve);
+  }
+
   /**
    * Listen for incoming connections
    */
@@ -380,7 +422,7 @@ Apps::RangeServer::RangeServer(PropertiesPtr &props, ConnectionManagerPtr &conn_
 
 }
 
-void Apps::RangeServer::status(Response::Callback::Status *cb) {
+void Apps::RangeServer::status(Response::Callback::Status *cb, int32_t flags) {
   Hypertable::Status status;
   if (m_startup)
     status.set(Status::Code::CRITICAL, Status::Text::SERVER_IS_COMING_UP);
@@ -399,7 +441,27 @@ void Apps::RangeServer::status(Response::Callback::Status *cb) {
     else
       StatusPersister::get(status);
   }
-  cb->response(status);
+  if (flags & Lib::RangeServer::Protocol::STATUS_FLAG_LATENCY)
+    cb->response(status, latency_report());
+  else
+    cb->response(status);
+}
+
+string Apps::RangeServer::latency_report() {
+  LatencyHistogram::Snapshot snapshot;
+  string report;
+  for (auto histogram : m_latency_histograms) {
+    histogram->snapshot(&snapshot);
+    report += format("%-15s count=%llu mean=%.3f p50=%.3f p90=%.3f p99=%.3f "
+                     "p999=%.3f max=%.3f\n", histogram->name().c_str(),
+                     (Llu)snapshot.count, snapshot.mean() / 1000.0,
+                     (double)snapshot.percentile(50) / 1000.0,
+                     (double)snapshot.percentile(90) / 1000.0,
+                     (double)snapshot.percentile(99) / 1000.0,
+                     (double)snapshot.percentile(99.9) / 1000.0,
+                     (double)snapshot.max / 1000.0);
+  }
+  return report;
 }
 
 void Apps::RangeServer::shutdown() {
@@ -869,7 +931,12 @@ void Apps::RangeServer::local_recover() {
         user_log_reader = make_shared<CommitLogReader>(Global::log_dfs,
                                               Global::log_dir + "/user");
 
-        replay_log(replay_map, user_log_reader);
+        int32_t replay_threads =
+          m_props->get_i32("Hypertable.RangeServer.CommitLog.Replay.Threads");
+        if (replay_threads > 1)
+          replay_log_parallel(replay_map, user_log_reader, replay_threads);
+        else
+          replay_log(replay_map, user_log_reader);
 
         user_log_reader->get_linked_logs(transfer_logs);
 
@@ -1074,11 +1141,15 @@ void Apps::RangeServer::replay_log(TableInfoMap &replay_map,
   RangePtr range;
   String start_row, end_row;
   unsigned long block_count = 0;
+  uint64_t byte_count = 0;
   uint8_t *base;
   size_t len;
+  auto start_time = chrono::steady_clock::now();
 
   while (log_reader->next((const uint8_t **)&base, &len, &header)) {
 
+    byte_count += len;
+
     const uint8_t *ptr = base;
     const uint8_t *end = base + len;
 
@@ -1137,8 +1208,37 @@ void Apps::RangeServer::replay_log(TableInfoMap &replay_map,
     block_count++;
   }
 
-  HT_INFOF("Replayed %lu blocks of updates from '%s'", block_count,
-           log_reader->get_log_dir().c_str());
+  double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+  HT_INFOF("Replayed %lu blocks (%.1fMB) of updates from '%s' in %.3fs "
+           "(%.1f MB/s)", block_count, (double)byte_count / (double)MiB,
+           log_reader->get_log_dir().c_str(), elapsed,
+           elapsed > 0.0 ? ((double)byte_count / (double)MiB) / elapsed : 0.0);
+}
+
+
+void Apps::RangeServer::replay_log_parallel(TableInfoMap &replay_map,
+                                            CommitLogReaderPtr &log_reader,
+                                            int32_t thread_count) {
+  LogReplayPipeline pipeline(replay_map, (size_t)thread_count);
+
+  pipeline.replay(log_reader);
+
+  const LogReplayPipeline::Statistics &stats = pipeline.get_statistics();
+  double elapsed = (double)stats.elapsed_micros / 1000000.0;
+  double mb = (double)stats.bytes / (double)MiB;
+  HT_INFOF("Replayed %lld blocks (%.1fMB, %lld cells) of updates from '%s' "
+           "with %d threads in %.3fs (%.1f MB/s)", (Lld)stats.blocks, mb,
+           (Lld)stats.cells, log_reader->get_log_dir().c_str(),
+           (int)thread_count, elapsed, elapsed > 0.0 ? mb / elapsed : 0.0);
+  HT_INFOF("Replay phases for '%s': read=%.3fs inflate=%.3fs "
+           "partition=%.3fs apply=%.3fs (inflate, partition, and apply "
+           "summed over threads), compressed=%.1fMB",
+           log_reader->get_log_dir().c_str(),
+           (double)stats.read_micros / 1000000.0,
+           (double)stats.inflate_micros / 1000000.0,
+           (double)stats.partition_micros / 1000000.0,
+           (double)stats.apply_micros / 1000000.0,
+           (double)stats.compressed_bytes / (double)MiB);
 }
 
 void
@@ -1459,6 +1559,8 @@ Apps::RangeServer::create_scanner(Response::Callback::CreateScanner *cb,
   if (!m_log_replay_barrier->wait(cb->event()->deadline(), table, range_spec))
     return;
 
+  LatencyHistogram::ScopedTimer latency_timer(Global::create_scanner_latency.get());
+
   try {
     DynamicBuffer rbuf;
 
@@ -1513,12 +1615,18 @@ Apps::RangeServer::create_scanner(Response::Callback::CreateScanner *cb,
       HT_THROWF(Error::RANGESERVER_RANGE_NOT_FOUND, "(b) %s[%s..%s]",
                 table.id, range_spec.start_row, range_spec.end_row);
 
-    // check query cache
-    if (cache_key && m_query_cache && !table.is_metadata()) {
+    // check query cache (single row) or range scan cache (multi-row)
+    if (cache_key && !table.is_metadata()) {
       boost::shared_array<uint8_t> ext_buffer;
       uint32_t ext_len;
       uint32_t cell_count;
-      if (m_query_cache->lookup(cache_key, ext_buffer, &ext_len, &cell_count)) {
+      bool hit = scan_spec.cacheable() ?
+        (m_query_cache &&
+         m_query_cache->lookup(cache_key, ext_buffer, &ext_len, &cell_count)) :
+        (Global::range_scan_cache &&
+         Global::range_scan_cache->lookup(cache_key, ext_buffer, &ext_len,
+                                          &cell_count));
+      if (hit) {
         if ((error = cb->response(id, 0, 0, false, profile_data, ext_buffer, ext_len))
                 != Error::OK)
           HT_ERRORF("Problem sending OK response - %s", Error::get_text(error));
@@ -1535,6 +1643,13 @@ Apps::RangeServer::create_scanner(Response::Callback::CreateScanner *cb,
         return;
       }
     }
+    // Taken before the scan revision, so that any update the scan misses
+    // is invalidated after this point (see UpdatePipeline)
+    uint64_t scan_cache_sequence {};
+    if (cache_key && Global::range_scan_cache && !scan_spec.cacheable())
+      scan_cache_sequence =
+        Global::range_scan_cache->sequence(table.id, range_spec.end_row);
+
     std::set<uint8_t> columns;
     scan_ctx = make_shared<ScanContext>(range->get_scan_revision(cb->event()->header.timeout_ms),
                                &scan_spec, &range_spec, schema, &columns);
@@ -1554,6 +1669,8 @@ Apps::RangeServer::create_scanner(Response::Callback::CreateScanner *cb,
     profile_data.bytes_scanned = scanner->get_input_bytes();
     profile_data.bytes_returned = scanner->get_output_bytes();
     profile_data.disk_read = scanner->get_disk_read();
+    profile_data.cells_filtered_pushdown = scanner->get_pushdown_filtered_cells();
+    profile_data.cells_filtered_merge = scanner->get_merge_filtered_cells();
 
     int64_t output_cells = scanner->get_output_cells();
 
@@ -1593,7 +1710,8 @@ Apps::RangeServer::create_scanner(Response::Callback::CreateScanner *cb,
     /**
      *  Send back data
      */
-    if (cache_key && m_query_cache && !table.is_metadata() && !more) {
+    if (cache_key && m_query_cache && scan_spec.cacheable() &&
+        !table.is_metadata() && !more) {
       const char *cache_row_key = scan_spec.cache_key();
       char *row_key_ptr, *tablename_ptr;
       uint8_t *buffer = new uint8_t [ rbuf.fill() + strlen(cache_row_key) + strlen(table.id) + 2 ];
@@ -1611,6 +1729,15 @@ Apps::RangeServer::create_scanner(Response::Callback::CreateScanner *cb,
       }
     }
     else {
+      // The cache drops the result if the range has been invalidated since
+      // scan_cache_sequence was taken
+      if (cache_key && Global::range_scan_cache && !scan_spec.cacheable() &&
+          !table.is_metadata() && !more)
+        Global::range_scan_cache->insert(scan_cache_sequence, cache_key,
+                                         table.id, range_spec.end_row,
+                                         scan_ctx->start_row.c_str(),
+                                         scan_ctx->end_row.c_str(), columns,
+                                         cell_count, rbuf.base, rbuf.fill());
       StaticBuffer ext(rbuf);
       if ((error = cb->response(id, skipped_rows, skipped_cells, more,
                                 profile_data, ext)) != Error::OK) {
@@ -1662,6 +1789,7 @@ Apps::RangeServer::fetch_scanblock(Response::Callback::CreateScanner *cb,
   SchemaPtr schema;
   ProfileDataScanner profile_data_before;
   ProfileDataScanner profile_data;
+  LatencyHistogram::ScopedTimer latency_timer(Global::fetch_scanblock_latency.get());
 
   HT_DEBUG_OUT <<"Scanner ID = " << scanner_id << HT_END;
 
@@ -1696,6 +1824,8 @@ Apps::RangeServer::fetch_scanblock(Response::Callback::CreateScanner *cb,
     profile_data.bytes_scanned = scanner->get_input_bytes();
     profile_data.bytes_returned = scanner->get_output_bytes();
     profile_data.disk_read = scanner->get_disk_read();
+    profile_data.cells_filtered_pushdown = scanner->get_pushdown_filtered_cells();
+    profile_data.cells_filtered_merge = scanner->get_merge_filtered_cells();
 
     int64_t output_cells = scanner->get_output_cells();
 
@@ -1943,6 +2073,12 @@ Apps::RangeServer::load_range(ResponseCallback *cb, const TableIdentifier &table
       this_thread::sleep_for(chrono::milliseconds(diff));
     }
 
+    // Drop results cached before the range was last relinquished, updates
+    // applied elsewhere in the meantime never invalidated them
+    if (Global::range_scan_cache)
+      Global::range_scan_cache->invalidate(table.id, range_spec.start_row,
+                                           range_spec.end_row);
+
     m_context->live_map->promote_staged_range(table, range, range_state.transfer_log);
 
     HT_MAYBE_FAIL_X("user-load-range-4", !table.is_system());
@@ -2294,6 +2430,10 @@ void Apps::RangeServer::dump(ResponseCallback *cb, const char *outfile,
     if (m_query_cache)
       m_query_cache->dump_keys(out);
 
+    // Range Scan Cache
+    if (Global::range_scan_cache)
+      Global::range_scan_cache->dump_keys(out);
+
     // Dump AccessGroup garbage tracker statistics
     out << "\nGarbage tracker statistics:\n";
     for (RangeData &rd : ranges.array) {
@@ -2781,6 +2921,36 @@ void
   m_ganglia_collector->update("compactions.merging", load_stats.compactions_merging);
   m_ganglia_collector->update("compactions.gc", load_stats.compactions_gc);
 
+  if (Global::compaction_throttle) {
+    CompactionThrottle::Statistics throttle_stats;
+    Global::compaction_throttle->get_statistics(&throttle_stats);
+    int64_t throttled_bytes = 0;
+    for (int i=0; i<CompactionThrottle::CLASS_COUNT; i++)
+      throttled_bytes += throttle_stats.bytes[i];
+    m_ganglia_collector->update("compactions.throttle.rate",
+                                (float)throttle_stats.rate / (float)MiB);
+    m_ganglia_collector->update("compactions.throttle.debt",
+                                (float)throttle_stats.debt / (float)MiB);
+    m_ganglia_collector->update("compactions.throttle.throughput",
+                                ((float)throttled_bytes / (float)MiB) / period_seconds);
+  }
+
+  // Latency percentiles (milliseconds) over the collection interval
+  for (size_t i=0; i<m_latency_histograms.size(); i++) {
+    LatencyHistogram::Snapshot snapshot;
+    m_latency_histograms[i]->snapshot(&snapshot);
+    LatencyHistogram::Snapshot interval = snapshot;
+    interval.subtract(m_latency_snapshots[i]);
+    m_latency_snapshots[i] = snapshot;
+    string prefix = "latency." + m_latency_histograms[i]->name();
+    m_ganglia_collector->update(prefix + ".p50",
+                                (float)interval.percentile(50) / 1000.0f);
+    m_ganglia_collector->update(prefix + ".p99",
+                                (float)interval.percentile(99) / 1000.0f);
+    m_ganglia_collector->update(prefix + ".max",
+                                (float)interval.max / 1000.0f);
+  }
+
   m_ganglia_collector->update("scanners",
                             m_stats->scanner_count);
   m_ganglia_collector->update("cellstores",
@@ -2916,6 +3086,53 @@ Apps::RangeServer::relinquish_range(ResponseCallback *cb,
   }
 }
 
+void
+Apps::RangeServer::adopt_cellstores(ResponseCallback *cb,
+        const TableIdentifier &table, const RangeSpec &range_spec,
+        const vector<pair<String, String>> &files) {
+  TableInfoPtr table_info;
+  RangePtr range;
+  std::stringstream sout;
+
+  sout << "adopt_cellstores\n" << table << range_spec << "files="
+       << files.size();
+  HT_INFOF("%s", sout.str().c_str());
+
+  if (!m_log_replay_barrier->wait(cb->event()->deadline(), table, range_spec))
+    return;
+
+  try {
+    if (!m_context->live_map->lookup(table.id, table_info)) {
+      cb->error(Error::TABLE_NOT_FOUND, table.id);
+      return;
+    }
+
+    if (!table_info->get_range(range_spec, range))
+      HT_THROW(Error::RANGESERVER_RANGE_NOT_FOUND,
+              format("%s[%s..%s]", table.id, range_spec.start_row,
+                  range_spec.end_row));
+
+    range->adopt_cellstores(files);
+
+    if (m_query_cache)
+      m_query_cache->invalidate(table.id, range_spec.start_row,
+                                range_spec.end_row);
+    if (Global::range_scan_cache)
+      Global::range_scan_cache->invalidate(table.id, range_spec.start_row,
+                                           range_spec.end_row);
+
+    HT_MAYBE_FAIL("adopt-cellstores-1");
+
+    cb->response_ok();
+  }
+  catch (Hypertable::Exception &e) {
+    int error = 0;
+    HT_INFOF("%s - %s", Error::get_text(e.code()), e.what());
+    if (cb && (error = cb->error(e.code(), e.what())) != Error::OK)
+      HT_ERRORF("Problem sending error response - %s", Error::get_text(error));
+  }
+}
+
 void Apps::RangeServer::replay_fragments(ResponseCallback *cb, int64_t op_id,
         const String &location, int32_t plan_generation, 
         int32_t type, const vector<int32_t> &fragments,
@@ -3565,6 +3782,12 @@ void Apps::RangeServer::phantom_commit_ranges(ResponseCallback *cb, int64_t op_i
                      << our_location << HT_END;
       }
 
+      // Drop results cached while this server last held the range, updates
+      // applied by the failed server never invalidated them
+      if (Global::range_scan_cache)
+        Global::range_scan_cache->invalidate(rr.table.id, rr.range.start_row,
+                                             rr.range.end_row);
+
       phantom_range->set_committed();
     }
 
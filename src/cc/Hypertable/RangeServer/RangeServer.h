@@ -143,6 +143,20 @@ namespace Apps {
 
     void relinquish_range(ResponseCallback *, const TableIdentifier &,
                           const RangeSpec &);
+
+    /// Adopts bulk loaded cell stores into a range.
+    /// Looks up the range identified by <code>table</code> and
+    /// <code>range_spec</code>, calls Range::adopt_cellstores() with
+    /// <code>files</code>, and invalidates any query cache entries for the
+    /// range.
+    /// @param cb Response callback
+    /// @param table %Table identifier
+    /// @param range_spec Range specification
+    /// @param files Vector of (access group name, cell store path) pairs
+    void adopt_cellstores(ResponseCallback *cb, const TableIdentifier &table,
+                          const RangeSpec &range_spec,
+                          const std::vector<std::pair<String, String>> &files);
+
     void heapcheck(ResponseCallback *, const char *);
 
     void metadata_sync(ResponseCallback *, const char *, uint32_t flags, std::vector<const char *> columns);
@@ -211,7 +225,10 @@ namespace Apps {
       return m_log_replay_barrier->user_complete();
     }
 
-    void status(Response::Callback::Status *cb);
+    /// Returns server status.
+    /// @param cb Response callback
+    /// @param flags Status flags (see Lib::RangeServer::Protocol::StatusFlags)
+    void status(Response::Callback::Status *cb, int32_t flags=0);
 
     void shutdown();
 
@@ -234,6 +251,9 @@ namespace Apps {
     void replay_load_range(TableInfoMap &replay_map,
                            MetaLogEntityRangePtr &range_entity);
     void replay_log(TableInfoMap &replay_map, CommitLogReaderPtr &log_reader);
+    void replay_log_parallel(TableInfoMap &replay_map,
+                             CommitLogReaderPtr &log_reader,
+                             int32_t thread_count);
 
     void verify_schema(TableInfoPtr &, uint32_t generation, const TableSchemaMap *table_schemas=0);
 
@@ -244,6 +264,12 @@ namespace Apps {
                           SchemaPtr &schema, const TableIdentifier &table,
                           uint32_t count, StaticBuffer &buffer, uint32_t flags);
 
+    /// Formats latency histograms for the <i>status</i> command.
+    /// Produces one line per histogram with the sample count, mean,
+    /// percentiles and maximum (milliseconds) since server start.
+    /// @return Latency histogram report
+    std::string latency_report();
+
     /** Performs a "test and set" operation on #m_get_statistics_outstanding
      * @param value New value for #m_get_statistics_outstanding
      * @return Previous value of #m_get_statistics_outstanding
@@ -347,6 +373,12 @@ namespace Apps {
     /// Ganglia metrics collector
     MetricsCollectorGangliaPtr m_ganglia_collector;
 
+    /// Latency histograms exported as metrics
+    std::vector<LatencyHistogram *> m_latency_histograms;
+
+    /// Latency histogram snapshots taken at last metrics collection
+    std::vector<LatencyHistogram::Snapshot> m_latency_snapshots;
+
     /// Process metrics
     MetricsProcess m_metrics_process;
   };
@@ -23,6 +23,7 @@
 
 #include "CreateScanner.h"
 
+#include <Hypertable/RangeServer/Global.h>
 #include <Hypertable/RangeServer/QueryCache.h>
 #include <Hypertable/RangeServer/RangeServer.h>
 
@@ -50,7 +51,8 @@ void CreateScanner::run() {
     const uint8_t *base = ptr;
     params.decode(&ptr, &remain);
 
-    if (params.scan_spec().cacheable()) {
+    if (params.scan_spec().cacheable() ||
+        (Global::range_scan_cache && params.scan_spec().range_cacheable())) {
       md5_csum((unsigned char *)base, ptr-base,
                reinterpret_cast<unsigned char *>(key.digest));
       m_range_server->create_scanner(&cb, params.table(), params.range_spec(),
@@ -26,6 +26,8 @@
 #include <Hypertable/RangeServer/RangeServer.h>
 #include <Hypertable/RangeServer/Response/Callback/Status.h>
 
+#include <Hypertable/Lib/RangeServer/Request/Parameters/Status.h>
+
 #include <AsyncComm/ResponseCallback.h>
 
 using namespace Hypertable;
@@ -35,7 +37,16 @@ void Request::Handler::Status::run() {
   Response::Callback::Status cb(m_comm, m_event);
 
   try {
-    m_range_server->status(&cb);
+    int32_t flags {};
+    // Older clients send an empty payload
+    if (m_event->payload_len) {
+      const uint8_t *ptr = m_event->payload;
+      size_t remain = m_event->payload_len;
+      Lib::RangeServer::Request::Parameters::Status params;
+      params.decode(&ptr, &remain);
+      flags = params.flags();
+    }
+    m_range_server->status(&cb, flags);
   }
   catch (Exception &e) {
     HT_ERROR_OUT << e << HT_END;
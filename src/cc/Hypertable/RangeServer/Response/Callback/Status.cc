@@ -38,10 +38,11 @@
 using namespace Hypertable;
 using namespace Hypertable::RangeServer;
 
-int Response::Callback::Status::response(Hypertable::Status &status) {
+int Response::Callback::Status::response(Hypertable::Status &status,
+                                         const std::string &latency_report) {
   CommHeader header;
   header.initialize_from_request_header(m_event->header);
-  Lib::RangeServer::Response::Parameters::Status params(status);
+  Lib::RangeServer::Response::Parameters::Status params(status, latency_report);
   CommBufPtr cbuf(new CommBuf(header, 4+params.encoded_length()));
   cbuf->append_i32(Error::OK);
   params.encode(cbuf->get_data_ptr_address());
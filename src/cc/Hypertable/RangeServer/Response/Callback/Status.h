@@ -34,6 +34,8 @@
 #include <Common/StaticBuffer.h>
 #include <Common/Status.h>
 
+#include <string>
+
 namespace Hypertable {
 namespace RangeServer {
 namespace Response {
@@ -55,8 +57,10 @@ namespace Callback {
 
     /// Sends response parameters back to client.
     /// @param status Status information
+    /// @param latency_report Latency histogram report (omitted if empty)
     /// @return Error code returned by Comm::send_result
-    int response(Hypertable::Status &status);
+    int response(Hypertable::Status &status,
+                 const std::string &latency_report = "");
 
   };
 
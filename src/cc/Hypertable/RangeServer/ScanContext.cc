@@ -398,5 +398,24 @@ ScanContext::initialize(int64_t rev, const ScanSpec *ss,
         cell_predicates[cf_spec->get_id()].indexed = cf_spec->get_value_index() || cf_spec->get_qualifier_index();
       }
     }
+
+    // Predicates can only be pushed down into the cell store and cell cache
+    // scanners if dropping a cell early can't change the outcome of the
+    // merge, i.e. no version limit (versions are counted before predicates
+    // are applied) and no counter accumulation
+    for (size_t i=1; i<256; i++) {
+      CellPredicate &cp = cell_predicates[i];
+      cp.pushdown = family_mask[i] && !cp.counter && cp.max_versions == 0 &&
+        (cp.has_patterns() || value_regexp);
+      if (cp.pushdown)
+        pushdown = true;
+    }
+
+    // Values can't be dropped if a predicate needs them
+    keys_only = spec->keys_only && !value_regexp;
+    for (size_t i=1; i<256 && keys_only; i++) {
+      if (family_mask[i] && cell_predicates[i].has_value_patterns())
+        keys_only = false;
+    }
   }
 }
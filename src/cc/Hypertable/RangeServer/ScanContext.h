@@ -72,6 +72,10 @@ namespace Hypertable {
     vector<CellPredicate> cell_predicates;
     RE2 *row_regexp;
     RE2 *value_regexp;
+    bool pushdown;
+    /// Cell values can be dropped by the cell store and cell cache scanners
+    /// (keys only scan that evaluates no value predicate or value regexp)
+    bool keys_only;
     typedef std::set<const char *, LtCstr, CstrAlloc> CstrRowSet;
     CstrRowSet rowset;
     uint32_t timeout_ms;
@@ -87,7 +91,9 @@ namespace Hypertable {
      */
     ScanContext(int64_t rev, const ScanSpec *ss, const RangeSpec *range,
                 SchemaPtr &schema, std::set<uint8_t> *columns=0) :
-      cell_predicates(256), row_regexp(0), value_regexp(0), timeout_ms(0) {
+      cell_predicates(256), row_regexp(0), value_regexp(0), pushdown(false),
+        keys_only(false),
+        timeout_ms(0) {
       initialize(rev, ss, range, schema, columns);
     }
 
@@ -98,7 +104,9 @@ namespace Hypertable {
      * @param schema smart pointer to schema object
      */
     ScanContext(int64_t rev, SchemaPtr &schema)
-      : cell_predicates(256), row_regexp(0), value_regexp(0), timeout_ms(0) {
+      : cell_predicates(256), row_regexp(0), value_regexp(0), pushdown(false),
+        keys_only(false),
+        timeout_ms(0) {
       initialize(rev, 0, 0, schema);
     }
 
@@ -108,7 +116,9 @@ namespace Hypertable {
      * @param rev scan revision
      */
     ScanContext(int64_t rev=TIMESTAMP_MAX) 
-      : cell_predicates(256), row_regexp(0), value_regexp(0), timeout_ms(0) {
+      : cell_predicates(256), row_regexp(0), value_regexp(0), pushdown(false),
+        keys_only(false),
+        timeout_ms(0) {
       SchemaPtr schema;
       initialize(rev, 0, 0, schema);
     }
@@ -119,7 +129,9 @@ namespace Hypertable {
      * @param schema smart pointer to schema object
      */
     ScanContext(SchemaPtr &schema) 
-      : cell_predicates(256), row_regexp(0), value_regexp(0), timeout_ms(0) {
+      : cell_predicates(256), row_regexp(0), value_regexp(0), pushdown(false),
+        keys_only(false),
+        timeout_ms(0) {
       initialize(TIMESTAMP_MAX, 0, 0, schema);
     }
 
@@ -132,6 +144,39 @@ namespace Hypertable {
       }
     }
 
+    /**
+     * Checks if a cell can be dropped by a cell store or cell cache scanner
+     * before it reaches the merge.  Only inserts in families whose predicate
+     * has CellPredicate::pushdown set are considered; the column predicates
+     * and value regexp are evaluated exactly as they are in
+     * MergeScannerAccessGroup.  If the value has been stripped (keys only
+     * scan) and the predicate needs it, the cell is passed through.
+     *
+     * @param key cell key
+     * @param value cell value
+     * @return <i>true</i> if the cell fails the predicate and can be dropped,
+     * <i>false</i> otherwise
+     */
+    bool pushdown_filter(const Key &key, const ByteString &value) {
+      if (key.flag != FLAG_INSERT)
+        return false;
+      CellPredicate &cp = cell_predicates[key.column_family_code];
+      if (!cp.pushdown)
+        return false;
+      const uint8_t *vptr = 0;
+      size_t vlen = 0;
+      if (value.ptr)
+        vlen = value.decode_length(&vptr);
+      else if (cp.has_value_patterns() || value_regexp)
+        return false;
+      if (!cp.matches(key.column_qualifier, key.column_qualifier_len,
+                      (const char *)vptr, vlen))
+        return true;
+      return value_regexp &&
+        !RE2::PartialMatch(re2::StringPiece((const char *)vptr, vlen),
+                           *value_regexp);
+    }
+
     void deep_copy_specs() {
       scan_spec_builder = *spec;
       spec = &scan_spec_builder.get();
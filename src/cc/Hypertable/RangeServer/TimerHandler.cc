@@ -52,7 +52,8 @@ TimerHandler::TimerHandler(Comm *comm, Apps::RangeServer *range_server)
   : m_comm(comm), m_range_server(range_server) {
   int32_t maintenance_interval;
 
-  m_query_cache_memory = get_i64("Hypertable.RangeServer.QueryCache.MaxMemory");
+  m_query_cache_memory = get_i64("Hypertable.RangeServer.QueryCache.MaxMemory") +
+    get_i64("Hypertable.RangeServer.RangeScanCache.MaxMemory");
   m_timer_interval = get_i32("Hypertable.RangeServer.Timer.Interval");
   maintenance_interval = get_i32("Hypertable.RangeServer.Maintenance.Interval");
   m_userlog_size_threshold = (int64_t)((double)Global::log_prune_threshold_max * 1.2);
@@ -60,7 +60,9 @@ namespace Hypertable {
   public:
     /// Constructor.
     /// Initializes the timer handler by setting #m_query_cache_memory to the
-    /// property <code>Hypertable.RangeServer.QueryCache.MaxMemory</code>,
+    /// sum of the properties
+    /// <code>Hypertable.RangeServer.QueryCache.MaxMemory</code> and
+    /// <code>Hypertable.RangeServer.RangeScanCache.MaxMemory</code>,
     /// #m_userlog_size_threshold to 20% larger than the maximum log prune
     /// threshold, m_max_app_queue_pause to the property
     /// <code>Hypertable.RangeServer.Maintenance.MaxAppQueuePause</code>,
@@ -166,6 +168,8 @@ namespace Hypertable {
     ApplicationQueuePtr m_app_queue;
 
     /// Query cache max size (Hypertable.RangeServer.QueryCache.MaxMemory)
+    /// plus range scan cache max size
+    /// (Hypertable.RangeServer.RangeScanCache.MaxMemory)
     int64_t m_query_cache_memory {};
     
     /// Pause app queue if USER log exceeds this size
@@ -27,6 +27,7 @@
 #include <Common/Compat.h>
 #include "UpdatePipeline.h"
 
+#include <Hypertable/RangeServer/ContainingRangeCache.h>
 #include <Hypertable/RangeServer/Global.h>
 #include <Hypertable/RangeServer/Response/Callback/Update.h>
 #include <Hypertable/RangeServer/UpdateContext.h>
@@ -42,8 +43,12 @@
 #include <Common/Serialization.h>
 
 #include <chrono>
+#include <map>
 #include <set>
 #include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 using namespace Hypertable;
 using namespace Hypertable::RangeServer;
@@ -55,6 +60,7 @@ UpdatePipeline::UpdatePipeline(ContextPtr &context, QueryCachePtr &query_cache,
   m_context(context), m_query_cache(query_cache),
   m_timer_handler(timer_handler), m_log(log), m_flags(flags) {
   m_update_coalesce_limit = m_context->props->get_i64("Hypertable.RangeServer.UpdateCoalesceLimit");
+  m_update_coalesce_window = m_context->props->get_i32("Hypertable.RangeServer.UpdateCoalesceWindow");
   m_maintenance_pause_interval = m_context->props->get_i32("Hypertable.RangeServer.Testing.MaintenanceNeeded.PauseInterval");
   m_update_delay = m_context->props->get_i32("Hypertable.RangeServer.UpdateDelay", 0);
   m_max_clock_skew = m_context->props->get_i32("Hypertable.RangeServer.ClockSkew.Max");
@@ -87,7 +93,11 @@ void UpdatePipeline::qualify_and_transform() {
   SerializedKey key;
   const uint8_t *mod, *mod_end;
   const char *row;
-  String start_row, end_row;
+  ContainingRangeCache range_cache;
+  const String &start_row = range_cache.start_row();
+  const String &end_row = range_cache.end_row();
+  String range_start_row, range_end_row;
+  SchemaPtr schema;
   UpdateRecRangeList *rulist;
   int error = Error::OK;
   int64_t latest_range_revision;
@@ -99,7 +109,7 @@ void UpdatePipeline::qualify_and_transform() {
   uint32_t root_buf_reset_offset;
   CommitLogPtr transfer_log;
   UpdateRecRange range_update;
-  RangePtr range;
+  bool newly_blocked;
   std::mutex &mutex = m_qualify_queue_mutex;
   condition_variable &cond = m_qualify_queue_cond;
   std::list<UpdateContext *> &queue = m_qualify_queue;
@@ -115,6 +125,8 @@ void UpdatePipeline::qualify_and_transform() {
       queue.pop_front();
     }
 
+    auto qualify_start = chrono::steady_clock::now();
+
     rulist = 0;
     transfer_bufp = 0;
     go_buf_reset_offset = 0;
@@ -176,6 +188,11 @@ void UpdatePipeline::qualify_and_transform() {
       table_update->id.encode(&table_update->go_buf.ptr);
       table_update->go_buf.set_mark();
 
+      // Generation was verified above, so use the same schema for all cells
+      schema = table_update->table_info->get_schema();
+
+      range_cache.reset();
+
       for (UpdateRequest *request : table_update->requests) {
         uc->total_updates++;
 
@@ -220,10 +237,10 @@ void UpdatePipeline::qualify_and_transform() {
             continue;
           }
 
-          // Look for containing range, add to stop mods if not found
-          if (!table_update->table_info->find_containing_range(row, range,
-                                                          start_row, end_row) ||
-              range->get_relinquish()) {
+          // Look for containing range, add to stop mods if not found.  Rows
+          // are sorted, so this is usually satisfied by the cached range.
+          if (!range_cache.find(*table_update->table_info, row) ||
+              range_cache.range()->get_relinquish()) {
             if (uc->send_back.error != Error::RANGESERVER_OUT_OF_RANGE
                 && uc->send_back.count > 0) {
               uc->send_back.len = (mod - request->buffer.base) - uc->send_back.offset;
@@ -241,10 +258,13 @@ void UpdatePipeline::qualify_and_transform() {
             continue;
           }
 
-          if ((rulist = table_update->range_map[range.get()]) == 0) {
-            rulist = new UpdateRecRangeList();
-            rulist->range = range;
-            table_update->range_map[range.get()] = rulist;
+          if (rulist == 0 || rulist->range != range_cache.range()) {
+            Range *range = range_cache.range().get();
+            if ((rulist = table_update->range_map[range]) == 0) {
+              rulist = new UpdateRecRangeList();
+              rulist->range = range_cache.range();
+              table_update->range_map[range] = rulist;
+            }
           }
 
           // See if range has some other error preventing it from receiving updates
@@ -275,6 +295,7 @@ void UpdatePipeline::qualify_and_transform() {
            *  Increment update count on range
            *  (block if maintenance in progress)
            */
+          newly_blocked = false;
           if (!rulist->range_blocked) {
             if (!rulist->range->increment_update_counter()) {
               uc->send_back.error = Error::RANGESERVER_RANGE_NOT_FOUND;
@@ -286,17 +307,21 @@ void UpdatePipeline::qualify_and_transform() {
               continue;
             }
             rulist->range_blocked = true;
+            newly_blocked = true;
           }
 
-          String range_start_row, range_end_row;
-          rulist->range->get_boundary_rows(range_start_row, range_end_row);
-
-          // Make sure range didn't just shrink
-          if (range_start_row != start_row || range_end_row != end_row) {
-            rulist->range->decrement_update_counter();
-            table_update->range_map.erase(rulist->range.get());
-            delete rulist;
-            continue;
+          // Make sure range didn't just shrink.  Shrinking blocks updates, so
+          // once the update counter is held the boundaries can't change.
+          if (newly_blocked) {
+            rulist->range->get_boundary_rows(range_start_row, range_end_row);
+            if (range_start_row != start_row || range_end_row != end_row) {
+              rulist->range->decrement_update_counter();
+              table_update->range_map.erase(rulist->range.get());
+              delete rulist;
+              rulist = 0;
+              range_cache.invalidate();
+              continue;
+            }
           }
 
           /** Fetch range transfer information **/
@@ -376,7 +401,7 @@ void UpdatePipeline::qualify_and_transform() {
           range_update.offset = cur_bufp->fill();
 
           while (mod < mod_end &&
-                 (end_row == "" || (strcmp(row, end_row.c_str()) <= 0))) {
+                 (end_row.empty() || (strcmp(row, end_row.c_str()) <= 0))) {
 
             if (transfer_pending) {
 
@@ -404,7 +429,6 @@ void UpdatePipeline::qualify_and_transform() {
             }
 
             try {
-              SchemaPtr schema = table_update->table_info->get_schema();
               uint8_t family=*(key.ptr+1+strlen((const char *)key.ptr+1)+1);
               ColumnFamilySpec *cf_spec = schema->get_column_family(family);
 
@@ -501,8 +525,15 @@ void UpdatePipeline::qualify_and_transform() {
         uc->total_added += table_update->total_added;
     }
 
+    // Don't hold on to ranges or schemas between update contexts
+    range_cache.reset();
+    schema.reset();
+
     uc->last_revision = m_last_revision;
 
+    if (Global::update_qualify_latency)
+      Global::update_qualify_latency->record_since(qualify_start);
+
     // Enqueue update
     {
       lock_guard<std::mutex> lock(m_commit_queue_mutex);
@@ -514,101 +545,118 @@ void UpdatePipeline::qualify_and_transform() {
 }
 
 void UpdatePipeline::commit() {
-  UpdateContext *uc;
-  SerializedKey key;
-  std::list<UpdateContext *> coalesce_queue;
-  uint64_t coalesce_amount = 0;
+  std::list<UpdateContext *> batch;
   int error = Error::OK;
   uint32_t committed_transfer_data;
   bool log_needs_syncing {};
 
   while (true) {
 
-    // Dequeue next update
+    // Dequeue batch of updates
     {
       unique_lock<std::mutex> lock(m_commit_queue_mutex);
       m_commit_queue_cond.wait(lock, [this](){
           return !m_commit_queue.empty() || m_shutdown; });
       if (m_shutdown)
         return;
-      uc = m_commit_queue.front();
-      m_commit_queue.pop_front();
-      m_commit_queue_count--;
+
+      // Give concurrent requests a chance to join a lone update
+      if (m_update_coalesce_window > 0 && m_commit_queue.size() == 1) {
+        m_commit_queue_cond.wait_for(lock, chrono::microseconds(m_update_coalesce_window),
+                                     [this](){ return m_commit_queue.size() > 1 || m_shutdown; });
+        if (m_shutdown)
+          return;
+      }
+
+      uint64_t coalesce_amount = 0;
+      while (!m_commit_queue.empty() &&
+             (batch.empty() || coalesce_amount < m_update_coalesce_limit)) {
+        UpdateContext *uc = m_commit_queue.front();
+        for (UpdateRecTable *table_update : uc->updates)
+          coalesce_amount += table_update->total_buffer_size;
+        batch.push_back(uc);
+        m_commit_queue.pop_front();
+        m_commit_queue_count--;
+      }
     }
 
+    auto commit_start = chrono::steady_clock::now();
+
     committed_transfer_data = 0;
     log_needs_syncing = false;
 
-    // Commit ROOT mutations
-    if (uc->root_buf.ptr > uc->root_buf.mark) {
-      if ((error = Global::root_log->write(ClusterId::get(), uc->root_buf, uc->last_revision, Filesystem::Flags::SYNC)) != Error::OK) {
-        HT_FATALF("Problem writing %d bytes to ROOT commit log - %s",
-                  (int)uc->root_buf.fill(), Error::get_text(error));
-      }
-    }
+    for (UpdateContext *uc : batch) {
 
-    for (UpdateRecTable *table_update : uc->updates) {
+      // Commit ROOT mutations
+      if (uc->root_buf.ptr > uc->root_buf.mark) {
+        if ((error = Global::root_log->write(ClusterId::get(), uc->root_buf, uc->last_revision, Filesystem::Flags::SYNC)) != Error::OK) {
+          HT_FATALF("Problem writing %d bytes to ROOT commit log - %s",
+                    (int)uc->root_buf.fill(), Error::get_text(error));
+        }
+      }
 
-      coalesce_amount += table_update->total_buffer_size;
-
-      // Iterate through all of the ranges, committing any transferring updates
-      for (auto iter = table_update->range_map.begin(); iter != table_update->range_map.end(); ++iter) {
-        if ((*iter).second->transfer_buf.ptr > (*iter).second->transfer_buf.mark) {
-          committed_transfer_data += (*iter).second->transfer_buf.ptr - (*iter).second->transfer_buf.mark;
-          if ((error = (*iter).second->transfer_log->write(ClusterId::get(), (*iter).second->transfer_buf,
-                                                           (*iter).second->latest_transfer_revision,
-                                                           m_flags)) != Error::OK) {
-            table_update->error = error;
-            table_update->error_msg = format("Problem writing %d bytes to transfer log",
-                                             (int)(*iter).second->transfer_buf.fill());
-            HT_ERRORF("%s - %s", table_update->error_msg.c_str(), Error::get_text(error));
-            break;
+      for (UpdateRecTable *table_update : uc->updates) {
+
+        // Iterate through all of the ranges, committing any transferring updates
+        for (auto iter = table_update->range_map.begin(); iter != table_update->range_map.end(); ++iter) {
+          if ((*iter).second->transfer_buf.ptr > (*iter).second->transfer_buf.mark) {
+            committed_transfer_data += (*iter).second->transfer_buf.ptr - (*iter).second->transfer_buf.mark;
+            if ((error = (*iter).second->transfer_log->write(ClusterId::get(), (*iter).second->transfer_buf,
+                                                             (*iter).second->latest_transfer_revision,
+                                                             m_flags)) != Error::OK) {
+              table_update->error = error;
+              table_update->error_msg = format("Problem writing %d bytes to transfer log",
+                                               (int)(*iter).second->transfer_buf.fill());
+              HT_ERRORF("%s - %s", table_update->error_msg.c_str(), Error::get_text(error));
+              break;
+            }
           }
         }
-      }
 
-      if (table_update->error != Error::OK)
-        continue;
+        if (table_update->error != Error::OK)
+          continue;
 
-      constexpr uint32_t NO_LOG_SYNC_FLAGS = 
-        Lib::RangeServer::Protocol::UPDATE_FLAG_NO_LOG_SYNC |
-        Lib::RangeServer::Protocol::UPDATE_FLAG_NO_LOG;
+        constexpr uint32_t NO_LOG_SYNC_FLAGS = 
+          Lib::RangeServer::Protocol::UPDATE_FLAG_NO_LOG_SYNC |
+          Lib::RangeServer::Protocol::UPDATE_FLAG_NO_LOG;
 
-      if ((table_update->flags & NO_LOG_SYNC_FLAGS) == 0)
-        log_needs_syncing = true;
-
-      // Commit valid (go) mutations
-      if ((table_update->flags & Lib::RangeServer::Protocol::UPDATE_FLAG_NO_LOG) == 0 &&
-          table_update->go_buf.ptr > table_update->go_buf.mark) {
-
-        if ((error = m_log->write(ClusterId::get(), table_update->go_buf, uc->last_revision, Filesystem::Flags::NONE)) != Error::OK) {
-          table_update->error_msg = format("Problem writing %d bytes to commit log (%s) - %s",
-                                           (int)table_update->go_buf.fill(),
-                                           m_log->get_log_dir().c_str(),
-                                           Error::get_text(error));
-          HT_ERRORF("%s", table_update->error_msg.c_str());
-          table_update->error = error;
-          continue;
-        }
+        if ((table_update->flags & NO_LOG_SYNC_FLAGS) == 0)
+          log_needs_syncing = true;
       }
-
     }
 
-    bool do_sync = false;
-    if (log_needs_syncing) {
-      if (m_commit_queue_count > 0 && coalesce_amount < m_update_coalesce_limit) {
-        coalesce_queue.push_back(uc);
-        continue;
+    // Write one commit log block per table generation
+    CommitBlockMap blocks;
+    build_commit_blocks(batch, blocks);
+    for (auto &entry : blocks) {
+      CommitBlock &block = entry.second;
+      DynamicBuffer &buf = block.buffer();
+      if ((error = m_log->write(ClusterId::get(), buf, block.revision, Filesystem::Flags::NONE)) != Error::OK) {
+        String error_msg = format("Problem writing %d bytes to commit log (%s) - %s",
+                                  (int)buf.fill(),
+                                  m_log->get_log_dir().c_str(),
+                                  Error::get_text(error));
+        HT_ERRORF("%s", error_msg.c_str());
+        for (UpdateRecTable *table_update : block.table_updates) {
+          table_update->error = error;
+          table_update->error_msg = error_msg;
+        }
       }
-      do_sync = true;
     }
-    else if (!coalesce_queue.empty())
-      do_sync = true;
+
+    if (Global::update_commit_latency)
+      Global::update_commit_latency->record_since(commit_start);
 
     // Now sync the commit log if needed
-    if (do_sync) {
+    if (log_needs_syncing) {
+      LatencyHistogram::ScopedTimer sync_timer(Global::update_sync_latency.get());
       size_t retry_count {};
-      uc->total_syncs++;
+
+      // One sync per synced commit log write
+      for (auto &entry : blocks) {
+        if (entry.second.sync)
+          entry.second.owner->total_syncs++;
+      }
 
       while (true) {
 
@@ -633,187 +681,284 @@ void UpdatePipeline::commit() {
       }
     }
 
-    // Enqueue update
+    // Enqueue updates
     {
       lock_guard<std::mutex> lock(m_response_queue_mutex);
-      coalesce_queue.push_back(uc);
-      while (!coalesce_queue.empty()) {
-        uc = coalesce_queue.front();
-        coalesce_queue.pop_front();
-        m_response_queue.push_back(uc);
-      }
-      coalesce_amount = 0;
+      m_response_queue.splice(m_response_queue.end(), batch);
       m_response_queue_cond.notify_all();
     }
   }
 }
 
+void UpdatePipeline::build_commit_blocks(std::list<UpdateContext *> &batch,
+                                         CommitBlockMap &blocks) {
+  constexpr uint32_t NO_LOG_SYNC_FLAGS =
+    Lib::RangeServer::Protocol::UPDATE_FLAG_NO_LOG_SYNC |
+    Lib::RangeServer::Protocol::UPDATE_FLAG_NO_LOG;
+
+  for (UpdateContext *uc : batch) {
+    for (UpdateRecTable *table_update : uc->updates) {
+      if (table_update->error != Error::OK ||
+          (table_update->flags & Lib::RangeServer::Protocol::UPDATE_FLAG_NO_LOG) ||
+          table_update->go_buf.ptr <= table_update->go_buf.mark)
+        continue;
+      CommitBlock &block = blocks[make_pair(String(table_update->id.id),
+                                            table_update->id.generation)];
+      if (block.table_updates.empty())
+        block.owner = uc;
+      block.table_updates.push_back(table_update);
+      if (uc->last_revision > block.revision)
+        block.revision = uc->last_revision;
+      if ((table_update->flags & NO_LOG_SYNC_FLAGS) == 0)
+        block.sync = true;
+    }
+  }
+
+  // Merge blocks with more than one contributor
+  for (auto &entry : blocks) {
+    CommitBlock &block = entry.second;
+    if (block.table_updates.size() == 1)
+      continue;
+    size_t length = block.table_updates.front()->id.encoded_length();
+    for (UpdateRecTable *table_update : block.table_updates)
+      length += table_update->go_buf.ptr - table_update->go_buf.mark;
+    block.merged.reserve(length);
+    block.table_updates.front()->id.encode(&block.merged.ptr);
+    block.merged.set_mark();
+    for (UpdateRecTable *table_update : block.table_updates)
+      block.merged.add_unchecked(table_update->go_buf.mark,
+                                 table_update->go_buf.ptr - table_update->go_buf.mark);
+  }
+}
+
 void UpdatePipeline::add_and_respond() {
-  UpdateContext *uc;
+  std::list<UpdateContext *> batch;
   SerializedKey key;
   int error = Error::OK;
 
   while (true) {
 
-    // Dequeue next update
+    // Dequeue batch of updates, bounded so that range locks are not held
+    // for more than the coalesce limit worth of updates
     {
       unique_lock<std::mutex> lock(m_response_queue_mutex);
       m_response_queue_cond.wait(lock, [this](){
           return !m_response_queue.empty() || m_shutdown; });
       if (m_shutdown)
         return;
-      uc = m_response_queue.front();
-      m_response_queue.pop_front();
+      uint64_t coalesce_amount = 0;
+      while (!m_response_queue.empty() &&
+             (batch.empty() || coalesce_amount < m_update_coalesce_limit)) {
+        UpdateContext *uc = m_response_queue.front();
+        for (UpdateRecTable *table_update : uc->updates)
+          coalesce_amount += table_update->total_buffer_size;
+        batch.push_back(uc);
+        m_response_queue.pop_front();
+      }
     }
 
+    auto respond_start = chrono::steady_clock::now();
+
     /**
-     *  Insert updates into Ranges
+     *  Group updates by range so that each range is locked once
      */
-    for (UpdateRecTable *table_update : uc->updates) {
+    struct RangeUpdate {
+      UpdateContext *uc;
+      UpdateRecTable *table_update;
+      UpdateRecRange *update;
+    };
+    std::unordered_map<Range *, std::vector<RangeUpdate>> range_updates;
+    for (UpdateContext *uc : batch) {
+      for (UpdateRecTable *table_update : uc->updates) {
+        for (auto iter = table_update->range_map.begin(); iter != table_update->range_map.end(); ++iter) {
+          for (UpdateRecRange &update : (*iter).second->updates)
+            range_updates[(*iter).first].push_back({uc, table_update, &update});
+        }
+      }
+    }
 
-      // Iterate through all of the ranges, inserting updates
-      for (auto iter = table_update->range_map.begin(); iter != table_update->range_map.end(); ++iter) {
-        ByteString value;
-        Key key_comps;
-
-        for (UpdateRecRange &update : (*iter).second->updates) {
-          Range *rangep = (*iter).first;
-          lock_guard<Range> lock(*rangep);
-          uint8_t *ptr = update.bufp->base + update.offset;
-          uint8_t *end = ptr + update.len;
-
-          if (!table_update->id.is_metadata())
-            uc->total_bytes_added += update.len;
-
-          rangep->add_bytes_written( update.len );
-          std::set<uint8_t> columns;
-          bool invalidate {};
-          const char *current_row {};
-          uint64_t count = 0;
-          while (ptr < end) {
-            key.ptr = ptr;
-            key_comps.load(key);
-            if (current_row == nullptr)
-              current_row = key_comps.row;
-            count++;
-            ptr += key_comps.length;
-            value.ptr = ptr;
-            ptr += value.length();
-            if (key_comps.column_family_code == 0 && key_comps.flag != FLAG_DELETE_ROW) {
-              HT_ERRORF("Skipping bad key - column family not specified in "
-                        "non-delete row update on %s row=%s",
-                        table_update->id.id, key_comps.row);
-              continue;
-            }
-            rangep->add(key_comps, value);
-            // invalidate
-            if (m_query_cache) {
-              if (strcmp(current_row, key_comps.row)) {
-                if (invalidate)
-                  columns.clear();
-                m_query_cache->invalidate(table_update->id.id, current_row, columns);
-                columns.clear();
-                invalidate = false;
-                current_row = key_comps.row;
-              }
-              if (key_comps.flag == FLAG_DELETE_ROW)
-                invalidate = true;
-              else
-                columns.insert(key_comps.column_family_code);
-            }
+    /**
+     *  Insert updates into Ranges
+     */
+    for (auto &entry : range_updates) {
+      Range *rangep = entry.first;
+      ByteString value;
+      Key key_comps;
+      const char *scan_cache_table {};
+      const char *scan_cache_start_row {};
+      const char *scan_cache_end_row {};
+      std::set<uint8_t> scan_cache_columns;
+      bool scan_cache_all_columns {};
+      unique_lock<Range> lock(*rangep);
+
+      for (RangeUpdate &ru : entry.second) {
+        UpdateRecRange &update = *ru.update;
+        UpdateRecTable *table_update = ru.table_update;
+        uint8_t *ptr = update.bufp->base + update.offset;
+        uint8_t *end = ptr + update.len;
+
+        if (!table_update->id.is_metadata())
+          ru.uc->total_bytes_added += update.len;
+
+        rangep->add_bytes_written( update.len );
+        std::set<uint8_t> columns;
+        bool invalidate {};
+        const char *current_row {};
+        uint64_t count = 0;
+        while (ptr < end) {
+          key.ptr = ptr;
+          key_comps.load(key);
+          if (current_row == nullptr)
+            current_row = key_comps.row;
+          count++;
+          ptr += key_comps.length;
+          value.ptr = ptr;
+          ptr += value.length();
+          if (key_comps.column_family_code == 0 && key_comps.flag != FLAG_DELETE_ROW) {
+            HT_ERRORF("Skipping bad key - column family not specified in "
+                      "non-delete row update on %s row=%s",
+                      table_update->id.id, key_comps.row);
+            continue;
           }
-
-          if (m_query_cache && current_row) {
-            if (invalidate)
+          rangep->add(key_comps, value);
+          // track updated row interval for range scan cache invalidation
+          if (Global::range_scan_cache) {
+            scan_cache_table = table_update->id.id;
+            if (scan_cache_start_row == nullptr ||
+                strcmp(key_comps.row, scan_cache_start_row) < 0)
+              scan_cache_start_row = key_comps.row;
+            if (scan_cache_end_row == nullptr ||
+                strcmp(key_comps.row, scan_cache_end_row) > 0)
+              scan_cache_end_row = key_comps.row;
+            if (key_comps.flag == FLAG_DELETE_ROW)
+              scan_cache_all_columns = true;
+            else
+              scan_cache_columns.insert(key_comps.column_family_code);
+          }
+          // invalidate
+          if (m_query_cache) {
+            if (strcmp(current_row, key_comps.row)) {
+              if (invalidate)
+                columns.clear();
+              m_query_cache->invalidate(table_update->id.id, current_row, columns);
               columns.clear();
-            m_query_cache->invalidate(table_update->id.id, current_row, columns);
+              invalidate = false;
+              current_row = key_comps.row;
+            }
+            if (key_comps.flag == FLAG_DELETE_ROW)
+              invalidate = true;
+            else
+              columns.insert(key_comps.column_family_code);
           }
+        }
 
-          rangep->add_cells_written(count);
+        if (m_query_cache && current_row) {
+          if (invalidate)
+            columns.clear();
+          m_query_cache->invalidate(table_update->id.id, current_row, columns);
         }
+
+        rangep->add_cells_written(count);
       }
-    }
 
-    // Decrement usage counters for all referenced ranges
-    for (UpdateRecTable *table_update : uc->updates) {
-      for (auto iter = table_update->range_map.begin(); iter != table_update->range_map.end(); ++iter) {
-        if ((*iter).second->range_blocked)
-          (*iter).first->decrement_update_counter();
+      lock.unlock();
+
+      // Invalidate range scan cache after unlocking, which is when the
+      // updates become visible to new scans (see
+      // Apps::RangeServer::create_scanner)
+      if (scan_cache_start_row) {
+        if (scan_cache_all_columns)
+          scan_cache_columns.clear();
+        Global::range_scan_cache->invalidate(scan_cache_table,
+                                             rangep->end_row().c_str(),
+                                             scan_cache_start_row,
+                                             scan_cache_end_row,
+                                             scan_cache_columns);
       }
     }
 
-    /**
-     * wait for these ranges to complete maintenance
-     */
     bool maintenance_needed = false;
-    for (UpdateRecTable *table_update : uc->updates) {
 
-      /*
-       * If any of the newly updated ranges needs maintenance,
-       * schedule immediately
-       */
-      for (auto iter = table_update->range_map.begin(); iter != table_update->range_map.end(); ++iter) {
-        if ((*iter).first->need_maintenance() &&
-            !Global::maintenance_queue->contains((*iter).first)) {
-          maintenance_needed = true;
-          HT_MAYBE_FAIL_X("metadata-update-and-respond", (*iter).first->is_metadata());
-          if (m_timer_handler)
-            m_timer_handler->schedule_immediate_maintenance();
-          break;
+    for (UpdateContext *uc : batch) {
+
+      // Decrement usage counters for all referenced ranges
+      for (UpdateRecTable *table_update : uc->updates) {
+        for (auto iter = table_update->range_map.begin(); iter != table_update->range_map.end(); ++iter) {
+          if ((*iter).second->range_blocked)
+            (*iter).first->decrement_update_counter();
         }
       }
 
-      for (UpdateRequest *request : table_update->requests) {
-	Response::Callback::Update cb(m_context->comm, request->event);
-
-        if (table_update->error != Error::OK) {
-          if ((error = cb.error(table_update->error, table_update->error_msg)) != Error::OK)
-            HT_ERRORF("Problem sending error response - %s", Error::get_text(error));
-          continue;
+      /**
+       * wait for these ranges to complete maintenance
+       */
+      for (UpdateRecTable *table_update : uc->updates) {
+
+        /*
+         * If any of the newly updated ranges needs maintenance,
+         * schedule immediately
+         */
+        for (auto iter = table_update->range_map.begin(); iter != table_update->range_map.end(); ++iter) {
+          if ((*iter).first->need_maintenance() &&
+              !Global::maintenance_queue->contains((*iter).first)) {
+            maintenance_needed = true;
+            HT_MAYBE_FAIL_X("metadata-update-and-respond", (*iter).first->is_metadata());
+            if (m_timer_handler)
+              m_timer_handler->schedule_immediate_maintenance();
+            break;
+          }
         }
 
-        if (request->error == Error::OK) {
-          /**
-           * Send back response
-           */
-          if (!request->send_back_vector.empty()) {
-            StaticBuffer ext(new uint8_t [request->send_back_vector.size() * 16],
-                             request->send_back_vector.size() * 16);
-            uint8_t *ptr = ext.base;
-            for (size_t i=0; i<request->send_back_vector.size(); i++) {
-              Serialization::encode_i32(&ptr, request->send_back_vector[i].error);
-              Serialization::encode_i32(&ptr, request->send_back_vector[i].count);
-              Serialization::encode_i32(&ptr, request->send_back_vector[i].offset);
-              Serialization::encode_i32(&ptr, request->send_back_vector[i].len);
-              /*
-                HT_INFOF("Sending back error %x, count %d, offset %d, len %d, table id %s",
-                request->send_back_vector[i].error, request->send_back_vector[i].count,
-                request->send_back_vector[i].offset, request->send_back_vector[i].len,
-                table_update->id.id);
-              */
+        for (UpdateRequest *request : table_update->requests) {
+          Response::Callback::Update cb(m_context->comm, request->event);
+
+          if (table_update->error != Error::OK) {
+            if ((error = cb.error(table_update->error, table_update->error_msg)) != Error::OK)
+              HT_ERRORF("Problem sending error response - %s", Error::get_text(error));
+            continue;
+          }
+
+          if (request->error == Error::OK) {
+            /**
+             * Send back response
+             */
+            if (!request->send_back_vector.empty()) {
+              StaticBuffer ext(new uint8_t [request->send_back_vector.size() * 16],
+                               request->send_back_vector.size() * 16);
+              uint8_t *ptr = ext.base;
+              for (size_t i=0; i<request->send_back_vector.size(); i++) {
+                Serialization::encode_i32(&ptr, request->send_back_vector[i].error);
+                Serialization::encode_i32(&ptr, request->send_back_vector[i].count);
+                Serialization::encode_i32(&ptr, request->send_back_vector[i].offset);
+                Serialization::encode_i32(&ptr, request->send_back_vector[i].len);
+              }
+              if ((error = cb.response(ext)) != Error::OK)
+                HT_ERRORF("Problem sending OK response - %s", Error::get_text(error));
+            }
+            else {
+              if ((error = cb.response_ok()) != Error::OK)
+                HT_ERRORF("Problem sending OK response - %s", Error::get_text(error));
             }
-            if ((error = cb.response(ext)) != Error::OK)
-              HT_ERRORF("Problem sending OK response - %s", Error::get_text(error));
           }
           else {
-            if ((error = cb.response_ok()) != Error::OK)
-              HT_ERRORF("Problem sending OK response - %s", Error::get_text(error));
+            if ((error = cb.error(request->error, "")) != Error::OK)
+              HT_ERRORF("Problem sending error response - %s", Error::get_text(error));
           }
         }
-        else {
-          if ((error = cb.error(request->error, "")) != Error::OK)
-            HT_ERRORF("Problem sending error response - %s", Error::get_text(error));
-        }
+
       }
 
-    }
+      {
+        lock_guard<LoadStatistics> lock(*Global::load_statistics);
+        Global::load_statistics->add_update_data(uc->total_updates, uc->total_added, uc->total_bytes_added, uc->total_syncs);
+      }
 
-    {
-      lock_guard<LoadStatistics> lock(*Global::load_statistics);
-      Global::load_statistics->add_update_data(uc->total_updates, uc->total_added, uc->total_bytes_added, uc->total_syncs);
+      delete uc;
     }
+    batch.clear();
 
-    delete uc;
+    if (Global::update_respond_latency)
+      Global::update_respond_latency->record_since(respond_start);
 
     // For testing
     if (m_maintenance_pause_interval > 0 && maintenance_needed)
@@ -39,9 +39,14 @@
 #include <Common/Filesystem.h>
 
 #include <condition_variable>
+#include <list>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 namespace Hypertable {
 
@@ -56,6 +61,8 @@ namespace Hypertable {
     /// Initializes the pipeline as follows:
     ///   - Sets #m_update_coalesce_limit to the value of the
     ///     <code>Hypertable.RangeServer.UpdateCoalesceLimit</code> property.
+    ///   - Sets #m_update_coalesce_window to the value of the
+    ///     <code>Hypertable.RangeServer.UpdateCoalesceWindow</code> property.
     ///   - Sets #m_maintenance_pause_interval to the value of the
     ///     <code>Hypertable.RangeServer.Testing.MaintenanceNeeded.PauseInterval</code>
     ///     property.
@@ -83,6 +90,39 @@ namespace Hypertable {
     /// variables, and performs a join on each pipeline thread.
     void shutdown();
 
+    /// Commit log block holding the updates of one table generation.
+    struct CommitBlock {
+      /// Table updates merged into the block, in batch order
+      std::vector<UpdateRecTable *> table_updates;
+      /// Update context charged with the log sync of this block
+      UpdateContext *owner {};
+      /// Largest revision of the contributing update contexts
+      int64_t revision {TIMESTAMP_MIN};
+      /// Flag indicating if any contributing update requires a log sync
+      bool sync {};
+      /// Merged buffer (only used for more than one table update)
+      DynamicBuffer merged;
+      /// Returns buffer to write to the commit log.
+      /// @return <code>go_buf</code> of the single table update, or #merged
+      DynamicBuffer &buffer() {
+        return table_updates.size() == 1 ? table_updates.front()->go_buf : merged;
+      }
+    };
+
+    /// Map of (table ID, generation) to commit log block
+    typedef std::map<std::pair<std::string, int64_t>, CommitBlock> CommitBlockMap;
+
+    /// Merges the buffered updates of a batch into commit log blocks.
+    /// Groups the <code>go_buf</code> contents of all table updates in
+    /// <code>batch</code> by table ID and generation, skipping table updates
+    /// that have an error, are flagged <code>UPDATE_FLAG_NO_LOG</code>, or
+    /// have nothing buffered.  Each block's revision is the largest
+    /// <code>last_revision</code> of the update contexts contributing to it.
+    /// @param batch Batch of update contexts
+    /// @param blocks Map to receive one block per table generation
+    static void build_commit_blocks(std::list<UpdateContext *> &batch,
+                                    CommitBlockMap &blocks);
+
   private:
 
     /// Thread function for stage 1 of update pipeline.
@@ -98,24 +138,30 @@ namespace Hypertable {
     void qualify_and_transform();
 
     /// Thread function for stage 2 of update pipeline.
-    /// For each UpdateContext object on the input queue #m_commit_queue, this
-    /// function does the following:
-    ///   - Writes the key/value pairs that were buffered in the previous stage
-    ///     to the appropriate
-    ///     commit log (or transfer log) <b>without</b> calling sync().
-    ///   - Once either #m_update_coalesce_limit amount of updates has been
-    ///     collected or when #m_qualify_queue becomes empty, sync() is called
-    ///     on the commit (or transfer) log.
-    ///   - Adds the UpdateContext objects to #m_response_queue and signals
+    /// Removes a batch of UpdateContext objects from the input queue
+    /// #m_commit_queue, up to #m_update_coalesce_limit bytes of updates.  If
+    /// only one object is queued, it first waits up to
+    /// #m_update_coalesce_window microseconds for more to arrive.  It then
+    /// does the following for the batch:
+    ///   - Writes transferring key/value pairs to the appropriate transfer
+    ///     logs.
+    ///   - Merges the buffered key/value pairs of each table across the
+    ///     batch (see build_commit_blocks()) and writes them to the commit
+    ///     log as one block per table generation, <b>without</b> calling
+    ///     sync().
+    ///   - Calls sync() on the commit log once, if any update requires it,
+    ///     and charges one sync to the owner of each block it covers.
+    ///   - Adds the batch to #m_response_queue and signals
     ///     #m_response_queue_cond.
     void commit();
 
     /// Thread function for stage 3 of update pipeline.
-    /// For each UpdateContext object on the input queue #m_response_queue, this
-    /// function does the following:
-    ///   - Adds the key/value pairs that were commited in the previous state to
-    ///     their appropriate ranges
-    ///   - Sends back a response to the originating requests
+    /// Removes a batch of UpdateContext objects from the input queue
+    /// #m_response_queue, up to #m_update_coalesce_limit bytes of updates,
+    /// and does the following:
+    ///   - Adds the key/value pairs that were commited in the previous stage
+    ///     to their ranges, locking each range once for the batch
+    ///   - Sends back a response to each originating request
     void add_and_respond();
 
     void transform_key(ByteString &bskey, DynamicBuffer *dest_bufp,
@@ -173,6 +219,9 @@ namespace Hypertable {
     /// Commit log coalesce limit
     uint64_t m_update_coalesce_limit {};
 
+    /// Microseconds to wait for more updates to coalesce with a lone update
+    int32_t m_update_coalesce_window {};
+
     /// Millisecond pause time at the end of the pipeline (TESTING)
     int32_t m_maintenance_pause_interval {};
 
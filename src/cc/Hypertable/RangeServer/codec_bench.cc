@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+/// @file
+/// Block compression codec benchmark.
+/// Reads the cells of a CellStore, rebuilds its uncompressed data blocks and
+/// reports the compression ratio and compress and decompress throughput of
+/// each block compression codec on those blocks.
+
+#include <Common/Compat.h>
+
+#include <Hypertable/RangeServer/CellStore.h>
+#include <Hypertable/RangeServer/CellStoreFactory.h>
+#include <Hypertable/RangeServer/Config.h>
+#include <Hypertable/RangeServer/Global.h>
+#include <Hypertable/RangeServer/KeyCompressorPrefix.h>
+
+#include <Hypertable/Lib/BlockCompressionCodecZstdDict.h>
+#include <Hypertable/Lib/BlockHeaderCellStore.h>
+#include <Hypertable/Lib/CompressorFactory.h>
+#include <Hypertable/Lib/Key.h>
+
+#include <FsBroker/Lib/Client.h>
+
+#include <AsyncComm/ConnectionManager.h>
+
+#include <Common/ByteString.h>
+#include <Common/DynamicBuffer.h>
+#include <Common/Init.h>
+#include <Common/Logger.h>
+#include <Common/Stopwatch.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Hypertable;
+using namespace Config;
+using namespace std;
+
+namespace {
+
+  struct AppPolicy : Policy {
+    static void init_options() {
+      cmdline_desc("Usage: %s [options] <filename>\n\n"
+        "Rebuilds the uncompressed data blocks of the CellStore contained in\n"
+        "the FS <filename> and reports the compression ratio and compress and\n"
+        "decompress throughput of each codec on those blocks.\n\nOptions")
+        .add_options()
+        ("codecs", str()->default_value("none,snappy,lz4,zlib,zstd,zstd_dict"),
+         "Comma separated list of codec specs, e.g. \"lz4,zstd --best\"")
+        ("block-size", i32(0),
+         "Uncompressed block size (0 uses the CellStore's block size)")
+        ("iterations", i32(5), "Number of decompression passes per codec")
+        ("dictionary-size", i32(16*1024), "Maximum zstd_dict dictionary size")
+        ("sample-size", i32(1024*1024),
+         "Amount of block data used to train the zstd_dict dictionary")
+        ;
+      cmdline_hidden_desc().add_options()
+        ("filename", str(), "")
+        ("filename", -1)
+        ;
+    }
+    static void init() {
+      if (!has("filename")) {
+        HT_ERROR_OUT <<"filename required" << HT_END;
+        cout << cmdline_desc() << endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+  };
+
+  typedef Meta::list<AppPolicy, FsClientPolicy, DefaultCommPolicy> Policies;
+
+  /// Rebuilds the uncompressed data blocks of <code>cellstore</code>.
+  void load_blocks(CellStorePtr &cellstore, size_t block_size,
+                   vector<String> &blocks, size_t *totalp) {
+    ScanContextPtr scan_ctx(new ScanContext());
+    CellListScannerPtr scanner = cellstore->create_scanner(scan_ctx.get());
+    KeyCompressorPrefix key_compressor;
+    DynamicBuffer block;
+    Key key;
+    ByteString value;
+
+    *totalp = 0;
+    while (scanner->get(key, value)) {
+      if (block.fill() > block_size) {
+        *totalp += block.fill();
+        blocks.push_back(String((const char *)block.base, block.fill()));
+        block.clear();
+        key_compressor.reset();
+      }
+      key_compressor.add(key);
+      block.ensure(key_compressor.length() + value.length());
+      key_compressor.write(block.ptr);
+      block.ptr += key_compressor.length();
+      block.add_unchecked(value.ptr, value.length());
+      scanner->forward();
+    }
+    if (block.fill()) {
+      *totalp += block.fill();
+      blocks.push_back(String((const char *)block.base, block.fill()));
+    }
+  }
+
+} // local namespace
+
+
+int main(int argc, char **argv) {
+  try {
+    init_with_policies<Policies>(argc, argv);
+
+    String fname = get_str("filename");
+    int32_t block_size = get_i32("block-size");
+    int32_t iterations = get_i32("iterations");
+    size_t dictionary_size = get_i32("dictionary-size");
+    size_t sample_size = get_i32("sample-size");
+    int timeout = get_i32("timeout");
+    vector<String> specs;
+
+    boost::split(specs, get_str("codecs"), boost::is_any_of(","));
+
+    if (iterations <= 0 || dictionary_size == 0) {
+      cerr << "error: invalid option value" << endl;
+      quick_exit(EXIT_FAILURE);
+    }
+
+    ConnectionManagerPtr conn_mgr = make_shared<ConnectionManager>();
+
+    FsBroker::Lib::ClientPtr dfs = std::make_shared<FsBroker::Lib::Client>(conn_mgr, properties);
+
+    if (!dfs->wait_for_connection(timeout)) {
+      cerr << "error: timed out waiting for FS broker" << endl;
+      quick_exit(EXIT_FAILURE);
+    }
+
+    Global::dfs = dfs;
+
+    Global::memory_tracker = new MemoryTracker(0, 0);
+
+    CellStorePtr cellstore = CellStoreFactory::open(fname, 0, 0);
+
+    if (block_size == 0)
+      block_size = cellstore->get_blocksize();
+
+    vector<String> blocks;
+    size_t total;
+    load_blocks(cellstore, block_size, blocks, &total);
+
+    if (total == 0) {
+      cerr << "error: " << fname << " is empty" << endl;
+      quick_exit(EXIT_FAILURE);
+    }
+
+    printf("%lu blocks, %lu bytes, block size %d\n\n", (unsigned long)blocks.size(),
+           (unsigned long)total, (int)block_size);
+    printf("%-20s %10s %8s %12s %12s\n", "codec", "zbytes", "ratio",
+           "deflate MB/s", "inflate MB/s");
+
+    for (auto &spec : specs) {
+      BlockCompressionCodec::Args args;
+      boost::trim(spec);
+      BlockCompressionCodec::Type type =
+        CompressorFactory::parse_block_codec_spec(spec, args);
+      if (type == BlockCompressionCodec::UNKNOWN)
+        quick_exit(EXIT_FAILURE);
+      unique_ptr<BlockCompressionCodec>
+        codec(CompressorFactory::create_block_codec(type, args));
+
+      size_t dict_len = 0;
+      if (type == BlockCompressionCodec::ZSTD_DICT) {
+        // Train from the leading blocks, as CellStoreV7 does
+        DynamicBuffer samples;
+        for (auto &block : blocks) {
+          if (samples.fill() >= sample_size)
+            break;
+          samples.add(block.data(), block.length());
+        }
+        ZstdDictionaryPtr dictionary =
+          ZstdDictionary::train(samples.base, samples.fill(), 1024,
+                                dictionary_size);
+        if (dictionary) {
+          dict_len = dictionary->size();
+          static_cast<BlockCompressionCodecZstdDict *>(codec.get())->set_dictionary(dictionary);
+        }
+      }
+
+      unique_ptr<DynamicBuffer[]> zblocks(new DynamicBuffer[blocks.size()]);
+      size_t ztotal = dict_len;
+      Stopwatch deflate_watch;
+      for (size_t i=0; i<blocks.size(); ++i) {
+        BlockHeaderCellStore header(1, CellStore::DATA_BLOCK_MAGIC);
+        DynamicBuffer input(0, false);
+        input.base = (uint8_t *)blocks[i].data();
+        input.ptr = input.base + blocks[i].length();
+        codec->deflate(input, zblocks[i], header);
+        ztotal += zblocks[i].fill();
+      }
+      deflate_watch.stop();
+
+      DynamicBuffer output;
+      Stopwatch inflate_watch;
+      for (int32_t n=0; n<iterations; ++n) {
+        for (size_t i=0; i<blocks.size(); ++i) {
+          BlockHeaderCellStore header(1);
+          output.clear();
+          codec->inflate(zblocks[i], output, header);
+          if (n == 0 && (output.fill() != blocks[i].length() ||
+                         memcmp(output.base, blocks[i].data(), output.fill()))) {
+            cerr << "error: " << spec << " block " << i
+                 << " does not match after inflate" << endl;
+            quick_exit(EXIT_FAILURE);
+          }
+        }
+      }
+      inflate_watch.stop();
+
+      double mb = (double)total / (1024.0*1024.0);
+      printf("%-20s %10lu %8.3f %12.1f %12.1f\n", spec.c_str(),
+             (unsigned long)ztotal, (double)ztotal / (double)total,
+             mb / deflate_watch.elapsed(),
+             (mb * iterations) / inflate_watch.elapsed());
+    }
+  }
+  catch (Exception &e) {
+    HT_ERROR_OUT << e << HT_END;
+    return 1;
+  }
+
+  return 0;
+}
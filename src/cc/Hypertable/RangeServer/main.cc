@@ -85,6 +85,8 @@ int main(int argc, char **argv) {
 
     int worker_count = get_i32("Hypertable.RangeServer.Workers");
     Global::app_queue = make_shared<ApplicationQueue>(worker_count);
+    Global::request_wait_latency = make_shared<LatencyHistogram>("requestWait");
+    Global::app_queue->set_wait_histogram(Global::request_wait_latency.get());
 
     /**
      * Connect to Hyperspace
@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include <Common/Compat.h>
+
+#include <Hypertable/RangeServer/Config.h>
+#include <Hypertable/RangeServer/MaintenanceFlag.h>
+#include <Hypertable/RangeServer/MaintenanceScorerLegacy.h>
+#include <Hypertable/RangeServer/MaintenanceScorerWeighted.h>
+#include <Hypertable/RangeServer/MaintenanceSnapshot.h>
+
+#include <Common/Init.h>
+#include <Common/Logger.h>
+#include <Common/StringExt.h>
+#include <Common/Usage.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace Hypertable;
+using namespace Config;
+using namespace std;
+
+namespace {
+
+  struct AppPolicy : Policy {
+    static void init_options() {
+      cmdline_desc("Usage: %s [options] <snapshot> [<snapshot> ...]\n\n"
+        "Replays maintenance scheduler snapshots (run/scheduler.output, written\n"
+        "when the run/debug-scheduler file exists) against the maintenance\n"
+        "scorers and compares the work they select for user ranges with the\n"
+        "decisions recorded in the snapshot.  Scoring weights default to the\n"
+        "Hypertable.RangeServer.Maintenance.Scoring.* properties.\n\nOptions")
+        .add_options()
+        ("memory-weight", f64(), "Weight of memory freed")
+        ("log-weight", f64(), "Weight of commit log bytes released")
+        ("disk-weight", f64(), "Weight of disk space reclaimed")
+        ("read-cost", i32(), "Bytes of I/O charged per CellStore read")
+        ("cpu-weight", f64(), "Weight of bytes passed through merge and compression code")
+        ("min-score", f64(), "Score optional candidates must exceed")
+        ("memory-needed", i64(), "Override memory need recorded in snapshot")
+        ("prune-threshold", i64(), "Override commit log prune threshold recorded in snapshot")
+        ("actions,a", "Display selected actions in priority order")
+        ;
+      cmdline_hidden_desc().add_options()
+        ("snapshot", strs(), "")
+        ("snapshot", -1)
+        ;
+    }
+    static void init() {
+      if (!has("snapshot")) {
+        HT_ERROR_OUT << "snapshot required" << HT_END;
+        cout << cmdline_desc() << endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+  };
+
+  typedef Meta::list<AppPolicy, DefaultPolicy> Policies;
+
+  double get_weight(const String &option, const String &property) {
+    if (has(option))
+      return get_f64(option);
+    return get_f64(property);
+  }
+
+  /// Selected action with the names needed to display it
+  struct Selection {
+    MaintenanceCandidate candidate;
+    const MaintenanceSnapshot::AccessGroupRecord *ag {};
+  };
+
+  /// Totals of the work selected by a policy
+  struct Totals {
+    size_t actions {};
+    int64_t io_bytes {};
+    int64_t cpu_bytes {};
+    int64_t memory_freed {};
+    int64_t log_bytes_released {};
+    int64_t disk_reclaimed {};
+    double reads_avoided {};
+    /// I/O spent before the memory need was met (-1 if never met)
+    int64_t io_to_free_memory {-1};
+  };
+
+  bool include_range(const MaintenanceSnapshot::RangeRecord &range) {
+    return !range.is_metadata && !range.is_system && !range.busy &&
+      (range.maintenance_flags & (MaintenanceFlag::SPLIT|MaintenanceFlag::RELINQUISH)) == 0;
+  }
+
+  /// Maps recorded access group flags to the action they denote.
+  bool recorded_action(int32_t flags, MaintenanceCandidate::Action *action) {
+    if (MaintenanceFlag::drop_expired(flags))
+      *action = MaintenanceCandidate::DROP_EXPIRED;
+    else if (MaintenanceFlag::gc_compaction(flags))
+      *action = MaintenanceCandidate::GC_COMPACTION;
+    else if (MaintenanceFlag::merging_compaction(flags))
+      *action = MaintenanceCandidate::MERGING_COMPACTION;
+    else if (MaintenanceFlag::major_compaction(flags))
+      *action = MaintenanceCandidate::MANUAL_COMPACTION;
+    else if (MaintenanceFlag::minor_compaction(flags))
+      *action = MaintenanceCandidate::MINOR_COMPACTION;
+    else if (MaintenanceFlag::purge_shadow_cache(flags) ||
+             MaintenanceFlag::purge_cellstore(flags) ||
+             (flags & MaintenanceFlag::MEMORY_PURGE) == MaintenanceFlag::MEMORY_PURGE)
+      *action = MaintenanceCandidate::MEMORY_PURGE;
+    else
+      return false;
+    return true;
+  }
+
+  void replay_recorded(const MaintenanceSnapshot &snapshot,
+                       const MaintenanceScorer::Parameters &params,
+                       std::vector<Selection> &selections) {
+    std::vector<const MaintenanceSnapshot::RangeRecord *> ranges;
+    MaintenanceCandidate::Action action;
+    Selection selection;
+
+    for (const auto &range : snapshot.ranges) {
+      if (include_range(range) && range.priority > 0)
+        ranges.push_back(&range);
+    }
+    stable_sort(ranges.begin(), ranges.end(),
+                [](const MaintenanceSnapshot::RangeRecord *x,
+                   const MaintenanceSnapshot::RangeRecord *y) {
+                  return x->priority < y->priority; });
+
+    for (auto range : ranges) {
+      for (const auto &ag : range->access_groups) {
+        if (!recorded_action(ag.maintenance_flags, &action))
+          continue;
+        MaintenanceScorer::estimate(ag.state, params, action,
+                                    selection.candidate);
+        selection.candidate.selected = true;
+        selection.ag = &ag;
+        selections.push_back(selection);
+      }
+    }
+  }
+
+  void replay_scorer(const MaintenanceSnapshot &snapshot,
+                     const MaintenanceScorer::Parameters &params,
+                     MaintenanceScorer *scorer, int64_t memory_needed,
+                     std::vector<Selection> &selections) {
+    std::vector<MaintenanceCandidate> candidates;
+    Selection selection;
+
+    for (const auto &range : snapshot.ranges) {
+      if (!include_range(range))
+        continue;
+      for (const auto &ag : range.access_groups)
+        MaintenanceScorer::generate(ag.state, params, candidates);
+    }
+
+    scorer->schedule(candidates, memory_needed);
+
+    for (auto &candidate : candidates) {
+      if (!candidate.selected)
+        continue;
+      selection.candidate = candidate;
+      selection.ag = (const MaintenanceSnapshot::AccessGroupRecord *)candidate.owner;
+      selections.push_back(selection);
+    }
+  }
+
+  Totals compute_totals(const std::vector<Selection> &selections,
+                        int64_t memory_needed) {
+    Totals totals;
+    for (const auto &selection : selections) {
+      const MaintenanceCandidate &candidate = selection.candidate;
+      totals.actions++;
+      totals.io_bytes += candidate.io_bytes;
+      totals.cpu_bytes += candidate.cpu_bytes;
+      totals.memory_freed += candidate.memory_freed;
+      totals.log_bytes_released += candidate.log_bytes_released;
+      totals.disk_reclaimed += candidate.disk_reclaimed;
+      totals.reads_avoided += candidate.reads_avoided;
+      if (memory_needed > 0 && totals.io_to_free_memory == -1 &&
+          totals.memory_freed >= memory_needed)
+        totals.io_to_free_memory = totals.io_bytes;
+    }
+    return totals;
+  }
+
+  double to_mb(int64_t bytes) {
+    return (double)bytes / (double)MiB;
+  }
+
+  void display(const char *policy, const std::vector<Selection> &selections,
+               int64_t memory_needed, bool verbose) {
+    Totals totals = compute_totals(selections, memory_needed);
+    String io_to_free = (totals.io_to_free_memory == -1) ? String("-") :
+      format("%.1f", to_mb(totals.io_to_free_memory));
+
+    printf("%-10s %7u %10.1f %10.1f %10.1f %10.1f %10.1f %12.0f %12s\n", policy,
+           (unsigned)totals.actions, to_mb(totals.io_bytes),
+           to_mb(totals.cpu_bytes), to_mb(totals.memory_freed),
+           to_mb(totals.log_bytes_released), to_mb(totals.disk_reclaimed),
+           totals.reads_avoided, io_to_free.c_str());
+
+    if (verbose) {
+      for (size_t i=0; i<selections.size(); i++) {
+        const MaintenanceCandidate &candidate = selections[i].candidate;
+        printf("  %4u %-13s %12.3f %10.1f %10.1f %s\n", (unsigned)i+1,
+               MaintenanceCandidate::action_name(candidate.action),
+               candidate.score, to_mb(candidate.io_bytes),
+               to_mb(candidate.memory_freed), selections[i].ag->name.c_str());
+      }
+    }
+  }
+
+} // local namespace
+
+
+int main(int argc, char **argv) {
+  try {
+    init_with_policies<Policies>(argc, argv);
+
+    bool verbose = has("actions");
+    Strings snapshots = get_strs("snapshot");
+    MaintenanceScorerWeighted::Weights weights;
+    MaintenanceScorer::Parameters params;
+
+    weights.memory = get_weight("memory-weight", "Hypertable.RangeServer.Maintenance.Scoring.MemoryWeight");
+    weights.log = get_weight("log-weight", "Hypertable.RangeServer.Maintenance.Scoring.LogWeight");
+    weights.disk = get_weight("disk-weight", "Hypertable.RangeServer.Maintenance.Scoring.DiskWeight");
+    weights.read_cost = has("read-cost") ? (double)get_i32("read-cost") :
+      (double)get_i32("Hypertable.RangeServer.Maintenance.Scoring.ReadCost");
+    weights.cpu = get_weight("cpu-weight", "Hypertable.RangeServer.Maintenance.Scoring.CpuWeight");
+    weights.min_score = get_weight("min-score", "Hypertable.RangeServer.Maintenance.Scoring.MinScore");
+
+    params.access_group_max_mem = get_i64("Hypertable.RangeServer.AccessGroup.MaxMemory");
+    params.garbage_threshold =
+      get_i32("Hypertable.RangeServer.AccessGroup.GarbageThreshold.Percentage");
+
+    MaintenanceScorerLegacy legacy;
+    MaintenanceScorerWeighted weighted(weights);
+
+    for (const auto &fname : snapshots) {
+      MaintenanceSnapshot snapshot;
+      ifstream in(fname.c_str());
+
+      if (!in) {
+        cerr << "error: unable to open '" << fname << "'" << endl;
+        quick_exit(EXIT_FAILURE);
+      }
+      snapshot.load(in);
+
+      int64_t memory_needed = has("memory-needed") ?
+        get_i64("memory-needed") : snapshot.memory_needed;
+      params.prune_threshold = has("prune-threshold") ?
+        get_i64("prune-threshold") : snapshot.prune_threshold;
+      if (params.prune_threshold == 0)
+        params.prune_threshold = get_i64("Hypertable.RangeServer.CommitLog.PruneThreshold.Min");
+
+      size_t ag_count = 0;
+      for (const auto &range : snapshot.ranges)
+        ag_count += range.access_groups.size();
+
+      printf("%s: ranges=%u access-groups=%u memory-needed=%.1fMB "
+             "prune-threshold=%.1fMB%s\n", fname.c_str(),
+             (unsigned)snapshot.ranges.size(), (unsigned)ag_count,
+             to_mb(memory_needed), to_mb(params.prune_threshold),
+             snapshot.low_memory ? " (low memory)" : "");
+      printf("%-10s %7s %10s %10s %10s %10s %10s %12s %12s\n", "policy",
+             "actions", "io-MB", "cpu-MB", "mem-MB", "log-MB", "disk-MB",
+             "reads-saved", "io-to-mem-MB");
+
+      {
+        std::vector<Selection> selections;
+        replay_recorded(snapshot, params, selections);
+        display("recorded", selections, memory_needed, verbose);
+      }
+
+      for (MaintenanceScorer *scorer : { (MaintenanceScorer *)&legacy,
+                                         (MaintenanceScorer *)&weighted }) {
+        std::vector<Selection> selections;
+        replay_scorer(snapshot, params, scorer, memory_needed, selections);
+        display(scorer->name(), selections, memory_needed, verbose);
+      }
+      printf("\n");
+    }
+  }
+  catch (Exception &e) {
+    HT_ERROR_OUT << e << HT_END;
+    quick_exit(EXIT_FAILURE);
+  }
+  fflush(stdout);
+  quick_exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+/// @file
+/// Allocation-counting benchmark for the CellStore scan path.
+/// Writes a CellStore through the FsBroker, scans it with
+/// FillScanBlock() the same way RangeServer::fetch_scanblock() does and
+/// reports the number of heap allocations per scan block.
+
+#include <Common/Compat.h>
+
+#include <Hypertable/RangeServer/CellStoreV7.h>
+#include <Hypertable/RangeServer/Config.h>
+#include <Hypertable/RangeServer/FileBlockCache.h>
+#include <Hypertable/RangeServer/FillScanBlock.h>
+#include <Hypertable/RangeServer/Global.h>
+#include <Hypertable/RangeServer/MergeScannerAccessGroup.h>
+#include <Hypertable/RangeServer/MergeScannerRange.h>
+
+#include <Hypertable/Lib/Key.h>
+#include <Hypertable/Lib/Schema.h>
+#include <Hypertable/Lib/SerializedKey.h>
+
+#include <FsBroker/Lib/Client.h>
+
+#include <AsyncComm/ConnectionManager.h>
+#include <AsyncComm/ReactorFactory.h>
+
+#include <Common/DynamicBuffer.h>
+#include <Common/Init.h>
+#include <Common/InetAddr.h>
+#include <Common/Logger.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+using namespace Hypertable;
+using namespace Config;
+using namespace std;
+
+namespace {
+
+  /// Number of calls to the global operator new
+  atomic<int64_t> g_allocations {};
+
+}
+
+void *operator new(size_t size) {
+  g_allocations.fetch_add(1, memory_order_relaxed);
+  void *ptr = malloc(size ? size : 1);
+  if (ptr == nullptr)
+    throw bad_alloc();
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+  free(ptr);
+}
+
+namespace {
+
+  struct AppPolicy : Policy {
+    static void init_options() {
+      cmdline_desc("Usage: %s [options]\n\n"
+        "Writes a CellStore through the FsBroker and scans it block by block\n"
+        "with FillScanBlock(), reporting heap allocations per scan block.\n"
+        "Steady state excludes the first block of each scan.\n\nOptions")
+        .add_options()
+        ("cells", i32(500000), "Number of cells in the CellStore")
+        ("value-size", i32(64), "Size of cell values")
+        ("scan-buffer-size", i32(64*1024), "Scan block size")
+        ("iterations", i32(3), "Number of scans over the CellStore")
+        ("block-cache", i64(0), "Block cache size (0 disables the cache)")
+        ("dir", str()->default_value("/ht_scan_alloc_bench"),
+         "FsBroker directory for the CellStore")
+        ;
+    }
+  };
+
+  typedef Meta::list<AppPolicy, DefaultPolicy> Policies;
+
+  const char *schema_str =
+  "<Schema>\n"
+  "  <AccessGroup name=\"default\">\n"
+  "    <ColumnFamily id=\"1\">\n"
+  "      <Name>tag</Name>\n"
+  "    </ColumnFamily>\n"
+  "  </AccessGroup>\n"
+  "</Schema>";
+
+  /// Scans the whole CellStore, returns steady state allocations per block.
+  double scan(CellStorePtr &cs, SchemaPtr &schema, int32_t buffer_size,
+              int64_t *blocksp, int64_t *cellsp) {
+    ScanSpec scan_spec;
+    RangeSpec range("", Key::END_ROW_MARKER);
+    String table_id("1");
+    ScanContextPtr scan_ctx =
+      make_shared<ScanContext>(TIMESTAMP_MAX, &scan_spec, &range, schema);
+
+    MergeScannerRangePtr scanner =
+      make_shared<MergeScannerRange>(table_id, scan_ctx);
+    MergeScannerAccessGroup *ag_scanner =
+      new MergeScannerAccessGroup(table_id, scan_ctx.get());
+    ag_scanner->add_scanner(cs->create_scanner(scan_ctx.get()));
+    scanner->add_scanner(ag_scanner);
+
+    int64_t blocks = 0, steady_allocations = 0;
+    bool more = true;
+    while (more) {
+      DynamicBuffer rbuf;
+      uint32_t cell_count = 0;
+      int64_t start = g_allocations.load(memory_order_relaxed);
+      more = FillScanBlock(scanner, rbuf, &cell_count, buffer_size);
+      if (blocks++ > 0)
+        steady_allocations += g_allocations.load(memory_order_relaxed) - start;
+      *cellsp += cell_count;
+    }
+    *blocksp += blocks;
+    return blocks > 1 ? (double)steady_allocations / (blocks - 1) : 0.0;
+  }
+
+} // local namespace
+
+
+int main(int argc, char **argv) {
+  try {
+    init_with_policies<Policies>(argc, argv);
+
+    int32_t cells = get_i32("cells");
+    int32_t value_size = get_i32("value-size");
+    int32_t buffer_size = get_i32("scan-buffer-size");
+    int32_t iterations = get_i32("iterations");
+    int64_t cache_size = get_i64("block-cache");
+    String dir = get_str("dir");
+
+    if (cells <= 0 || value_size <= 0 || buffer_size <= 0 || iterations <= 0) {
+      cerr << "error: invalid option value" << endl;
+      quick_exit(EXIT_FAILURE);
+    }
+
+    ReactorFactory::initialize(2);
+
+    struct sockaddr_in addr;
+    InetAddr::initialize(&addr, "localhost", get_i16("FsBroker.Port"));
+    ConnectionManagerPtr conn_mgr = make_shared<ConnectionManager>();
+    Global::dfs = make_shared<FsBroker::Lib::Client>(conn_mgr, addr, 15000);
+    if (!static_pointer_cast<FsBroker::Lib::Client>(Global::dfs)->wait_for_connection(15000)) {
+      HT_ERROR("Unable to connect to DFS");
+      quick_exit(EXIT_FAILURE);
+    }
+
+    Global::memory_tracker = new MemoryTracker(0, 0);
+    if (cache_size > 0)
+      Global::block_cache = new FileBlockCache(cache_size, cache_size, false);
+
+    SchemaPtr schema(Schema::new_instance(schema_str));
+    TableIdentifier table_id("1");
+    PropertiesPtr cs_props = make_shared<Properties>();
+    String csname = dir + "/cs0";
+
+    Global::dfs->mkdirs(dir);
+
+    CellStorePtr cs = make_shared<CellStoreV7>(Global::dfs.get(), schema);
+    cs->create(csname.c_str(), 0, cs_props, &table_id);
+    {
+      DynamicBuffer kbuf, vbuf;
+      String value(value_size, 'v');
+      append_as_byte_string(vbuf, value.c_str(), value.length());
+      Key key;
+      SerializedKey serkey;
+      ByteString bsvalue(vbuf.base);
+      for (int32_t i=0; i<cells; i++) {
+        String row = format("row%012d", (int)i);
+        kbuf.clear();
+        create_key_and_append(kbuf, FLAG_INSERT, row.c_str(), 1, "q",
+                              (int64_t)i+1, (int64_t)i+1);
+        serkey.ptr = kbuf.base;
+        key.load(serkey);
+        cs->add(key, bsvalue);
+      }
+    }
+    cs->finalize(&table_id);
+
+    printf("cells=%d value-size=%d scan-buffer-size=%d block-cache=%lld\n",
+           (int)cells, (int)value_size, (int)buffer_size, (Lld)cache_size);
+
+    for (int32_t i=0; i<iterations; i++) {
+      int64_t blocks = 0, scanned = 0;
+      double per_block = scan(cs, schema, buffer_size, &blocks, &scanned);
+      printf("scan %d: %lld cells, %lld blocks, %.2f allocations/block "
+             "(steady state, includes the response buffer)\n", (int)i,
+             (Lld)scanned, (Lld)blocks, per_block);
+    }
+
+    cs.reset();
+    Global::dfs->rmdir(dir);
+  }
+  catch (Exception &e) {
+    HT_ERROR_OUT << e << HT_END;
+    quick_exit(EXIT_FAILURE);
+  }
+  fflush(stdout);
+  quick_exit(EXIT_SUCCESS);
+}
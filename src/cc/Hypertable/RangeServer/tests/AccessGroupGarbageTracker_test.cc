@@ -28,6 +28,8 @@
 #include "../AccessGroupGarbageTracker.h"
 #include "../Global.h"
 
+#include "Hypertable/Lib/KeySpec.h"
+
 using namespace Hypertable;
 using namespace Config;
 
@@ -69,6 +71,48 @@ namespace {
 
 
 int main(int argc, char **argv) {
+
+  // Fully expired cell store detection
+  {
+    PropertiesPtr props = std::make_shared<Properties>();
+    props->set("Hypertable.RangeServer.AccessGroup.GarbageThreshold.Percentage",
+               (int32_t)20);
+    props->set("Hypertable.RangeServer.Range.SplitSize", (int64_t)250000000);
+    CellCacheManagerPtr cell_cache_manager = std::make_shared<CellCacheManager>();
+
+    AccessGroupSpec ag_spec("default");
+    ColumnFamilySpec *cf = new ColumnFamilySpec("a");
+    cf->set_option_ttl(3600);
+    ag_spec.add_column(cf);
+    cf = new ColumnFamilySpec("b");
+    cf->set_option_ttl(60);
+    ag_spec.add_column(cf);
+
+    AccessGroupGarbageTracker tracker(props, cell_cache_manager, &ag_spec);
+
+    int64_t now = 100000LL * 1000000000LL;
+    CellStoreInfo csi;
+    csi.timestamp_min = now - 7300LL * 1000000000LL;
+    csi.timestamp_max = now - 7200LL * 1000000000LL;
+    HT_ASSERT(tracker.check_expired(csi, now));
+
+    // Newest cell still within the largest TTL
+    csi.timestamp_max = now - 1800LL * 1000000000LL;
+    HT_ASSERT(!tracker.check_expired(csi, now));
+
+    // Unknown timestamp range
+    csi.timestamp_min = TIMESTAMP_MAX;
+    csi.timestamp_max = TIMESTAMP_MIN;
+    HT_ASSERT(!tracker.check_expired(csi, now));
+
+    // Column family without TTL
+    csi.timestamp_min = now - 7300LL * 1000000000LL;
+    csi.timestamp_max = now - 7200LL * 1000000000LL;
+    ag_spec.add_column(new ColumnFamilySpec("c"));
+    tracker.update_schema(&ag_spec);
+    HT_ASSERT(!tracker.check_expired(csi, now));
+  }
+
 #if 0
   init_with_policy<DefaultPolicy>(argc, argv);
 
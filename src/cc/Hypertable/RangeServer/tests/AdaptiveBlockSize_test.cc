@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <Common/Compat.h>
+
+#include <Hypertable/RangeServer/AccessGroup.h>
+
+#include <Common/Logger.h>
+
+#include <cstdlib>
+
+using namespace Hypertable;
+using namespace std;
+
+namespace {
+
+  const int32_t MIN_BLOCKSIZE = 4096;
+  const int32_t MAX_BLOCKSIZE = 262144;
+  const int32_t MIN_SCANS = 16;
+
+  /// Block size chosen for <code>scans</code> scans of which
+  /// <code>point_lookups</code> were single row lookups and the rest each
+  /// returned <code>bytes_per_range_scan</code> bytes
+  int32_t blocksize(double scans, double point_lookups,
+                    double bytes_per_range_scan,
+                    int32_t min_blocksize=MIN_BLOCKSIZE,
+                    int32_t max_blocksize=MAX_BLOCKSIZE) {
+    return AccessGroup::adaptive_blocksize(scans, point_lookups,
+        (scans - point_lookups) * bytes_per_range_scan,
+        min_blocksize, max_blocksize, MIN_SCANS);
+  }
+
+}
+
+int main(int argc, char **argv) {
+
+  // too few scans to adapt
+  HT_ASSERT(blocksize(0, 0, 0) == 0);
+  HT_ASSERT(blocksize(MIN_SCANS - 1, 0, 65536) == 0);
+  HT_ASSERT(AccessGroup::adaptive_blocksize(0, 0, 0, MIN_BLOCKSIZE,
+                                            MAX_BLOCKSIZE, 0) == 0);
+  HT_ASSERT(blocksize(MIN_SCANS, 0, 65536) == 65536);
+
+  // invalid limits
+  HT_ASSERT(blocksize(100, 0, 65536, 0) == 0);
+  HT_ASSERT(blocksize(100, 0, 65536, 65536, 4096) == 0);
+
+  // all point lookups
+  HT_ASSERT(blocksize(100, 100, 0) == MIN_BLOCKSIZE);
+
+  // all range scans, rounded to the nearest power of two
+  HT_ASSERT(blocksize(100, 0, 65536) == 65536);
+  HT_ASSERT(blocksize(100, 0, 49152) == 65536);
+  HT_ASSERT(blocksize(100, 0, 40000) == 32768);
+
+  // a mix is the weighted geometric mean of both targets
+  HT_ASSERT(blocksize(100, 50, 65536) == 16384);
+  HT_ASSERT(blocksize(100, 75, 65536) == 8192);
+  HT_ASSERT(blocksize(100, 25, 65536) == 32768);
+
+  // clamped to the block size limits
+  HT_ASSERT(blocksize(100, 0, 100) == MIN_BLOCKSIZE);
+  HT_ASSERT(blocksize(100, 0, 10000000) == MAX_BLOCKSIZE);
+  HT_ASSERT(blocksize(100, 100, 0, 5000) == 5000);
+  HT_ASSERT(blocksize(100, 0, 10000000, 4096, 100000) == 100000);
+
+  return 0;
+}
@@ -115,6 +115,8 @@ int main(int argc, char **argv) {
 
     Config::properties->set("Hypertable.RangeServer.CellStore.DefaultCompressor", String("none"));
     Config::properties->set("Hypertable.RangeServer.CellStore.DefaultBlockSize", 4*1024*1024);
+    // The golden block index records blocks without restart points
+    Config::properties->set("Hypertable.RangeServer.CellStore.RestartInterval", int32_t(0));
 
     cs = new CellStoreV7(Global::dfs.get());
     HT_TRY("creating cellstore", cs->create(csname.c_str(), 4096, Config::properties, &table_id));
@@ -0,0 +1,437 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <Common/Compat.h>
+
+#include "../CellStoreFactory.h"
+#include "../CellStoreTrailerV7.h"
+#include "../CellStoreV7.h"
+#include "../Global.h"
+#include "../KeyCompressor.h"
+
+#include <Hypertable/Lib/Key.h>
+#include <Hypertable/Lib/Schema.h>
+#include <Hypertable/Lib/SerializedKey.h>
+
+#include <FsBroker/Lib/Client.h>
+
+#include <AsyncComm/ConnectionManager.h>
+
+#include <Common/Init.h>
+#include <Common/DynamicBuffer.h>
+#include <Common/InetAddr.h>
+#include <Common/Usage.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace Hypertable;
+using namespace std;
+
+namespace {
+  const char *usage[] = {
+    "usage: CellStoreLayout_test",
+    "",
+    "  This program writes cell stores with each of the optional block",
+    "  layouts and checks that point lookups, cell lookups, row interval",
+    "  scans, full scans and keys only scans of them return exactly the",
+    "  cells written.",
+    (const char *)0
+  };
+  const char *schema_str =
+  "<Schema>\n"
+  "  <AccessGroup name=\"default\">\n"
+  "    <ColumnFamily id=\"1\">\n"
+  "      <Name>tag</Name>\n"
+  "    </ColumnFamily>\n"
+  "  </AccessGroup>\n"
+  "</Schema>";
+
+  const size_t QUALIFIERS = 3;
+
+  struct TestCell {
+    String row;
+    String qualifier;
+    int64_t timestamp;
+    String value;
+  };
+
+  String row_name(size_t i) {
+    char buf[16];
+    sprintf(buf, "row%05u", (unsigned)i);
+    return buf;
+  }
+
+  /// Cells of <code>rows</code> rows in key order, with values of varying
+  /// length
+  vector<TestCell> make_cells(size_t rows) {
+    vector<TestCell> cells;
+    for (size_t i=0; i<rows; i++) {
+      for (size_t q=0; q<QUALIFIERS; q++) {
+        TestCell cell;
+        cell.row = row_name(i);
+        cell.qualifier = format("q%u", (unsigned)q);
+        cell.timestamp = (int64_t)((i*QUALIFIERS + q) * 7919 % 100000) + 1;
+        cell.value = format("value-%u-%u-", (unsigned)i, (unsigned)q);
+        cell.value.append(i % 37, 'x');
+        cells.push_back(cell);
+      }
+    }
+    return cells;
+  }
+
+  String to_string(const TestCell &cell) {
+    return format("%s tag:%s %lld %s", cell.row.c_str(), cell.qualifier.c_str(),
+                  (Lld)cell.timestamp, cell.value.c_str());
+  }
+
+  String to_string(const Key &key, const ByteString &value) {
+    const uint8_t *ptr;
+    size_t len = value.decode_length(&ptr);
+    return format("%s tag:%s %lld %s", key.row, key.column_qualifier,
+                  (Lld)key.timestamp, String((const char *)ptr, len).c_str());
+  }
+
+  /// Writes <code>cells</code> to a new cell store and reopens it the way
+  /// the RangeServer does, so that the layout is read back from the trailer
+  CellStorePtr write_store(const String &name, const vector<TestCell> &cells,
+                           SchemaPtr &schema,
+                           const String &compressor = String()) {
+    TableIdentifier table_id("0");
+    PropertiesPtr props = make_shared<Properties>();
+    // small blocks so that scans cross many block and restart boundaries
+    props->set("blocksize", int32_t(1024));
+    if (!compressor.empty())
+      props->set("compressor", compressor);
+
+    CellStorePtr cs = make_shared<CellStoreV7>(Global::dfs.get(), schema);
+    cs->create(name.c_str(), cells.size(), props, &table_id);
+
+    DynamicBuffer key_buf;
+    DynamicBuffer value_buf;
+    for (auto &cell : cells) {
+      key_buf.clear();
+      create_key_and_append(key_buf, FLAG_INSERT, cell.row.c_str(), 1,
+                            cell.qualifier.c_str(), cell.timestamp,
+                            cell.timestamp);
+      Key key;
+      key.load(SerializedKey(key_buf.base));
+      value_buf.clear();
+      append_as_byte_string(value_buf, cell.value.c_str());
+      ByteString value;
+      value.ptr = value_buf.base;
+      cs->add(key, value);
+    }
+    cs->finalize(&table_id);
+
+    return CellStoreFactory::open(name, 0, 0);
+  }
+
+  String key_string(const TestCell &cell) {
+    return format("%s tag:%s %lld", cell.row.c_str(), cell.qualifier.c_str(),
+                  (Lld)cell.timestamp);
+  }
+
+  String key_string(const Key &key) {
+    return format("%s tag:%s %lld", key.row, key.column_qualifier,
+                  (Lld)key.timestamp);
+  }
+
+  /// Scans <code>cs</code>, returning each cell formatted with to_string(),
+  /// or with key_string() if the scan is keys only.  A keys only scan of a
+  /// store with separate values must not return any value.
+  vector<String> scan(CellStorePtr &cs, ScanSpecBuilder &ssbuilder,
+                      SchemaPtr &schema) {
+    RangeSpec range;
+    range.start_row = "";
+    range.end_row = Key::END_ROW_MARKER;
+    ScanContextPtr scan_ctx =
+      make_shared<ScanContext>(TIMESTAMP_MAX, &(ssbuilder.get()), &range, schema);
+    CellListScannerPtr scanner = cs->create_scanner(scan_ctx.get());
+    vector<String> result;
+    Key key;
+    ByteString value;
+    bool keys_only = ssbuilder.get().keys_only;
+    while (scanner->get(key, value)) {
+      if (keys_only) {
+        HT_ASSERT(!cs->has_separate_values() || value.ptr == 0);
+        result.push_back(key_string(key));
+      }
+      else
+        result.push_back(to_string(key, value));
+      scanner->forward();
+    }
+    return result;
+  }
+
+  void check(const String &what, const vector<String> &got,
+             const vector<String> &expected) {
+    if (got == expected)
+      return;
+    cerr << what << ": got " << got.size() << " cells, expected "
+         << expected.size() << endl;
+    for (size_t i=0; i<got.size() || i<expected.size(); i++) {
+      String g = i < got.size() ? got[i] : "<none>";
+      String e = i < expected.size() ? expected[i] : "<none>";
+      if (g != e) {
+        cerr << "  first difference at " << i << ": got '" << g
+             << "', expected '" << e << "'" << endl;
+        break;
+      }
+    }
+    exit(EXIT_FAILURE);
+  }
+
+  vector<String> expected_rows(const vector<TestCell> &cells, const String &start,
+                               const String &end) {
+    vector<String> result;
+    for (auto &cell : cells)
+      if (cell.row >= start && cell.row <= end)
+        result.push_back(to_string(cell));
+    return result;
+  }
+
+  vector<String> expected_keys(const vector<TestCell> &cells,
+                               const String &start, const String &end) {
+    vector<String> result;
+    for (auto &cell : cells)
+      if (cell.row >= start && cell.row <= end)
+        result.push_back(key_string(cell));
+    return result;
+  }
+
+  /// Scans <code>cs</code> with each kind of scanner and compares the
+  /// results with <code>cells</code>.  Lookups are done for up to 400 rows
+  /// spread over the store.
+  void check_scans(const String &label, CellStorePtr &cs,
+                   const vector<TestCell> &cells, SchemaPtr &schema) {
+    ScanSpecBuilder ssbuilder;
+    size_t rows = cells.size() / QUALIFIERS;
+    size_t stride = rows > 400 ? rows / 400 : 1;
+
+    // full scan (readahead scanner)
+    ssbuilder.add_row_interval("", true, Key::END_ROW_MARKER, true);
+    check(label + " full scan", scan(cs, ssbuilder, schema),
+          expected_rows(cells, "", Key::END_ROW_MARKER));
+
+    for (size_t i=0; i<rows; i+=stride) {
+      String row = row_name(i);
+
+      // row lookup hit (block index scanner, seeks within the block)
+      ssbuilder.clear();
+      ssbuilder.add_row(row);
+      check(label + " row " + row, scan(cs, ssbuilder, schema),
+            expected_rows(cells, row, row));
+
+      // row lookup miss, sorting between this row and the next
+      ssbuilder.clear();
+      ssbuilder.add_row(row + "-");
+      check(label + " row " + row + "-", scan(cs, ssbuilder, schema),
+            vector<String>());
+
+      // cell lookup hit and miss
+      const TestCell &cell = cells[i*QUALIFIERS + 1];
+      ssbuilder.clear();
+      ssbuilder.add_cell(row, "tag:" + cell.qualifier);
+      check(label + " cell " + row, scan(cs, ssbuilder, schema),
+            vector<String>(1, to_string(cell)));
+      ssbuilder.clear();
+      ssbuilder.add_cell(row, "tag:" + cell.qualifier + "a");
+      check(label + " cell " + row + " miss", scan(cs, ssbuilder, schema),
+            vector<String>());
+    }
+
+    // misses before the first and after the last key
+    ssbuilder.clear();
+    ssbuilder.add_row("a");
+    check(label + " row before first", scan(cs, ssbuilder, schema),
+          vector<String>());
+    ssbuilder.clear();
+    ssbuilder.add_row("zzz");
+    check(label + " row after last", scan(cs, ssbuilder, schema),
+          vector<String>());
+
+    // row intervals (readahead scanner positioned with the block index)
+    for (size_t i=0; i+7<rows; i+=13*stride) {
+      String start = row_name(i);
+      String end = row_name(i+7);
+      ssbuilder.clear();
+      ssbuilder.add_row_interval(start, true, end, true);
+      check(label + " interval " + start + ".." + end,
+            scan(cs, ssbuilder, schema), expected_rows(cells, start, end));
+    }
+
+    // keys only, with both scanners
+    ssbuilder.clear();
+    ssbuilder.set_keys_only(true);
+    ssbuilder.add_row_interval("", true, Key::END_ROW_MARKER, true);
+    check(label + " keys only full scan", scan(cs, ssbuilder, schema),
+          expected_keys(cells, "", Key::END_ROW_MARKER));
+    for (size_t i=0; i<rows; i+=7*stride) {
+      String row = row_name(i);
+      ssbuilder.clear();
+      ssbuilder.set_keys_only(true);
+      ssbuilder.add_row(row);
+      check(label + " keys only row " + row, scan(cs, ssbuilder, schema),
+            expected_keys(cells, row, row));
+    }
+  }
+
+  CellStoreTrailerV7 *get_trailer(CellStorePtr &cs) {
+    CellStoreTrailerV7 *trailer =
+      dynamic_cast<CellStoreTrailerV7 *>(cs->get_trailer());
+    HT_ASSERT(trailer);
+    return trailer;
+  }
+
+  void set_layout(int32_t restart_interval, bool delta_timestamps=false,
+                  bool separate_values=false) {
+    Config::properties->set("Hypertable.RangeServer.CellStore.RestartInterval",
+                            restart_interval);
+    Config::properties->set("Hypertable.RangeServer.CellStore"
+                            ".DeltaEncodeTimestamps", delta_timestamps);
+    Config::properties->set("Hypertable.RangeServer.CellStore"
+                            ".SeparateValues", separate_values);
+  }
+
+}
+
+
+int main(int argc, char **argv) {
+  try {
+    struct sockaddr_in addr;
+    FsBroker::Lib::ClientPtr client;
+
+    Config::init(argc, argv);
+
+    if (Config::has("help"))
+      Usage::dump_and_exit(usage);
+
+    ReactorFactory::initialize(2);
+
+    uint16_t port = Config::properties->get_i16("FsBroker.Port");
+
+    InetAddr::initialize(&addr, "localhost", port);
+
+    ConnectionManagerPtr conn_mgr = make_shared<ConnectionManager>();
+    client = std::make_shared<FsBroker::Lib::Client>(conn_mgr, addr, 15000);
+
+    Global::dfs = client;
+
+    if (!client->wait_for_connection(15000)) {
+      HT_ERROR("Unable to connect to DFS");
+      return 1;
+    }
+
+    Global::memory_tracker = new MemoryTracker(0, 0);
+
+    String testdir = "/CellStoreLayout_test";
+    client->mkdirs(testdir);
+
+    SchemaPtr schema( Schema::new_instance(schema_str) );
+    vector<TestCell> cells = make_cells(400);
+    CellStorePtr cs;
+
+    // The default layout is readable by releases without version 8
+    cs = write_store(testdir + "/default", cells, schema);
+    HT_ASSERT(!cs->has_restart_points() && !cs->has_separate_values());
+    HT_ASSERT(get_trailer(cs)->version == 7);
+    check_scans("default", cs, cells, schema);
+
+    // Restart points, including a restart point at every key and none at
+    // all; stores without them keep the version 7 format
+    for (int32_t interval : { 0, 1, 4, 16 }) {
+      String label = format("restart-interval-%d", (int)interval);
+      set_layout(interval);
+      cs = write_store(testdir + "/" + label, cells, schema);
+      HT_ASSERT(cs->has_restart_points() == (interval > 0));
+      HT_ASSERT(get_trailer(cs)->version == (interval > 0 ? 8 : 7));
+      check_scans(label, cs, cells, schema);
+    }
+
+    // Delta encoded timestamps, alone and reset at each restart point
+    for (int32_t interval : { 0, 4 }) {
+      String label = format("delta-timestamps-%d", (int)interval);
+      set_layout(interval, true);
+      cs = write_store(testdir + "/" + label, cells, schema);
+      HT_ASSERT(get_trailer(cs)->key_compression_scheme ==
+                KeyCompressionType::PREFIX_DELTA);
+      HT_ASSERT(get_trailer(cs)->version == 8);
+      check_scans(label, cs, cells, schema);
+    }
+
+    // Separate value sections, with and without restart points
+    for (int32_t interval : { 0, 4 }) {
+      String label = format("separate-values-%d", (int)interval);
+      set_layout(interval, false, true);
+      cs = write_store(testdir + "/" + label, cells, schema);
+      HT_ASSERT(cs->has_separate_values());
+      HT_ASSERT(cs->has_restart_points() == (interval > 0));
+      HT_ASSERT(get_trailer(cs)->version == 8);
+      check_scans(label, cs, cells, schema);
+    }
+    set_layout(16);
+
+    // zstd_dict compressor.  Blocks are held back until SampleSize bytes
+    // have been buffered and the dictionary is trained from them; the
+    // reopened store loads the dictionary from the file.
+    Config::properties->set("Hypertable.RangeServer.CellStore.Dictionary"
+                            ".MaxSize", int32_t(8*1024));
+    Config::properties->set("Hypertable.RangeServer.CellStore.Dictionary"
+                            ".SampleSize", int32_t(256*1024));
+    {
+      // Too little data to train a dictionary, so the held back blocks are
+      // written without one when the store is finalized
+      vector<TestCell> small_cells = make_cells(20);
+      cs = write_store(testdir + "/zstd-dict-small", small_cells, schema,
+                       "zstd_dict");
+      HT_ASSERT((get_trailer(cs)->flags & CellStoreTrailerV7::DICTIONARY) == 0);
+      check_scans("zstd-dict-small", cs, small_cells, schema);
+
+      // The dictionary is trained part way through, after which the held
+      // back blocks are written followed by the rest
+      vector<TestCell> large_cells = make_cells(6000);
+      cs = write_store(testdir + "/zstd-dict-large", large_cells, schema,
+                       "zstd_dict");
+      HT_ASSERT(get_trailer(cs)->flags & CellStoreTrailerV7::DICTIONARY);
+      check_scans("zstd-dict-large", cs, large_cells, schema);
+
+      // Key and value sections are both compressed with the dictionary
+      set_layout(16, false, true);
+      cs = write_store(testdir + "/zstd-dict-separate-values", large_cells,
+                       schema, "zstd_dict");
+      HT_ASSERT(get_trailer(cs)->flags & CellStoreTrailerV7::DICTIONARY);
+      HT_ASSERT(cs->has_separate_values());
+      check_scans("zstd-dict-separate-values", cs, large_cells, schema);
+      set_layout(16);
+    }
+
+    cs = 0;
+    client->rmdir(testdir);
+  }
+  catch (Exception &e) {
+    HT_ERROR_OUT << e << HT_END;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <Common/Compat.h>
+
+#include <Hypertable/RangeServer/CompactionPolicyFactory.h>
+#include <Hypertable/RangeServer/CompactionPolicySizeTiered.h>
+#include <Hypertable/RangeServer/CompactionPolicyTimeWindow.h>
+
+#include <Hypertable/Lib/KeySpec.h>
+
+#include <Common/Error.h>
+#include <Common/Logger.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace Hypertable;
+using namespace std;
+
+namespace {
+
+  const int64_t NANOS_PER_HOUR = 3600LL * 1000000000LL;
+
+  CompactionPolicy::StoreInfo store(int64_t disk_usage, int64_t ts_min=0,
+                                    int64_t ts_max=0) {
+    CompactionPolicy::StoreInfo info;
+    info.disk_usage = disk_usage;
+    info.timestamp_min = ts_min;
+    info.timestamp_max = ts_max;
+    return info;
+  }
+
+}
+
+int main(int argc, char **argv) {
+  vector<CompactionPolicy::StoreInfo> stores;
+  size_t index, length;
+
+  // Factory
+  HT_ASSERT(!strcmp(CompactionPolicyFactory::create("")->name(), "default"));
+  HT_ASSERT(!strcmp(CompactionPolicyFactory::create("size-tiered")->name(),
+                    "size-tiered"));
+  HT_ASSERT(!strcmp(CompactionPolicyFactory::create("time-window --window 3600")->name(),
+                    "time-window"));
+  try {
+    CompactionPolicyFactory::create("leveled");
+    HT_ASSERT(!"unknown compaction policy accepted");
+  }
+  catch (Exception &e) {
+    HT_ASSERT(e.code() == Error::BAD_SCHEMA);
+  }
+
+  // Size-tiered: one large store followed by four similar small ones
+  {
+    CompactionPolicySizeTiered policy(4, 32, 2.0);
+    stores = { store(1000), store(10), store(12), store(9) };
+    HT_ASSERT(!policy.find_merge_run(stores, 0, &index, &length));
+    stores.push_back(store(11));
+    HT_ASSERT(policy.find_merge_run(stores, 0, &index, &length));
+    HT_ASSERT(index == 1 && length == 4);
+
+    // Run is capped at max threshold
+    CompactionPolicySizeTiered capped(2, 3, 2.0);
+    HT_ASSERT(capped.find_merge_run(stores, 0, &index, &length));
+    HT_ASSERT(index == 1 && length == 3);
+  }
+
+  // Time window: one hour windows, "now" is in hour 10
+  {
+    CompactionPolicyTimeWindow policy(3600, 4, 32);
+    int64_t now = 10 * NANOS_PER_HOUR + 1;
+    int64_t h8 = 8 * NANOS_PER_HOUR;
+    int64_t h9 = 9 * NANOS_PER_HOUR;
+    int64_t h10 = 10 * NANOS_PER_HOUR;
+
+    HT_ASSERT(policy.window_of(store(1, h8 + 5, h8 + 10)) == 8);
+    HT_ASSERT(policy.window_of(store(1, h8 + 5, h9 + 10)) == -1);
+    HT_ASSERT(policy.window_of(store(1, TIMESTAMP_MAX, TIMESTAMP_MIN)) == -1);
+
+    // A store spanning the window boundary separates the two hour 8 stores
+    stores = { store(1, h8, h8+1), store(1, h8+2, h9+1), store(1, h8+3, h8+4),
+               store(1, h10, h10+1) };
+    HT_ASSERT(!policy.find_merge_run(stores, now, &index, &length));
+
+    // Two contiguous stores of an ended window are merged
+    stores = { store(1, h8, h8+1), store(1, h8+2, h8+3), store(1, h9, h9+1),
+               store(1, h10, h10+1) };
+    HT_ASSERT(policy.find_merge_run(stores, now, &index, &length));
+    HT_ASSERT(index == 0 && length == 2);
+
+    // Current window needs min threshold, newest store is never included
+    stores = { store(1, h8, h8+1), store(1, h10, h10+1), store(1, h10+2, h10+3),
+               store(1, h10+4, h10+5), store(1, h10+6, h10+7) };
+    HT_ASSERT(!policy.find_merge_run(stores, now, &index, &length));
+    stores.push_back(store(1, h10+8, h10+9));
+    HT_ASSERT(policy.find_merge_run(stores, now, &index, &length));
+    HT_ASSERT(index == 1 && length == 4);
+  }
+
+  return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <Common/Compat.h>
+
+#include <Hypertable/RangeServer/CompactionThrottle.h>
+#include <Hypertable/RangeServer/MaintenanceFlag.h>
+
+#include <Common/Logger.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace Hypertable;
+using namespace std;
+
+namespace {
+
+  int64_t elapsed_millis(chrono::steady_clock::time_point start) {
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+  }
+
+}
+
+int main(int argc, char **argv) {
+  gInt32t rate(0);
+  gInt32t reserve(50);
+  CompactionThrottle::Statistics stats;
+
+  // Classification
+  HT_ASSERT(CompactionThrottle::classify(MaintenanceFlag::COMPACT_MINOR) ==
+            CompactionThrottle::URGENT);
+  HT_ASSERT(CompactionThrottle::classify(MaintenanceFlag::COMPACT_MINOR |
+                                         MaintenanceFlag::RELINQUISH) ==
+            CompactionThrottle::NORMAL);
+  HT_ASSERT(CompactionThrottle::classify(MaintenanceFlag::COMPACT_MAJOR |
+                                         MaintenanceFlag::SPLIT) ==
+            CompactionThrottle::NORMAL);
+  HT_ASSERT(CompactionThrottle::classify(MaintenanceFlag::COMPACT_MERGING) ==
+            CompactionThrottle::BACKGROUND);
+  HT_ASSERT(CompactionThrottle::classify(MaintenanceFlag::COMPACT_GC) ==
+            CompactionThrottle::BACKGROUND);
+
+  // Unlimited rate never blocks
+  {
+    CompactionThrottle throttle(rate, reserve);
+    auto start = chrono::steady_clock::now();
+    for (int i=0; i<100; i++)
+      throttle.acquire(CompactionThrottle::BACKGROUND, 100*MiB);
+    HT_ASSERT(elapsed_millis(start) < 500);
+    throttle.get_statistics(&stats);
+    HT_ASSERT(stats.rate == 0 && stats.debt == 0);
+    HT_ASSERT(stats.bytes[CompactionThrottle::BACKGROUND] == 10000*(int64_t)MiB);
+  }
+
+  // Urgent I/O may run into debt, background I/O waits for the reserve
+  rate = 10;
+  {
+    CompactionThrottle throttle(rate, reserve);
+    auto start = chrono::steady_clock::now();
+    throttle.acquire(CompactionThrottle::URGENT, 15*MiB);
+    throttle.acquire(CompactionThrottle::URGENT, 1*MiB);
+    HT_ASSERT(elapsed_millis(start) < 500);
+    throttle.get_statistics(&stats);
+    HT_ASSERT(stats.rate == 10*(int64_t)MiB);
+    HT_ASSERT(stats.debt > 5*(int64_t)MiB);
+
+    // Balance is about -6MB, reserve is 5MB, so wait should be ~1.1s
+    start = chrono::steady_clock::now();
+    throttle.acquire(CompactionThrottle::BACKGROUND, 1*MiB);
+    int64_t millis = elapsed_millis(start);
+    if (millis < 800) {
+      cout << "Background acquire only waited " << millis << "ms" << endl;
+      exit(EXIT_FAILURE);
+    }
+    throttle.get_statistics(&stats);
+    HT_ASSERT(stats.wait_millis[CompactionThrottle::BACKGROUND] >= 800);
+  }
+
+  // Rate can be changed at runtime
+  {
+    CompactionThrottle throttle(rate, reserve);
+    throttle.acquire(CompactionThrottle::NORMAL, 30*MiB);
+    rate = 0;
+    auto start = chrono::steady_clock::now();
+    throttle.acquire(CompactionThrottle::NORMAL, 30*MiB);
+    HT_ASSERT(elapsed_millis(start) < 500);
+  }
+
+  return 0;
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <Common/Compat.h>
+
+#include <Hypertable/RangeServer/KeyCompressorPrefixDelta.h>
+#include <Hypertable/RangeServer/KeyDecompressorPrefixDelta.h>
+
+#include <Hypertable/Lib/Key.h>
+#include <Hypertable/Lib/SerializedKey.h>
+
+#include <Common/DynamicBuffer.h>
+#include <Common/Logger.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace Hypertable;
+using namespace std;
+
+namespace {
+
+  /// Appends keys covering each kind of timestamp and revision encoding,
+  /// returning the offset of each key in <code>buf</code>
+  vector<size_t> make_keys(DynamicBuffer &buf) {
+    vector<size_t> offsets;
+    auto add = [&](uint8_t flag, const char *row, const char *qualifier,
+                   int64_t timestamp, int64_t revision, bool time_order_asc) {
+      offsets.push_back(buf.fill());
+      create_key_and_append(buf, flag, row, 1, qualifier, timestamp, revision,
+                            time_order_asc);
+    };
+    char row[32];
+    for (int i=0; i<50; i++) {
+      sprintf(row, "row%04d", i);
+      // several versions of one cell, timestamps decreasing in key order
+      for (int64_t ts=1000000; ts>1000000-5*7; ts-=7)
+        add(FLAG_INSERT, row, "a", ts + i, ts + i, true);
+      // revision differs from timestamp, moving in the opposite direction
+      add(FLAG_INSERT, row, "b", 5000 - i, 900000 + i, true);
+      // chronological timestamp order
+      add(FLAG_INSERT, row, "c", 10 + i, 10 + i, false);
+      // no timestamp
+      add(FLAG_INSERT, row, "d", TIMESTAMP_NULL, 777 + i, true);
+      // extreme values, so deltas wrap around
+      add(FLAG_INSERT, row, "e", TIMESTAMP_MAX - 1, TIMESTAMP_MIN + 2, true);
+      add(FLAG_INSERT, row, "f", TIMESTAMP_MIN + 2, TIMESTAMP_MIN + 2, true);
+      add(FLAG_DELETE_CELL, row, "g", -i, 123456789012LL, true);
+    }
+    offsets.push_back(buf.fill());
+    return offsets;
+  }
+
+  bool same_key(const uint8_t *a, const uint8_t *b) {
+    SerializedKey ka(a), kb(b);
+    return ka.length() == kb.length() && memcmp(a, b, ka.length()) == 0;
+  }
+
+  /// Compresses all keys into one block with a restart point every
+  /// <code>interval</code> keys (none if zero), then decodes the block
+  /// sequentially and from each restart point
+  void round_trip(const DynamicBuffer &keys, const vector<size_t> &offsets,
+                  size_t interval) {
+    size_t count = offsets.size() - 1;
+    KeyCompressorPrefixDelta compressor;
+    DynamicBuffer block;
+    vector<size_t> block_offsets;
+    vector<size_t> restarts;
+    DynamicBuffer uncompressed;
+
+    compressor.reset();
+    for (size_t i=0; i<count; i++) {
+      if (interval && i % interval == 0) {
+        compressor.reset();
+        restarts.push_back(i);
+      }
+      Key key;
+      HT_ASSERT(key.load(SerializedKey(keys.base + offsets[i])));
+      compressor.add(key);
+
+      // the uncompressed rendering reproduces the original key
+      uncompressed.clear();
+      uncompressed.ensure(compressor.length_uncompressed());
+      compressor.write_uncompressed(uncompressed.base);
+      HT_ASSERT(same_key(uncompressed.base, keys.base + offsets[i]));
+
+      block_offsets.push_back(block.fill());
+      block.ensure(compressor.length());
+      compressor.write(block.ptr);
+      block.ptr += compressor.length();
+    }
+    HT_ASSERT(block.fill() < keys.fill());
+
+    // sequential decode, resetting at each restart point
+    KeyDecompressorPrefixDelta decompressor;
+    decompressor.reset();
+    const uint8_t *ptr = block.base;
+    size_t next_restart = 0;
+    for (size_t i=0; i<count; i++) {
+      if (next_restart < restarts.size() && restarts[next_restart] == i) {
+        decompressor.reset();
+        next_restart++;
+      }
+      ptr = decompressor.add(ptr);
+      Key key;
+      decompressor.load(key);
+      HT_ASSERT(same_key(key.serial.ptr, keys.base + offsets[i]));
+      if (i+1 < count) {
+        SerializedKey next(keys.base + offsets[i+1]);
+        HT_ASSERT(decompressor.less_than(next) == (SerializedKey(keys.base + offsets[i]) < next));
+      }
+    }
+    HT_ASSERT(ptr == block.ptr);
+
+    // each restart point decodes without the keys before it
+    for (size_t r : restarts) {
+      decompressor.reset();
+      ptr = decompressor.add(block.base + block_offsets[r]);
+      Key key;
+      decompressor.load(key);
+      HT_ASSERT(same_key(key.serial.ptr, keys.base + offsets[r]));
+      for (size_t i=r+1; i<count && i<r+interval; i++) {
+        ptr = decompressor.add(ptr);
+        decompressor.load(key);
+        HT_ASSERT(same_key(key.serial.ptr, keys.base + offsets[i]));
+      }
+    }
+  }
+
+}
+
+int main(int argc, char **argv) {
+  DynamicBuffer keys;
+  vector<size_t> offsets = make_keys(keys);
+
+  for (size_t interval : { 0, 1, 3, 16 })
+    round_trip(keys, offsets, interval);
+
+  return 0;
+}
@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+#include <Common/Compat.h>
+
+#include <Hypertable/RangeServer/MaintenanceScorerLegacy.h>
+#include <Hypertable/RangeServer/MaintenanceScorerWeighted.h>
+#include <Hypertable/RangeServer/MaintenanceSnapshot.h>
+
+#include <Common/Logger.h>
+#include <Common/Property.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Hypertable;
+using namespace std;
+
+namespace {
+
+  const char *snapshot_text =
+    "low_memory\ttrue\n"
+    "memory_state.needed\t104857600\n"
+    "\n"
+    "Scheduling Decisions:\n"
+    "201 prune threshold\t1073741824\n"
+    "266 prune compact 2/t[..a] (cumulative_size=9, priority=1)\n"
+    "RANGE 2/t[..a]\n"
+    "table_id=2\n"
+    "scans=10\n"
+    "priority=1\n"
+    "maintenance_flags=512\n"
+    "compaction_type_needed=0\n"
+    "busy=false\n"
+    "is_metadata=false\n"
+    "is_system=false\n"
+    "\n"
+    "ACCESS GROUP 2/t[..a](default)\n"
+    "mem_used=209715200\n"
+    "mem_allocated=268435456\n"
+    "disk_used=1073741824\n"
+    "log_space_pinned=2147483648\n"
+    "file_count=4\n"
+    "expired_file_count=0\n"
+    "compression_ratio=0.5\n"
+    "maintenance_flags=513\n"
+    "block_index_memory=1000\n"
+    "bloom_filter_memory=24\n"
+    "shadow_cache_memory=0\n"
+    "scans=6.5\n"
+    "stores_per_scan=3\n"
+    "read_amplification=2.5\n"
+    "in_memory=false\n"
+    "gc_needed=false\n"
+    "needs_merging=true\n"
+    "end_merge=false\n"
+    "\n"
+    "table_id=3\n"
+    "scans=0\n"
+    "is_system=true\n"
+    "\n"
+    "ACCESS GROUP 3/t[..\xff\xff](default)\n"
+    "mem_used=100\n"
+    "\n"
+    "RemoveOkLogs:\n"
+    "/hypertable/servers/rs1/log/user/0\n";
+
+}
+
+int main(int argc, char **argv) {
+  MaintenanceScorer::Parameters params;
+  MaintenanceScorer::AccessGroupState ag;
+  std::vector<MaintenanceCandidate> candidates;
+  int64_t memory_needed;
+  int owners[4];
+
+  params.prune_threshold = 100*MiB;
+  params.access_group_max_mem = 1000*MiB;
+  params.garbage_threshold = 20;
+
+  // Required compaction precedence
+  ag.owner = &owners[0];
+  ag.mem_used = 10*MiB;
+  ag.mem_allocated = 16*MiB;
+  ag.disk_used = 400*MiB;
+  ag.file_count = 4;
+  ag.expired_file_count = 1;
+  ag.gc_needed = true;
+  ag.needs_merging = true;
+  MaintenanceScorer::generate(ag, params, candidates);
+  HT_ASSERT(candidates.size() == 1);
+  HT_ASSERT(candidates[0].action == MaintenanceCandidate::DROP_EXPIRED);
+  HT_ASSERT(candidates[0].required && candidates[0].io_bytes == 0);
+  HT_ASSERT(candidates[0].disk_reclaimed == 100*(int64_t)MiB);
+
+  candidates.clear();
+  ag.expired_file_count = 0;
+  MaintenanceScorer::generate(ag, params, candidates);
+  HT_ASSERT(candidates.size() == 1);
+  HT_ASSERT(candidates[0].action == MaintenanceCandidate::GC_COMPACTION);
+
+  candidates.clear();
+  ag.gc_needed = false;
+  ag.log_space_pinned = 300*MiB;
+  MaintenanceScorer::generate(ag, params, candidates);
+  HT_ASSERT(candidates.size() == 1);
+  HT_ASSERT(candidates[0].action == MaintenanceCandidate::MINOR_COMPACTION);
+  HT_ASSERT(candidates[0].required);
+  HT_ASSERT(candidates[0].log_bytes_released == 200*(int64_t)MiB);
+
+  candidates.clear();
+  ag.log_space_pinned = 0;
+  ag.shadow_cache_memory = 4*MiB;
+  MaintenanceScorer::generate(ag, params, candidates);
+  HT_ASSERT(candidates.size() == 2);
+  HT_ASSERT(candidates[0].action == MaintenanceCandidate::MERGING_COMPACTION);
+  HT_ASSERT(candidates[1].action == MaintenanceCandidate::MEMORY_PURGE);
+  HT_ASSERT(!candidates[1].required);
+
+  candidates.clear();
+  ag.needs_merging = false;
+  MaintenanceScorer::generate(ag, params, candidates);
+  HT_ASSERT(candidates.size() == 2);
+  HT_ASSERT(candidates[0].action == MaintenanceCandidate::MINOR_COMPACTION);
+  HT_ASSERT(!candidates[0].required);
+
+  // Weighted scorer: cheap memory first, only while memory is needed
+  {
+    MaintenanceScorerWeighted::Weights weights;
+    MaintenanceScorerWeighted scorer(weights);
+    MaintenanceScorer::AccessGroupState cheap, expensive, log_heavy;
+
+    candidates.clear();
+
+    // Uncompressible cell cache, costly to write
+    expensive.owner = &owners[1];
+    expensive.mem_used = 60*MiB;
+    expensive.mem_allocated = 64*MiB;
+    expensive.compression_ratio = 1.0;
+    MaintenanceScorer::generate(expensive, params, candidates);
+
+    // Shadow cache purge, free
+    cheap.owner = &owners[2];
+    cheap.shadow_cache_memory = 32*MiB;
+    MaintenanceScorer::generate(cheap, params, candidates);
+
+    // Log pinned beyond the prune threshold
+    log_heavy.owner = &owners[3];
+    log_heavy.mem_used = 1*MiB;
+    log_heavy.mem_allocated = 2*MiB;
+    log_heavy.compression_ratio = 0.5;
+    log_heavy.log_space_pinned = 500*MiB;
+    MaintenanceScorer::generate(log_heavy, params, candidates);
+    HT_ASSERT(candidates.size() == 3);
+
+    memory_needed = 16*MiB;
+    scorer.schedule(candidates, memory_needed);
+    HT_ASSERT(memory_needed == 0);
+    // Free purge first, then log pruning compaction
+    HT_ASSERT(candidates[0].owner == &owners[2] && candidates[0].selected);
+    HT_ASSERT(candidates[1].owner == &owners[3] && candidates[1].selected);
+    // Memory need already met, expensive compaction not worth it
+    HT_ASSERT(candidates[2].owner == &owners[1] && !candidates[2].selected);
+
+    memory_needed = 0;
+    scorer.schedule(candidates, memory_needed);
+    for (auto &candidate : candidates)
+      HT_ASSERT(candidate.selected == (candidate.owner == &owners[3]));
+
+    memory_needed = 256*MiB;
+    scorer.schedule(candidates, memory_needed);
+    for (auto &candidate : candidates)
+      HT_ASSERT(candidate.selected);
+    HT_ASSERT(memory_needed == 256*(int64_t)MiB - 98*(int64_t)MiB);
+  }
+
+  // At most one optional action per access group, never alongside a
+  // required one
+  {
+    MaintenanceScorerLegacy scorer;
+    candidates.clear();
+    ag = MaintenanceScorer::AccessGroupState();
+    ag.owner = &owners[0];
+    ag.mem_used = 10*MiB;
+    ag.mem_allocated = 10*MiB;
+    ag.shadow_cache_memory = 1*MiB;
+    MaintenanceScorer::generate(ag, params, candidates);
+    HT_ASSERT(candidates.size() == 2);
+    memory_needed = 100*MiB;
+    scorer.schedule(candidates, memory_needed);
+    HT_ASSERT(candidates[0].action == MaintenanceCandidate::MEMORY_PURGE);
+    HT_ASSERT(candidates[0].selected && !candidates[1].selected);
+
+    candidates.clear();
+    ag.needs_merging = true;
+    MaintenanceScorer::generate(ag, params, candidates);
+    scorer.schedule(candidates, memory_needed);
+    HT_ASSERT(candidates[0].action == MaintenanceCandidate::MERGING_COMPACTION);
+    HT_ASSERT(candidates[0].selected && !candidates[1].selected);
+  }
+
+  // Merging benefit follows scan fan-in and read amplification
+  {
+    MaintenanceScorer::AccessGroupState cold, hot;
+    candidates.clear();
+    cold.owner = &owners[0];
+    cold.disk_used = 800*MiB;
+    cold.file_count = 8;
+    cold.needs_merging = true;
+    cold.scans = 100;
+    cold.stores_per_scan = 1;
+    MaintenanceScorer::generate(cold, params, candidates);
+    hot = cold;
+    hot.owner = &owners[1];
+    hot.stores_per_scan = 6;
+    hot.read_amplification = 2;
+    MaintenanceScorer::generate(hot, params, candidates);
+    HT_ASSERT(candidates.size() == 2);
+    // Scans that touch a single store gain nothing from a merge
+    HT_ASSERT(candidates[0].reads_avoided == 0.0);
+    // Run of four stores, scans read six of them
+    HT_ASSERT(candidates[1].reads_avoided == 100.0 * 3.0 * 2.0);
+    MaintenanceScorerWeighted::Weights weights;
+    MaintenanceScorerWeighted scorer(weights);
+    memory_needed = 0;
+    scorer.schedule(candidates, memory_needed);
+    HT_ASSERT(candidates[0].owner == &owners[1]);
+  }
+
+  // Snapshot loading
+  {
+    MaintenanceSnapshot snapshot;
+    istringstream in(snapshot_text);
+    snapshot.load(in);
+    HT_ASSERT(snapshot.low_memory);
+    HT_ASSERT(snapshot.memory_needed == 100*(int64_t)MiB);
+    HT_ASSERT(snapshot.prune_threshold == 1*(int64_t)GiB);
+    HT_ASSERT(snapshot.ranges.size() == 2);
+
+    const MaintenanceSnapshot::RangeRecord &range = snapshot.ranges[0];
+    HT_ASSERT(range.name == "2/t[..a]");
+    HT_ASSERT(range.table_id == "2" && range.scans == 10);
+    HT_ASSERT(range.priority == 1 && range.maintenance_flags == 512);
+    HT_ASSERT(range.access_groups.size() == 1);
+    const MaintenanceSnapshot::AccessGroupRecord &rec = range.access_groups[0];
+    HT_ASSERT(rec.name == "2/t[..a](default)");
+    HT_ASSERT(rec.maintenance_flags == 513);
+    HT_ASSERT(rec.state.owner == &rec);
+    HT_ASSERT(rec.has_scan_statistics && rec.state.scans == 6.5);
+    HT_ASSERT(rec.state.stores_per_scan == 3.0);
+    HT_ASSERT(rec.state.read_amplification == 2.5);
+    HT_ASSERT(rec.state.mem_used == 200*(int64_t)MiB);
+    HT_ASSERT(rec.state.log_space_pinned == 2*(int64_t)GiB);
+    HT_ASSERT(rec.state.file_count == 4);
+    HT_ASSERT(rec.state.compression_ratio == 0.5);
+    HT_ASSERT(rec.state.index_memory == 1024);
+    HT_ASSERT(rec.state.needs_merging && !rec.state.end_merge);
+
+    // Range without a name line
+    HT_ASSERT(snapshot.ranges[1].name.empty());
+    HT_ASSERT(snapshot.ranges[1].table_id == "3");
+    HT_ASSERT(snapshot.ranges[1].is_system);
+    HT_ASSERT(snapshot.ranges[1].access_groups.size() == 1);
+    HT_ASSERT(snapshot.ranges[1].access_groups[0].state.mem_used == 100);
+    HT_ASSERT(!snapshot.ranges[1].access_groups[0].has_scan_statistics);
+  }
+
+  return 0;
+}
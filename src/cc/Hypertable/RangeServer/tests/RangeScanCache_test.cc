@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <Common/Compat.h>
+
+#include <Hypertable/RangeServer/RangeScanCache.h>
+
+#include <Hypertable/Lib/Key.h>
+
+#include <Common/Logger.h>
+#include <Common/md5.h>
+#include <Common/System.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace Hypertable;
+using namespace std;
+
+#define MAX_MEMORY 100000
+#define MAX_RESULT_SIZE 1000
+
+namespace {
+
+  void make_key(RangeScanCache::Key *key, const char *str) {
+    md5_csum((unsigned char *)str, strlen(str), (unsigned char *)key->digest);
+  }
+
+  bool cached(RangeScanCache &cache, const char *str) {
+    RangeScanCache::Key key;
+    boost::shared_array<uint8_t> result;
+    uint32_t result_length, cell_count;
+    make_key(&key, str);
+    return cache.lookup(&key, result, &result_length, &cell_count);
+  }
+
+}
+
+int main(int argc, char **argv) {
+  RangeScanCache cache(MAX_MEMORY, MAX_RESULT_SIZE);
+  RangeScanCache::Key key;
+  uint8_t result[MAX_RESULT_SIZE+1];
+  std::set<uint8_t> columns;
+
+  System::initialize(System::locate_install_dir(argv[0]));
+
+  memset(result, 0, sizeof(result));
+
+  // results larger than the threshold are not cached
+  make_key(&key, "big");
+  HT_ASSERT(!cache.insert(cache.sequence("1", "m"), &key, "1", "m", "a", "c",
+                          columns, 0, result, MAX_RESULT_SIZE+1));
+  HT_ASSERT(!cached(cache, "big"));
+
+  // scans over [b..d] and [f..h] in range (..m], [p..r] in range (m..z]
+  columns.insert(1);
+  make_key(&key, "bd");
+  HT_ASSERT(cache.insert(cache.sequence("1", "m"), &key, "1", "m", "b", "d",
+                         columns, 0, result, 100));
+  columns.insert(2);
+  make_key(&key, "fh");
+  HT_ASSERT(cache.insert(cache.sequence("1", "m"), &key, "1", "m", "f", "h",
+                         columns, 0, result, 100));
+  make_key(&key, "pr");
+  HT_ASSERT(cache.insert(cache.sequence("1", "z"), &key, "1", "z", "p", "r",
+                         columns, 0, result, 100));
+  HT_ASSERT(cached(cache, "bd") && cached(cache, "fh") && cached(cache, "pr"));
+
+  // update outside of any cached interval
+  cache.invalidate("1", "m", "e", "e", columns);
+  HT_ASSERT(cached(cache, "bd") && cached(cache, "fh") && cached(cache, "pr"));
+
+  // update inside [b..d] but to a column the scan didn't select
+  columns.clear();
+  columns.insert(2);
+  cache.invalidate("1", "m", "c", "c", columns);
+  HT_ASSERT(cached(cache, "bd"));
+
+  // update overlapping [f..h] in another table
+  cache.invalidate("2", "m", "a", "g", columns);
+  HT_ASSERT(cached(cache, "fh"));
+
+  // update interval overlapping both [b..d] and [f..h], all columns
+  columns.clear();
+  cache.invalidate("1", "m", "d", "f", columns);
+  HT_ASSERT(!cached(cache, "bd") && !cached(cache, "fh"));
+  HT_ASSERT(cached(cache, "pr"));
+
+  // range load invalidation
+  cache.invalidate("1", "m", "z");
+  HT_ASSERT(!cached(cache, "pr"));
+  HT_ASSERT(cache.available_memory() == MAX_MEMORY);
+
+  // LRU eviction
+  char keybuf[32];
+  for (int i=0; i<1000; i++) {
+    snprintf(keybuf, sizeof(keybuf), "%d", i);
+    make_key(&key, keybuf);
+    HT_ASSERT(cache.insert(cache.sequence("1", "m"), &key, "1", "m", "a", "b",
+                           columns, 0, result, 500));
+    if (i == 10)
+      HT_ASSERT(cached(cache, "0"));
+  }
+  HT_ASSERT(!cached(cache, "1") && cached(cache, "999"));
+  HT_ASSERT(cache.memory_used() <= MAX_MEMORY);
+
+  // a result that raced with an invalidation of its range is dropped, even
+  // if the invalidated interval doesn't overlap it
+  columns.clear();
+  uint64_t sequence_m = cache.sequence("1", "m");
+  uint64_t sequence_z = cache.sequence("1", "z");
+  cache.invalidate("1", "m", "x", "x", columns);
+  HT_ASSERT(cache.sequence("1", "m") != sequence_m);
+  make_key(&key, "race");
+  HT_ASSERT(!cache.insert(sequence_m, &key, "1", "m", "a", "c", columns, 0,
+                          result, 100));
+  HT_ASSERT(!cached(cache, "race"));
+
+  // other ranges are unaffected
+  HT_ASSERT(cache.sequence("1", "z") == sequence_z);
+  make_key(&key, "other");
+  HT_ASSERT(cache.insert(sequence_z, &key, "1", "z", "p", "r", columns, 0,
+                         result, 100));
+  HT_ASSERT(cached(cache, "other"));
+
+  // a range load invalidation races with scans of every range
+  sequence_z = cache.sequence("1", "z");
+  cache.invalidate("2", "a", "b");
+  make_key(&key, "load");
+  HT_ASSERT(!cache.insert(sequence_z, &key, "1", "z", "p", "r", columns, 0,
+                          result, 100));
+
+  return 0;
+}
@@ -0,0 +1,354 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <Common/Compat.h>
+
+#include <Hypertable/RangeServer/CellCache.h>
+#include <Hypertable/RangeServer/Global.h>
+#include <Hypertable/RangeServer/MergeScannerAccessGroup.h>
+#include <Hypertable/RangeServer/ScanContext.h>
+
+#include <Hypertable/Lib/Key.h>
+#include <Hypertable/Lib/ProfileDataScanner.h>
+#include <Hypertable/Lib/Schema.h>
+
+#include <Common/DynamicBuffer.h>
+#include <Common/Init.h>
+#include <Common/Logger.h>
+
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace Hypertable;
+using namespace std;
+
+namespace {
+
+  const char *schema_str =
+  "<Schema>\n"
+  "  <AccessGroup name=\"default\">\n"
+  "    <ColumnFamily id=\"1\">\n"
+  "      <Name>a</Name>\n"
+  "    </ColumnFamily>\n"
+  "    <ColumnFamily id=\"2\">\n"
+  "      <Name>v</Name>\n"
+  "      <Options>\n"
+  "        <MaxVersions>1</MaxVersions>\n"
+  "      </Options>\n"
+  "    </ColumnFamily>\n"
+  "    <ColumnFamily id=\"3\">\n"
+  "      <Name>c</Name>\n"
+  "      <Options>\n"
+  "        <Counter>true</Counter>\n"
+  "      </Options>\n"
+  "    </ColumnFamily>\n"
+  "  </AccessGroup>\n"
+  "</Schema>";
+
+  const size_t ROWS = 30;
+
+  String row_name(size_t i) {
+    return format("row%02u", (unsigned)i);
+  }
+
+  void add(CellCachePtr &cache, uint8_t flag, const String &row,
+           uint8_t family, const char *qualifier, int64_t revision,
+           const String &value = String()) {
+    DynamicBuffer key_buf;
+    create_key_and_append(key_buf, flag, row.c_str(), family, qualifier,
+                          revision, revision);
+    Key key;
+    key.load(SerializedKey(key_buf.base));
+    DynamicBuffer value_buf;
+    append_as_byte_string(value_buf, value.c_str(), value.length());
+    cache->add(key, ByteString(value_buf.base));
+  }
+
+  void add_counter(CellCachePtr &cache, const String &row,
+                   const char *qualifier, int64_t revision, int64_t amount) {
+    DynamicBuffer key_buf;
+    create_key_and_append(key_buf, FLAG_INSERT, row.c_str(), 3, qualifier,
+                          revision, revision);
+    Key key;
+    key.load(SerializedKey(key_buf.base));
+    uint8_t value_buf[9];
+    uint8_t *ptr = value_buf;
+    *ptr++ = 8;
+    Serialization::encode_i64(&ptr, (uint64_t)amount);
+    cache->add_counter(key, ByteString(value_buf));
+  }
+
+  /// Three cell caches standing in for an older cell store, a newer cell
+  /// store and the cell cache of an access group.  Inserts alternate
+  /// between values matching and not matching "keep", and the newer caches
+  /// hold deletes that shadow cells of the older ones.
+  vector<CellCachePtr> make_caches() {
+    vector<CellCachePtr> caches;
+    for (size_t i=0; i<3; i++)
+      caches.push_back(make_shared<CellCache>());
+    int64_t revision = 1;
+    for (size_t i=0; i<ROWS; i++) {
+      String row = row_name(i);
+      for (int q=0; q<3; q++) {
+        String qualifier = format("q%d", q);
+        add(caches[0], FLAG_INSERT, row, 1, qualifier.c_str(), revision++,
+            format("%s-%s-old", (i+q) % 2 ? "keep" : "drop", row.c_str()));
+      }
+      // versions of a single cell, alternating between matching and not
+      for (int n=0; n<3; n++)
+        add(caches[0], FLAG_INSERT, row, 2, "x", revision++,
+            format("%s-%d", (i+n) % 2 ? "keep" : "drop", n));
+      add_counter(caches[0], row, "n", revision++, (int64_t)i);
+    }
+    for (size_t i=0; i<ROWS; i++) {
+      String row = row_name(i);
+      if (i % 3 == 0)
+        add(caches[1], FLAG_DELETE_CELL, row, 1, "q1", revision++);
+      if (i % 5 == 0)
+        add(caches[1], FLAG_DELETE_ROW, row, 0, "", revision++);
+      add(caches[1], FLAG_INSERT, row, 1, "q1", revision++,
+          format("%s-%s-new", i % 4 ? "drop" : "keep", row.c_str()));
+      add_counter(caches[1], row, "n", revision++, 100);
+    }
+    for (size_t i=0; i<ROWS; i+=2) {
+      String row = row_name(i);
+      add(caches[2], FLAG_INSERT, row, 1, "q2", revision++,
+          format("keep-%s-mem", row.c_str()));
+      add(caches[2], FLAG_INSERT, row, 2, "x", revision++, "drop-mem");
+      if (i % 7 == 0)
+        add(caches[2], FLAG_DELETE_CELL, row, 1, "q0", revision++);
+      add_counter(caches[2], row, "n", revision++, 1000);
+    }
+    return caches;
+  }
+
+  String to_string(const Key &key, const ByteString &value) {
+    String str = format("%s %d:%s %lld %d", key.row,
+                        (int)key.column_family_code, key.column_qualifier,
+                        (Lld)key.timestamp, (int)key.flag);
+    if (value.ptr == 0)
+      return str + " <no value>";
+    const uint8_t *ptr;
+    size_t len = value.decode_length(&ptr);
+    str += " ";
+    for (size_t i=0; i<len; i++) {
+      if (isprint(ptr[i]))
+        str += (char)ptr[i];
+      else
+        str += format("\\x%02x", (unsigned)ptr[i]);
+    }
+    return str;
+  }
+
+  struct ScanResult {
+    vector<String> cells;
+    int64_t filtered_pushdown {};
+    int64_t filtered_merge {};
+  };
+
+  /// Merges <code>caches</code> for the scan built by <code>build</code>,
+  /// with predicate pushdown as chosen by ScanContext or disabled
+  ScanResult scan(vector<CellCachePtr> &caches, SchemaPtr &schema,
+                  function<void(ScanSpecBuilder &)> build, bool pushdown,
+                  bool *pushdown_chosen = 0) {
+    ScanSpecBuilder ssbuilder;
+    build(ssbuilder);
+    RangeSpec range("", Key::END_ROW_MARKER);
+    ScanContextPtr scan_ctx =
+      make_shared<ScanContext>(TIMESTAMP_MAX, &(ssbuilder.get()), &range,
+                               schema);
+    if (pushdown_chosen)
+      *pushdown_chosen = scan_ctx->pushdown;
+    if (!pushdown)
+      scan_ctx->pushdown = false;
+
+    String table_name("0");
+    MergeScannerAccessGroup mscanner(table_name, scan_ctx.get(),
+                                     MergeScannerAccessGroup::ACCUMULATE_COUNTERS);
+    for (auto &cache : caches)
+      mscanner.add_scanner(cache->create_scanner(scan_ctx.get()));
+
+    ScanResult result;
+    Key key;
+    ByteString value;
+    while (mscanner.get(key, value)) {
+      result.cells.push_back(to_string(key, value));
+      mscanner.forward();
+    }
+    result.filtered_pushdown = mscanner.get_pushdown_filtered_cells();
+    result.filtered_merge = mscanner.get_merge_filtered_cells();
+    return result;
+  }
+
+  /// Runs a scan with and without pushdown, checks that both return the
+  /// same cells and that pushdown was chosen as <code>expect_pushdown</code>
+  ScanResult check(const String &label, vector<CellCachePtr> &caches,
+                   SchemaPtr &schema, function<void(ScanSpecBuilder &)> build,
+                   bool expect_pushdown) {
+    bool pushdown_chosen;
+    ScanResult with = scan(caches, schema, build, true, &pushdown_chosen);
+    ScanResult without = scan(caches, schema, build, false);
+
+    if (with.cells != without.cells) {
+      cerr << label << ": " << with.cells.size() << " cells with pushdown, "
+           << without.cells.size() << " without" << endl;
+      for (size_t i=0; i<with.cells.size() || i<without.cells.size(); i++) {
+        String w = i < with.cells.size() ? with.cells[i] : "<none>";
+        String wo = i < without.cells.size() ? without.cells[i] : "<none>";
+        if (w != wo) {
+          cerr << "  first difference at " << i << ": '" << w << "' with, '"
+               << wo << "' without" << endl;
+          break;
+        }
+      }
+      exit(EXIT_FAILURE);
+    }
+    if (pushdown_chosen != expect_pushdown) {
+      cerr << label << ": pushdown " << (pushdown_chosen ? "on" : "off")
+           << ", expected " << (expect_pushdown ? "on" : "off") << endl;
+      exit(EXIT_FAILURE);
+    }
+    HT_ASSERT(!with.cells.empty());
+    HT_ASSERT(without.filtered_pushdown == 0);
+    if (expect_pushdown) {
+      // cells dropped early no longer reach the merge
+      HT_ASSERT(with.filtered_pushdown > 0);
+      HT_ASSERT(with.filtered_merge < without.filtered_merge);
+    }
+    else {
+      HT_ASSERT(with.filtered_pushdown == 0);
+      HT_ASSERT(with.filtered_merge == without.filtered_merge);
+    }
+    return with;
+  }
+
+  void check_profile_data(int64_t filtered_pushdown, int64_t filtered_merge) {
+    ProfileDataScanner profile_data;
+    profile_data.cells_scanned = 10;
+    profile_data.cells_filtered_pushdown = filtered_pushdown;
+    profile_data.cells_filtered_merge = filtered_merge;
+    profile_data.servers.insert("rs1");
+
+    vector<uint8_t> buf(profile_data.encoded_length());
+    uint8_t *ptr = buf.data();
+    profile_data.encode(&ptr);
+    HT_ASSERT(ptr == buf.data() + buf.size());
+
+    ProfileDataScanner decoded;
+    const uint8_t *cptr = buf.data();
+    size_t remain = buf.size();
+    decoded.decode(&cptr, &remain);
+    HT_ASSERT(remain == 0);
+    HT_ASSERT(decoded.cells_scanned == 10);
+    HT_ASSERT(decoded.cells_filtered_pushdown == filtered_pushdown);
+    HT_ASSERT(decoded.cells_filtered_merge == filtered_merge);
+
+    decoded += profile_data;
+    HT_ASSERT(decoded.cells_filtered_pushdown == 2*filtered_pushdown);
+    HT_ASSERT(decoded.cells_filtered_merge == 2*filtered_merge);
+    decoded -= profile_data;
+    HT_ASSERT(decoded.cells_filtered_pushdown == filtered_pushdown);
+    HT_ASSERT(decoded.cells_filtered_merge == filtered_merge);
+  }
+
+}
+
+int main(int argc, char **argv) {
+  Config::init(argc, argv);
+  Global::cell_cache_scanner_cache_size = 16;
+
+  SchemaPtr schema(Schema::new_instance(schema_str));
+  vector<CellCachePtr> caches = make_caches();
+
+  // value predicate over inserts shadowed by DELETE_CELL and DELETE_ROW
+  ScanResult result =
+    check("value predicate", caches, schema, [](ScanSpecBuilder &ssb) {
+        ssb.add_column("a");
+        ssb.add_column_predicate("a", "", ColumnPredicate::PREFIX_MATCH, "keep");
+      }, true);
+  check_profile_data(result.filtered_pushdown, result.filtered_merge);
+
+  check("qualifier predicate", caches, schema, [](ScanSpecBuilder &ssb) {
+      ssb.add_column("a:q1");
+    }, true);
+
+  check("value regexp", caches, schema, [](ScanSpecBuilder &ssb) {
+      ssb.add_column("a");
+      ssb.set_value_regexp("^keep.*new$");
+    }, true);
+
+  // deletes are returned as well
+  check("value predicate with deletes", caches, schema,
+        [](ScanSpecBuilder &ssb) {
+          ssb.add_column("a");
+          ssb.add_column_predicate("a", "", ColumnPredicate::PREFIX_MATCH,
+                                   "keep");
+          ssb.set_return_deletes(true);
+        }, true);
+
+  // keys only with a predicate that needs the values
+  check("keys only value predicate", caches, schema, [](ScanSpecBuilder &ssb) {
+      ssb.set_keys_only(true);
+      ssb.add_column("a");
+      ssb.add_column_predicate("a", "", ColumnPredicate::PREFIX_MATCH, "keep");
+    }, true);
+  check("keys only value regexp", caches, schema, [](ScanSpecBuilder &ssb) {
+      ssb.set_keys_only(true);
+      ssb.add_column("a");
+      ssb.set_value_regexp("keep");
+    }, true);
+  check("keys only qualifier predicate", caches, schema,
+        [](ScanSpecBuilder &ssb) {
+          ssb.set_keys_only(true);
+          ssb.add_column("a:q1");
+        }, true);
+
+  // versions are counted before predicates are applied, so neither a
+  // family nor a scan version limit may be pushed down
+  check("max versions family", caches, schema, [](ScanSpecBuilder &ssb) {
+      ssb.add_column("v");
+      ssb.add_column_predicate("v", "", ColumnPredicate::PREFIX_MATCH, "keep");
+    }, false);
+  check("max versions scan", caches, schema, [](ScanSpecBuilder &ssb) {
+      ssb.set_max_versions(1);
+      ssb.add_column("a");
+      ssb.add_column_predicate("a", "", ColumnPredicate::PREFIX_MATCH, "keep");
+    }, false);
+
+  // counters are accumulated before the value regexp is applied
+  check("counter", caches, schema, [](ScanSpecBuilder &ssb) {
+      ssb.add_column("c");
+      ssb.set_value_regexp("keep");
+    }, false);
+
+  // pushdown applies to some families of a scan only
+  check("mixed families", caches, schema, [](ScanSpecBuilder &ssb) {
+      ssb.add_column("a");
+      ssb.add_column("v");
+      ssb.add_column("c");
+      ssb.set_value_regexp("keep");
+    }, true);
+
+  return 0;
+}
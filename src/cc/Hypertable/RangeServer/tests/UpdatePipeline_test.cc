@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <Common/Compat.h>
+
+#include <Hypertable/RangeServer/UpdatePipeline.h>
+
+#include <Hypertable/Lib/RangeServer/Protocol.h>
+
+#include <Common/Error.h>
+#include <Common/Logger.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Hypertable;
+using namespace std;
+
+namespace {
+
+  typedef UpdatePipeline::CommitBlock CommitBlock;
+
+  UpdateRecTable *make_update(const char *table_id, int64_t generation,
+                              const string &data, uint32_t flags = 0) {
+    UpdateRecTable *table_update = new UpdateRecTable();
+    table_update->id.id = table_id;
+    table_update->id.generation = generation;
+    table_update->flags = flags;
+    table_update->go_buf.reserve(table_update->id.encoded_length() + data.length());
+    table_update->id.encode(&table_update->go_buf.ptr);
+    table_update->go_buf.set_mark();
+    if (!data.empty())
+      table_update->go_buf.add_unchecked(data.data(), data.length());
+    return table_update;
+  }
+
+  UpdateContext *make_context(vector<UpdateRecTable *> updates,
+                              int64_t revision) {
+    UpdateContext *uc =
+      new UpdateContext(updates, chrono::fast_clock::now());
+    uc->last_revision = revision;
+    return uc;
+  }
+
+  /// Checks that a block starts with the table identifier followed by
+  /// <code>data</code>
+  void check_block(CommitBlock &block, const char *table_id,
+                   int64_t generation, const string &data) {
+    DynamicBuffer &buf = block.buffer();
+    const uint8_t *ptr = buf.base;
+    size_t remain = buf.fill();
+    TableIdentifier id;
+    id.decode(&ptr, &remain);
+    HT_ASSERT(!strcmp(id.id, table_id));
+    HT_ASSERT(id.generation == generation);
+    HT_ASSERT(ptr == buf.mark);
+    HT_ASSERT(string((const char *)ptr, remain) == data);
+  }
+
+}
+
+int main(int argc, char **argv) {
+  const uint32_t NO_LOG_SYNC =
+    Lib::RangeServer::Protocol::UPDATE_FLAG_NO_LOG_SYNC;
+  const uint32_t NO_LOG = Lib::RangeServer::Protocol::UPDATE_FLAG_NO_LOG;
+
+  std::list<UpdateContext *> batch;
+
+  batch.push_back(make_context({ make_update("1", 1, "a1"),
+                                 make_update("2", 1, "b1", NO_LOG_SYNC) },
+                               100));
+
+  batch.push_back(make_context({ make_update("1", 1, "a2"),
+                                 make_update("1", 2, "c2"),
+                                 make_update("3", 1, "x2", NO_LOG) },
+                               300));
+
+  UpdateRecTable *failed = make_update("4", 1, "y3");
+  failed->error = Error::RANGESERVER_TABLE_NOT_FOUND;
+  batch.push_back(make_context({ make_update("2", 1, "b3", NO_LOG_SYNC),
+                                 failed,
+                                 make_update("5", 1, "") },
+                               200));
+
+  UpdatePipeline::CommitBlockMap blocks;
+  UpdatePipeline::build_commit_blocks(batch, blocks);
+
+  // one block per table generation with something to log
+  HT_ASSERT(blocks.size() == 3);
+
+  // table 1 generation 1, merged across two contexts
+  {
+    CommitBlock &block = blocks[make_pair(string("1"), (int64_t)1)];
+    HT_ASSERT(block.table_updates.size() == 2);
+    HT_ASSERT(block.owner == batch.front());
+    HT_ASSERT(block.revision == 300);
+    HT_ASSERT(block.sync);
+    check_block(block, "1", 1, "a1a2");
+  }
+
+  // table 1 generation 2 is a separate block, written from go_buf directly
+  {
+    CommitBlock &block = blocks[make_pair(string("1"), (int64_t)2)];
+    HT_ASSERT(block.table_updates.size() == 1);
+    HT_ASSERT(&block.buffer() == &block.table_updates.front()->go_buf);
+    HT_ASSERT(block.owner == *std::next(batch.begin()));
+    HT_ASSERT(block.revision == 300);
+    HT_ASSERT(block.sync);
+    check_block(block, "1", 2, "c2");
+  }
+
+  // table 2 takes the largest revision of its own contributors only, and
+  // does not need a sync
+  {
+    CommitBlock &block = blocks[make_pair(string("2"), (int64_t)1)];
+    HT_ASSERT(block.table_updates.size() == 2);
+    HT_ASSERT(block.owner == batch.front());
+    HT_ASSERT(block.revision == 200);
+    HT_ASSERT(!block.sync);
+    check_block(block, "2", 1, "b1b3");
+  }
+
+  // NO_LOG, failed and empty table updates are not logged
+  HT_ASSERT(blocks.count(make_pair(string("3"), (int64_t)1)) == 0);
+  HT_ASSERT(blocks.count(make_pair(string("4"), (int64_t)1)) == 0);
+  HT_ASSERT(blocks.count(make_pair(string("5"), (int64_t)1)) == 0);
+
+  // a single context yields one block per table without merging
+  {
+    std::list<UpdateContext *> single;
+    single.push_back(batch.back());
+    UpdatePipeline::CommitBlockMap single_blocks;
+    UpdatePipeline::build_commit_blocks(single, single_blocks);
+    HT_ASSERT(single_blocks.size() == 1);
+    CommitBlock &block = single_blocks.begin()->second;
+    HT_ASSERT(block.revision == 200 && !block.sync);
+    HT_ASSERT(block.merged.fill() == 0);
+    check_block(block, "2", 1, "b3");
+  }
+
+  for (UpdateContext *uc : batch)
+    delete uc;
+
+  return 0;
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+
+
+#include <Common/Compat.h>
+
+#include <Hypertable/RangeServer/Config.h>
+#include <Hypertable/RangeServer/ContainingRangeCache.h>
+#include <Hypertable/RangeServer/TableInfo.h>
+
+#include <Hypertable/Lib/Key.h>
+#include <Hypertable/Lib/SerializedKey.h>
+
+#include <Common/ByteString.h>
+#include <Common/DynamicBuffer.h>
+#include <Common/Init.h>
+#include <Common/Logger.h>
+#include <Common/Usage.h>
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <string>
+
+using namespace Hypertable;
+using namespace Config;
+using namespace std;
+
+namespace {
+
+  struct AppPolicy : Policy {
+    static void init_options() {
+      cmdline_desc("Usage: %s [options]\n\n"
+        "Measures the rate (cells/s) at which sorted update buffers are routed\n"
+        "to their containing ranges by the qualify stage of the update\n"
+        "pipeline, with a range set lookup per cell and with the cached\n"
+        "containing range.\n\nOptions")
+        .add_options()
+        ("ranges", i32(64), "Number of ranges")
+        ("cells", i32(1000000), "Number of cells per buffer")
+        ("row-length", i32(24), "Length of row keys")
+        ("iterations", i32(5), "Number of passes over the buffer")
+        ;
+    }
+  };
+
+  typedef Meta::list<AppPolicy, DefaultPolicy> Policies;
+
+  /// %Range set with the same lookup as TableInfo::find_containing_range().
+  /// Ranges are not instantiated, the located RangePtr is always null.
+  class RangeSetModel {
+  public:
+    void add(const String &start_row, const String &end_row) {
+      m_active_set.insert(RangeInfo(start_row, end_row));
+    }
+    bool find_containing_range(const String &row, RangePtr &range,
+                               String &start_row, String &end_row) {
+      lock_guard<mutex> lock(m_mutex);
+      RangeInfo range_info("", row);
+      auto iter = m_active_set.lower_bound(range_info);
+      if (iter == m_active_set.end() || iter->start_row.compare(row) >= 0)
+        return false;
+      start_row = iter->start_row;
+      end_row = iter->end_row;
+      range = iter->range;
+      return true;
+    }
+  private:
+    mutex m_mutex;
+    set<RangeInfo> m_active_set;
+  };
+
+  String make_row(int64_t n, int length) {
+    return format("%0*lld", length, (Lld)n);
+  }
+
+  /// Routes every cell in <code>buf</code>, returning number of range
+  /// switches.
+  int64_t route_per_cell(RangeSetModel &range_set, const DynamicBuffer &buf) {
+    SerializedKey key;
+    RangePtr range;
+    String start_row, end_row, last_end_row;
+    int64_t switches = 0;
+    const uint8_t *end = buf.base + buf.fill();
+    key.ptr = buf.base;
+    while (key.ptr < end) {
+      if (!range_set.find_containing_range(key.row(), range, start_row, end_row))
+        HT_FATALF("Row %s not found", key.row());
+      if (end_row != last_end_row) {
+        last_end_row = end_row;
+        switches++;
+      }
+      key.next(); // skip key
+      key.next(); // skip value
+    }
+    return switches;
+  }
+
+  int64_t route_cached(RangeSetModel &range_set, const DynamicBuffer &buf) {
+    SerializedKey key;
+    ContainingRangeCache range_cache;
+    int64_t switches = 0;
+    const uint8_t *end = buf.base + buf.fill();
+    key.ptr = buf.base;
+    while (key.ptr < end) {
+      if (!range_cache.contains(key.row())) {
+        if (!range_cache.find(range_set, key.row()))
+          HT_FATALF("Row %s not found", key.row());
+        switches++;
+      }
+      key.next(); // skip key
+      key.next(); // skip value
+    }
+    return switches;
+  }
+
+  template <typename RouteT>
+  void run(const char *label, RouteT route, RangeSetModel &range_set,
+           const DynamicBuffer &buf, int64_t cells, int iterations) {
+    int64_t switches = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i=0; i<iterations; i++)
+      switches = route(range_set, buf);
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    printf("%-10s %12.0f cells/s (%lld range switches per pass)\n", label,
+           ((double)cells * (double)iterations) / elapsed, (Lld)switches);
+  }
+
+} // local namespace
+
+
+int main(int argc, char **argv) {
+  try {
+    init_with_policies<Policies>(argc, argv);
+
+    int32_t range_count = get_i32("ranges");
+    int32_t cells = get_i32("cells");
+    int32_t row_length = get_i32("row-length");
+    int32_t iterations = get_i32("iterations");
+
+    if (range_count <= 0 || cells <= 0 || iterations <= 0 || row_length < 10) {
+      cerr << "error: invalid option value" << endl;
+      quick_exit(EXIT_FAILURE);
+    }
+
+    // Row keys are the zero-padded even numbers [0, 2*cells), ranges are split
+    // on odd numbers so that every row is contained in some range
+    RangeSetModel range_set;
+    String start_row;
+    for (int32_t i=1; i<range_count; i++) {
+      String end_row = make_row(((2*(int64_t)cells*i) / range_count) | 1, row_length);
+      range_set.add(start_row, end_row);
+      start_row = end_row;
+    }
+    range_set.add(start_row, Key::END_ROW_MARKER);
+
+    DynamicBuffer buf;
+    for (int32_t i=0; i<cells; i++) {
+      String row = make_row(2*(int64_t)i, row_length);
+      create_key_and_append(buf, FLAG_INSERT, row.c_str(), 1, "q");
+      append_as_byte_string(buf, "value");
+    }
+
+    printf("ranges=%d cells=%d row-length=%d iterations=%d\n",
+           (int)range_count, (int)cells, (int)row_length, (int)iterations);
+    run("per-cell", route_per_cell, range_set, buf, cells, iterations);
+    run("cached", route_cached, range_set, buf, cells, iterations);
+  }
+  catch (Exception &e) {
+    HT_ERROR_OUT << e << HT_END;
+    quick_exit(EXIT_FAILURE);
+  }
+  fflush(stdout);
+  quick_exit(EXIT_SUCCESS);
+}
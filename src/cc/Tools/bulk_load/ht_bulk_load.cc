@@ -0,0 +1,442 @@
+/*
+ * Copyright (C) 2007-2016 Hypertable, Inc.
+ *
+ * This file is part of Hypertable.
+ *
+ * Hypertable is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 3 of the
+ * License, or any later version.
+ *
+ * Hypertable is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <Common/Compat.h>
+
+#include <FsBroker/Lib/Client.h>
+#include <FsBroker/Lib/Config.h>
+
+#include <Hypertable/RangeServer/CellStoreV7.h>
+#include <Hypertable/RangeServer/Global.h>
+
+#include <Hypertable/Lib/AccessGroupSpec.h>
+#include <Hypertable/Lib/Client.h>
+#include <Hypertable/Lib/Key.h>
+#include <Hypertable/Lib/LoadDataEscape.h>
+#include <Hypertable/Lib/LoadDataFlags.h>
+#include <Hypertable/Lib/LoadDataSource.h>
+#include <Hypertable/Lib/LoadDataSourceFactory.h>
+#include <Hypertable/Lib/RangeServer/Client.h>
+#include <Hypertable/Lib/Schema.h>
+
+#include <AsyncComm/Comm.h>
+
+#include <Common/DynamicBuffer.h>
+#include <Common/Error.h>
+#include <Common/Init.h>
+#include <Common/Stopwatch.h>
+#include <Common/StringExt.h>
+#include <Common/Time.h>
+#include <Common/Timer.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace Hypertable;
+using namespace Config;
+using namespace std;
+
+namespace {
+
+  const char *usage = R"(
+Usage: ht bulk_load [options] <table> <input-file>
+
+This tool loads <input-file>, which must be in the LOAD DATA INFILE
+format, into <table> without going through the RangeServer update
+path.  The cells are sorted and written directly into CellStore
+files, one per access group per range, which are then handed to the
+RangeServer that owns each range with the adopt_cellstores request.
+No commit log entries are written and the cell cache is bypassed.
+
+Cells that don't have a timestamp are assigned the time at which
+the load started.  All cells are given that same revision, which is
+recorded in a CellStore trailer flag so the RangeServer doesn't treat
+it as a commit log replay point.  A RangeServer rejects files whose
+revision is ahead of its own clock (RANGESERVER_CLOCK_SKEW), so the
+clock of the host running this tool must not lead those of the
+RangeServers.
+
+Adopting is idempotent: a RangeServer skips files it has already
+adopted, so requests that time out are simply re-sent.
+
+If a range splits or moves while the files are being written, the
+files are adopted by every range that now covers their rows; each
+range only sees the part of the file that falls within its bounds.
+
+The entire input is held in memory while it is sorted, so very large
+inputs should be split up and loaded in several passes.  Counter
+columns and delete records are not supported.
+
+Options)";
+
+  struct AppPolicy : Policy {
+    static void init_options() {
+      cmdline_desc(usage).add_options()
+        ("namespace", str()->default_value("/"), "Namespace containing <table>")
+        ("header-file", str(), "Read the header line from <arg>")
+        ("no-escape", "Don't unescape rows, qualifiers and values")
+        ("ignore-unknown-columns", "Skip cells with unknown column families")
+        ("timeout", i32(), "Timeout in milliseconds for each request")
+        ("revision", i64(), "Revision (and default timestamp) of the loaded "
+         "cells, in nanoseconds since the epoch; defaults to the current time")
+        ;
+      cmdline_hidden_desc().add_options()
+        ("table", str(), "table name")
+        ("input-file", str(), "input file")
+        ("table", 1)
+        ("input-file", -1);
+    }
+    static void init() {
+      if (!has("table") || !has("input-file")) {
+        HT_ERROR_OUT << "table and input-file required\n" << cmdline_desc()
+                     << HT_END;
+        exit(1);
+      }
+    }
+  };
+
+  typedef Meta::list<AppPolicy, FsClientPolicy, DefaultCommPolicy> Policies;
+
+  /// Offsets of a cell's serialized key and value within the load buffers.
+  struct CellOffsets {
+    size_t key;
+    size_t value;
+    uint8_t ag;
+  };
+
+  /// State shared by the load steps.
+  struct LoadContext {
+    TableIdentifierManaged table_id;
+    SchemaPtr schema;
+    vector<String> ag_names;
+    vector<PropertiesPtr> ag_props;
+    map<uint8_t, uint8_t> family_to_ag;
+    map<uint8_t, bool> family_time_order_desc;
+    DynamicBuffer keys {1024*1024};
+    DynamicBuffer values {1024*1024};
+    vector<CellOffsets> cells;
+    int64_t revision {};
+    String load_id;
+    uint32_t timeout_ms {};
+  };
+
+  /// Builds per access group CellStore properties the same way
+  /// AccessGroup::update_schema() does, adding the <i>bulk-load</i> flag.
+  void setup_access_groups(LoadContext &ctx) {
+    for (auto ag_spec : ctx.schema->get_access_groups()) {
+      if (ag_spec->get_option_in_memory())
+        HT_THROWF(Error::NOT_IMPLEMENTED, "Access group %s is in memory",
+                  ag_spec->get_name().c_str());
+      PropertiesPtr props = make_shared<Properties>();
+      props->set("compressor", ag_spec->get_option_compressor());
+      props->set("blocksize", ag_spec->get_option_blocksize());
+      if (ag_spec->get_option_replication() != -1)
+        props->set("replication", (int32_t)ag_spec->get_option_replication());
+      if (!ag_spec->get_option_bloom_filter().empty())
+        AccessGroupOptions::parse_bloom_filter(ag_spec->get_option_bloom_filter(),
+                                               props);
+      else
+        AccessGroupOptions::parse_bloom_filter(
+          get_str("Hypertable.RangeServer.CellStore.DefaultBloomFilter"), props);
+      props->set("bulk-load", true);
+      uint8_t ag_index = (uint8_t)ctx.ag_names.size();
+      for (auto cf_spec : ag_spec->columns()) {
+        if (cf_spec->get_deleted())
+          continue;
+        ctx.family_to_ag[(uint8_t)cf_spec->get_id()] = ag_index;
+        ctx.family_time_order_desc[(uint8_t)cf_spec->get_id()] =
+          cf_spec->get_option_time_order_desc();
+      }
+      ctx.ag_names.push_back(ag_spec->get_name());
+      ctx.ag_props.push_back(props);
+    }
+  }
+
+  /// Reads the input into memory as serialized keys and values.
+  void read_input(LoadContext &ctx, FsBroker::Lib::ClientPtr &fs_client) {
+    String input_file = get_str("input-file");
+    String header_file = has("header-file") ? get_str("header-file") : String();
+    int src = LOCAL_FILE, header_src = LOCAL_FILE;
+    int flags = has("no-escape") ? LoadDataFlags::NO_ESCAPE : 0;
+    bool ignore_unknown = has("ignore-unknown-columns");
+    vector<String> key_columns;
+
+    if (boost::algorithm::starts_with(input_file, "fs://")) {
+      input_file = input_file.substr(5);
+      src = DFS_FILE;
+    }
+    else if (input_file == "-")
+      src = STDIN;
+    if (boost::algorithm::starts_with(header_file, "fs://")) {
+      header_file = header_file.substr(5);
+      header_src = DFS_FILE;
+    }
+
+    LoadDataSourcePtr lds(LoadDataSourceFactory::create(fs_client, input_file,
+                                                        src, header_file,
+                                                        header_src, key_columns,
+                                                        "", '\t', 0, flags));
+    KeySpec key;
+    uint8_t *value;
+    uint32_t value_len;
+    uint32_t consumed;
+    bool is_delete;
+    LoadDataEscape row_escaper, qualifier_escaper, value_escaper;
+    const char *escaped_buf;
+    size_t escaped_len;
+    String row, qualifier;
+    CellOffsets offsets;
+
+    try {
+      while (lds->next(&key, &value, &value_len, &is_delete, &consumed)) {
+        if (is_delete)
+          HT_THROW(Error::NOT_IMPLEMENTED, "Delete records are not supported");
+
+        ColumnFamilySpec *cf_spec =
+          ctx.schema->get_column_family(key.column_family);
+        if (cf_spec == nullptr) {
+          if (ignore_unknown)
+            continue;
+          HT_THROWF(Error::BAD_KEY, "Unknown column family '%s'",
+                    (const char *)key.column_family);
+        }
+        if (cf_spec->get_option_counter())
+          HT_THROWF(Error::NOT_IMPLEMENTED, "Column family '%s' is a counter",
+                    cf_spec->get_name().c_str());
+
+        if (flags & LoadDataFlags::NO_ESCAPE) {
+          row.assign((const char *)key.row, key.row_len);
+          qualifier.assign(key.column_qualifier ? key.column_qualifier : "",
+                           key.column_qualifier_len);
+          escaped_buf = (const char *)value;
+          escaped_len = value_len;
+        }
+        else {
+          row_escaper.unescape((const char *)key.row, (size_t)key.row_len,
+                               &escaped_buf, &escaped_len);
+          row.assign(escaped_buf, escaped_len);
+          qualifier_escaper.unescape(key.column_qualifier,
+                                     (size_t)key.column_qualifier_len,
+                                     &escaped_buf, &escaped_len);
+          qualifier.assign(escaped_buf ? escaped_buf : "", escaped_len);
+          value_escaper.unescape((const char *)value, (size_t)value_len,
+                                 &escaped_buf, &escaped_len);
+        }
+
+        uint8_t family = (uint8_t)cf_spec->get_id();
+        int64_t timestamp = (key.timestamp == AUTO_ASSIGN) ?
+          ctx.revision : key.timestamp;
+
+        offsets.key = ctx.keys.fill();
+        offsets.value = ctx.values.fill();
+        offsets.ag = ctx.family_to_ag[family];
+        create_key_and_append(ctx.keys, FLAG_INSERT, row.c_str(), family,
+                              qualifier.c_str(), timestamp, ctx.revision,
+                              !ctx.family_time_order_desc[family]);
+        append_as_byte_string(ctx.values, escaped_buf, escaped_len);
+        ctx.cells.push_back(offsets);
+      }
+    }
+    catch (Exception &e) {
+      HT_THROW2F(e.code(), e, "line number %lld",
+                 (Lld)lds->get_current_lineno());
+    }
+  }
+
+  /// Sorts cells by serialized key and drops exact duplicates, keeping the
+  /// last one read.
+  void sort_cells(LoadContext &ctx) {
+    const uint8_t *base = ctx.keys.base;
+    stable_sort(ctx.cells.begin(), ctx.cells.end(),
+                [base](const CellOffsets &a, const CellOffsets &b) {
+                  return SerializedKey(base + a.key) < SerializedKey(base + b.key);
+                });
+    vector<CellOffsets> unique_cells;
+    unique_cells.reserve(ctx.cells.size());
+    for (auto &cell : ctx.cells) {
+      if (!unique_cells.empty() &&
+          SerializedKey(base + unique_cells.back().key) == SerializedKey(base + cell.key))
+        unique_cells.back() = cell;
+      else
+        unique_cells.push_back(cell);
+    }
+    ctx.cells.swap(unique_cells);
+  }
+
+  const char *cell_row(LoadContext &ctx, size_t i) {
+    return SerializedKey(ctx.keys.base + ctx.cells[i].key).row();
+  }
+
+  /// Writes cells [begin, end) into one CellStore per access group and
+  /// returns the (access group, file) pairs.
+  vector<pair<String, String>> write_cellstores(LoadContext &ctx, size_t begin,
+                                                size_t end, uint32_t file_id) {
+    vector<pair<String, String>> files;
+    vector<CellStorePtr> cellstores(ctx.ag_names.size());
+    vector<size_t> counts(ctx.ag_names.size(), 0);
+    Key key;
+
+    for (size_t i=begin; i<end; i++)
+      counts[ctx.cells[i].ag]++;
+
+    for (size_t ag=0; ag<ctx.ag_names.size(); ag++) {
+      if (counts[ag] == 0)
+        continue;
+      String dir = format("%s/tables/%s/%s/bulk-%s", Global::toplevel_dir.c_str(),
+                          ctx.table_id.id, ctx.ag_names[ag].c_str(),
+                          ctx.load_id.c_str());
+      String fname = format("%s/cs%u", dir.c_str(), (unsigned)file_id);
+      Global::dfs->mkdirs(dir);
+      cellstores[ag] = make_shared<CellStoreV7>(Global::dfs.get(), ctx.schema);
+      cellstores[ag]->create(fname.c_str(), counts[ag], ctx.ag_props[ag],
+                             &ctx.table_id);
+      files.push_back(make_pair(ctx.ag_names[ag], fname));
+    }
+
+    for (size_t i=begin; i<end; i++) {
+      key.load(SerializedKey(ctx.keys.base + ctx.cells[i].key));
+      cellstores[ctx.cells[i].ag]->add(key,
+                                       ByteString(ctx.values.base + ctx.cells[i].value));
+    }
+
+    for (auto &cellstore : cellstores) {
+      if (cellstore)
+        cellstore->finalize(&ctx.table_id);
+    }
+    return files;
+  }
+
+  /// Hands <code>files</code>, holding rows <code>first_row</code> through
+  /// <code>last_row</code>, to every range that covers those rows.
+  void adopt(LoadContext &ctx, RangeLocatorPtr &locator,
+             Lib::RangeServer::Client &rs_client, const String &first_row,
+             const String &last_row, const vector<pair<String, String>> &files) {
+    RangeLocationInfo range_loc;
+    String row = first_row;
+    bool hard = false;
+
+    while (true) {
+      Timer timer(ctx.timeout_ms, true);
+      locator->find_loop(&ctx.table_id, row.c_str(), &range_loc, timer, hard);
+      RangeSpec range(range_loc.start_row.c_str(), range_loc.end_row.c_str());
+      try {
+        rs_client.adopt_cellstores(range_loc.addr, ctx.table_id, range, files,
+                                   timer);
+      }
+      catch (Exception &e) {
+        if (e.code() == Error::RANGESERVER_RANGE_NOT_FOUND ||
+            e.code() == Error::RANGESERVER_RANGE_BUSY ||
+            e.code() == Error::RANGESERVER_RANGE_NOT_ACTIVE ||
+            e.code() == Error::REQUEST_TIMEOUT) {
+          // Range split, moved, or is undergoing maintenance, or the
+          // response was lost (files already adopted are skipped)
+          locator->invalidate(&ctx.table_id, row.c_str());
+          hard = true;
+          this_thread::sleep_for(chrono::milliseconds(1000));
+          continue;
+        }
+        throw;
+      }
+      hard = false;
+      if (range_loc.end_row.compare(last_row) >= 0)
+        break;
+      // Smallest row greater than the end row of this range
+      row = range_loc.end_row + (char)1;
+    }
+  }
+
+} // local namespace
+
+
+int main(int argc, char **argv) {
+  try {
+    init_with_policies<Policies>(argc, argv);
+
+    LoadContext ctx;
+    Stopwatch stopwatch;
+
+    ctx.timeout_ms = has("timeout") ? get_i32("timeout") :
+      get_i32("Hypertable.Request.Timeout");
+    ctx.revision = has("revision") ? get_i64("revision") : get_ts64();
+    ctx.load_id = format("%lld", (Lld)ctx.revision);
+
+    Global::toplevel_dir = get_str("Hypertable.Directory");
+    boost::trim_if(Global::toplevel_dir, boost::is_any_of("/"));
+    Global::toplevel_dir = String("/") + Global::toplevel_dir;
+
+    FsBroker::Lib::ClientPtr fs_client =
+      make_shared<FsBroker::Lib::Client>(get_str("FsBroker.Host"),
+                                         get_i16("FsBroker.Port"),
+                                         ctx.timeout_ms);
+    Global::dfs = fs_client;
+    Global::memory_tracker = new MemoryTracker(0, 0);
+
+    ClientPtr client = make_shared<Hypertable::Client>();
+    NamespacePtr ns = client->open_namespace(get_str("namespace"));
+    TablePtr table = ns->open_table(get_str("table"));
+    table->get(ctx.table_id, ctx.schema);
+    RangeLocatorPtr locator = table->get_range_locator();
+    Lib::RangeServer::Client rs_client(Comm::instance(), ctx.timeout_ms);
+
+    setup_access_groups(ctx);
+    read_input(ctx, fs_client);
+    sort_cells(ctx);
+
+    cout << "Read " << ctx.cells.size() << " cells in "
+         << stopwatch.elapsed() << " seconds" << endl;
+
+    // Split sorted cells at range boundaries and write one set of
+    // CellStores per range
+    RangeLocationInfo range_loc;
+    size_t begin = 0;
+    uint32_t file_id = 0;
+    while (begin < ctx.cells.size()) {
+      Timer timer(ctx.timeout_ms, true);
+      locator->find_loop(&ctx.table_id, cell_row(ctx, begin), &range_loc,
+                         timer, false);
+      size_t end = begin + 1;
+      while (end < ctx.cells.size() &&
+             strcmp(cell_row(ctx, end), range_loc.end_row.c_str()) <= 0)
+        end++;
+      String first_row = cell_row(ctx, begin);
+      String last_row = cell_row(ctx, end-1);
+      auto files = write_cellstores(ctx, begin, end, file_id++);
+      adopt(ctx, locator, rs_client, first_row, last_row, files);
+      begin = end;
+    }
+
+    cout << "Loaded " << ctx.cells.size() << " cells into " << file_id
+         << " ranges in " << stopwatch.elapsed() << " seconds" << endl;
+  }
+  catch (Exception &e) {
+    HT_ERROR_OUT << e << HT_END;
+    quick_exit(EXIT_FAILURE);
+  }
+  quick_exit(EXIT_SUCCESS);
+}
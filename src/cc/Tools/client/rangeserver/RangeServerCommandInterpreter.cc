@@ -144,8 +144,16 @@ int RangeServerCommandInterpreter::execute_line(const String &line) {
 
     if (state.command == COMMAND_STATUS) {
       Status status;
+      string latency_report;
       try {
-        m_range_server->status(m_addr, status);
+        if (state.latency) {
+          Timer timer(m_range_server->default_timeout(), true);
+          m_range_server->status(m_addr,
+                                 Lib::RangeServer::Protocol::STATUS_FLAG_LATENCY,
+                                 status, latency_report, timer);
+        }
+        else
+          m_range_server->status(m_addr, status);
       }
       catch (Exception &e) {
         status.set(Status::Code::CRITICAL,
@@ -159,6 +167,7 @@ int RangeServerCommandInterpreter::execute_line(const String &line) {
         if (!output.empty())
           cout << " - " << output;
         cout << endl;
+        cout << latency_report << flush;
       }
       return static_cast<int>(code);
     }
@@ -598,6 +598,63 @@ def metric_init(params):
              'groups': 'hypertable RangeServer'}
         descriptors.append(d);
         
+        d = {'name': 'ht.rangeserver.compactions.throttle.rate',
+             'call_back': metric_callback,
+             'time_max': 90,
+             'value_type': 'float',
+             'units': 'MB/s',
+             'slope': 'both',
+             'format': '%f',
+             'description': 'Compaction throttle rate',
+             'groups': 'hypertable RangeServer'}
+        descriptors.append(d);
+        
+        d = {'name': 'ht.rangeserver.compactions.throttle.debt',
+             'call_back': metric_callback,
+             'time_max': 90,
+             'value_type': 'float',
+             'units': 'MB',
+             'slope': 'both',
+             'format': '%f',
+             'description': 'Compaction throttle debt',
+             'groups': 'hypertable RangeServer'}
+        descriptors.append(d);
+        
+        d = {'name': 'ht.rangeserver.compactions.throttle.throughput',
+             'call_back': metric_callback,
+             'time_max': 90,
+             'value_type': 'float',
+             'units': 'MB/s',
+             'slope': 'both',
+             'format': '%f',
+             'description': 'Throttled compaction throughput',
+             'groups': 'hypertable RangeServer'}
+        descriptors.append(d);
+        
+        latency_histograms = [('updateQualify', 'update qualify stage'),
+                              ('updateCommit', 'update commit log write stage'),
+                              ('updateSync', 'update commit log sync'),
+                              ('updateRespond', 'update add-and-respond stage'),
+                              ('createScanner', 'create scanner'),
+                              ('fetchScanblock', 'fetch scanblock'),
+                              ('blockCacheMiss', 'block cache miss'),
+                              ('requestWait', 'request queue wait')]
+        latency_stats = [('p50', 'Median'),
+                         ('p99', '99th percentile'),
+                         ('max', 'Maximum')]
+        for (histogram, histogram_desc) in latency_histograms:
+            for (stat, stat_desc) in latency_stats:
+                d = {'name': 'ht.rangeserver.latency.%s.%s' % (histogram, stat),
+                     'call_back': metric_callback,
+                     'time_max': 90,
+                     'value_type': 'float',
+                     'units': 'ms',
+                     'slope': 'both',
+                     'format': '%f',
+                     'description': '%s %s latency' % (stat_desc, histogram_desc),
+                     'groups': 'hypertable RangeServer'}
+                descriptors.append(d);
+        
         d = {'name': 'ht.rangeserver.scanners',
              'call_back': metric_callback,
              'time_max': 90,
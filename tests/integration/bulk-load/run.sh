@@ -0,0 +1,54 @@
+#!/usr/bin/env bash
+
+HT_HOME=${INSTALL_DIR:-"$HOME/hypertable/current"}
+SCRIPT_DIR=`dirname $0`
+
+function finish {
+  $HT_HOME/bin/ht-destroy-database.sh
+}
+trap finish EXIT
+
+# The first adopt_cellstores response is held back past the request timeout
+# of ht bulk_load, which then re-sends the request for the same files
+$HT_HOME/bin/ht-start-test-servers.sh --clear --no-thriftbroker \
+    --induce-failure="adopt-cellstores-1:pause(6000):0"
+
+echo "use '/'; DROP TABLE IF EXISTS BulkLoad; CREATE TABLE BulkLoad (a, b, ACCESS GROUP ag1 (a), ACCESS GROUP ag2 (b));" | $HT_HOME/bin/ht shell --batch
+
+grep -v '^#' $SCRIPT_DIR/data.tsv > bulk-load.golden
+
+$HT_HOME/bin/ht bulk_load --timeout=3000 BulkLoad $SCRIPT_DIR/data.tsv
+if [ $? -ne 0 ]; then
+  echo "error: ht bulk_load failed"
+  exit 1
+fi
+
+echo "use '/'; SELECT * FROM BulkLoad;" | $HT_HOME/bin/ht shell --batch > bulk-load.output
+diff bulk-load.output bulk-load.golden
+if [ $? -ne 0 ]; then
+  echo "error: loaded cells differ from input"
+  exit 1
+fi
+
+fgrep "already adopted" $HT_HOME/log/RangeServer.log
+if [ $? -ne 0 ]; then
+  echo "error: re-sent adopt_cellstores request was not skipped"
+  exit 1
+fi
+
+# A revision ahead of the RangeServer clock is rejected
+FUTURE_REVISION=$(( (`date +%s` + 3600) * 1000000000 ))
+$HT_HOME/bin/ht bulk_load --revision=$FUTURE_REVISION BulkLoad $SCRIPT_DIR/future.tsv
+if [ $? -eq 0 ]; then
+  echo "error: ht bulk_load with a future revision succeeded"
+  exit 1
+fi
+
+echo "use '/'; SELECT * FROM BulkLoad;" | $HT_HOME/bin/ht shell --batch > bulk-load.output
+diff bulk-load.output bulk-load.golden
+if [ $? -ne 0 ]; then
+  echo "error: cells with a future revision were adopted"
+  exit 1
+fi
+
+exit 0
@@ -0,0 +1,67 @@
+#!/usr/bin/env bash
+
+HT_HOME=${INSTALL_DIR:-"$HOME/hypertable/current"}
+HYPERTABLE_HOME=$HT_HOME
+SCRIPT_DIR=`dirname $0`
+WRITE_TOTAL=${WRITE_TOTAL:-"5000000"}
+
+. $HT_HOME/bin/ht-env.sh
+
+function finish {
+  $HT_HOME/bin/ht-destroy-database.sh
+}
+trap finish EXIT
+
+# Replays the user commit log at RangeServer startup with the given number of
+# replay threads and dumps the resulting table contents to the given file
+function replay_and_dump {
+  $HT_HOME/bin/ht-stop-rangeserver.sh
+  $HT_HOME/bin/ht-start-rangeserver.sh \
+      --Hypertable.RangeServer.CommitLog.Replay.Threads=$1
+  echo "use '/'; SELECT * FROM LogReplay DISPLAY_TIMESTAMPS;" | \
+      $HT_HOME/bin/ht shell --batch > $2
+}
+
+# A small split size spreads the log over several ranges.  Shutting down the
+# RangeServer leaves the commit log in place, so each restart replays it
+$HT_HOME/bin/ht-start-test-servers.sh --clear --no-thriftbroker \
+    --Hypertable.RangeServer.Range.SplitSize=500K \
+    --Hypertable.RangeServer.CommitLog.RollLimit=1M
+
+$HT_HOME/bin/ht shell --no-prompt < $SCRIPT_DIR/create-table.hql
+
+# Rows are written twice so that replay has to preserve revision order
+for seed in 1 2; do
+  $HT_HOME/bin/ht load_generator update \
+      --rowkey.component.0.type=integer \
+      --rowkey.component.0.order=random \
+      --rowkey.component.0.format="%010lld" \
+      --rowkey.component.0.max=20000 \
+      --Field.value.size=100 --row-seed=1 --seed=$seed \
+      --max-bytes=$WRITE_TOTAL
+done
+
+echo "use '/'; SELECT * FROM LogReplay DISPLAY_TIMESTAMPS;" | \
+    $HT_HOME/bin/ht shell --batch > log-replay.golden
+
+replay_and_dump 1 log-replay.serial
+diff log-replay.serial log-replay.golden
+if [ $? -ne 0 ]; then
+  echo "error: serial replay lost or reordered cells"
+  exit 1
+fi
+
+replay_and_dump 4 log-replay.parallel
+diff log-replay.parallel log-replay.serial
+if [ $? -ne 0 ]; then
+  echo "error: parallel replay differs from serial replay"
+  exit 1
+fi
+
+fgrep "with 4 threads" $HT_HOME/log/RangeServer.log
+if [ $? -ne 0 ]; then
+  echo "error: commit log was not replayed through the pipeline"
+  exit 1
+fi
+
+exit 0
@@ -0,0 +1,6 @@
+[rowkey]
+        component.0.order=ascending
+        component.0.type=integer
+        component.0.format="%030lld"
+[Field.value]
+        size=150
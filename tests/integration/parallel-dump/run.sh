@@ -0,0 +1,86 @@
+#!/usr/bin/env bash
+
+HT_HOME=${INSTALL_DIR:-"$HOME/hypertable/current"}
+SCRIPT_DIR=`dirname $0`
+DUMP_DIR=`pwd`/parallel-dump.out
+export LC_ALL=C
+
+function finish {
+  $HT_HOME/bin/ht-destroy-database.sh
+}
+trap finish EXIT
+
+# A small split size gives the table many ranges
+$HT_HOME/bin/ht-start-test-servers.sh --clear --no-thriftbroker \
+    --Hypertable.RangeServer.Range.SplitSize=50K
+
+$HT_HOME/bin/ht shell --no-prompt < $SCRIPT_DIR/create-table.hql
+
+$HT_HOME/bin/ht ht_load_generator update --spec-file=${SCRIPT_DIR}/data.spec \
+    --table=ParallelDump --max-keys=20000 2>&1
+
+sleep 5
+
+rm -rf $DUMP_DIR parallel-dump.serial
+echo "use '/'; DUMP TABLE ParallelDump NO_TIMESTAMPS INTO FILE 'parallel-dump.serial';" | $HT_HOME/bin/ht shell --batch
+grep -v '^#' parallel-dump.serial | sort > parallel-dump.golden
+
+# Interrupt the first attempt, then remove some of the parts it may have
+# completed so that resuming has work to do whatever the timing was
+echo "use '/'; DUMP TABLE ParallelDump NO_TIMESTAMPS INTO DIRECTORY '$DUMP_DIR' PARALLEL 2;" | \
+    timeout -s KILL 5 $HT_HOME/bin/ht shell --batch
+
+if [ ! -f $DUMP_DIR/ranges ]; then
+  echo "error: range list was not written"
+  exit 1
+fi
+
+RANGES=`grep -c -v '^#' $DUMP_DIR/ranges`
+if [ $RANGES -lt 4 ]; then
+  echo "error: expected several ranges, found $RANGES"
+  exit 1
+fi
+
+rm -f $DUMP_DIR/part-000000.tsv $DUMP_DIR/part-000002.tsv
+rm -f `printf "$DUMP_DIR/part-%06d.tsv" $((RANGES - 1))`
+
+echo "use '/'; DUMP TABLE ParallelDump NO_TIMESTAMPS INTO DIRECTORY '$DUMP_DIR' PARALLEL 4;" | $HT_HOME/bin/ht shell --batch
+if [ $? -ne 0 ]; then
+  echo "error: resumed parallel dump failed"
+  exit 1
+fi
+
+PARTS=`ls $DUMP_DIR/part-*.tsv | wc -l`
+if [ $PARTS -ne $RANGES ]; then
+  echo "error: expected $RANGES part files, found $PARTS"
+  exit 1
+fi
+
+cat $DUMP_DIR/part-*.tsv | grep -v '^#' > parallel-dump.output
+sort -c parallel-dump.output
+if [ $? -ne 0 ]; then
+  echo "error: concatenated parts are not in row order"
+  exit 1
+fi
+
+diff parallel-dump.output parallel-dump.golden
+if [ $? -ne 0 ]; then
+  echo "error: parallel dump differs from DUMP TABLE"
+  exit 1
+fi
+
+# Resuming with a different scan specification, output format or table
+# must not mix the existing parts into the new dump
+for dump in "DUMP TABLE ParallelDump MAX_VERSIONS 1 NO_TIMESTAMPS" \
+            "DUMP TABLE ParallelDump" \
+            "DUMP TABLE ParallelDumpOther NO_TIMESTAMPS"; do
+  echo "use '/'; $dump INTO DIRECTORY '$DUMP_DIR';" | \
+      $HT_HOME/bin/ht shell --batch > parallel-dump.mismatch 2>&1
+  fgrep "Unable to resume dump" parallel-dump.mismatch
+  if [ $? -ne 0 ]; then
+    echo "error: '$dump' resumed a dump it did not start"
+    exit 1
+  fi
+done
+
+exit 0